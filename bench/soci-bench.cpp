@@ -0,0 +1,1367 @@
+//
+// Copyright (C) 2004-2006 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// Microbenchmarks of the core exchange layer.
+//
+// The workloads are run against the Empty backend, which does no work of its
+// own and so exposes the cost of session, statement_impl and the into/use
+// elements, and against an in-memory SQLite3 database (if the backend was
+// built), which adds a realistic but cheap backend on top of it. The "codec"
+// workloads measure the text conversions used by the backends on their own.
+//
+// Every benchmark prints a single line of JSON on the standard output, e.g.
+//
+// {"benchmark":"empty/into_use/prepared","backend":"empty","iterations":1024,
+//  "ns_per_op":123.4,"allocs_per_op":0,"rows_per_op":1,"rows_per_sec":8103727}
+//
+// so that the results of two builds can be compared by a script.
+
+#include "soci/soci.h"
+#include "soci/empty/soci-empty.h"
+#include "soci-text-codec.h"
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+#include "soci/sqlite3/soci-sqlite3.h"
+#endif
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace soci;
+
+// Allocation counting
+//
+// All the allocations done by the program, including the ones done by the
+// SOCI libraries, go through these replacements. Benchmarks are run from a
+// single thread, so a plain counter is enough.
+
+namespace
+{
+
+unsigned long long allocation_count = 0;
+
+void * counted_allocate(std::size_t size)
+{
+    ++allocation_count;
+
+    void * p = std::malloc(size != 0 ? size : 1);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+} // namespace anonymous
+
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+    #define SOCI_BENCH_THROW_BAD_ALLOC
+    #define SOCI_BENCH_NOTHROW noexcept
+#else
+    #define SOCI_BENCH_THROW_BAD_ALLOC throw(std::bad_alloc)
+    #define SOCI_BENCH_NOTHROW throw()
+#endif
+
+void * operator new(std::size_t size) SOCI_BENCH_THROW_BAD_ALLOC
+{
+    return counted_allocate(size);
+}
+
+void * operator new[](std::size_t size) SOCI_BENCH_THROW_BAD_ALLOC
+{
+    return counted_allocate(size);
+}
+
+void * operator new(std::size_t size, std::nothrow_t const &) SOCI_BENCH_NOTHROW
+{
+    ++allocation_count;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void * operator new[](std::size_t size, std::nothrow_t const &) SOCI_BENCH_NOTHROW
+{
+    ++allocation_count;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void * p) SOCI_BENCH_NOTHROW
+{
+    std::free(p);
+}
+
+void operator delete[](void * p) SOCI_BENCH_NOTHROW
+{
+    std::free(p);
+}
+
+void operator delete(void * p, std::nothrow_t const &) SOCI_BENCH_NOTHROW
+{
+    std::free(p);
+}
+
+void operator delete[](void * p, std::nothrow_t const &) SOCI_BENCH_NOTHROW
+{
+    std::free(p);
+}
+
+namespace
+{
+
+// Monotonic clock, in nanoseconds
+double now_ns()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) * 1e9 / frequency.QuadPart;
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + ts.tv_nsec;
+#endif
+}
+
+// Workloads
+//
+// A workload prepares whatever it needs in setup(), outside of the measured
+// region, and then performs one operation (typically one statement execution)
+// per call to run_once().
+
+class workload
+{
+public:
+    workload(std::string const & name, std::string const & backend,
+        std::size_t rows_per_op)
+        : name_(backend + "/" + name), backend_(backend),
+          rows_per_op_(rows_per_op) {}
+    virtual ~workload() {}
+
+    std::string const & name() const { return name_; }
+    std::string const & backend() const { return backend_; }
+    std::size_t rows_per_op() const { return rows_per_op_; }
+
+    virtual void setup() {}
+    virtual void run_once() = 0;
+
+private:
+    std::string name_;
+    std::string backend_;
+    std::size_t rows_per_op_;
+
+    SOCI_NOT_COPYABLE(workload)
+};
+
+// The number of rows exchanged by the bulk workloads in a single operation
+std::size_t const bulk_size = 100;
+
+// The number of rows in the table of the SQLite3 workloads
+std::size_t const table_size = 1000;
+
+// Sample values and column names for each exchange_type supported by vectors
+template <typename T> struct bench_type;
+
+template <> struct bench_type<char>
+{
+    static char const * name() { return "char"; }
+    static char const * column() { return "c"; }
+    static char make(std::size_t i) { return static_cast<char>('a' + i % 26); }
+};
+
+template <> struct bench_type<std::string>
+{
+    static char const * name() { return "stdstring"; }
+    static char const * column() { return "s"; }
+    static std::string make(std::size_t i)
+    {
+        std::ostringstream ss;
+        ss << "value number " << i;
+        return ss.str();
+    }
+};
+
+template <> struct bench_type<short>
+{
+    static char const * name() { return "short"; }
+    static char const * column() { return "sh"; }
+    static short make(std::size_t i) { return static_cast<short>(i % 30000); }
+};
+
+template <> struct bench_type<int>
+{
+    static char const * name() { return "integer"; }
+    static char const * column() { return "i"; }
+    static int make(std::size_t i) { return static_cast<int>(i * 7); }
+};
+
+template <> struct bench_type<long long>
+{
+    static char const * name() { return "long_long"; }
+    static char const * column() { return "ll"; }
+    static long long make(std::size_t i) { return 10000000000LL + i; }
+};
+
+template <> struct bench_type<unsigned long long>
+{
+    static char const * name() { return "unsigned_long_long"; }
+    static char const * column() { return "ull"; }
+    static unsigned long long make(std::size_t i) { return 20000000000ULL + i; }
+};
+
+template <> struct bench_type<double>
+{
+    static char const * name() { return "double"; }
+    static char const * column() { return "d"; }
+    static double make(std::size_t i) { return 0.25 * i + 1.0 / 3; }
+};
+
+template <> struct bench_type<std::tm>
+{
+    static char const * name() { return "stdtm"; }
+    static char const * column() { return "t"; }
+    static std::tm make(std::size_t i)
+    {
+        std::tm t;
+        std::memset(&t, 0, sizeof(t));
+        t.tm_year = 120;
+        t.tm_mon = static_cast<int>(i % 12);
+        t.tm_mday = static_cast<int>(1 + i % 28);
+        t.tm_hour = static_cast<int>(i % 24);
+        t.tm_min = static_cast<int>(i % 60);
+        t.tm_sec = static_cast<int>((i * 7) % 60);
+        return t;
+    }
+};
+
+template <typename T>
+void fill_vector(std::vector<T> & v, std::size_t count)
+{
+    v.clear();
+    v.reserve(count);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        v.push_back(bench_type<T>::make(i));
+    }
+}
+
+} // namespace anonymous
+
+// The record used by the ORM workloads
+
+struct bench_record
+{
+    int id;
+    std::string name;
+    double value;
+};
+
+namespace soci
+{
+
+template <> struct type_conversion<bench_record>
+{
+    typedef values base_type;
+
+    static void from_base(values const & v, indicator /* ind */, bench_record & r)
+    {
+        r.id = v.get<int>("id");
+        r.name = v.get<std::string>("s");
+        r.value = v.get<double>("d");
+    }
+
+    static void to_base(bench_record const & r, values & v, indicator & ind)
+    {
+        v.set("id", r.id);
+        v.set("s", r.name);
+        v.set("d", r.value);
+        ind = i_ok;
+    }
+};
+
+} // namespace soci
+
+// The same record with the fields mapped at compile time, in the order in
+// which they're used in the queries below.
+struct bench_struct
+{
+    int id;
+    std::string name;
+    double value;
+};
+
+SOCI_MAP_STRUCT_BEGIN(bench_struct)
+    SOCI_MAP_FIELD(name)
+    SOCI_MAP_FIELD(value)
+    SOCI_MAP_FIELD(id)
+SOCI_MAP_STRUCT_END()
+
+// Wrapper around int, which is either converted element by element when
+// exchanging the vectors of it, as any user type, or declared to be layout
+// compatible with int and exchanged directly.
+template <bool LayoutCompatible>
+struct bench_int
+{
+    int value;
+};
+
+namespace soci
+{
+
+template <bool LayoutCompatible>
+struct type_conversion<bench_int<LayoutCompatible> >
+{
+    typedef int base_type;
+
+    static void from_base(int i, indicator /* ind */,
+        bench_int<LayoutCompatible> & n)
+    {
+        n.value = i;
+    }
+
+    static void to_base(bench_int<LayoutCompatible> const & n, int & i,
+        indicator & ind)
+    {
+        i = n.value;
+        ind = i_ok;
+    }
+};
+
+template <> struct is_layout_compatible_with_base<bench_int<true> >
+{
+    static bool const value = true;
+};
+
+} // namespace soci
+
+namespace
+{
+
+template <bool LayoutCompatible> struct bench_type<bench_int<LayoutCompatible> >
+{
+    static char const * name()
+    {
+        return LayoutCompatible ? "user_int/layout_compatible" : "user_int";
+    }
+
+    static char const * column() { return "i"; }
+};
+
+// Single row into and use, with a new statement for every execution
+class into_use_once_workload : public workload
+{
+public:
+    into_use_once_workload(session & sql, std::string const & backend,
+        std::string const & query)
+        : workload("into_use/once", backend, 1),
+          sql_(sql), query_(query), id_(1), value_(0) {}
+
+    virtual void run_once()
+    {
+        sql_ << query_, into(value_), use(id_);
+    }
+
+private:
+    session & sql_;
+    std::string query_;
+    int id_;
+    int value_;
+};
+
+// The same as above, but with the statement prepared once
+class into_use_prepared_workload : public workload
+{
+public:
+    into_use_prepared_workload(session & sql, std::string const & backend,
+        std::string const & query)
+        : workload("into_use/prepared", backend, 1),
+          sql_(sql), query_(query), st_(sql), id_(1), value_(0) {}
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare << query_, into(value_), use(id_));
+    }
+
+    virtual void run_once()
+    {
+        st_.execute(true);
+    }
+
+private:
+    session & sql_;
+    std::string query_;
+    statement st_;
+    int id_;
+    int value_;
+};
+
+// Inserting a vector of the given type with a prepared statement. As SQLite3
+// has a real table behind it, the rows are inserted in a transaction which is
+// rolled back, so that the table doesn't grow with the number of iterations.
+template <typename T>
+class bulk_use_workload : public workload
+{
+public:
+    bulk_use_workload(session & sql, std::string const & backend,
+        std::string const & query, bool rollback)
+        : workload(std::string("bulk_use/") + bench_type<T>::name(),
+            backend, bulk_size),
+          sql_(sql), query_(query), rollback_(rollback), st_(sql) {}
+
+    virtual void setup()
+    {
+        fill_vector(values_, bulk_size);
+        st_ = (sql_.prepare << query_, use(values_));
+    }
+
+    virtual void run_once()
+    {
+        if (rollback_)
+        {
+            transaction tr(sql_);
+            st_.execute(true);
+            tr.rollback();
+        }
+        else
+        {
+            st_.execute(true);
+        }
+    }
+
+private:
+    session & sql_;
+    std::string query_;
+    bool rollback_;
+    statement st_;
+    std::vector<T> values_;
+};
+
+// Fetching the whole table into vectors of the given type
+template <typename T>
+class bulk_into_workload : public workload
+{
+public:
+    bulk_into_workload(session & sql, std::string const & backend)
+        : workload(std::string("bulk_into/") + bench_type<T>::name(),
+            backend, table_size),
+          sql_(sql), st_(sql), values_(bulk_size) {}
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare << "select " << bench_type<T>::column()
+            << " from bench_types", into(values_));
+    }
+
+    virtual void run_once()
+    {
+        values_.resize(bulk_size);
+        st_.execute();
+        while (st_.fetch())
+        {
+            // Just fetching is what is measured here.
+        }
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    std::vector<T> values_;
+};
+
+// Iterating over all the rows of the table, reading each column as its
+// natural type, with the rows fetched in batches of the given size
+class rowset_row_workload : public workload
+{
+public:
+    rowset_row_workload(session & sql, std::string const & backend,
+        std::size_t batchSize)
+        : workload(batchSize > 1 ? "rowset/row" : "rowset/row/unbatched",
+            backend, table_size),
+          sql_(sql), batchSize_(batchSize) {}
+
+    virtual void run_once()
+    {
+        sql_.set_rowset_batch_size(batchSize_);
+
+        rowset<row> rs = (sql_.prepare << "select * from bench_types");
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            row const & r = *it;
+            for (std::size_t i = 0; i != r.size(); ++i)
+            {
+                if (r.get_indicator(i) == i_null)
+                {
+                    continue;
+                }
+
+                switch (r.get_properties(i).get_data_type())
+                {
+                case dt_string:
+                    r.get<std::string>(i);
+                    break;
+                case dt_double:
+                    r.get<double>(i);
+                    break;
+                case dt_integer:
+                    r.get<int>(i);
+                    break;
+                case dt_long_long:
+                    r.get<long long>(i);
+                    break;
+                case dt_unsigned_long_long:
+                    r.get<unsigned long long>(i);
+                    break;
+                case dt_date:
+                    r.get<std::tm>(i);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    session & sql_;
+    std::size_t const batchSize_;
+};
+
+// Iterating over the table through the type_conversion<bench_record>
+class rowset_orm_workload : public workload
+{
+public:
+    rowset_orm_workload(session & sql, std::string const & backend,
+        std::size_t batchSize)
+        : workload(batchSize > 1 ? "rowset/orm" : "rowset/orm/unbatched",
+            backend, table_size),
+          sql_(sql), batchSize_(batchSize) {}
+
+    virtual void run_once()
+    {
+        sql_.set_rowset_batch_size(batchSize_);
+
+        rowset<bench_record> rs =
+            (sql_.prepare << "select id, s, d from bench_types");
+        for (rowset<bench_record>::const_iterator it = rs.begin();
+            it != rs.end(); ++it)
+        {
+            // Just converting is what is measured here.
+        }
+    }
+
+private:
+    session & sql_;
+    std::size_t const batchSize_;
+};
+
+// Using a record through the type_conversion<bench_record>
+class orm_use_workload : public workload
+{
+public:
+    orm_use_workload(session & sql, std::string const & backend,
+        bool prepared)
+        : workload(prepared ? "orm_use/prepared" : "orm_use/once", backend, 1),
+          sql_(sql), prepared_(prepared), st_(sql)
+    {
+        record_.id = 1;
+        record_.name = "updated";
+        record_.value = 3.25;
+    }
+
+    virtual void setup()
+    {
+        if (prepared_)
+        {
+            st_ = (sql_.prepare << query_, use(record_));
+        }
+    }
+
+    virtual void run_once()
+    {
+        if (prepared_)
+        {
+            st_.execute(true);
+        }
+        else
+        {
+            sql_ << query_, use(record_);
+        }
+    }
+
+private:
+    static char const * const query_;
+
+    session & sql_;
+    bool prepared_;
+    statement st_;
+    bench_record record_;
+};
+
+char const * const orm_use_workload::query_ =
+    "update bench_types set s = :s, d = :d where id = :id";
+
+// Reading a single record through the type_conversion<bench_record>
+class orm_into_workload : public workload
+{
+public:
+    orm_into_workload(session & sql, std::string const & backend)
+        : workload("orm_into/prepared", backend, 1),
+          sql_(sql), st_(sql), id_(1) {}
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare << "select id, s, d from bench_types where id = :id",
+            into(record_), use(id_));
+    }
+
+    virtual void run_once()
+    {
+        st_.execute(true);
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    int id_;
+    bench_record record_;
+};
+
+// Updating bulk_size records through the type_conversion<bench_record> with
+// a single bulk operation
+class orm_bulk_use_workload : public workload
+{
+public:
+    orm_bulk_use_workload(session & sql, std::string const & backend)
+        : workload("orm_bulk_use/prepared", backend, bulk_size),
+          sql_(sql), st_(sql), records_(bulk_size)
+    {
+        for (std::size_t i = 0; i != records_.size(); ++i)
+        {
+            records_[i].id = static_cast<int>(i + 1);
+            records_[i].name = "updated";
+            records_[i].value = 3.25;
+        }
+    }
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare <<
+            "update bench_types set s = :s, d = :d where id = :id",
+            use(records_));
+    }
+
+    virtual void run_once()
+    {
+        st_.execute(true);
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    std::vector<bench_record> records_;
+};
+
+// Fetching the whole table into a vector of bench_record
+class orm_bulk_into_workload : public workload
+{
+public:
+    orm_bulk_into_workload(session & sql, std::string const & backend)
+        : workload("orm_bulk_into/prepared", backend, table_size),
+          sql_(sql), st_(sql), records_(bulk_size) {}
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare << "select id, s, d from bench_types",
+            into(records_));
+    }
+
+    virtual void run_once()
+    {
+        records_.resize(bulk_size);
+        st_.execute();
+        while (st_.fetch())
+        {
+            // Just fetching and converting is what is measured here.
+        }
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    std::vector<bench_record> records_;
+};
+
+// Updating a single record through the fields mapped with SOCI_MAP_FIELD(),
+// for comparison with orm_use/prepared
+class struct_use_workload : public workload
+{
+public:
+    struct_use_workload(session & sql, std::string const & backend)
+        : workload("struct_use/prepared", backend, 1), sql_(sql), st_(sql)
+    {
+        record_.id = 1;
+        record_.name = "updated";
+        record_.value = 3.25;
+    }
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare <<
+            "update bench_types set s = :s, d = :d where id = :id",
+            use(record_));
+    }
+
+    virtual void run_once()
+    {
+        st_.execute(true);
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    bench_struct record_;
+};
+
+// Reading a single record through the fields mapped with SOCI_MAP_FIELD(),
+// for comparison with orm_into/prepared
+class struct_into_workload : public workload
+{
+public:
+    struct_into_workload(session & sql, std::string const & backend)
+        : workload("struct_into/prepared", backend, 1),
+          sql_(sql), st_(sql), id_(1) {}
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare << "select s, d, id from bench_types where id = :id",
+            into(record_), use(id_));
+    }
+
+    virtual void run_once()
+    {
+        st_.execute(true);
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    int id_;
+    bench_struct record_;
+};
+
+// Fetching the whole table into a vector of bench_struct, for comparison
+// with orm_bulk_into/prepared
+class struct_bulk_into_workload : public workload
+{
+public:
+    struct_bulk_into_workload(session & sql, std::string const & backend)
+        : workload("struct_bulk_into/prepared", backend, table_size),
+          sql_(sql), st_(sql), records_(bulk_size) {}
+
+    virtual void setup()
+    {
+        st_ = (sql_.prepare << "select s, d, id from bench_types",
+            into(records_));
+    }
+
+    virtual void run_once()
+    {
+        records_.resize(bulk_size);
+        st_.execute();
+        while (st_.fetch())
+        {
+            // Just fetching and copying is what is measured here.
+        }
+    }
+
+private:
+    session & sql_;
+    statement st_;
+    std::vector<bench_struct> records_;
+};
+
+// Conversions between the values and their text representation, as done by
+// the backends exchanging the data as text, using either the functions from
+// soci-text-codec.h ("codec") or the standard library functions which were
+// used by the backends before ("legacy"), for comparison.
+struct text_samples
+{
+    std::vector<std::string> integers;
+    std::vector<std::string> doubles;
+    std::vector<std::string> dates;
+    std::vector<long long> integer_values;
+    std::vector<double> double_values;
+    std::vector<std::tm> date_values;
+
+    // Accumulates the results to prevent the compiler from optimizing the
+    // conversions away.
+    double sink;
+};
+
+typedef void (*text_conversion)(text_samples & s);
+
+void codec_parse_integer(text_samples & s)
+{
+    for (std::size_t i = 0; i != s.integers.size(); ++i)
+    {
+        long long n = 0;
+        details::parse_integer(s.integers[i].c_str(), n);
+        s.sink += static_cast<double>(n);
+    }
+}
+
+void legacy_parse_integer(text_samples & s)
+{
+    for (std::size_t i = 0; i != s.integers.size(); ++i)
+    {
+        long long n = 0;
+        std::sscanf(s.integers[i].c_str(), "%lld", &n);
+        s.sink += static_cast<double>(n);
+    }
+}
+
+void codec_format_integer(text_samples & s)
+{
+    char buf[details::number_text_buffer_size];
+    for (std::size_t i = 0; i != s.integer_values.size(); ++i)
+    {
+        s.sink += details::format_integer(s.integer_values[i], buf);
+    }
+}
+
+void legacy_format_integer(text_samples & s)
+{
+    char buf[details::number_text_buffer_size];
+    for (std::size_t i = 0; i != s.integer_values.size(); ++i)
+    {
+        s.sink += std::sprintf(buf, "%lld", s.integer_values[i]);
+    }
+}
+
+void codec_parse_double(text_samples & s)
+{
+    for (std::size_t i = 0; i != s.doubles.size(); ++i)
+    {
+        double d = 0;
+        details::parse_double(s.doubles[i].c_str(), d);
+        s.sink += d;
+    }
+}
+
+void legacy_parse_double(text_samples & s)
+{
+    for (std::size_t i = 0; i != s.doubles.size(); ++i)
+    {
+        // This is what cstring_to_double() did in the "C" locale.
+        char const * const text = s.doubles[i].c_str();
+        char * end;
+        double const d = std::strtod(text, &end);
+        if (end != text && *end == '\0' && !std::strchr(text, ','))
+        {
+            s.sink += d;
+        }
+    }
+}
+
+void codec_format_double(text_samples & s)
+{
+    char buf[details::number_text_buffer_size];
+    for (std::size_t i = 0; i != s.double_values.size(); ++i)
+    {
+        s.sink += details::format_double(s.double_values[i], buf);
+    }
+}
+
+void legacy_format_double(text_samples & s)
+{
+    char buf[details::number_text_buffer_size];
+    for (std::size_t i = 0; i != s.double_values.size(); ++i)
+    {
+        s.sink += std::sprintf(buf, "%.20g", s.double_values[i]);
+    }
+}
+
+void codec_parse_std_tm(text_samples & s)
+{
+    for (std::size_t i = 0; i != s.dates.size(); ++i)
+    {
+        std::tm t;
+        details::parse_std_tm(s.dates[i].c_str(), t);
+        s.sink += t.tm_yday;
+    }
+}
+
+void legacy_parse_std_tm(text_samples & s)
+{
+    for (std::size_t i = 0; i != s.dates.size(); ++i)
+    {
+        int year, month, day, hour, minute, second;
+        std::sscanf(s.dates[i].c_str(), "%d-%d-%d %d:%d:%d",
+            &year, &month, &day, &hour, &minute, &second);
+
+        // This is what mktime_from_ymdhms() did.
+        std::tm t;
+        std::memset(&t, 0, sizeof(t));
+        t.tm_isdst = -1;
+        t.tm_year = year - 1900;
+        t.tm_mon = month - 1;
+        t.tm_mday = day;
+        t.tm_hour = hour;
+        t.tm_min = minute;
+        t.tm_sec = second;
+        std::mktime(&t);
+
+        s.sink += t.tm_yday;
+    }
+}
+
+void codec_format_std_tm(text_samples & s)
+{
+    char buf[details::std_tm_text_buffer_size];
+    for (std::size_t i = 0; i != s.date_values.size(); ++i)
+    {
+        s.sink += details::format_std_tm(s.date_values[i], buf);
+    }
+}
+
+void legacy_format_std_tm(text_samples & s)
+{
+    char buf[details::std_tm_text_buffer_size];
+    for (std::size_t i = 0; i != s.date_values.size(); ++i)
+    {
+        std::tm const & t = s.date_values[i];
+        s.sink += std::sprintf(buf, "%d-%02d-%02d %02d:%02d:%02d",
+            t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+            t.tm_hour, t.tm_min, t.tm_sec);
+    }
+}
+
+class text_codec_workload : public workload
+{
+public:
+    text_codec_workload(std::string const & name, text_conversion conversion)
+        : workload(name, "codec", bulk_size), conversion_(conversion) {}
+
+    virtual void setup()
+    {
+        samples_.sink = 0;
+
+        fill_vector(samples_.integer_values, bulk_size);
+        fill_vector(samples_.date_values, bulk_size);
+
+        // Use a mix of values with a few decimal digits, as typically stored
+        // in the database, and values using the full double precision.
+        samples_.double_values.clear();
+        for (std::size_t i = 0; i != bulk_size; ++i)
+        {
+            samples_.double_values.push_back(i % 2
+                ? bench_type<double>::make(i)
+                : static_cast<double>((i * 1234567) % 1000000) / 100);
+        }
+
+        char buf[details::std_tm_text_buffer_size];
+
+        samples_.integers.clear();
+        samples_.doubles.clear();
+        samples_.dates.clear();
+        for (std::size_t i = 0; i != bulk_size; ++i)
+        {
+            samples_.integers.push_back(std::string(buf,
+                details::format_integer(samples_.integer_values[i], buf)));
+            samples_.doubles.push_back(std::string(buf,
+                details::format_double(samples_.double_values[i], buf)));
+            samples_.dates.push_back(std::string(buf,
+                details::format_std_tm(samples_.date_values[i], buf)));
+        }
+    }
+
+    virtual void run_once()
+    {
+        conversion_(samples_);
+    }
+
+private:
+    text_conversion const conversion_;
+    text_samples samples_;
+};
+
+// Owns the workloads, which must be destroyed before the sessions they use
+class workloads
+{
+public:
+    typedef std::vector<workload *>::const_iterator const_iterator;
+
+    workloads() {}
+    ~workloads()
+    {
+        for (const_iterator it = items_.begin(); it != items_.end(); ++it)
+        {
+            delete *it;
+        }
+    }
+
+    void push_back(workload * w) { items_.push_back(w); }
+
+    const_iterator begin() const { return items_.begin(); }
+    const_iterator end() const { return items_.end(); }
+
+private:
+    std::vector<workload *> items_;
+
+    SOCI_NOT_COPYABLE(workloads)
+};
+
+template <typename T>
+void add_bulk_use(workloads & w, session & sql, std::string const & backend,
+    bool rollback)
+{
+    std::string const query = std::string("insert into bench_sink(")
+        + bench_type<T>::column() + ") values(:v)";
+    w.push_back(new bulk_use_workload<T>(sql, backend, query, rollback));
+}
+
+void add_bulk_use_all(workloads & w, session & sql, std::string const & backend,
+    bool rollback)
+{
+    add_bulk_use<char>(w, sql, backend, rollback);
+    add_bulk_use<std::string>(w, sql, backend, rollback);
+    add_bulk_use<short>(w, sql, backend, rollback);
+    add_bulk_use<int>(w, sql, backend, rollback);
+    add_bulk_use<long long>(w, sql, backend, rollback);
+    add_bulk_use<unsigned long long>(w, sql, backend, rollback);
+    add_bulk_use<double>(w, sql, backend, rollback);
+    add_bulk_use<std::tm>(w, sql, backend, rollback);
+}
+
+void add_empty_workloads(workloads & w, session & sql)
+{
+    std::string const backend = "empty";
+    std::string const query = "select i from bench_types where id = :id";
+
+    w.push_back(new into_use_once_workload(sql, backend, query));
+    w.push_back(new into_use_prepared_workload(sql, backend, query));
+    w.push_back(new orm_use_workload(sql, backend, false));
+    w.push_back(new orm_use_workload(sql, backend, true));
+
+    // The Empty backend always reports a single fetched row, so only the
+    // vector use elements are exercised with it.
+    add_bulk_use_all(w, sql, backend, false);
+}
+
+void add_codec_workloads(workloads & w)
+{
+    w.push_back(new text_codec_workload("parse_integer", codec_parse_integer));
+    w.push_back(new text_codec_workload("parse_integer/legacy", legacy_parse_integer));
+    w.push_back(new text_codec_workload("format_integer", codec_format_integer));
+    w.push_back(new text_codec_workload("format_integer/legacy", legacy_format_integer));
+    w.push_back(new text_codec_workload("parse_double", codec_parse_double));
+    w.push_back(new text_codec_workload("parse_double/legacy", legacy_parse_double));
+    w.push_back(new text_codec_workload("format_double", codec_format_double));
+    w.push_back(new text_codec_workload("format_double/legacy", legacy_format_double));
+    w.push_back(new text_codec_workload("parse_std_tm", codec_parse_std_tm));
+    w.push_back(new text_codec_workload("parse_std_tm/legacy", legacy_parse_std_tm));
+    w.push_back(new text_codec_workload("format_std_tm", codec_format_std_tm));
+    w.push_back(new text_codec_workload("format_std_tm/legacy", legacy_format_std_tm));
+}
+
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+
+template <typename T>
+void add_bulk_into(workloads & w, session & sql, std::string const & backend)
+{
+    w.push_back(new bulk_into_workload<T>(sql, backend));
+}
+
+void create_sqlite3_tables(session & sql)
+{
+    char const * const columns =
+        "c char(1), s varchar(40), sh smallint, i integer, ll bigint,"
+        " ull unsigned big int, d real, t datetime";
+
+    sql << "create table bench_types(id integer primary key, " << columns << ")";
+    sql << "create table bench_sink(" << columns << ")";
+
+    std::vector<int> ids(table_size);
+    for (std::size_t i = 0; i != table_size; ++i)
+    {
+        ids[i] = static_cast<int>(i + 1);
+    }
+
+    std::vector<char> c;
+    std::vector<std::string> s;
+    std::vector<short> sh;
+    std::vector<int> i;
+    std::vector<long long> ll;
+    std::vector<unsigned long long> ull;
+    std::vector<double> d;
+    std::vector<std::tm> t;
+
+    fill_vector(c, table_size);
+    fill_vector(s, table_size);
+    fill_vector(sh, table_size);
+    fill_vector(i, table_size);
+    fill_vector(ll, table_size);
+    fill_vector(ull, table_size);
+    fill_vector(d, table_size);
+    fill_vector(t, table_size);
+
+    transaction tr(sql);
+    sql << "insert into bench_types(id, c, s, sh, i, ll, ull, d, t)"
+        " values(:id, :c, :s, :sh, :i, :ll, :ull, :d, :t)",
+        use(ids), use(c), use(s), use(sh), use(i), use(ll), use(ull), use(d),
+        use(t);
+    tr.commit();
+}
+
+void add_sqlite3_workloads(workloads & w, session & sql)
+{
+    std::string const backend = "sqlite3";
+    std::string const query = "select i from bench_types where id = :id";
+
+    create_sqlite3_tables(sql);
+
+    w.push_back(new into_use_once_workload(sql, backend, query));
+    w.push_back(new into_use_prepared_workload(sql, backend, query));
+    w.push_back(new orm_use_workload(sql, backend, false));
+    w.push_back(new orm_use_workload(sql, backend, true));
+    w.push_back(new orm_into_workload(sql, backend));
+    w.push_back(new orm_bulk_use_workload(sql, backend));
+    w.push_back(new orm_bulk_into_workload(sql, backend));
+    w.push_back(new struct_use_workload(sql, backend));
+    w.push_back(new struct_into_workload(sql, backend));
+    w.push_back(new struct_bulk_into_workload(sql, backend));
+
+    add_bulk_use_all(w, sql, backend, true);
+
+    add_bulk_into<char>(w, sql, backend);
+    add_bulk_into<std::string>(w, sql, backend);
+    add_bulk_into<short>(w, sql, backend);
+    add_bulk_into<int>(w, sql, backend);
+    add_bulk_into<long long>(w, sql, backend);
+    add_bulk_into<unsigned long long>(w, sql, backend);
+    add_bulk_into<double>(w, sql, backend);
+    add_bulk_into<std::tm>(w, sql, backend);
+    add_bulk_into<bench_int<false> >(w, sql, backend);
+    add_bulk_into<bench_int<true> >(w, sql, backend);
+
+    w.push_back(new rowset_row_workload(sql, backend, bulk_size));
+    w.push_back(new rowset_row_workload(sql, backend, 1));
+    w.push_back(new rowset_orm_workload(sql, backend, bulk_size));
+    w.push_back(new rowset_orm_workload(sql, backend, 1));
+}
+
+#endif // SOCI_BENCH_HAVE_SQLITE3
+
+// Running the benchmarks
+
+struct options
+{
+    options() : min_time_ns(100e6), iterations(0), list(false),
+        sqlite3_connect_string(":memory:") {}
+
+    double min_time_ns;
+    std::size_t iterations;
+    bool list;
+    std::string filter;
+    std::string sqlite3_connect_string;
+};
+
+struct measurement
+{
+    std::size_t iterations;
+    double elapsed_ns;
+    unsigned long long allocations;
+};
+
+measurement measure(workload & w, std::size_t iterations)
+{
+    measurement m;
+    m.iterations = iterations;
+
+    unsigned long long const allocations_before = allocation_count;
+    double const start = now_ns();
+
+    for (std::size_t i = 0; i != iterations; ++i)
+    {
+        w.run_once();
+    }
+
+    m.elapsed_ns = now_ns() - start;
+    m.allocations = allocation_count - allocations_before;
+
+    return m;
+}
+
+// Either runs the given number of iterations or keeps doubling their number
+// until a single run takes at least the minimal time.
+measurement run(workload & w, options const & opts)
+{
+    w.setup();
+
+    // Warm up: this also performs any allocations done only once.
+    w.run_once();
+
+    if (opts.iterations != 0)
+    {
+        return measure(w, opts.iterations);
+    }
+
+    std::size_t iterations = 1;
+    for (;;)
+    {
+        measurement const m = measure(w, iterations);
+        if (m.elapsed_ns >= opts.min_time_ns || iterations >= (1u << 30))
+        {
+            return m;
+        }
+
+        iterations *= 2;
+    }
+}
+
+void report(workload const & w, measurement const & m)
+{
+    double const ns_per_op = m.elapsed_ns / m.iterations;
+    double const allocs_per_op = static_cast<double>(m.allocations) / m.iterations;
+    double const rows_per_sec = m.elapsed_ns > 0
+        ? w.rows_per_op() * m.iterations * 1e9 / m.elapsed_ns
+        : 0;
+
+    std::printf("{\"benchmark\":\"%s\",\"backend\":\"%s\",\"iterations\":%lu,"
+        "\"ns_per_op\":%.1f,\"allocs_per_op\":%.2f,\"rows_per_op\":%lu,"
+        "\"rows_per_sec\":%.0f}\n",
+        w.name().c_str(), w.backend().c_str(),
+        static_cast<unsigned long>(m.iterations),
+        ns_per_op, allocs_per_op,
+        static_cast<unsigned long>(w.rows_per_op()),
+        rows_per_sec);
+    std::fflush(stdout);
+}
+
+void usage(char const * program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+        "\n"
+        "Options:\n"
+        "  --filter <text>     run only the benchmarks with the given text in the name\n"
+        "  --iterations <n>    run each benchmark exactly n times\n"
+        "  --min-time <ms>     run each benchmark for at least this long (default: 100)\n"
+        "  --sqlite3 <connstr> connection string of the SQLite3 database (default: :memory:)\n"
+        "  --list              list the benchmarks without running them\n";
+}
+
+bool parse_options(int argc, char ** argv, options & opts)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string const arg = argv[i];
+        bool const has_value = i + 1 < argc;
+
+        if (arg == "--list")
+        {
+            opts.list = true;
+        }
+        else if (arg == "--filter" && has_value)
+        {
+            opts.filter = argv[++i];
+        }
+        else if (arg == "--iterations" && has_value)
+        {
+            long const n = std::strtol(argv[++i], NULL, 10);
+            if (n <= 0)
+            {
+                return false;
+            }
+
+            opts.iterations = static_cast<std::size_t>(n);
+        }
+        else if (arg == "--min-time" && has_value)
+        {
+            opts.min_time_ns = std::strtod(argv[++i], NULL) * 1e6;
+        }
+        else if (arg == "--sqlite3" && has_value)
+        {
+            opts.sqlite3_connect_string = argv[++i];
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace anonymous
+
+int main(int argc, char ** argv)
+{
+    options opts;
+    if (!parse_options(argc, argv, opts))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        session empty_sql(*factory_empty(), "dummy");
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+        session sqlite3_sql(*factory_sqlite3(), opts.sqlite3_connect_string);
+#endif
+
+        workloads w;
+        add_codec_workloads(w);
+        add_empty_workloads(w, empty_sql);
+#ifdef SOCI_BENCH_HAVE_SQLITE3
+        add_sqlite3_workloads(w, sqlite3_sql);
+#endif
+
+        for (workloads::const_iterator it = w.begin(); it != w.end(); ++it)
+        {
+            workload & current = **it;
+            if (current.name().find(opts.filter) == std::string::npos)
+            {
+                continue;
+            }
+
+            if (opts.list)
+            {
+                std::cout << current.name() << '\n';
+                continue;
+            }
+
+            report(current, run(current, opts));
+        }
+    }
+    catch (std::exception const & e)
+    {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -9,6 +9,7 @@
 #define SOCI_FIREBIRD_COMMON_H_INCLUDED
 
 #include "soci/firebird/soci-firebird.h"
+#include "soci-text-codec.h"
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
@@ -30,6 +31,10 @@ namespace firebird
 
 char * allocBuffer(XSQLVAR* var);
 
+// Size of the data of the variable in the SQLDA message, which may be less
+// than the size of the buffer returned by allocBuffer().
+std::size_t getDataSize(XSQLVAR const * var);
+
 void tmEncode(short type, std::tm * src, void * dst);
 
 void tmDecode(short type, void * src, std::tm * dst);
@@ -183,9 +188,8 @@ template<typename IntType>
 std::string format_decimal(const void *sqldata, int sqlscale)
 {
     IntType x = *reinterpret_cast<const IntType *>(sqldata);
-    std::stringstream out;
-    out << x;
-    std::string r = out.str();
+    char buf[number_text_buffer_size];
+    std::string r(buf, format_integer(x, buf));
     if (sqlscale < 0)
     {
         if (static_cast<int>(r.size()) - (x < 0) <= -sqlscale)
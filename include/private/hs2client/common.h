@@ -0,0 +1,155 @@
+//
+// Copyright (C) 2004-2006 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_HS2CLIENT_COMMON_H_INCLUDED
+#define SOCI_HS2CLIENT_COMMON_H_INCLUDED
+
+#include "soci/hs2client/soci-hs2client.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+namespace hs2client_columns
+{
+
+/* Converts seconds since the epoch into the local time, the same way 'localtime' does (which is what the
+   values written via 'mktime' are expected to round-trip through), although without the global state of
+   'localtime'. The UTC offset is looked up once per day and the conversion itself is plain arithmetic,
+   with 'localtime_r' only being used for days during which the offset changes. */
+class SOCI_HS2CLIENT_DECL local_time_converter
+{
+	public:
+		local_time_converter() :
+		_day(std::numeric_limits<int64_t>::min()),
+		_offset(0),
+		_isdst(0),
+		_uniform(false)
+		{
+		}
+
+		void convert(int64_t seconds, std::tm& out);
+
+		static void from_utc_seconds(int64_t seconds, std::tm& out);
+
+	private:
+		int64_t _day;
+		int64_t _offset;
+		int _isdst;
+		bool _uniform;
+
+		void lookup_offset(int64_t day);
+};
+
+/* The rows of the segment ['start', 'end') are available in 'data' only up-to 'length', the rest are treated
+   as NULLs. 'is_null' is expected to behave like 'hs2client::Column::IsNull'. */
+inline std::size_t get_available_count(std::size_t length, std::size_t start, std::size_t end)
+{
+	if (length <= start) return 0;
+	return std::min(length, end) - start;
+}
+
+template <typename IsNull>
+inline void set_indicators(IsNull is_null, std::size_t start, std::size_t available, std::size_t count, indicator* ind)
+{
+	if (ind == nullptr) return;
+
+	for (std::size_t i = 0; i < available; i++)
+		ind[i] = is_null(start + i) ? i_null : i_ok;
+
+	std::fill(ind + available, ind + count, i_null);
+}
+
+template <typename T, typename Source>
+inline void copy_values(const Source* source, std::size_t count, T* destination, std::true_type /* same representation */)
+{
+	if (count > 0) std::memcpy(destination, source, count * sizeof(T));
+}
+
+template <typename T, typename Source>
+inline void copy_values(const Source* source, std::size_t count, T* destination, std::false_type /* same representation */)
+{
+	for (std::size_t i = 0; i < count; i++)
+		destination[i] = static_cast<T>(source[i]);
+}
+
+/* Fixed width values are copied over as a whole (NULL values included), as the column data is contiguous. */
+template <typename T, typename Source, typename IsNull>
+void decode_fixed_width_column(const Source* data, std::size_t length, IsNull is_null, std::size_t start, std::size_t end, std::vector<T>& destination, indicator* ind)
+{
+	static_assert(std::is_arithmetic<T>::value && std::is_arithmetic<Source>::value, "Only arithmetic types are supported.");
+
+	const std::size_t count = end - start;
+	const std::size_t available = get_available_count(length, start, end);
+
+	destination.resize(count);
+	copy_values(data + start, available, destination.data(),
+		std::integral_constant<bool, sizeof(T) == sizeof(Source) && std::is_integral<T>::value == std::is_integral<Source>::value>());
+
+	set_indicators(is_null, start, available, count, ind);
+}
+
+/* The existing strings of the destination are assigned to, so that their buffers are reused across fetches */
+template <typename IsNull>
+void decode_string_column(const std::string* data, std::size_t length, IsNull is_null, std::size_t start, std::size_t end, std::vector<std::string>& destination, indicator* ind)
+{
+	const std::size_t count = end - start;
+	const std::size_t available = get_available_count(length, start, end);
+
+	destination.resize(count);
+	for (std::size_t i = 0; i < available; i++)
+	{
+		if (is_null(start + i)) destination[i].clear();
+		else destination[i].assign(data[start + i]);
+	}
+
+	set_indicators(is_null, start, available, count, ind);
+}
+
+/* We expect the date & time columns to be of type long(int64) holding seconds since the epoch */
+template <typename IsNull>
+void decode_time_column(const int64_t* data, std::size_t length, IsNull is_null, std::size_t start, std::size_t end, std::vector<std::tm>& destination, indicator* ind)
+{
+	const std::size_t count = end - start;
+	const std::size_t available = get_available_count(length, start, end);
+
+	destination.resize(count);
+
+	local_time_converter converter;
+	for (std::size_t i = 0; i < available; i++)
+		if (is_null(start + i) == false)
+			converter.convert(data[start + i], destination[i]);
+
+	set_indicators(is_null, start, available, count, ind);
+}
+
+} // namespace hs2client_columns
+
+namespace hs2client_parameters
+{
+
+/* Renders the value (of the given exchange type) pointed by 'data' as SQL text into 'out', reusing its storage */
+void render_value(exchange_type type, void* data, std::string& out);
+
+} // namespace hs2client_parameters
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_HS2CLIENT_COMMON_H_INCLUDED
@@ -9,9 +9,9 @@
 #define SOCI_PRIVATE_SOCI_CSTRTOD_H_INCLUDED
 
 #include "soci/error.h"
+#include "soci-text-codec.h"
 
-#include <stdlib.h>
-#include <string.h>
+#include <string>
 
 namespace soci
 {
@@ -28,43 +28,8 @@ namespace details
 inline
 double cstring_to_double(char const* s)
 {
-    // Unfortunately there is no clean way to parse a number in C locale
-    // without this hack: normally, using std::istringstream with classic
-    // locale should work, but some standard library implementations are buggy
-    // and handle non-default locale in thread-unsafe way, by changing the
-    // global C locale which is unacceptable as it introduces subtle bugs in
-    // multi-thread programs. So we rely on just the standard C functions and
-    // try to make them work by tweaking the input into the form appropriate
-    // for the current locale.
-
-    // First try with the original input.
-    char* end;
-    double d = strtod(s, &end);
-
-    bool parsedOK;
-    if (*end == '.')
-    {
-        // Parsing may have stopped because the current locale uses something
-        // different from the point as decimal separator, retry with a comma.
-        //
-        // In principle, values other than point or comma are possible but they
-        // don't seem to be used in practice, so for now keep things simple.
-        size_t const bufSize = strlen(s) + 1;
-        char* const buf = new char[bufSize];
-        strcpy(buf, s);
-        buf[end - s] = ',';
-        d = strtod(buf, &end);
-        parsedOK = end != buf && *end == '\0';
-        delete [] buf;
-    }
-    else
-    {
-        // Notice that we must detect false positives as well: parsing a string
-        // using decimal comma should fail when using this function.
-        parsedOK = end != s && *end == '\0' && !strchr(s, ',');
-    }
-
-    if (!parsedOK)
+    double d;
+    if (!parse_double(s, d))
     {
       throw soci_error(std::string("Cannot convert data: string \"") + s + "\" "
                        "is not a number.");
@@ -9,10 +9,9 @@
 #define SOCI_PRIVATE_SOCI_DTOCSTR_H_INCLUDED
 
 #include "soci/soci-platform.h"
-#include "soci/error.h"
+#include "soci-text-codec.h"
 
-#include <stdlib.h>
-#include <stdio.h>
+#include <string>
 
 namespace soci
 {
@@ -25,30 +24,12 @@ namespace details
 //
 // The resulting string will contain the floating point number in "C" locale,
 // i.e. will always use point as decimal separator independently of the current
-// locale.
+// locale, using the shortest representation preserving its value.
 inline
 std::string double_to_cstring(double d)
 {
-    // See comments in cstring_to_double() in soci-cstrtod.h, we're dealing
-    // with the same issues here.
-
-    static size_t const bufSize = 32;
-    char buf[bufSize];
-    snprintf(buf, bufSize, "%.20g", d);
-
-    // Replace any commas which can be used as decimal separator with points.
-    for (char* p = buf; *p != '\0'; p++ )
-    {
-        if (*p == ',')
-        {
-            *p = '.';
-
-            // There can be at most one comma in this string anyhow.
-            break;
-        }
-    }
-
-    return buf;
+    char buf[number_text_buffer_size];
+    return std::string(buf, format_double(d, buf));
 }
 
 } // namespace details
@@ -11,7 +11,10 @@
 #include "soci/soci-backend.h"
 #include "soci/type-wrappers.h"
 
+#include <cstddef>
 #include <ctime>
+#include <string>
+#include <vector>
 
 namespace soci
 {
@@ -90,6 +93,114 @@ typename exchange_type_traits<e>::value_type& exchange_type_cast(void *data)
     return *static_cast<typename exchange_type_traits<e>::value_type*>(data);
 }
 
+// return the size of the data of a value of one of the types above, i.e. the
+// length of the text for the string types and sizeof for the other ones
+template <typename T>
+inline std::size_t exchange_value_size(T const &) { return sizeof(T); }
+
+inline std::size_t exchange_value_size(std::string const & s)
+{
+    return s.size();
+}
+
+inline std::size_t exchange_value_size(long_string const & s)
+{
+    return s.value.size();
+}
+
+inline std::size_t exchange_value_size(xml_type const & s)
+{
+    return s.value.size();
+}
+
+template <exchange_type e>
+std::size_t exchange_vector_data_size(void *data,
+    std::size_t begin, std::size_t const *end)
+{
+    std::vector<typename exchange_type_traits<e>::value_type> const & v =
+        *static_cast<std::vector<typename exchange_type_traits<e>::value_type>*>(data);
+
+    std::size_t const last = end != NULL ? *end : v.size();
+
+    std::size_t size = 0;
+    for (std::size_t i = begin; i < last && i < v.size(); ++i)
+    {
+        size += exchange_value_size(v[i]);
+    }
+
+    return size;
+}
+
+// return the size of the data of the given value (or of the elements in the
+// [begin, end) range of the given vector), 0 for the types without any data
+// of their own such as statements, rowids and blobs
+inline std::size_t exchange_data_size(exchange_type type, void *data)
+{
+    switch (type)
+    {
+        case x_char:
+            return exchange_value_size(exchange_type_cast<x_char>(data));
+        case x_stdstring:
+            return exchange_value_size(exchange_type_cast<x_stdstring>(data));
+        case x_short:
+            return exchange_value_size(exchange_type_cast<x_short>(data));
+        case x_integer:
+            return exchange_value_size(exchange_type_cast<x_integer>(data));
+        case x_long_long:
+            return exchange_value_size(exchange_type_cast<x_long_long>(data));
+        case x_unsigned_long_long:
+            return exchange_value_size(exchange_type_cast<x_unsigned_long_long>(data));
+        case x_double:
+            return exchange_value_size(exchange_type_cast<x_double>(data));
+        case x_stdtm:
+            return exchange_value_size(exchange_type_cast<x_stdtm>(data));
+        case x_longstring:
+            return exchange_value_size(exchange_type_cast<x_longstring>(data));
+        case x_xmltype:
+            return exchange_value_size(exchange_type_cast<x_xmltype>(data));
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+
+    return 0;
+}
+
+inline std::size_t exchange_vector_data_size(exchange_type type, void *data,
+    std::size_t begin, std::size_t const *end)
+{
+    switch (type)
+    {
+        case x_char:
+            return exchange_vector_data_size<x_char>(data, begin, end);
+        case x_stdstring:
+            return exchange_vector_data_size<x_stdstring>(data, begin, end);
+        case x_short:
+            return exchange_vector_data_size<x_short>(data, begin, end);
+        case x_integer:
+            return exchange_vector_data_size<x_integer>(data, begin, end);
+        case x_long_long:
+            return exchange_vector_data_size<x_long_long>(data, begin, end);
+        case x_unsigned_long_long:
+            return exchange_vector_data_size<x_unsigned_long_long>(data, begin, end);
+        case x_double:
+            return exchange_vector_data_size<x_double>(data, begin, end);
+        case x_stdtm:
+            return exchange_vector_data_size<x_stdtm>(data, begin, end);
+        case x_longstring:
+            return exchange_vector_data_size<x_longstring>(data, begin, end);
+        case x_xmltype:
+            return exchange_vector_data_size<x_xmltype>(data, begin, end);
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+
+    return 0;
+}
+
 } // namespace details
 
 } // namespace soci
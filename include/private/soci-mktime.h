@@ -8,8 +8,7 @@
 #ifndef SOCI_PRIVATE_SOCI_MKTIME_H_INCLUDED
 #define SOCI_PRIVATE_SOCI_MKTIME_H_INCLUDED
 
-// Not <ctime> because we also want to get timegm() if available.
-#include <time.h>
+#include "soci-text-codec.h"
 
 namespace soci
 {
@@ -24,26 +23,13 @@ namespace details
 // not 1900 or 0-based as in struct tm itself.
 inline
 void
-mktime_from_ymdhms(tm& t,
+mktime_from_ymdhms(std::tm& t,
                    int year, int month, int day,
                    int hour, int minute, int second)
 {
-    t.tm_isdst = -1;
-    t.tm_year = year - 1900;
-    t.tm_mon  = month - 1;
-    t.tm_mday = day;
-    t.tm_hour = hour;
-    t.tm_min  = minute;
-    t.tm_sec  = second;
-
-    mktime(&t);
+    make_std_tm(t, year, month, day, hour, minute, second);
 }
 
-// Helper function for parsing datetime values.
-//
-// Throws if the string in buf couldn't be parsed as a date or a time string.
-SOCI_DECL void parse_std_tm(char const *buf, std::tm &t);
-
 } // namespace details
 
 } // namespace soci
@@ -0,0 +1,62 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_MONOTONIC_CLOCK_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_MONOTONIC_CLOCK_H_INCLUDED
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/time.h>
+#include <time.h>
+#endif
+
+namespace soci
+{
+
+namespace details
+{
+
+// Returns the time, in nanoseconds, elapsed since some unspecified point in
+// the past, which can only be used for measuring intervals.
+inline long long get_monotonic_time_ns()
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency = { 0 };
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    // Avoid the overflow of counter * 10^9 by splitting it.
+    long long const seconds = counter.QuadPart / frequency.QuadPart;
+    long long const rest = counter.QuadPart % frequency.QuadPart;
+    return seconds * 1000000000LL + rest * 1000000000LL / frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<long long>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+#else
+    timeval tv;
+    gettimeofday(&tv, NULL);
+    return static_cast<long long>(tv.tv_sec) * 1000000000LL + tv.tv_usec * 1000LL;
+#endif
+}
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_MONOTONIC_CLOCK_H_INCLUDED
@@ -0,0 +1,54 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_RESULT_CACHE_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_RESULT_CACHE_H_INCLUDED
+
+#include "soci/soci-backend.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Functions used by the into and use elements to store their values in the
+// compact binary form used by result_cache: the values of fixed size types
+// are stored as their bytes, the strings are preceded by their length and
+// the indicators take a single byte. The data is only used by the same
+// process, so there is no need to care about its portability.
+
+// Append the value (or just the indicator if it is null) to the buffer and
+// return true, or return false if the values of this type can't be cached.
+SOCI_DECL bool cache_save_value(std::string & buf, exchange_type type,
+    void * data, indicator const * ind);
+
+// Read the value saved by cache_save_value() and advance the pointer past it.
+SOCI_DECL void cache_load_value(char const * & p, exchange_type type,
+    void * data, indicator * ind);
+
+// Same as above for the vectors of values of the given type.
+SOCI_DECL bool cache_save_vector(std::string & buf, exchange_type type,
+    void * data, std::vector<indicator> const * ind);
+SOCI_DECL void cache_load_vector(char const * & p, exchange_type type,
+    void * data, std::vector<indicator> * ind);
+
+// Append the type of the into element to the key of the cache entry, as well
+// as the size of the vector for the vectors, as it determines the number of
+// rows fetched, or return false if the values of this type can't be cached.
+SOCI_DECL bool cache_append_into_key(std::string & key, exchange_type type);
+SOCI_DECL bool cache_append_vector_into_key(std::string & key,
+    exchange_type type, void * data);
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_RESULT_CACHE_H_INCLUDED
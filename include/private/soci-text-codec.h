@@ -0,0 +1,163 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_TEXT_CODEC_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_TEXT_CODEC_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+#include <cstddef>
+#include <ctime>
+#include <limits>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Conversions between the values and their textual representation used by
+// the backends exchanging the data with the database as text.
+//
+// All these functions always use the "C" locale conventions, independently of
+// the current locale, and never allocate memory, so that they can be used for
+// every value fetched from the database. Notice that the dates are still
+// normalized by mktime(), which depends on the current time zone, in order to
+// keep filling tm_isdst, tm_wday and tm_yday as SOCI always did.
+
+// Size of the buffer sufficient for any number formatted by the functions
+// below, including the trailing NUL.
+std::size_t const number_text_buffer_size = 32;
+
+// Size of the buffer sufficient for any date formatted by format_std_tm(),
+// including the trailing NUL.
+std::size_t const std_tm_text_buffer_size = 80;
+
+// Parse the string which must contain just an integer number, optionally
+// preceded by whitespace and a sign (only "+" is accepted for the unsigned
+// numbers), and return false if it doesn't or if the number is out of range.
+SOCI_DECL bool parse_integer(char const * s, long long & value);
+SOCI_DECL bool parse_integer(char const * s, unsigned long long & value);
+
+// Same as above for the other integer types.
+template <typename T>
+bool parse_integer(char const * s, T & value)
+{
+    if (std::numeric_limits<T>::is_signed)
+    {
+        long long n;
+        if (!parse_integer(s, n) ||
+            n < static_cast<long long>((std::numeric_limits<T>::min)()) ||
+            n > static_cast<long long>((std::numeric_limits<T>::max)()))
+        {
+            return false;
+        }
+
+        value = static_cast<T>(n);
+    }
+    else
+    {
+        unsigned long long n;
+        if (!parse_integer(s, n) ||
+            n > static_cast<unsigned long long>((std::numeric_limits<T>::max)()))
+        {
+            return false;
+        }
+
+        value = static_cast<T>(n);
+    }
+
+    return true;
+}
+
+// Parse an unsigned number as parse_integer() does, but also accept negative
+// numbers and wrap them around, as strtoull() does, so that "-1" gives the
+// maximal unsigned long long value (and fails for the smaller types).
+template <typename T>
+bool parse_unsigned_integer(char const * s, T & value)
+{
+    unsigned long long n;
+    if (!parse_integer(s, n))
+    {
+        long long m;
+        if (!parse_integer(s, m))
+        {
+            return false;
+        }
+
+        n = static_cast<unsigned long long>(m);
+    }
+
+    if (n > static_cast<unsigned long long>((std::numeric_limits<T>::max)()))
+    {
+        return false;
+    }
+
+    value = static_cast<T>(n);
+    return true;
+}
+
+// Parse the string which must contain just a floating point number using
+// point as decimal separator (or infinity or NaN, as accepted by strtod()),
+// optionally preceded by whitespace, and return false if it doesn't.
+SOCI_DECL bool parse_double(char const * s, double & value);
+
+// Format the number into the provided buffer, which must be big enough for
+// any value of this type and the trailing NUL (number_text_buffer_size bytes
+// are always enough), and return the length of the result.
+SOCI_DECL std::size_t format_integer(long long value, char * buf);
+SOCI_DECL std::size_t format_integer(unsigned long long value, char * buf);
+
+// Same as above for the other integer types.
+template <typename T>
+std::size_t format_integer(T value, char * buf)
+{
+    if (std::numeric_limits<T>::is_signed)
+    {
+        return format_integer(static_cast<long long>(value), buf);
+    }
+    else
+    {
+        return format_integer(static_cast<unsigned long long>(value), buf);
+    }
+}
+
+// Format the number in the same way as "%.15g" would do it, if this is enough
+// to parse it back into the same value, or using 16 or, if necessary, 17
+// significant digits otherwise, which are always enough.
+SOCI_DECL std::size_t format_double(double value, char * buf);
+
+// Same as above for float, using from 6 to 9 significant digits, so that the
+// result is parsed back into the same float, but not necessarily the same
+// double, e.g. 0.1f is output as "0.1".
+SOCI_DECL std::size_t format_float(float value, char * buf);
+
+// Fill the provided struct tm with the values corresponding to the given
+// date, normalizing them and filling in the other fields using mktime().
+//
+// Notice that both years and months are normal human 1-based values here and
+// not 1900 or 0-based as in struct tm itself.
+SOCI_DECL void make_std_tm(std::tm & t,
+    int year, int month, int day, int hour, int minute, int second);
+
+// Parse the date and time in "YYYY-MM-DD HH:MM:SS" (or using "T" instead of
+// space) format, just the date in "YYYY-MM-DD" format or just the time in
+// "HH:MM:SS" format, ignoring anything following the seconds, e.g. fractional
+// part or time zone.
+//
+// Throws if the string in buf couldn't be parsed as a date or a time string.
+SOCI_DECL void parse_std_tm(char const * buf, std::tm & t);
+
+// Format the date and time in "YYYY-MM-DD HH:MM:SS" format into the provided
+// buffer, which must have at least std_tm_text_buffer_size bytes, and return
+// the length of the result.
+SOCI_DECL std::size_t format_std_tm(std::tm const & t, char * buf);
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_TEXT_CODEC_H_INCLUDED
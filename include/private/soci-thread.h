@@ -0,0 +1,264 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_THREAD_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_THREAD_H_INCLUDED
+
+#include "soci/soci-platform.h"
+#include "soci/error.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <sys/time.h>
+#include <errno.h>
+#endif
+
+#include <exception>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Minimal portable wrappers for the threading primitives used by the library
+// itself. They are used instead of the standard ones because SOCI must still
+// compile in C++98 mode.
+
+#ifndef _WIN32
+
+class mutex
+{
+public:
+    mutex()
+    {
+        if (pthread_mutex_init(&mtx_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~mutex() { pthread_mutex_destroy(&mtx_); }
+
+    void lock() { pthread_mutex_lock(&mtx_); }
+    void unlock() { pthread_mutex_unlock(&mtx_); }
+
+private:
+    friend class condition;
+
+    pthread_mutex_t mtx_;
+
+    SOCI_NOT_COPYABLE(mutex)
+};
+
+class condition
+{
+public:
+    condition()
+    {
+        if (pthread_cond_init(&cond_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~condition() { pthread_cond_destroy(&cond_); }
+
+    void wait(mutex & mtx) { pthread_cond_wait(&cond_, &mtx.mtx_); }
+
+    // Returns false if the timeout, in milliseconds, expired.
+    bool wait_for(mutex & mtx, int timeout)
+    {
+        struct timeval tmv;
+        gettimeofday(&tmv, NULL);
+
+        struct timespec tm;
+        tm.tv_sec = tmv.tv_sec + timeout / 1000;
+        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
+        if (tm.tv_nsec >= 1000 * 1000 * 1000)
+        {
+            ++tm.tv_sec;
+            tm.tv_nsec -= 1000 * 1000 * 1000;
+        }
+
+        return pthread_cond_timedwait(&cond_, &mtx.mtx_, &tm) != ETIMEDOUT;
+    }
+
+    void notify_one() { pthread_cond_signal(&cond_); }
+    void notify_all() { pthread_cond_broadcast(&cond_); }
+
+private:
+    pthread_cond_t cond_;
+
+    SOCI_NOT_COPYABLE(condition)
+};
+
+class thread
+{
+public:
+    typedef void (*thread_function)(void * arg);
+
+    thread(thread_function func, void * arg)
+        : func_(func), arg_(arg)
+    {
+        if (pthread_create(&thread_, NULL, &thread::run, this) != 0)
+        {
+            throw soci_error("Failed to create a thread");
+        }
+    }
+
+    void join() { pthread_join(thread_, NULL); }
+
+private:
+    static void * run(void * self)
+    {
+        thread * const t = static_cast<thread *>(self);
+        t->func_(t->arg_);
+        return NULL;
+    }
+
+    thread_function const func_;
+    void * const arg_;
+    pthread_t thread_;
+
+    SOCI_NOT_COPYABLE(thread)
+};
+
+#else // _WIN32
+
+class mutex
+{
+public:
+    mutex() { InitializeCriticalSection(&mtx_); }
+    ~mutex() { DeleteCriticalSection(&mtx_); }
+
+    void lock() { EnterCriticalSection(&mtx_); }
+    void unlock() { LeaveCriticalSection(&mtx_); }
+
+private:
+    friend class condition;
+
+    CRITICAL_SECTION mtx_;
+
+    SOCI_NOT_COPYABLE(mutex)
+};
+
+class condition
+{
+public:
+    condition() { InitializeConditionVariable(&cond_); }
+
+    void wait(mutex & mtx)
+    {
+        SleepConditionVariableCS(&cond_, &mtx.mtx_, INFINITE);
+    }
+
+    // Returns false if the timeout, in milliseconds, expired.
+    bool wait_for(mutex & mtx, int timeout)
+    {
+        return SleepConditionVariableCS(&cond_, &mtx.mtx_,
+            static_cast<DWORD>(timeout)) != 0;
+    }
+
+    void notify_one() { WakeConditionVariable(&cond_); }
+    void notify_all() { WakeAllConditionVariable(&cond_); }
+
+private:
+    CONDITION_VARIABLE cond_;
+
+    SOCI_NOT_COPYABLE(condition)
+};
+
+class thread
+{
+public:
+    typedef void (*thread_function)(void * arg);
+
+    thread(thread_function func, void * arg)
+        : func_(func), arg_(arg)
+    {
+        uintptr_t const h = _beginthreadex(NULL, 0, &thread::run, this, 0, NULL);
+        if (h == 0)
+        {
+            throw soci_error("Failed to create a thread");
+        }
+
+        thread_ = reinterpret_cast<HANDLE>(h);
+    }
+
+    void join()
+    {
+        WaitForSingleObject(thread_, INFINITE);
+        CloseHandle(thread_);
+    }
+
+private:
+    static unsigned __stdcall run(void * self)
+    {
+        thread * const t = static_cast<thread *>(self);
+        t->func_(t->arg_);
+        return 0;
+    }
+
+    thread_function const func_;
+    void * const arg_;
+    HANDLE thread_;
+
+    SOCI_NOT_COPYABLE(thread)
+};
+
+#endif // _WIN32
+
+class scoped_lock
+{
+public:
+    explicit scoped_lock(mutex & mtx) : mtx_(mtx) { mtx_.lock(); }
+    ~scoped_lock() { mtx_.unlock(); }
+
+private:
+    mutex & mtx_;
+
+    SOCI_NOT_COPYABLE(scoped_lock)
+};
+
+// Must be called from a catch clause, returns the copy of the exception being
+// handled, converted to soci_error if necessary, so that it can be rethrown
+// in another thread using soci_error::raise(), which preserves the type of
+// the backend-specific errors.
+inline soci_error * capture_current_error()
+{
+    try
+    {
+        throw;
+    }
+    catch (soci_error const & e)
+    {
+        return e.clone();
+    }
+    catch (std::exception const & e)
+    {
+        return new soci_error(e.what());
+    }
+    catch (...)
+    {
+        return new soci_error("Unknown error during asynchronous execution.");
+    }
+}
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_THREAD_H_INCLUDED
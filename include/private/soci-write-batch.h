@@ -0,0 +1,82 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PRIVATE_SOCI_WRITE_BATCH_H_INCLUDED
+#define SOCI_PRIVATE_SOCI_WRITE_BATCH_H_INCLUDED
+
+#include "soci/soci-backend.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+class session;
+
+namespace details
+{
+
+// Value of a use element of a statement queued for the later execution, as
+// returned by use_type_base::get_batch_value().
+struct batched_value
+{
+    std::string name;
+    exchange_type type;
+    void * data;
+    indicator const * ind;
+};
+
+class batch_column;
+
+// Statements with the same query and the same use elements queued by the
+// session when write batching is enabled, see session::set_write_batch_size().
+// The values of the use elements are copied, so that the variables bound to
+// them can be changed as soon as the statement is queued.
+class write_batch
+{
+public:
+    // The first statement of the batch is the given one and it is the
+    // statement with the given number, counting from 1, queued in the
+    // current transaction.
+    write_batch(std::string const & query,
+        std::vector<batched_value> const & values, std::size_t first);
+    ~write_batch();
+
+    std::size_t size() const { return size_; }
+
+    // Returns true if the statement with the given query and values can be
+    // added to this batch.
+    bool matches(std::string const & query,
+        std::vector<batched_value> const & values) const;
+
+    void add(std::vector<batched_value> const & values);
+
+    // Executes all the queued statements at once using vector use elements.
+    void execute(session & sql);
+
+private:
+    std::string const query_;
+    std::vector<batch_column *> columns_;
+    std::size_t const first_;
+    std::size_t size_;
+
+    SOCI_NOT_COPYABLE(write_batch)
+};
+
+// Returns true if the query is an INSERT, UPDATE or DELETE statement, which
+// can be executed as a part of a batch.
+bool is_batchable_query(std::string const & query);
+
+// Returns true if the values of this type can be queued in a batch.
+bool is_batchable_type(exchange_type type);
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_PRIVATE_SOCI_WRITE_BATCH_H_INCLUDED
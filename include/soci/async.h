@@ -0,0 +1,109 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_ASYNC_H_INCLUDED
+#define SOCI_ASYNC_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+namespace details
+{
+
+class statement_impl;
+struct async_execute_state;
+
+// Base class for the tasks run by async_executor.
+class SOCI_DECL async_task
+{
+public:
+    virtual ~async_task() {}
+
+    // Must not throw.
+    virtual void run() = 0;
+};
+
+} // namespace details
+
+// Pool of worker threads running the asynchronous operations.
+//
+// Each session creates an executor with a single worker thread when it is
+// used asynchronously for the first time, but an executor can also be
+// created explicitly and shared by several sessions, see
+// session::set_executor().
+class SOCI_DECL async_executor
+{
+public:
+    // Creates the executor with the given number of worker threads. If
+    // maxPending is not 0, submit() blocks while this number of tasks are
+    // already waiting for a free worker.
+    explicit async_executor(std::size_t threads = 1, std::size_t maxPending = 0);
+
+    // Waits until all the submitted tasks are done.
+    ~async_executor();
+
+    // Takes ownership of the task, which is deleted after running it.
+    void submit(details::async_task * task);
+
+private:
+    struct async_executor_impl;
+    async_executor_impl * pimpl_;
+
+    SOCI_NOT_COPYABLE(async_executor)
+};
+
+// Handle for the result of statement::execute_async().
+//
+// The handle can be copied, all copies referring to the same execution. The
+// statement is kept alive until the last copy is destroyed, which waits for
+// the execution to complete if it hasn't been done already.
+class SOCI_DECL execute_future
+{
+public:
+    // Creates an invalid handle not associated with any execution.
+    execute_future();
+
+    execute_future(execute_future const & other);
+    execute_future & operator=(execute_future const & other);
+    ~execute_future();
+
+    bool valid() const { return state_ != NULL; }
+
+    // Returns true if the execution is done and get() won't block.
+    bool ready() const;
+
+    // Waits until the execution is done.
+    void wait() const;
+
+    // Waits for at most the given number of milliseconds and returns true if
+    // the execution is done.
+    bool wait_for(int timeout) const;
+
+    // Waits until the execution is done and returns the same value as
+    // statement::execute() would or throws soci_error if it failed.
+    bool get() const;
+
+private:
+    friend class details::statement_impl;
+    friend class statement;
+
+    explicit execute_future(details::async_execute_state * state);
+
+    // Waits until the execution is done and returns the same value as get()
+    // without throwing if it failed, used by statement::got_data().
+    bool wait_got_data() const;
+
+    details::async_execute_state * state_;
+};
+
+} // namespace soci
+
+#endif // SOCI_ASYNC_H_INCLUDED
@@ -16,6 +16,8 @@ namespace soci
 {
 
 class session;
+class metrics_registry;
+class result_cache;
 
 class SOCI_DECL connection_pool
 {
@@ -29,7 +31,24 @@ public:
     bool try_lease(std::size_t & pos, int timeout);
     void give_back(std::size_t pos);
 
+    // Collect the pool metrics (time spent waiting in lease()) and those of
+    // all the pooled sessions in the given registry, which must outlive the
+    // pool. Pass NULL to stop collecting them. The sessions currently leased
+    // only start using the new registry after being given back.
+    void set_metrics(metrics_registry * metrics);
+    metrics_registry * get_metrics() const;
+
+    // Cache the results of the queries of all the pooled sessions in the
+    // given cache, which must outlive the pool, so that the modifications
+    // done using any of them invalidate the results cached by all of them.
+    // Pass NULL to stop caching them. As with set_metrics(), the sessions
+    // currently leased are only updated after being given back.
+    void set_result_cache(result_cache * cache);
+    result_cache * get_result_cache() const;
+
 private:
+    bool do_try_lease(std::size_t & pos, int timeout);
+
     struct connection_pool_impl;
     connection_pool_impl * pimpl_;
 
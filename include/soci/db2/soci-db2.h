@@ -66,6 +66,13 @@ public:
     db2_soci_error(std::string const & msg, SQLRETURN rc) : soci_error(msg),errorCode(rc) {};
     ~db2_soci_error() throw() SOCI_OVERRIDE { };
 
+    db2_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new db2_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
     //We have to extract error information before exception throwing, cause CLI handles could be broken at the construction time
     static const std::string sqlState(std::string const & msg,const SQLSMALLINT htype,const SQLHANDLE hndl);
 
@@ -162,7 +169,7 @@ struct SOCI_DB2_DECL db2_standard_use_type_backend : details::standard_use_type_
 struct SOCI_DB2_DECL db2_vector_use_type_backend : details::vector_use_type_backend
 {
     db2_vector_use_type_backend(db2_statement_backend &st)
-        : statement_(st),buf(NULL) {}
+        : statement_(st),position(0),indptr(NULL),data(NULL),type(),colSize(0),dataAtExec(false) {}
 
     void bind_by_pos(int& position, void* data, details::exchange_type type) SOCI_OVERRIDE;
     void bind_by_name(std::string const& name, void* data, details::exchange_type type) SOCI_OVERRIDE;
@@ -179,12 +186,23 @@ struct SOCI_DB2_DECL db2_vector_use_type_backend : details::vector_use_type_back
     void prepare_for_bind(void *&data, SQLUINTEGER &size,SQLSMALLINT &sqlType, SQLSMALLINT &cType);
     void bind_helper(int &position, void *data, details::exchange_type type);
 
+    // Sends the value of the given row of a parameter bound for providing
+    // its data at execution time.
+    void put_data(std::size_t row);
+
+    int position;
     SQLLEN *indptr;
     std::vector<SQLLEN> indVec;
     void *data;
-    char *buf;
+    std::vector<char> buf; // reused by all executions of the statement
     details::exchange_type type;
     std::size_t colSize;
+
+    // Strings of very different lengths are not copied into a buffer padded
+    // to the longest of them but sent one by one at execution time. The
+    // driver gives us back the address of the token of the row it needs.
+    bool dataAtExec;
+    std::vector<db2_vector_use_type_backend*> dataAtExecTokens;
 };
 
 struct db2_session_backend;
@@ -10,6 +10,7 @@
 #define SOCI_ERROR_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/noreturn.h"
 // std
 #include <stdexcept>
 #include <string>
@@ -40,6 +41,12 @@ public:
     // highest level context.
     void add_context(std::string const& context);
 
+    // Return a new copy of this object and throw a copy of it respectively.
+    // The derived classes must override both of them to preserve their type
+    // when an error is stored to be rethrown later, e.g. in another thread.
+    virtual soci_error* clone() const;
+    virtual SOCI_NORETURN raise() const;
+
     // Basic error classes.
     enum error_category
     {
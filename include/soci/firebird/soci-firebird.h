@@ -51,6 +51,13 @@ public:
 
     ~firebird_soci_error() throw() SOCI_OVERRIDE {};
 
+    firebird_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new firebird_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
     std::vector<ISC_STATUS> status_;
 };
 
@@ -95,7 +102,8 @@ private:
 struct firebird_vector_into_type_backend : details::vector_into_type_backend
 {
     firebird_vector_into_type_backend(firebird_statement_backend &st)
-        : statement_(st), data_(NULL), type_(), position_(0), buf_(NULL), indISCHolder_(0)
+        : statement_(st), data_(NULL), type_(), position_(0), buf_(NULL), indISCHolder_(0),
+          stride_(0)
     {}
 
     void define_by_pos(int &position,
@@ -112,12 +120,23 @@ struct firebird_vector_into_type_backend : details::vector_into_type_backend
     firebird_statement_backend &statement_;
     virtual void exchangeData(std::size_t row);
 
+    // Save the data of the just fetched row in the staging buffer.
+    virtual void stageData(std::size_t row);
+
+    // Convert all staged rows and store them in the user vector at once.
+    virtual void exchangeStagedData(std::size_t rows);
+
     void *data_;
     details::exchange_type type_;
     int position_;
 
     char *buf_;
     short indISCHolder_;
+
+    // column-major buffer with the raw data of all rows fetched by the
+    // current fetch() call, stride_ bytes per row
+    std::vector<char> staging_;
+    std::size_t stride_;
 };
 
 struct firebird_standard_use_type_backend : details::standard_use_type_backend
@@ -185,6 +204,23 @@ struct firebird_vector_use_type_backend : details::vector_use_type_backend
     short indISCHolder_;
 };
 
+// Statement executing several rows of a bulk DML operation at once by
+// grouping them into a single EXECUTE BLOCK, see executeBlocks().
+struct firebird_block_statement
+{
+    firebird_block_statement() : stmtp_(0), sqldap_(NULL), rows_(0) {}
+
+    isc_stmt_handle stmtp_;
+    XSQLDA * sqldap_;
+
+    // number of rows executed by this statement
+    std::size_t rows_;
+
+    // buffers for all parameters of all rows
+    std::vector<char> data_;
+    std::vector<short> inds_;
+};
+
 struct firebird_session_backend;
 struct firebird_statement_backend : details::statement_backend
 {
@@ -234,12 +270,24 @@ protected:
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
     virtual void exchangeData(bool gotData, int row);
+    virtual void stageData(int row);
     virtual void prepareSQLDA(XSQLDA ** sqldap, short size = 10);
     virtual void rewriteQuery(std::string const & query,
         std::vector<char> & buffer);
     virtual void rewriteParameters(std::string const & src,
         std::vector<char> & dst);
 
+    // Execute as many rows of a bulk operation using EXECUTE BLOCK as
+    // possible, starting from the first one. Returns the number of rows
+    // executed, which may be 0 if this statement can't be grouped in blocks,
+    // and updates rowsAffected accordingly.
+    virtual std::size_t executeBlocks(std::size_t rows,
+        long long & rowsAffected);
+    virtual int getRowsPerBlock();
+    virtual void prepareBlock(firebird_block_statement & block,
+        std::size_t rows);
+    virtual void freeBlock(firebird_block_statement & block);
+
     BuffersType intoType_;
     BuffersType useType_;
 
@@ -251,6 +299,17 @@ protected:
     std::map <std::string, int> names_;
 
     bool procedure_;
+
+    // statement type and text, as determined by rewriteQuery()
+    int stmtType_;
+    std::string queryText_;
+
+    // number of rows grouped in a single block for bulk operations, 0 if
+    // this statement can't be executed in blocks or -1 if not known yet
+    int rowsPerBlock_;
+
+    // statements used for the full blocks and the last, partial, one
+    firebird_block_statement blocks_[2];
 };
 
 struct firebird_blob_backend : details::blob_backend
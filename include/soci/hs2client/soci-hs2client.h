@@ -30,6 +30,13 @@
 #include <string>
 #include <boost/optional.hpp>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
 
 #define ENABLE_STRING_ESCAPING
 
@@ -56,61 +63,116 @@ namespace soci
 				std::cout << message << "'" << (time_in_ns / 1000000.0) << " ms')" << std::endl;
 			}
 
-			static void escape_string_to_buffer(const std::string& s, char* &buffer)
+			/* Renders the string as a quoted literal into the buffer, reusing its storage. Quotes which aren't
+			   already escaped are escaped (although the check is flawed) and a trailing '\' is doubled. */
+			static void escape_string_to_buffer(const std::string& s, std::string& buffer)
 			{
-				/*buffer = new char[s.size() + 3]{ '\0' };
-				buffer[0] = buffer[s.size() + 1] = '\'';
+				size_t escape_character_count = 0;
+				for (size_t i = 0; i < s.length(); i++)
+					if (s[i] == '\'' && (i == 0 || s[i - 1] != '\\'))
+						escape_character_count++;
 
-				strncpy(buffer + 1, s.c_str(), s.size());*/
+				bool has_trailing_backslash = (s.empty() == false && s[s.length() - 1] == '\\');
 
-				std::vector<size_t> offsets;
+				buffer.resize(s.length() + escape_character_count + 2 + (has_trailing_backslash ? 1 : 0));
 
-				size_t offset = -1;
-				while ((offset = s.find("'", offset + 1)) != std::string::npos)
-					if (offset == 0 || s[offset - 1] != '\\') // If it isn't already escaped, but the check is flawed
-						offsets.push_back(offset);
+				char* dest = &buffer[0];
+				*dest++ = '\'';
 
-				size_t escape_character_count = offsets.size();
-
-				if (offsets.empty() || *offsets.rbegin() != s.length() - 1)
-					offsets.push_back(s.length());
-
-				if (s.at(s.length() - 1) != '\\')
+				for (size_t i = 0; i < s.length(); i++)
 				{
-					buffer = new char[s.length() + escape_character_count + 3]{ '\0' };
-					buffer[0] = buffer[s.length() + escape_character_count + 1] = '\'';
-				}
-				else
-				{
-					buffer = new char[s.length() + escape_character_count + 3 + 1]{ '\0' };
-					buffer[0] = buffer[s.length() + escape_character_count + 2] = '\'';
-					buffer[s.length() + escape_character_count + 1] = '\\';
+					if (s[i] == '\'' && (i == 0 || s[i - 1] != '\\')) *dest++ = '\\';
+					*dest++ = s[i];
 				}
 
-				size_t previous_offset = 0;
-				size_t current_offset = 0;
+				if (has_trailing_backslash) *dest++ = '\\';
+				*dest = '\'';
+			}
+	};
 
-				for (size_t i = 0; i < offsets.size(); i++)
-				{
-					current_offset = offsets.at(i);
+/* Controls how often the state of a pending operation is polled. Polling starts at 'initial_interval'
+   and the interval is doubled after each poll that finds the operation still pending, until it
+   reaches 'max_interval'. Both intervals are in microseconds. */
+struct hs2client_poll_policy
+{
+	hs2client_poll_policy(uint32_t initial = 50, uint32_t max = 100000) :
+	initial_interval(initial),
+	max_interval(max)
+	{
+	}
 
-					size_t i_offset = (i == 0 ? 0 : 1);
-					char* dest = buffer + 1 /* because the beginning ' */ + previous_offset + i + i_offset /* the number of \ we added */;
-					const char* source = s.c_str() + previous_offset + i_offset;
-					size_t length = current_offset - previous_offset - i_offset;
+	uint32_t initial_interval;
+	uint32_t max_interval;
+};
 
-					memcpy(dest, source, length);
+class SOCI_HS2CLIENT_DECL hs2client_backoff
+{
+	public:
+		hs2client_backoff(const hs2client_poll_policy& policy) :
+		_policy(policy),
+		_interval(policy.initial_interval)
+		{
+		}
 
-					if (current_offset != s.length())
-					{
-						*(dest + length) = '\\';
-						*(dest + length + 1) = '\'';
-					}
+		void reset() { _interval = _policy.initial_interval; }
+		void sleep();
 
-					previous_offset = current_offset;
-				}
-			}
-	};
+	private:
+		hs2client_poll_policy _policy;
+		uint32_t _interval;
+};
+
+/* Allows waiting on any number of pending operations from a single thread. Each round polls every
+   pending operation once and the rounds are spaced out according to the poll policy, with the
+   interval being reset whenever an operation completes. The handler of an operation is invoked
+   from the waiting thread once it is no longer pending. */
+class SOCI_HS2CLIENT_DECL hs2client_operation_poller
+{
+	public:
+		typedef std::function<void(hs2client::Operation::State state, uint64_t poll_count)> completion_handler;
+
+		/* The 'operation_mutex' (i.e. the one of the session the operations belong to) is locked while polling
+		   each operation, since the operations of a session share its connection with the background fetches. */
+		hs2client_operation_poller(const hs2client_poll_policy& policy = hs2client_poll_policy(), std::mutex* operation_mutex = nullptr) :
+		_policy(policy),
+		_operation_mutex(operation_mutex),
+		_pending(),
+		_completed_count(0)
+		{
+		}
+
+		void add(hs2client::Operation& operation, completion_handler handler);
+
+		/* Polls each of the pending operations once, returns the number of operations still pending */
+		size_t poll();
+		/* Blocks until at least one of the pending operations completes, returns the number still pending */
+		size_t wait_any();
+		void wait_all();
+
+		inline size_t pending() const { return _pending.size(); }
+
+		static bool is_pending(hs2client::Operation::State state)
+		{
+			return state == hs2client::Operation::State::PENDING ||
+				   state == hs2client::Operation::State::RUNNING ||
+				   state == hs2client::Operation::State::UNKNOWN;
+		}
+
+	private:
+		struct pending_operation
+		{
+			hs2client::Operation* operation;
+			completion_handler handler;
+			uint64_t poll_count;
+		};
+
+		hs2client_poll_policy _policy;
+		std::mutex* _operation_mutex;
+		std::list<pending_operation> _pending;
+		uint64_t _completed_count;
+
+		void poll_until(uint64_t completed_count);
+};
 
 struct hs2client_statement_backend;
 
@@ -185,8 +247,7 @@ struct SOCI_HS2CLIENT_DECL hs2client_standard_use_type_backend : details::standa
 		_data(nullptr),
 		_type(),
 		_position(0),
-		_name(""),
-		_buf(nullptr)
+		_name("")
 		{
 		}
 
@@ -205,7 +266,6 @@ struct SOCI_HS2CLIENT_DECL hs2client_standard_use_type_backend : details::standa
 		details::exchange_type _type;
 		int _position;
 		std::string _name;
-		char* _buf;
 };
 
 struct SOCI_HS2CLIENT_DECL hs2client_vector_use_type_backend : details::vector_use_type_backend
@@ -262,67 +322,79 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 
 				void prepare();
 
-				void clear_parameter_values(int position)
+				/* The rendered values of a parameter. The strings are kept around (and reused) when the values
+				   are cleared, so that rendering the same statement again doesn't allocate. */
+				struct parameter_values
 				{
-					std::map<int, std::vector<char*>>::iterator itr = _parameter_values_by_index.find(position);
-					if (itr == _parameter_values_by_index.end()) return;
+					std::vector<std::string> values;
+					size_t count = 0;
 
-					for (char* data : itr->second)
-						if (data != nullptr) 
-							delete[] data;
+					std::string& add()
+					{
+						if (count == values.size()) values.emplace_back();
+						return values[count++];
+					}
+				};
 
-					itr->second.clear();
+				void clear_parameter_values(int position)
+				{
+					std::map<int, parameter_values>::iterator itr = _parameter_values_by_index.find(position);
+					if (itr != _parameter_values_by_index.end()) itr->second.count = 0;
 				}
 
 				void clear_parameter_values(const std::string& name)
 				{
-					std::map<std::string, std::vector<char*>>::iterator itr = _parameter_values_by_name.find(name);
-					if (itr == _parameter_values_by_name.end()) return;
-
-					for (char* data : itr->second)
-						if (data != nullptr) 
-							delete[] data;
-
-					itr->second.clear();
+					std::map<std::string, parameter_values>::iterator itr = _parameter_values_by_name.find(name);
+					if (itr != _parameter_values_by_name.end()) itr->second.count = 0;
 				}
 
 				void clear_all_parameter_values()
 				{
-					for (auto itr : _parameter_values_by_index)
-						for (char* data : itr.second)
-							if (data != nullptr)
-								delete[] data;
-
-					for (auto itr : _parameter_values_by_name)
-						for (char* data : itr.second)
-							if (data != nullptr)
-								delete[] data;
-
 					_parameter_values_by_index.clear();
 					_parameter_values_by_name.clear();
 				}
 
-				void add_parameter_value(int index, char* value);
-				void add_parameter_value(const std::string& parameter_name, char* value);
+				/* These return the buffer the next value of the parameter should be rendered into */
+				std::string& add_parameter_value(int index);
+				std::string& add_parameter_value(const std::string& parameter_name);
 
 				void get_statement(std::string& out_statement, int index = -1);
+				int get_bulk_statement(std::string& out_statement, int index, int count, size_t max_length);
 				const std::string& get_parameter_name(int index) const;
 				inline bool is_parameter_available(int index) const { return (static_cast<size_t>(index) < _names.size()); }
+				inline bool is_bulk_insert() const { return _is_bulk_insert; }
 
 			private:
 				std::string _query = "";
 				std::vector<std::string> _query_chunks = {};
 				std::vector<std::string> _names = {};
+				std::vector<const std::string*> _values = {};
+
+				/* Only valid when '_is_bulk_insert' is set. '_values_start_offset' points at the '(' opening the
+				   VALUES tuple within the first chunk and '_values_end_offset' at the matching ')' within the last. */
+				bool _is_bulk_insert = false;
+				size_t _values_start_offset = 0;
+				size_t _values_end_offset = 0;
+
+				void detect_bulk_insert();
 
-				std::map<int, std::vector<char*>> _parameter_values_by_index = {};
-				std::map<std::string, std::vector<char*>> _parameter_values_by_name = {};
+				std::map<int, parameter_values> _parameter_values_by_index = {};
+				std::map<std::string, parameter_values> _parameter_values_by_name = {};
 
-				void fill_parameter_values_into_list(std::vector<char*>& values, int index = 0);
+				void fill_parameter_values_into_list(std::vector<const std::string*>& values, int index = 0);
 		};
 
 		class segmented_result
 		{
 			private:
+				struct fetched_batch
+				{
+					std::unique_ptr<hs2client::ColumnarRowSet> results;
+					bool has_more_data = false;
+					uint32_t record_count = 0;
+					uint64_t poll_count = 0;
+				};
+
 				uint32_t _segment_start_offset;
 				uint32_t _segment_end_offset;
 				uint32_t _segment_size;
@@ -335,8 +407,19 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 				uint64_t _total_fetched_record_count;
 				std::unique_ptr<hs2client::ColumnarRowSet> _current_result;
 
+				/* The number of batches fetched ahead by the background worker, while the current one is being
+				   consumed. The worker is started by the first fetch and stopped once the results are reset. */
+				uint32_t _prefetch_depth;
+				std::mutex* _operation_mutex;
+				std::thread _prefetch_thread;
+				std::mutex _prefetch_mutex;
+				std::condition_variable _prefetch_condition;
+				std::deque<fetched_batch> _prefetched_batches;
+				std::exception_ptr _prefetch_error;
+				bool _stop_prefetching;
+
 			public:
-				segmented_result(uint32_t bulk_read_size = 10000) :
+				segmented_result(uint32_t bulk_read_size = 10000, uint32_t prefetch_depth = 0, std::mutex* operation_mutex = nullptr) :
 				_segment_start_offset(0),
 				_segment_end_offset(0),
 				_segment_size(0),
@@ -345,10 +428,18 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 				_has_more_data(true),
 				_is_initial_attempt(true),
 				_total_fetched_record_count(0),
-				_current_result(nullptr)
+				_current_result(nullptr),
+				_prefetch_depth(prefetch_depth),
+				_operation_mutex(operation_mutex),
+				_stop_prefetching(false)
 				{
 				}
 
+				~segmented_result()
+				{
+					stop_prefetching();
+				}
+
 				inline uint32_t get_segment_start_offset() const { return _segment_start_offset; }
 
 				inline uint32_t get_segment_end_offset() const { return _segment_end_offset; }
@@ -365,31 +456,7 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 
 				inline const hs2client::ColumnarRowSet& get_results() const { return *_current_result; }
 
-				inline bool fetch_next(hs2client::Operation& operation, int container_size)
-				{
-					bool data_pending = is_more_data_pending();
-					cleanup();
-
-					_segment_size = container_size;
-					if (_segment_size > _bulk_read_size) _bulk_read_size = _segment_size;
-
-					if (data_pending == false) return false;
-
-					operation.Fetch(_bulk_read_size, hs2client::FetchOrientation::NEXT, &_current_result, &_has_more_data);
-
-					/* AFAIK Fetching is a blocking operation and most likely doesn't require this. But... */
-					hs2client::Operation::State status = wait_for_operation_to_complete(operation);
-					if (status != hs2client::Operation::State::FINISHED)
-					{
-						// TODO : We probably have to handle this properly.
-						throw soci_error("Failed to fetch results.");
-					}
-					
-					_fetched_record_count = hs2client_statement_backend::get_fetched_row_count(operation, *_current_result);
-					_total_fetched_record_count += _fetched_record_count;
-
-					return (_fetched_record_count > 0);
-				}
+				bool fetch_next(hs2client::Operation& operation, int container_size, const hs2client_poll_policy& poll_policy, uint64_t* poll_count);
 
 				inline bool move_segment(uint32_t container_size)
 				{
@@ -413,6 +480,7 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 
 				inline void reset()
 				{
+					stop_prefetching();
 					cleanup();
 
 					_total_fetched_record_count = 0;
@@ -430,6 +498,10 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 					_has_more_data = true;
 					_current_result.reset(nullptr);
 				}
+
+				void fetch_batch(hs2client::Operation& operation, uint32_t batch_size, const hs2client_poll_policy& poll_policy, fetched_batch& batch);
+				void prefetch(hs2client::Operation& operation, hs2client_poll_policy poll_policy);
+				void stop_prefetching();
 		};
 
 		static void generate_variable_name(std::string& variable_name)
@@ -467,12 +539,19 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 
 		sql_statement& get_current_statement() { return *_current_statement; }
 
+		/* The number of times the state of the operations of the last execution (including its fetches) was polled */
+		uint64_t get_state_poll_count() const { return _state_poll_count; }
+
 	protected:
 		hs2client_session_backend& _session;
 		std::unique_ptr<sql_statement> _current_statement = nullptr;
 		std::unique_ptr<hs2client::Operation> _current_operation = nullptr;
 
 		uint32_t _bulk_read_size = 10000;
+		uint32_t _bulk_insert_size = 1000;
+		uint32_t _max_statement_length = 16 * 1024 * 1024;
+		hs2client_poll_policy _poll_policy;
+		uint64_t _state_poll_count = 0;
 		bool _just_described = false;
 		int _affected_row_count = -1;
 		bool _has_more_data = false;
@@ -481,12 +560,14 @@ struct SOCI_HS2CLIENT_DECL hs2client_statement_backend : details::statement_back
 		element_count _into_element_count = element_count::none;
 
 		segmented_result _current_result;
+		std::string _statement_buffer;
 
 		const segmented_result& get_current_results() { return _current_result; }
 		void execute_statements(int number);
+		void execute_single_statement(const std::string& statement);
 
 		static bool get_affected_row_count_from_profile(const std::string& profile, int& modified_count, int& error_count);
-		static hs2client::Operation::State wait_for_operation_to_complete(hs2client::Operation& operation);
+		static hs2client::Operation::State wait_for_operation_to_complete(hs2client::Operation& operation, const hs2client_poll_policy& poll_policy, uint64_t* poll_count = nullptr, std::mutex* operation_mutex = nullptr);
 		static uint32_t get_fetched_row_count(const hs2client::Operation& operation, const hs2client::ColumnarRowSet& results);
 };
 
@@ -536,14 +617,29 @@ struct hs2client_session_backend : details::session_backend
 
 		bool is_connected() const;
 
+		/* Starts executing the statement without waiting for it to complete, which allows the operation to be
+		   waited on together with others (i.e. via a 'hs2client_operation_poller') */
+		hs2client::Status execute_statement(const std::string& statement, std::unique_ptr<hs2client::Operation>* operation) const;
+
+		const hs2client_poll_policy& get_poll_policy() const { return _poll_policy; }
+
+		/* Serializes the calls made via the connection of the session, which is shared by all of its operations */
+		std::mutex& get_operation_mutex() const { return _operation_mutex; }
+
 	protected:
 		std::unique_ptr<hs2client::Service> _service;
 		std::unique_ptr<hs2client::Session> _session;
 		uint32_t _bulk_read_size;
+		uint32_t _bulk_insert_size;
+		uint32_t _max_statement_length;
+		hs2client_poll_policy _poll_policy;
+		uint32_t _prefetch_depth;
+		mutable std::mutex _operation_mutex;
 
+		uint32_t get_prefetch_depth() const { return _prefetch_depth; }
 		uint32_t get_bulk_read_size() const { return _bulk_read_size; }
-
-		hs2client::Status execute_statement(const std::string& statement, std::unique_ptr<hs2client::Operation>* operation) const;
+		uint32_t get_bulk_insert_size() const { return _bulk_insert_size; }
+		uint32_t get_max_statement_length() const { return _max_statement_length; }
 };
 
 struct SOCI_HS2CLIENT_DECL hs2client_backend_factory : backend_factory
@@ -13,6 +13,7 @@
 #include "soci/exchange-traits.h"
 // std
 #include <cstddef>
+#include <string>
 #include <vector>
 
 namespace soci
@@ -43,6 +44,18 @@ public:
 
     virtual std::size_t size() const = 0;  // returns the number of elements
     virtual void resize(std::size_t /* sz */) {} // used for vectors only
+
+    // returns the size of the data, in bytes (used for instrumentation only)
+    virtual std::size_t get_data_size() const { return 0; }
+
+    // used by result_cache: append the type of the element to the key of
+    // the cache entry, store the fetched data in the buffer and restore it
+    // from there without fetching anything, the elements which can't be
+    // cached just return false from the first two functions
+    virtual bool append_cache_key(std::string & /* key */) const { return false; }
+    virtual bool save_to_cache(std::string & /* buf */, bool /* gotData */) const
+    { return false; }
+    virtual void load_from_cache(char const * & /* p */, bool /* gotData */) {}
 };
 
 typedef type_ptr<into_type_base> into_type_ptr;
@@ -69,6 +82,11 @@ private:
     void clean_up() SOCI_OVERRIDE;
 
     std::size_t size() const SOCI_OVERRIDE { return 1; }
+    std::size_t get_data_size() const SOCI_OVERRIDE;
+
+    bool append_cache_key(std::string & key) const SOCI_OVERRIDE;
+    bool save_to_cache(std::string & buf, bool gotData) const SOCI_OVERRIDE;
+    void load_from_cache(char const * & p, bool gotData) SOCI_OVERRIDE;
 
     // conversion hook (from base type to arbitrary user type)
     virtual void convert_from_base() {}
@@ -115,6 +133,11 @@ protected:
     void clean_up() SOCI_OVERRIDE;
     void resize(std::size_t sz) SOCI_OVERRIDE;
     std::size_t size() const SOCI_OVERRIDE;
+    std::size_t get_data_size() const SOCI_OVERRIDE;
+
+    bool append_cache_key(std::string & key) const SOCI_OVERRIDE;
+    bool save_to_cache(std::string & buf, bool gotData) const SOCI_OVERRIDE;
+    void load_from_cache(char const * & p, bool gotData) SOCI_OVERRIDE;
 
     void * data_;
     exchange_type type_;
@@ -9,27 +9,113 @@
 #define SOCI_LOGGER_H_INCLUDED
 
 #include "soci/soci-platform.h"
+#include "soci/query-builder.h"
 
+#include <cstddef>
 #include <ostream>
+#include <string>
 
 namespace soci
 {
 
+// Statement operations reported to logger_impl::start_operation() and
+// end_operation().
+enum statement_operation
+{
+    so_prepare,
+    so_execute,
+    so_fetch
+};
+
+// Describes a statement operation for the logger instrumentation hooks.
+//
+// The object (and the strings it refers to) is only valid during the call to
+// the hook, copy whatever needs to be kept.
+struct statement_event
+{
+    statement_event(statement_operation op, std::string const & q,
+        std::string const & backend)
+        : operation(op), query(q), backend_name(backend), bulk(false),
+          duration_ns(0), rows(0), bytes(0), failed(false) {}
+
+    statement_operation operation;
+    std::string const & query;
+    std::string const & backend_name;
+
+    // The remaining fields are only filled in for end_operation().
+
+    // True if more than one row could be exchanged by this operation, i.e.
+    // vectors are used. Always false for so_prepare.
+    bool bulk;
+
+    // Wall clock time taken by the operation.
+    long long duration_ns;
+
+    // Number of rows fetched into the into elements or, for statements
+    // without any into elements, the number of rows of use elements sent to
+    // the database. Notice that this is not the number of rows affected by
+    // DML statements, use statement::get_affected_rows() for this.
+    long long rows;
+
+    // Size of the data in the exchanged into and use elements, i.e. the
+    // number of bytes of the fixed size values and the length of strings.
+    // Only computed if statement_events_bytes is requested.
+    std::size_t bytes;
+
+    // True if the operation failed with an exception.
+    bool failed;
+};
+
 // Allows to customize the logging of database operations performed by SOCI.
 //
 // To do it, derive your own class from logger_impl and override its pure
 // virtual start_query() and do_clone() methods (overriding the other methods
 // is optional), then call session::set_logger() with a logger object using
 // your implementation.
+//
+// To also be notified about the individual statement operations, e.g. to
+// measure their duration, override get_statement_events() and the
+// start_operation() and end_operation() hooks.
 class SOCI_DECL logger_impl
 {
 public:
+    // Flags returned by get_statement_events().
+    enum statement_event_flags
+    {
+        statement_events_none = 0,
+
+        // Call start_operation() and end_operation() for each prepare,
+        // execute and fetch of the statements.
+        statement_events_timing = 1,
+
+        // Also fill in statement_event::bytes, which requires iterating over
+        // the exchanged values and so is not done by default.
+        statement_events_bytes = 2
+    };
+
     logger_impl() {}
     virtual ~logger_impl();
 
     // Called to indicate that a new query is about to be executed.
     virtual void start_query(std::string const & query) = 0;
 
+    // Called instead of start_query() for the queries built by SOCI itself,
+    // allowing to keep the query text without copying it. By default just
+    // forwards to start_query().
+    virtual void start_shared_query(details::shared_query const & query);
+
+    // Return the combination of statement_event_flags for the events this
+    // logger is interested in. This is called only once, when the logger
+    // object is created, and by default no events are requested, so that the
+    // statements don't incur any overhead.
+    virtual int get_statement_events() const;
+
+    // Called before and after each statement operation, if requested by
+    // get_statement_events(). end_operation() is called even if the operation
+    // failed, but not if start_operation() threw.
+    virtual void start_operation(statement_event const & event);
+    virtual void end_operation(statement_event const & event);
+
     logger_impl * clone() const;
 
     // These methods are for compatibility only as they're used to implement
@@ -67,6 +153,21 @@ public:
     ~logger();
 
     void start_query(std::string const & query) { m_impl->start_query(query); }
+    void start_shared_query(details::shared_query const & query)
+    {
+        m_impl->start_shared_query(query);
+    }
+
+    // Methods used by the statements to report their operations.
+    int get_statement_events() const { return m_events; }
+    void start_operation(statement_event const & event) const
+    {
+        m_impl->start_operation(event);
+    }
+    void end_operation(statement_event const & event) const
+    {
+        m_impl->end_operation(event);
+    }
 
     // Methods used for the implementation of session basic logging support.
     void set_stream(std::ostream * s) { m_impl->set_stream(s); }
@@ -75,6 +176,9 @@ public:
 
 private:
     logger_impl * m_impl;
+
+    // Cached result of m_impl->get_statement_events().
+    int m_events;
 };
 
 } // namespace soci
@@ -0,0 +1,198 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_METRICS_H_INCLUDED
+#define SOCI_METRICS_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+// std
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+struct metrics_query_entry;
+struct live_histogram;
+
+} // namespace details
+
+// Snapshot of a histogram of durations.
+//
+// The durations are counted in buckets whose width grows with the value: the
+// values below 8ns have buckets of their own and each following power of two
+// range is split into 8 equal buckets, so that the percentiles computed from
+// the histogram are always within 12.5% of the actual values (this is the
+// same idea as used by HDR histograms). Durations of more than 2^41ns (about
+// 36 minutes) are all counted in the last bucket.
+class SOCI_DECL latency_histogram
+{
+public:
+    enum { bucket_count = 312 };
+
+    latency_histogram();
+
+    // Returns the index of the bucket used for the given duration.
+    static std::size_t get_bucket_index(long long ns);
+
+    // Returns the largest duration counted in the bucket with this index.
+    static long long get_bucket_upper_bound(std::size_t index);
+
+    unsigned long long get_count() const { return count_; }
+    unsigned long long get_sum_ns() const { return sum_; }
+
+    // Both return 0 if the histogram is empty.
+    long long get_min_ns() const { return count_ ? min_ : 0; }
+    long long get_max_ns() const { return count_ ? max_ : 0; }
+
+    // Returns the duration which is greater than or equal to the given
+    // percentage (between 0 and 100) of all durations, with the precision
+    // explained above, or 0 if the histogram is empty.
+    long long get_percentile_ns(double percentile) const;
+
+    unsigned long long get_bucket_count(std::size_t index) const
+    {
+        return buckets_[index];
+    }
+
+    // Returns the number of durations less than or equal to the given one,
+    // rounded down to the bucket boundaries.
+    unsigned long long get_cumulative_count(long long ns) const;
+
+private:
+    friend struct details::live_histogram;
+
+    std::vector<unsigned long long> buckets_;
+    unsigned long long count_;
+    unsigned long long sum_;
+    long long min_;
+    long long max_;
+};
+
+// Global counters of a metrics registry.
+struct SOCI_DECL metrics_counters
+{
+    metrics_counters();
+
+    unsigned long long statements_prepared;
+    unsigned long long executions;
+    unsigned long long fetches;
+    unsigned long long rows_fetched;
+    unsigned long long rows_sent;
+    unsigned long long errors;
+    unsigned long long reconnects;
+    unsigned long long pool_leases;
+    unsigned long long pool_lease_timeouts;
+    unsigned long long pool_wait_ns;
+    unsigned long long cache_hits;
+    unsigned long long cache_misses;
+};
+
+// Metrics of all the statements with the same normalized query text.
+struct SOCI_DECL query_metrics
+{
+    query_metrics();
+
+    std::string query;
+
+    unsigned long long executions;
+    unsigned long long fetches;
+    unsigned long long rows_fetched;
+    unsigned long long rows_sent;
+    unsigned long long errors;
+
+    // Durations of the statement executions, including fetching the first
+    // batch of rows if the statement was executed with data exchange.
+    latency_histogram execute_latency;
+};
+
+// Consistent (for each individual value) copy of the registry contents.
+class SOCI_DECL metrics_snapshot
+{
+public:
+    metrics_counters counters;
+
+    // Durations of all executions, whichever the query.
+    latency_histogram execute_latency;
+
+    // Durations of the fetches following the executions.
+    latency_histogram fetch_latency;
+
+    // Time spent waiting for a session in connection_pool::lease().
+    latency_histogram pool_wait;
+
+    // Per query metrics, in the order in which the queries were first seen.
+    std::vector<query_metrics> queries;
+
+    // Writes the snapshot in the Prometheus text exposition format, with all
+    // the metric names starting with the given prefix.
+    void write_prometheus(std::ostream & os,
+        std::string const & prefix = "soci") const;
+};
+
+// Collects the metrics of the sessions (and connection pools) using it.
+//
+// The registry is not owned by the sessions, it must outlive all of them and
+// all the statements created using them. It can be shared by any number of
+// sessions used from different threads: the counters and histograms are
+// updated using atomic operations and a lock is only taken the first time a
+// statement with a new query is seen.
+//
+// If a parent registry is given, all metrics recorded by this registry are
+// also recorded by the parent one, which allows to have both per-session and
+// aggregated per-pool metrics.
+class SOCI_DECL metrics_registry
+{
+public:
+    // The number of distinct normalized queries is limited to the given
+    // maximum, the metrics of all queries beyond it are accumulated under a
+    // single "(other)" entry.
+    explicit metrics_registry(metrics_registry * parent = NULL,
+        std::size_t maxQueries = 1000);
+    ~metrics_registry();
+
+    metrics_snapshot get_snapshot() const;
+
+    // Resets all the counters and histograms to 0, without forgetting the
+    // queries seen so far.
+    void reset();
+
+    // Replaces the literal numbers and strings in the query with "?" and
+    // collapses all whitespace, so that the queries differing only by the
+    // values embedded in them share the same metrics.
+    static std::string normalize_query(std::string const & query);
+
+    // The functions below are used by SOCI itself to record the metrics.
+
+    details::metrics_query_entry * get_query_entry(std::string const & query);
+
+    void record_prepare(details::metrics_query_entry * entry, bool failed);
+    void record_execute(details::metrics_query_entry * entry, long long ns,
+        long long rowsFetched, long long rowsSent, bool failed);
+    void record_fetch(details::metrics_query_entry * entry, long long ns,
+        long long rowsFetched, bool failed);
+    void record_reconnect();
+    void record_pool_lease(long long waitNs, bool timedOut);
+    void record_cache_lookup(bool hit);
+
+private:
+    struct metrics_registry_impl;
+    metrics_registry_impl * pimpl_;
+
+    metrics_registry * parent_;
+
+    SOCI_NOT_COPYABLE(metrics_registry)
+};
+
+} // namespace soci
+
+#endif // SOCI_METRICS_H_INCLUDED
@@ -41,6 +41,13 @@ public:
     mysql_soci_error(std::string const & msg, int errNum)
         : soci_error(msg), err_num_(errNum) {}
 
+    mysql_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new mysql_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
     unsigned int err_num_;
 };
 
@@ -166,6 +173,21 @@ struct mysql_statement_backend : details::statement_backend
     mysql_vector_into_type_backend * make_vector_into_type_backend() SOCI_OVERRIDE;
     mysql_vector_use_type_backend * make_vector_use_type_backend() SOCI_OVERRIDE;
 
+    // Helpers of execute() for the statements with use elements.
+    void get_use_buffers(std::vector<char **> &buffers);
+    void append_row_query(std::string &query,
+        std::vector<char **> const &buffers, int row);
+    void execute_bulk(std::vector<char **> const &buffers, int rows);
+    void execute_bulk_query(std::string const &query);
+
+    // Helper of fetch() used when streaming the results.
+    exec_fetch_result fetch_streamed(int number);
+
+    // Return the values of the given row, which must be one of the rows of
+    // the last fetch, and the lengths of the values of the last returned row.
+    MYSQL_ROW get_row(int row);
+    unsigned long * get_row_lengths();
+
     mysql_session_backend &session_;
 
     MYSQL_RES *result_;
@@ -179,6 +201,20 @@ struct mysql_statement_backend : details::statement_backend
 
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
+    // The way in which the rows of bulk operations are sent to the server.
+    enum bulk_mode
+    {
+        bulk_one_by_one,       // a separate query for each row
+        bulk_multi_row_insert, // INSERT with several rows in VALUES
+        bulk_multi_statement   // several statements in the same query
+    };
+    bulk_mode bulkMode_;
+
+    // For bulk_multi_row_insert, the position of the row values in the first
+    // query chunk and the number of characters following them in the query.
+    std::size_t valuesPos_;
+    std::size_t valuesTail_;
+
     int numberOfRows_;  // number of rows retrieved from the server
     int currentRow_;    // "current" row number to consume in postFetch
     int rowsToConsume_; // number of rows to be consumed in postFetch
@@ -190,6 +226,17 @@ struct mysql_statement_backend : details::statement_backend
     // random access to rows, since mysql_data_seek() is expensive.
     std::vector<MYSQL_ROW_OFFSET> resultRowOffsets_;
 
+    // When streaming the results (see mysql_session_backend::streamResults_),
+    // the values of the rows of the last fetch are copied to streamData_,
+    // with streamValues_ pointing to them (or NULL) and streamLengths_
+    // containing their lengths, as for the rows returned by mysql_fetch_row().
+    bool streamEnded_;
+    std::vector<char> streamData_;
+    std::vector<std::size_t> streamOffsets_;
+    std::vector<char *> streamValues_;
+    std::vector<unsigned long> streamLengths_;
+    std::size_t rowValuesPos_; // in the vectors above for get_row_lengths()
+
     bool hasIntoElements_;
     bool hasVectorIntoElements_;
     bool hasUseElements_;
@@ -249,11 +296,26 @@ struct mysql_session_backend : details::session_backend
 
     void clean_up();
 
+    // Returns the maximal size of the query accepted by the server, which is
+    // retrieved from it when this function is called for the first time.
+    std::size_t get_max_allowed_packet();
+
     mysql_statement_backend * make_statement_backend() SOCI_OVERRIDE;
     mysql_rowid_backend * make_rowid_backend() SOCI_OVERRIDE;
     mysql_blob_backend * make_blob_backend() SOCI_OVERRIDE;
 
     MYSQL *conn_;
+
+    // If true (default), the rows of bulk DML statements are sent to the
+    // server in as few queries as possible instead of one by one.
+    bool bulkBatching_;
+
+    // If true, the rows of the query results are retrieved from the server
+    // as they are fetched, using mysql_use_result(), instead of all at once
+    // when the statement is executed. False by default.
+    bool streamResults_;
+
+    std::size_t maxAllowedPacket_; // 0 if not retrieved yet
 };
 
 
@@ -0,0 +1,92 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_OBJECT_CACHE_H_INCLUDED
+#define SOCI_OBJECT_CACHE_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+class session;
+
+namespace details
+{
+
+// Cache of the memory blocks used by the objects created for every statement
+// (statement_impl, ref_counted_statement, rowset_impl...), which allows to
+// reuse the blocks freed by the previous statements instead of going through
+// the global heap for each query.
+//
+// Each session has its own cache and, just as the session itself, it is not
+// thread-safe.
+class SOCI_DECL object_cache
+{
+public:
+    object_cache();
+
+    void * allocate(std::size_t size);
+
+    // Allocates a block not associated with any cache, which can still be
+    // freed using deallocate().
+    static void * allocate_uncached(std::size_t size);
+
+    // Frees a block allocated by either of the functions above.
+    static void deallocate(void * p);
+
+    // Must be called instead of deleting the cache when its owner is
+    // destroyed: the cache itself is deleted only once all the blocks
+    // allocated from it are freed.
+    void close();
+
+private:
+    ~object_cache();
+
+    struct block_header;
+
+    void release(block_header * block);
+
+    // The blocks are allocated in multiples of granularity bytes, the larger
+    // ones are never cached and no more than max_cached_blocks free blocks
+    // are kept for each size.
+    enum
+    {
+        granularity = 64,
+        size_class_count = 16,
+        max_cached_blocks = 8
+    };
+
+    block_header * free_[size_class_count];
+    std::size_t freeCounts_[size_class_count];
+    std::size_t outstanding_;
+    bool closed_;
+
+    SOCI_NOT_COPYABLE(object_cache)
+};
+
+// Base class for the objects allocated from the cache of their session with
+// "new (session) T(...)". They can still be created with plain "new", e.g.
+// when they don't have any session, and are freed with plain "delete" in
+// either case.
+class SOCI_DECL cached_object
+{
+public:
+    static void * operator new(std::size_t size, session & s);
+    static void operator delete(void * p, session & s);
+
+    static void * operator new(std::size_t size);
+    static void operator delete(void * p);
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_OBJECT_CACHE_H_INCLUDED
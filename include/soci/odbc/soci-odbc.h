@@ -386,6 +386,14 @@ public:
     {
         return message_;
     }
+
+    odbc_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new odbc_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
 private:
     std::string interpret_odbc_error(SQLSMALLINT htype, SQLHANDLE hndl, std::string const& msg)
     {
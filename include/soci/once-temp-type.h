@@ -31,6 +31,14 @@ public:
     once_temp_type(once_temp_type const & o);
     once_temp_type & operator=(once_temp_type const & o);
 
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    once_temp_type(once_temp_type && o) noexcept
+        : rcst_(o.rcst_)
+    {
+        o.rcst_ = NULL;
+    }
+#endif // SOCI_HAVE_MOVE_SEMANTICS
+
     ~once_temp_type() SOCI_NOEXCEPT_FALSE;
 
     template <typename T>
@@ -122,6 +130,14 @@ public:
     ddl_type(const ddl_type & d);
     ddl_type & operator=(const ddl_type & d);
 
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    ddl_type(ddl_type && d) noexcept
+        : s_(d.s_), rcst_(d.rcst_)
+    {
+        d.rcst_ = NULL;
+    }
+#endif // SOCI_HAVE_MOVE_SEMANTICS
+
     ~ddl_type() SOCI_NOEXCEPT_FALSE;
 
     void create_table(const std::string & tableName);
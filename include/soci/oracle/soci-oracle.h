@@ -43,6 +43,13 @@ public:
 
     error_category get_error_category() const SOCI_OVERRIDE { return cat_; }
 
+    oracle_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new oracle_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
     int err_num_;
     error_category cat_;
 };
@@ -0,0 +1,108 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_PARTITIONED_QUERY_H_INCLUDED
+#define SOCI_PARTITIONED_QUERY_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+// std
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+class connection_pool;
+class row;
+
+// Half-open range [begin, end) of the values of the partitioning key.
+struct partition_range
+{
+    partition_range(long long b, long long e) : begin(b), end(e) {}
+
+    long long begin;
+    long long end;
+};
+
+// Receives the rows of all the partitions, one by one, in the thread calling
+// partitioned_query::for_each_row(). The rows of the same partition are
+// received in order, but those of different partitions are interleaved.
+class SOCI_DECL partition_row_consumer
+{
+public:
+    virtual ~partition_row_consumer() {}
+
+    virtual void consume(std::size_t partition, row const & r) = 0;
+};
+
+// Receives the batches of rows fetched for each partition in the worker
+// thread executing it, so that this function can be called concurrently for
+// different partitions (but never for the same one).
+//
+// The row is in bulk mode, see row::get_bulk_size() and select_bulk_row(),
+// and is reused for the next batch after this function returns.
+class SOCI_DECL partition_batch_consumer
+{
+public:
+    virtual ~partition_batch_consumer() {}
+
+    virtual void consume(std::size_t partition, row & batch) = 0;
+};
+
+// Executes the same query for several ranges of the partitioning key
+// concurrently, using the sessions leased from the given pool.
+//
+// The query must have exactly two placeholders, which are bound to the
+// beginning and the end of the range of each partition respectively, e.g.
+// "select ... where id >= :begin and id < :end".
+//
+// At most parallelism partitions are executed at once and each of them keeps
+// at most a single batch of rows in memory: its worker doesn't fetch the next
+// batch before the previous one is consumed.
+class SOCI_DECL partitioned_query
+{
+public:
+    partitioned_query(connection_pool & pool, std::string const & query,
+        std::size_t parallelism);
+
+    void add_partition(long long begin, long long end);
+    std::size_t get_partitions_count() const { return partitions_.size(); }
+
+    // Number of rows fetched at once by each partition, 100 by default.
+    void set_batch_size(std::size_t size);
+    std::size_t get_batch_size() const { return batchSize_; }
+
+    // Both functions below block until all the partitions are done. If any
+    // of them fails, the others are stopped as soon as possible and the
+    // error is rethrown as soci_error.
+
+    // Delivers the rows of all the partitions to the consumer in the calling
+    // thread. The exceptions thrown by the consumer stop all the partitions
+    // and are propagated as is.
+    void for_each_row(partition_row_consumer & consumer);
+
+    // Delivers the batches of rows directly to the consumer in the worker
+    // threads, avoiding any synchronization between them.
+    void for_each_batch(partition_batch_consumer & consumer);
+
+private:
+    void execute(partition_row_consumer * rowConsumer,
+        partition_batch_consumer * batchConsumer);
+
+    connection_pool & pool_;
+    std::string const query_;
+    std::size_t const parallelism_;
+    std::size_t batchSize_;
+    std::vector<partition_range> partitions_;
+
+    SOCI_NOT_COPYABLE(partitioned_query)
+};
+
+} // namespace soci
+
+#endif // SOCI_PARTITIONED_QUERY_H_INCLUDED
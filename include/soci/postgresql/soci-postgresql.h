@@ -40,6 +40,13 @@ public:
 
     error_category get_error_category() const SOCI_OVERRIDE { return cat_; }
 
+    postgresql_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new postgresql_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
 private:
     char sqlstate_[ 5 ];   // not std::string to keep copy-constructor no-throw
     error_category cat_;
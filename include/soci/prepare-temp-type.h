@@ -27,6 +27,14 @@ public:
     prepare_temp_type(prepare_temp_type const &);
     prepare_temp_type & operator=(prepare_temp_type const &);
 
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    prepare_temp_type(prepare_temp_type && o) noexcept
+        : rcpi_(o.rcpi_)
+    {
+        o.rcpi_ = NULL;
+    }
+#endif // SOCI_HAVE_MOVE_SEMANTICS
+
     ~prepare_temp_type();
 
     template <typename T>
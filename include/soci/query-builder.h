@@ -0,0 +1,238 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_QUERY_BUILDER_H_INCLUDED
+#define SOCI_QUERY_BUILDER_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+// std
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace soci
+{
+
+namespace details
+{
+
+// Immutable query text shared by reference counting, so that it can be
+// passed to the statement and the logger without copying it.
+//
+// Just as the session the text comes from, this class is not thread-safe:
+// the reference count is not atomic, so all copies of the same query must be
+// created and destroyed by the same thread. Use str() to get a copy of the
+// text which can be passed to another thread.
+class SOCI_DECL shared_query
+{
+public:
+    shared_query() : body_(NULL) {}
+    explicit shared_query(std::string const & text);
+
+    shared_query(shared_query const & other)
+        : body_(other.body_)
+    {
+        if (body_ != NULL)
+        {
+            ++body_->refs;
+        }
+    }
+
+    shared_query & operator=(shared_query const & other)
+    {
+        if (other.body_ != NULL)
+        {
+            ++other.body_->refs;
+        }
+
+        release();
+        body_ = other.body_;
+
+        return *this;
+    }
+
+    ~shared_query() { release(); }
+
+    std::string const & str() const;
+
+private:
+    struct body
+    {
+        explicit body(std::string const & t) : text(t), refs(1) {}
+
+        std::string const text;
+        int refs;
+    };
+
+    void release()
+    {
+        if (body_ != NULL && --body_->refs == 0)
+        {
+            delete body_;
+        }
+    }
+
+    body * body_;
+};
+
+// Accumulates the text of the query built by the user with operator<<.
+//
+// This is similar to std::ostringstream, but much cheaper to use: the strings
+// are just appended to the buffer, which is reused for all the queries of the
+// session, and the numbers are formatted without using the stream machinery
+// and independently of the current locale. The values of all the other types
+// are still formatted using a standard stream, which is kept for the entire
+// query, so that the manipulators such as std::setprecision() or std::hex
+// apply to all the values following them, including the numbers, just as
+// they would with a stream.
+class SOCI_DECL query_builder
+{
+public:
+    query_builder() : stream_(NULL), customized_(false), streamOnly_(false) {}
+    ~query_builder();
+
+    // Starts a new query, keeping the already allocated buffer and resetting
+    // the format changed by any manipulators.
+    void clear();
+
+    std::string const & str() const;
+
+    // Returns the stream used for formatting the values of the other types.
+    //
+    // This function only exists for compatibility with the code using the
+    // deprecated session::get_query_stream(): once it is called, all the
+    // query text is accumulated in this stream until clear() is called.
+    std::ostringstream & get_stream();
+
+    query_builder & operator<<(std::string const & s)
+    {
+        if (customized_)
+        {
+            return append_streamed(s);
+        }
+
+        text_ += s;
+        return *this;
+    }
+
+    query_builder & operator<<(char const * s)
+    {
+        if (customized_)
+        {
+            return append_streamed(s);
+        }
+
+        text_ += s;
+        return *this;
+    }
+
+    // As with the standard streams, all character types are output as
+    // characters and not numbers.
+    query_builder & operator<<(char c)
+    {
+        if (customized_)
+        {
+            return append_streamed(c);
+        }
+
+        text_ += c;
+        return *this;
+    }
+
+    query_builder & operator<<(signed char c)
+    {
+        return *this << static_cast<char>(c);
+    }
+
+    query_builder & operator<<(unsigned char c)
+    {
+        return *this << static_cast<char>(c);
+    }
+
+    query_builder & operator<<(bool b)
+    {
+        if (customized_)
+        {
+            return append_streamed(b);
+        }
+
+        text_ += b ? '1' : '0';
+        return *this;
+    }
+
+    query_builder & operator<<(short n) { return append_signed(n); }
+    query_builder & operator<<(int n) { return append_signed(n); }
+    query_builder & operator<<(long n) { return append_signed(n); }
+    query_builder & operator<<(long long n) { return append_signed(n); }
+
+    query_builder & operator<<(unsigned short n) { return append_unsigned(n); }
+    query_builder & operator<<(unsigned int n) { return append_unsigned(n); }
+    query_builder & operator<<(unsigned long n) { return append_unsigned(n); }
+    query_builder & operator<<(unsigned long long n) { return append_unsigned(n); }
+
+    // Unless the precision is changed using std::setprecision(), the floating
+    // point numbers are output with as many significant digits as necessary
+    // to represent them exactly, unlike with the standard streams, and floats
+    // use only as many of them as needed to be read back as the same float.
+    query_builder & operator<<(float d) { return append_float(d); }
+    query_builder & operator<<(double d) { return append_double(d); }
+    query_builder & operator<<(long double d);
+
+    // Fallback for all the other types, e.g. user-defined types with an
+    // output operator for std::ostream, and the stream manipulators.
+    template <typename T>
+    query_builder & operator<<(T const & t)
+    {
+        return append_streamed(t);
+    }
+
+private:
+    template <typename T>
+    query_builder & append_streamed(T const & t)
+    {
+        if (stream_ == NULL)
+        {
+            create_stream();
+        }
+
+        *stream_ << t;
+        flush_stream();
+        return *this;
+    }
+
+    void create_stream();
+
+    // Appends the text output to the stream to the query and checks whether
+    // the stream format was changed by a manipulator.
+    void flush_stream();
+
+    query_builder & append_signed(long long n);
+    query_builder & append_unsigned(unsigned long long n);
+    query_builder & append_double(double d);
+    query_builder & append_float(float d);
+
+    // The text is mutable because str() must retrieve it from the stream in
+    // the compatibility mode, see get_stream().
+    mutable std::string text_;
+
+    std::ostringstream * stream_;
+
+    // True if the stream format is not the default one any more and all the
+    // values must be output using it.
+    bool customized_;
+
+    // True if get_stream() was called for the current query.
+    bool streamOnly_;
+
+    SOCI_NOT_COPYABLE(query_builder)
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_QUERY_BUILDER_H_INCLUDED
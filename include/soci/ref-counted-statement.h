@@ -9,10 +9,11 @@
 #define SOCI_REF_COUNTED_STATEMENT_H_INCLUDED
 
 #include "soci/statement.h"
+#include "soci/object-cache.h"
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 // std
-#include <sstream>
+#include "soci/query-builder.h"
 
 namespace soci
 {
@@ -21,7 +22,7 @@ namespace details
 {
 
 // this class is a base for both "once" and "prepare" statements
-class SOCI_DECL ref_counted_statement_base
+class SOCI_DECL ref_counted_statement_base : public cached_object
 {
 public:
     ref_counted_statement_base(session& s);
@@ -55,16 +56,18 @@ public:
     }
 
     template <typename T>
-    void accumulate(T const & t) { get_query_stream() << t; }
+    void accumulate(T const & t) { get_query_builder() << t; }
 
     void set_tail(const std::string & tail) { tail_ = tail; }
     void set_need_comma(bool need_comma) { need_comma_ = need_comma; }
     bool get_need_comma() const { return need_comma_; }
 
+    session & get_session() const { return session_; }
+
 protected:
     // this function allows to break the circular dependenc
     // between session and this class
-    std::ostringstream & get_query_stream();
+    query_builder & get_query_builder();
 
     int refCount_;
 
@@ -0,0 +1,132 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_RESULT_CACHE_H_INCLUDED
+#define SOCI_RESULT_CACHE_H_INCLUDED
+
+#include "soci/soci-platform.h"
+
+// std
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+// Counters of a result cache.
+struct SOCI_DECL result_cache_stats
+{
+    result_cache_stats();
+
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long insertions;
+
+    // Numbers of entries removed, respectively, to stay within the memory
+    // budget, because they expired and because the tables they use were
+    // modified.
+    unsigned long long evictions;
+    unsigned long long expirations;
+    unsigned long long invalidations;
+
+    std::size_t entries;
+    std::size_t bytes;
+
+    // Returns the fraction of the lookups which found the results in the
+    // cache, or 0 if there were no lookups at all.
+    double get_hit_rate() const;
+};
+
+// Cache of the results of the queries executed using session::operator<<,
+// see session::set_result_cache().
+//
+// The results are stored in a compact binary form under the key consisting
+// of the normalized query text, the values of the use elements and the types
+// of the into elements, so that they can be copied to the into elements
+// later without executing the query at all. Only the queries reading data
+// from at least one table and using the elements of the basic types (or
+// the user-defined types converted to them) and vectors of basic types are
+// cached.
+//
+// The entries are removed when their time to live expires or when any of the
+// tables they use is modified by a statement executed using a session using
+// the same cache. The tables are found using a simple lexical analysis of the
+// queries, which doesn't handle all possible SQL constructs, and, of course,
+// the modifications done by the other applications, or via stored procedures
+// and triggers, are not detected at all, so a finite TTL should be used
+// unless the cached data never changes.
+//
+// The cache is thread-safe and can be shared by several sessions, e.g. all
+// the sessions of a connection pool.
+class SOCI_DECL result_cache
+{
+public:
+    // The total size of the stored entries is limited by the given number of
+    // bytes, the least recently used entries are removed to stay under it.
+    // The entries expire after the given number of milliseconds, or never if
+    // it is 0.
+    explicit result_cache(std::size_t maxBytes = 1024 * 1024, int ttl = 0);
+    ~result_cache();
+
+    std::size_t get_max_bytes() const { return maxBytes_; }
+    int get_ttl() const { return ttl_; }
+
+    // Removes the results of all the queries using the given table, which is
+    // compared case-insensitively and without any schema prefix.
+    void invalidate_table(std::string const & table);
+
+    // Removes all the entries.
+    void clear();
+
+    result_cache_stats get_stats() const;
+
+    // Kinds of the queries as far as the cache is concerned.
+    enum query_kind
+    {
+        query_read,     // Only reads data, e.g. SELECT.
+        query_write,    // Modifies the tables it uses, e.g. INSERT or DROP.
+        query_unknown   // May modify anything, e.g. a procedure call.
+    };
+
+    // Collapses all whitespace outside of the quoted strings and identifiers,
+    // so that the queries differing only by formatting share the results.
+    static std::string normalize_query(std::string const & query);
+
+    // Returns the kind of the query and fills the vector with the (lower case
+    // and without schema) names of the tables used by it.
+    static query_kind analyze_query(std::string const & query,
+        std::vector<std::string> & tables);
+
+    // The functions below are used by SOCI itself.
+
+    // Copies the data stored under the given key and returns true if it was
+    // found and didn't expire yet. Otherwise fills the generation which must
+    // be passed to store() later.
+    bool find(std::string const & key, std::string & data,
+        unsigned long long & generation);
+
+    // Stores the data under the given key, replacing any existing entry,
+    // unless some entries were invalidated since the generation was
+    // returned by find(), as the data could have been read before the
+    // modification which triggered the invalidation then.
+    void store(std::string const & key, std::string const & data,
+        std::vector<std::string> const & tables,
+        unsigned long long generation);
+
+private:
+    struct result_cache_impl;
+    result_cache_impl * pimpl_;
+
+    std::size_t const maxBytes_;
+    int const ttl_;
+
+    SOCI_NOT_COPYABLE(result_cache)
+};
+
+} // namespace soci
+
+#endif // SOCI_RESULT_CACHE_H_INCLUDED
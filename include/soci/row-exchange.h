@@ -67,6 +67,39 @@ private:
     SOCI_NOT_COPYABLE(into_type)
 };
 
+// Support selecting several rows at once into a row in bulk mode, which is
+// used by rowset
+
+class bulk_row_into_type : public into_type_base
+{
+public:
+    bulk_row_into_type(row & r, std::size_t sz) : r_(r)
+    {
+        r_.set_bulk_size(sz);
+    }
+
+private:
+    void define(statement_impl & st, int & /* position */) SOCI_OVERRIDE
+    {
+        st.set_row(&r_);
+
+        // the columns are created by the row description performed as part
+        // of the statement execution, just as for the single row
+    }
+
+    void pre_exec(int /* num */) SOCI_OVERRIDE {}
+    void pre_fetch() SOCI_OVERRIDE {}
+    void post_fetch(bool /* gotData */, bool /* calledFromFetch */) SOCI_OVERRIDE {}
+    void clean_up() SOCI_OVERRIDE {}
+
+    std::size_t size() const SOCI_OVERRIDE { return r_.get_bulk_size(); }
+    void resize(std::size_t sz) SOCI_OVERRIDE { r_.set_bulk_size(sz); }
+
+    row & r_;
+
+    SOCI_NOT_COPYABLE(bulk_row_into_type)
+};
+
 template <>
 struct exchange_traits<row>
 {
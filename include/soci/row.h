@@ -37,6 +37,55 @@ private:
     data_type dataType_;
 };
 
+namespace details
+{
+
+// Column of a row fetched in bulk, containing the values of this column in
+// all the fetched rows.
+class row_column_base
+{
+public:
+    virtual ~row_column_base() {}
+
+    virtual void resize(std::size_t sz) = 0;
+
+    // Make the holder of the column refer to the value in the given row.
+    virtual void select(std::size_t i) = 0;
+
+    std::vector<indicator> indicators_;
+};
+
+template <typename T>
+class row_column : public row_column_base
+{
+public:
+    row_column(type_holder<T> & holder, std::size_t sz)
+        : values_(sz), holder_(holder)
+    {
+        indicators_.resize(sz);
+    }
+
+    void resize(std::size_t sz) SOCI_OVERRIDE
+    {
+        values_.resize(sz);
+        indicators_.resize(sz);
+    }
+
+    void select(std::size_t i) SOCI_OVERRIDE
+    {
+        holder_.reset(&values_[i]);
+    }
+
+    std::vector<T> values_;
+
+private:
+    type_holder<T> & holder_;
+
+    SOCI_NOT_COPYABLE(row_column)
+};
+
+} // namespace details
+
 class SOCI_DECL row
 {
 public:
@@ -58,6 +107,26 @@ public:
         indicators_.push_back(ind);
     }
 
+    // In bulk mode, used by rowset, all the columns are fetched into vectors
+    // of the given size at once and select_bulk_row() must be used to choose
+    // the row returned by the accessors.
+    void set_bulk_size(std::size_t sz);
+    bool is_bulk() const { return bulk_; }
+    std::size_t get_bulk_size() const { return bulkSize_; }
+    void select_bulk_row(std::size_t i);
+
+    template <typename T>
+    details::row_column<T>& add_bulk_holder()
+    {
+        details::type_holder<T>* holder = new details::type_holder<T>(NULL, false);
+        holders_.push_back(holder);
+        indicators_.push_back(NULL);
+
+        details::row_column<T>* column = new details::row_column<T>(*holder, bulkSize_);
+        bulkColumns_.push_back(column);
+        return *column;
+    }
+
     column_properties const& get_properties(std::size_t pos) const;
     column_properties const& get_properties(std::string const& name) const;
 
@@ -131,6 +200,11 @@ private:
     std::vector<indicator*> indicators_;
     std::map<std::string, std::size_t> index_;
 
+    // Only used in bulk mode, the indicators then point into these columns.
+    std::vector<details::row_column_base*> bulkColumns_;
+    bool bulk_;
+    std::size_t bulkSize_;
+
     bool uppercaseColumnNames_;
     mutable std::size_t currentPos_;
 };
@@ -10,13 +10,156 @@
 
 #include "soci/soci-platform.h"
 #include "soci/statement.h"
+#include "soci/prepare-temp-type.h"
+#include "soci/object-cache.h"
+#include "soci/session.h"
+#include "soci/row-exchange.h"
 // std
+#include <cstddef>
 #include <iterator>
 #include <memory>
+#include <vector>
 
 namespace soci
 {
 
+class values;
+
+namespace details
+{
+
+//
+// Rows fetched in bulk by rowset, which are then returned one by one by its
+// iterator.
+//
+template <typename T>
+class rowset_buffer
+{
+public:
+    explicit rowset_buffer(std::size_t size)
+        : rows_(size), pos_(0), size_(0)
+    {}
+
+    void exchange(statement & st)
+    {
+        st.exchange_for_rowset(into(rows_));
+    }
+
+    // Returns the next row, fetching the next batch of rows if all the
+    // previously fetched ones were already returned, or NULL at the end.
+    T * next(statement & st)
+    {
+        if (++pos_ >= size_)
+        {
+            if (st.fetch() == false)
+            {
+                return NULL;
+            }
+
+            pos_ = 0;
+            size_ = rows_.size();
+        }
+
+        return &rows_[pos_];
+    }
+
+private:
+    std::vector<T> rows_;
+    std::size_t pos_;
+    std::size_t size_;
+
+    SOCI_NOT_COPYABLE(rowset_buffer)
+};
+
+// row can't be stored in a vector, so a single row in bulk mode is used
+// instead, exposing one of the fetched rows at a time.
+template <>
+class rowset_buffer<row>
+{
+public:
+    explicit rowset_buffer(std::size_t size)
+        : size_(size), pos_(0), fetched_(0)
+    {}
+
+    void exchange(statement & st)
+    {
+        st.exchange_for_rowset(into_type_ptr(new bulk_row_into_type(row_, size_)));
+    }
+
+    row * next(statement & st)
+    {
+        if (++pos_ >= fetched_)
+        {
+            if (st.fetch() == false)
+            {
+                return NULL;
+            }
+
+            pos_ = 0;
+            fetched_ = row_.get_bulk_size();
+        }
+
+        row_.select_bulk_row(pos_);
+        return &row_;
+    }
+
+private:
+    row row_;
+    std::size_t size_;
+    std::size_t pos_;
+    std::size_t fetched_;
+
+    SOCI_NOT_COPYABLE(rowset_buffer)
+};
+
+// Bulk fetching is not possible for values, nor for Boost.Fusion sequences,
+// which are fetched as their individual elements, so rowset always fetches
+// the rows of these types one by one.
+template <typename T>
+struct rowset_batching
+{
+#ifdef SOCI_HAVE_BOOST
+    static bool const enabled = !boost::fusion::traits::is_sequence<T>::value;
+#else
+    static bool const enabled = true;
+#endif // SOCI_HAVE_BOOST
+};
+
+template <>
+struct rowset_batching<values>
+{
+    static bool const enabled = false;
+};
+
+// Creates the buffer used by rowset and binds it to the statement, or returns
+// NULL if the rows must be fetched one by one.
+template <typename T, bool Enabled = rowset_batching<T>::enabled>
+struct rowset_buffer_factory
+{
+    static rowset_buffer<T> * create(statement & st, std::size_t size)
+    {
+        if (size <= 1)
+        {
+            return NULL;
+        }
+
+        cxx_details::auto_ptr<rowset_buffer<T> > buffer(new rowset_buffer<T>(size));
+        buffer->exchange(st);
+        return buffer.release();
+    }
+};
+
+template <typename T>
+struct rowset_buffer_factory<T, false>
+{
+    static rowset_buffer<T> * create(statement &, std::size_t)
+    {
+        return NULL;
+    }
+};
+
+} // namespace details
+
 //
 // rowset iterator of input category.
 //
@@ -36,16 +179,23 @@ public:
     // Constructors
 
     rowset_iterator()
-        : st_(0), define_(0)
+        : st_(0), define_(0), buffer_(0)
     {}
 
     rowset_iterator(statement & st, T & define)
-        : st_(&st), define_(&define)
+        : st_(&st), define_(&define), buffer_(0)
     {
         // Fetch first row to properly initialize iterator
         ++(*this);
     }
 
+    // Iterate over the rows fetched in bulk into the given buffer.
+    rowset_iterator(statement & st, details::rowset_buffer<T> & buffer)
+        : st_(&st), define_(0), buffer_(&buffer)
+    {
+        ++(*this);
+    }
+
     // Access operators
 
     reference operator*() const
@@ -62,9 +212,19 @@ public:
 
     rowset_iterator & operator++()
     {
-        // Fetch next row from dataset
+        // Fetch next row from dataset, or just take the next one from the
+        // buffer if the rows are fetched in bulk
 
-        if (st_->fetch() == false)
+        if (buffer_ != 0)
+        {
+            define_ = buffer_->next(*st_);
+            if (define_ == 0)
+            {
+                st_ = 0;
+                buffer_ = 0;
+            }
+        }
+        else if (st_->fetch() == false)
         {
             // Set iterator to non-derefencable state (pass-the-end)
             st_ = 0;
@@ -97,6 +257,7 @@ private:
 
     statement * st_;
     T * define_;
+    details::rowset_buffer<T> * buffer_;
 
 }; // class rowset_iterator
 
@@ -107,17 +268,23 @@ namespace details
 // Implementation of rowset
 //
 template <typename T>
-class rowset_impl
+class rowset_impl : public cached_object
 {
 public:
 
     typedef rowset_iterator<T> iterator;
 
     rowset_impl(details::prepare_temp_type const & prep)
-        : refs_(1), st_(new statement(prep)), define_(new T())
+        : refs_(1), st_(prep), define_()
     {
-        st_->exchange_for_rowset(into(*define_));
-        st_->execute();
+        buffer_.reset(rowset_buffer_factory<T>::create(st_,
+            prep.get_prepare_info()->get_session().get_rowset_batch_size()));
+        if (buffer_.get() == NULL)
+        {
+            st_.exchange_for_rowset(into(define_));
+        }
+
+        st_.execute();
     }
 
     void incRef()
@@ -136,7 +303,12 @@ public:
     iterator begin() const
     {
         // No ownership transfer occurs here
-        return iterator(*st_, *define_);
+        if (buffer_.get() != NULL)
+        {
+            return iterator(st_, *buffer_);
+        }
+
+        return iterator(st_, define_);
     }
 
     iterator end() const
@@ -148,8 +320,14 @@ private:
 
     unsigned int refs_;
 
-    const cxx_details::auto_ptr<statement> st_;
-    const cxx_details::auto_ptr<T> define_;
+    // only used if the rows are fetched in bulk, this must outlive st_ which
+    // refers to it
+    cxx_details::auto_ptr<rowset_buffer<T> > buffer_;
+
+    // these are mutable as the iterators modify them
+    mutable statement st_;
+    mutable T define_;
+
     SOCI_NOT_COPYABLE(rowset_impl)
 }; // class rowset_impl
 
@@ -172,7 +350,8 @@ public:
 
     // this is a conversion constructor
     rowset(details::prepare_temp_type const& prep)
-        : pimpl_(new details::rowset_impl<T>(prep))
+        : pimpl_(new (prep.get_prepare_info()->get_session())
+            details::rowset_impl<T>(prep))
     {
     }
 
@@ -182,9 +361,36 @@ public:
         pimpl_->incRef();
     }
 
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    // the moved from rowset can only be destroyed or assigned to
+    rowset(rowset && other) noexcept
+        : pimpl_(other.pimpl_)
+    {
+        other.pimpl_ = NULL;
+    }
+
+    rowset& operator=(rowset && rhs) noexcept
+    {
+        if (&rhs != this)
+        {
+            if (pimpl_ != NULL)
+            {
+                pimpl_->decRef();
+            }
+
+            pimpl_ = rhs.pimpl_;
+            rhs.pimpl_ = NULL;
+        }
+        return *this;
+    }
+#endif // SOCI_HAVE_MOVE_SEMANTICS
+
     ~rowset()
     {
-        pimpl_->decRef();
+        if (pimpl_ != NULL)
+        {
+            pimpl_->decRef();
+        }
     }
 
     rowset& operator=(rowset const& rhs)
@@ -13,6 +13,7 @@
 #include "soci/query_transformation.h"
 #include "soci/connection-parameters.h"
 #include "soci/logger.h"
+#include "soci/query-builder.h"
 
 // std
 #include <cstddef>
@@ -20,11 +21,15 @@
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace soci
 {
 class values;
 class backend_factory;
+class metrics_registry;
+class result_cache;
+class async_executor;
 
 namespace details
 {
@@ -33,6 +38,9 @@ class session_backend;
 class statement_backend;
 class rowid_backend;
 class blob_backend;
+class object_cache;
+class write_batch;
+struct batched_value;
 
 } // namespace details
 
@@ -76,9 +84,18 @@ public:
     template <typename T>
     details::once_temp_type operator<<(T const & t) { return once << t; }
 
-    std::ostringstream & get_query_stream();
+    details::query_builder & get_query_builder();
     std::string get_query() const;
 
+    // Deprecated, use get_query_builder() instead. Once this function is
+    // called, the current query is built using the returned stream, which is
+    // slower, and the numbers are formatted as by the standard streams.
+    std::ostringstream & get_query_stream();
+
+    // Returns the same text as get_query(), but without copying it when it
+    // is passed to the statement and the logger.
+    details::shared_query get_shared_query() const;
+
     template <typename T>
     void set_query_transformation(T callback)
     {
@@ -96,12 +113,40 @@ public:
     // standard SOCI logger.
     logger const & get_logger() const;
 
+    // Collect the metrics of the statements executed using this session in
+    // the given registry, which must outlive the session, or stop collecting
+    // them if the argument is NULL (default).
+    void set_metrics(metrics_registry * metrics);
+    metrics_registry * get_metrics() const;
+
+    // Cache the results of the queries executed using operator<< in the
+    // given cache, which must outlive the session, or stop caching them if
+    // the argument is NULL (default). See result_cache for the details.
+    void set_result_cache(result_cache * cache);
+    result_cache * get_result_cache() const;
+
+    // Used by the statements to remove the cached results using any of the
+    // given tables, or all of them if the vector is empty. Inside a
+    // transaction the results are removed again when it is committed, as
+    // they could have been cached by another session in the meanwhile.
+    void invalidate_cached_results(std::vector<std::string> const & tables);
+
+    // Returns true between begin() and commit() or rollback().
+    bool is_in_transaction() const;
+
+    // Set the executor used by statement::execute_async(), which must
+    // outlive the session, or use the default one if the argument is NULL.
+    // By default, each session creates its own executor with a single
+    // worker thread the first time it is needed.
+    void set_executor(async_executor * executor);
+    async_executor & get_executor();
 
     // support for basic logging (use set_logger() for more control).
     void set_log_stream(std::ostream * s);
     std::ostream * get_log_stream() const;
 
     void log_query(std::string const & query);
+    void log_query(details::shared_query const & query);
     std::string get_last_query() const;
 
     void set_got_data(bool gotData);
@@ -111,6 +156,35 @@ public:
 
     bool get_uppercase_column_names() const;
 
+    // Set the number of rows fetched at once by rowset, which then uses bulk
+    // operations under the hood to avoid fetching the rows one by one, or 1
+    // to disable this, which is the default.
+    void set_rowset_batch_size(std::size_t size);
+    std::size_t get_rowset_batch_size() const;
+
+    // Queue the INSERT, UPDATE and DELETE statements executed inside a
+    // transaction, instead of executing them immediately, and execute all
+    // the consecutive statements with the same query at once using a bulk
+    // operation when the given number of them is queued, or when the
+    // transaction is committed or any other statement is executed, or 0 to
+    // disable this (default). Errors of the queued statements are reported
+    // by the operation executing them.
+    void set_write_batch_size(std::size_t size);
+    std::size_t get_write_batch_size() const;
+
+    // Also execute the queued statements when the next statement is queued
+    // after the given number of milliseconds since the first one, or never
+    // if it is 0 (default).
+    void set_write_batch_delay(int delay);
+    int get_write_batch_delay() const;
+
+    // Execute the queued statements now.
+    void flush_batched_writes();
+
+    // Used by the statements to queue a statement with the given values.
+    void queue_batched_write(std::string const & query,
+        std::vector<details::batched_value> const & values);
+
     // Functions for dealing with sequence/auto-increment values.
 
     // If true is returned, value is filled with the next value from the given
@@ -184,13 +258,20 @@ public:
     std::string get_backend_name() const;
 
     details::statement_backend * make_statement_backend();
+
+    // Cache of the memory used by the statement objects, see object_cache.
+    details::object_cache & get_object_cache();
+
     details::rowid_backend * make_rowid_backend();
     details::blob_backend * make_blob_backend();
 
 private:
     SOCI_NOT_COPYABLE(session)
 
-    std::ostringstream query_stream_;
+    void end_transaction();
+    void discard_batched_writes();
+
+    details::query_builder query_builder_;
     details::query_transformation_function* query_transformation_;
 
     logger logger_;
@@ -199,10 +280,35 @@ private:
 
     bool uppercaseColumnNames_;
 
+    std::size_t rowsetBatchSize_;
+
     details::session_backend * backEnd_;
 
     bool gotData_;
 
+    metrics_registry * metrics_;
+
+    result_cache * resultCache_;
+
+    // The tables modified in the current transaction, to invalidate their
+    // cached results again when it is committed.
+    bool inTransaction_;
+    bool invalidateAllOnCommit_;
+    std::vector<std::string> invalidateOnCommit_;
+
+    // The statements queued in the current transaction, if any, the time when
+    // the first of them was queued and their total number in it.
+    std::size_t writeBatchSize_;
+    int writeBatchDelay_;
+    details::write_batch * writeBatch_;
+    long long writeBatchStart_;
+    std::size_t writeBatchQueued_;
+
+    async_executor * executor_;
+    async_executor * defaultExecutor_;
+
+    details::object_cache * objectCache_;
+
     bool isFromPool_;
     std::size_t poolPosition_;
     connection_pool * pool_;
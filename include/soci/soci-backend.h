@@ -189,6 +189,19 @@ public:
     virtual exec_fetch_result execute(int number) = 0;
     virtual exec_fetch_result fetch(int number) = 0;
 
+    // Optional support for non-blocking execution, used by
+    // statement::execute_async(): if the backend supports it, start_execute()
+    // must send the statement to the server and return true without waiting
+    // for the result. The following call to execute() with the same number
+    // then waits for and returns the result of this execution, while
+    // wait_execute() waits for it for at most the given number of
+    // milliseconds (not at all if 0, indefinitely if negative) and returns
+    // true if execute() would not block any more. By default, false is
+    // returned and execute() is called from a worker thread instead, which
+    // is currently the case for all the backends.
+    virtual bool start_execute(int /* number */) { return false; }
+    virtual bool wait_execute(int /* timeout */) { return true; }
+
     virtual long long get_affected_rows() = 0;
     virtual int get_number_of_rows() = 0;
 
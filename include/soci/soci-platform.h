@@ -142,4 +142,10 @@ namespace cxx_details
     #define SOCI_NOEXCEPT_FALSE
 #endif
 
+// Rvalue references are used to make the handle classes (statement, rowset
+// and the temporary objects used for building the queries) movable.
+#if defined(SOCI_HAVE_CXX11) || (defined(_MSC_VER) && _MSC_VER >= 1900)
+    #define SOCI_HAVE_MOVE_SEMANTICS
+#endif
+
 #endif // SOCI_PLATFORM_H_INCLUDED
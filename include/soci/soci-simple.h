@@ -10,6 +10,8 @@
 
 #include "soci/soci-platform.h"
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -87,6 +89,20 @@ SOCI_DECL long long    soci_get_into_long_long_v(statement_handle st, int positi
 SOCI_DECL double       soci_get_into_double_v   (statement_handle st, int position, int index);
 SOCI_DECL char const * soci_get_into_date_v     (statement_handle st, int position, int index);
 
+// read of the whole vector at once
+typedef struct soci_column
+{
+    int size;                       // number of values
+    unsigned char const * validity; // bit i is set if value i is not null
+    void const * values;            // array of int, long long or double, or
+                                    // 6 ints per date (year, month, day,
+                                    // hour, minute, second), NULL for strings
+    size_t const * offsets;         // size + 1 offsets of the strings in data
+    char const * data;              // concatenated strings
+} soci_column;
+
+SOCI_DECL int soci_get_into_column_v(statement_handle st, int position, soci_column * column);
+
 
 // named bind of use elements
 SOCI_DECL void soci_use_string   (statement_handle st, char const * name);
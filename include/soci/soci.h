@@ -10,6 +10,7 @@
 
 // namespace soci
 #include "soci/soci-platform.h"
+#include "soci/async.h"
 #include "soci/backend-loader.h"
 #include "soci/blob.h"
 #include "soci/blob-exchange.h"
@@ -19,11 +20,14 @@
 #include "soci/exchange-traits.h"
 #include "soci/into.h"
 #include "soci/into-type.h"
+#include "soci/metrics.h"
 #include "soci/once-temp-type.h"
+#include "soci/partitioned-query.h"
 #include "soci/prepare-temp-type.h"
 #include "soci/procedure.h"
 #include "soci/ref-counted-prepare-info.h"
 #include "soci/ref-counted-statement.h"
+#include "soci/result-cache.h"
 #include "soci/row.h"
 #include "soci/row-exchange.h"
 #include "soci/rowid.h"
@@ -32,6 +36,7 @@
 #include "soci/session.h"
 #include "soci/soci-backend.h"
 #include "soci/statement.h"
+#include "soci/struct-mapping.h"
 #include "soci/transaction.h"
 #include "soci/type-conversion.h"
 #include "soci/type-conversion-traits.h"
@@ -63,6 +63,13 @@ public:
 
     int result() const;
 
+    sqlite3_soci_error * clone() const SOCI_OVERRIDE
+    {
+        return new sqlite3_soci_error(*this);
+    }
+
+    SOCI_NORETURN raise() const SOCI_OVERRIDE { throw *this; }
+
 private:
     int result_;
 };
@@ -232,6 +239,11 @@ struct sqlite3_statement_backend : details::statement_backend
     sqlite_api::sqlite3_stmt *stmt_;
     sqlite3_recordset dataCache_;
     sqlite3_recordset useData_;
+
+    // Storage for the text and blob values in dataCache_, reused by all
+    // fetches to avoid allocating memory for every value, unless it becomes
+    // too big.
+    std::vector<char> dataCacheBuffer_;
     bool databaseReady_;
     bool boundByName_;
     bool boundByPos_;
@@ -11,7 +11,12 @@
 #include "soci/bind-values.h"
 #include "soci/into-type.h"
 #include "soci/into.h"
+#include "soci/logger.h"
+#include "soci/async.h"
 #include "soci/noreturn.h"
+#include "soci/object-cache.h"
+#include "soci/query-builder.h"
+#include "soci/result-cache.h"
 #include "soci/use-type.h"
 #include "soci/use.h"
 #include "soci/soci-backend.h"
@@ -26,6 +31,7 @@ namespace soci
 
 class session;
 class values;
+class metrics_registry;
 
 namespace details
 {
@@ -33,8 +39,9 @@ namespace details
 class into_type_base;
 class use_type_base;
 class prepare_temp_type;
+struct metrics_query_entry;
 
-class SOCI_DECL statement_impl
+class SOCI_DECL statement_impl : public cached_object
 {
 public:
     explicit statement_impl(session & s);
@@ -44,6 +51,11 @@ public:
     void alloc();
     void bind(values & v);
 
+    // Binds the use element created for a column of the values used for a
+    // bulk operation, taking ownership of it, if it is positional or if the
+    // query references it, and returns false otherwise.
+    bool bind_values_column(use_type_base * u);
+
     void exchange(into_type_ptr const & i) { intos_.exchange(i); }
     template <typename T, typename Indicator>
     void exchange(into_container<T, Indicator> const &ic)
@@ -60,18 +72,34 @@ public:
 
     void prepare(std::string const & query,
                     statement_type eType = st_repeatable_query);
+    void prepare(shared_query const & query,
+                    statement_type eType = st_repeatable_query);
     void define_and_bind();
     void undefine_and_bind();
     bool execute(bool withDataExchange = false);
+    execute_future execute_async(bool withDataExchange = false);
     long long get_affected_rows();
     bool fetch();
     void describe();
     void set_row(row * r);
+    void set_bulk_values(values * v);
     void exchange_for_rowset(into_type_ptr const & i) { exchange_for_rowset_(i); }
     template<typename T, typename Indicator>
     void exchange_for_rowset(into_container<T, Indicator> const &ic)
     { exchange_for_rowset_(ic); }
 
+    // Used for the one-time queries if the session has a result cache:
+    // returns true if the results of the query were found in it and copied
+    // to the into elements without executing it, otherwise remembers the key
+    // under which store_cached_results() stores them after executing it.
+    bool find_cached_results(shared_query const & query, bool & gotData);
+    void store_cached_results(bool gotData);
+
+    // Queues the statement with the given query in the session write batch
+    // instead of executing it and returns true if the session has write
+    // batching enabled and the statement can be batched.
+    bool batch_write(shared_query const & query);
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end statement class)
     statement_backend * get_backend() { return backEnd_; }
@@ -103,9 +131,10 @@ private:
     int refCount_;
 
     row * row_;
+    values * bulkValues_;
     std::size_t fetchSize_;
     std::size_t initialFetchSize_;
-    std::string query_;
+    shared_query query_;
 
     into_type_vector intosForRow_;
     int definePositionForRow_;
@@ -138,15 +167,37 @@ private:
     template<typename T>
     void into_row()
     {
+        if (bulkValues_ != NULL)
+        {
+            into_bulk_values<T>();
+            return;
+        }
+
+        if (row_->is_bulk())
+        {
+            into_bulk_row<T>();
+            return;
+        }
+
         T * t = new T();
         indicator * ind = new indicator(i_ok);
         row_->add_holder(t, ind);
         exchange_for_row(into(*t, *ind));
     }
 
+    // Defined in statement.cpp, as it needs the full declaration of values.
+    template<typename T>
+    void into_bulk_values();
+
+    template<typename T>
+    void into_bulk_row();
+
     template<data_type>
     void bind_into();
 
+    // Returns true if the query contains the placeholder with this name.
+    bool has_placeholder(std::string const & name) const;
+
     bool alreadyDescribed_;
 
     std::size_t intos_size();
@@ -159,6 +210,49 @@ private:
     bool resize_intos(std::size_t upperBound = 0);
     void truncate_intos();
 
+    // The implementations of prepare(), execute() and fetch(), which are
+    // wrapped by the public methods reporting them to the logger.
+    void do_prepare(shared_query const & query, statement_type eType);
+    bool do_execute(bool withDataExchange);
+    bool do_fetch();
+
+    // The parts of do_execute() preceding and following the backend call,
+    // also used separately by execute_async().
+    int pre_execute(bool withDataExchange);
+    bool post_execute(int num, statement_backend::exec_fetch_result res);
+
+    // Number of rows reported to the logger for a successful execution.
+    long long get_executed_rows(bool withDataExchange, bool gotData);
+
+    friend struct async_execute_state;
+
+    // Report the start and the end of an operation to the logger, if it has
+    // requested it (see logger_impl::get_statement_events()), and to the
+    // session metrics registry, if any.
+    long long start_operation(statement_operation op,
+        std::string const & query, int events);
+    void end_operation(statement_operation op, std::string const & query,
+        int events, long long start, long long rows, bool failed);
+
+    // Cached session backend name, only used for the logger.
+    std::string backendName_;
+
+    // Registry used for the last operation and the entry of our query in it.
+    metrics_registry * metricsRegistry_;
+    metrics_query_entry * metricsQuery_;
+
+    // Only used if the session has a result cache: the kind of the query and
+    // the tables it uses, determined once, and the key and the cache
+    // generation of the results of a one-time query which weren't found.
+    void analyze_for_cache(std::string const & query);
+    void invalidate_cached_results();
+
+    bool cacheAnalyzed_;
+    result_cache::query_kind cacheQueryKind_;
+    std::vector<std::string> cacheTables_;
+    std::string cacheKey_;
+    unsigned long long cacheGeneration_;
+
     soci::details::statement_backend * backEnd_;
 
     SOCI_NOT_COPYABLE(statement_impl)
@@ -171,15 +265,19 @@ private:
 class SOCI_DECL statement
 {
 public:
-    statement(session & s)
-        : impl_(new details::statement_impl(s)), gotData_(false) {}
-    statement(details::prepare_temp_type const & prep)
-        : impl_(new details::statement_impl(prep)), gotData_(false) {}
-    ~statement() { impl_->dec_ref(); }
+    statement(session & s);
+    statement(details::prepare_temp_type const & prep);
+    ~statement()
+    {
+        if (impl_ != NULL)
+        {
+            impl_->dec_ref();
+        }
+    }
 
     // copy is supported for this handle class
     statement(statement const & other)
-        : impl_(other.impl_)
+        : impl_(other.impl_), gotData_(other.gotData_), async_(other.async_)
     {
         impl_->inc_ref();
     }
@@ -190,7 +288,34 @@ public:
         impl_->dec_ref();
         impl_ = other.impl_;
         gotData_ = other.gotData_;
+        async_ = other.async_;
+    }
+
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    // moving avoids updating the reference count, the moved from statement
+    // can only be destroyed or assigned to
+    statement(statement && other) noexcept
+        : impl_(other.impl_), gotData_(other.gotData_), async_(other.async_)
+    {
+        other.impl_ = NULL;
+    }
+
+    void operator=(statement && other) noexcept
+    {
+        if (&other != this)
+        {
+            if (impl_ != NULL)
+            {
+                impl_->dec_ref();
+            }
+
+            impl_ = other.impl_;
+            gotData_ = other.gotData_;
+            async_ = other.async_;
+            other.impl_ = NULL;
+        }
     }
+#endif // SOCI_HAVE_MOVE_SEMANTICS
 
     void alloc()                         { impl_->alloc();    }
     void bind(values & v)                { impl_->bind(v);    }
@@ -209,14 +334,31 @@ public:
         impl_->prepare(query, eType);
     }
 
+    void prepare(details::shared_query const & query,
+        details::statement_type eType = details::st_repeatable_query)
+    {
+        impl_->prepare(query, eType);
+    }
+
     void define_and_bind() { impl_->define_and_bind(); }
     void undefine_and_bind()  { impl_->undefine_and_bind(); }
     bool execute(bool withDataExchange = false)
     {
+        async_ = execute_future();
         gotData_ = impl_->execute(withDataExchange);
         return gotData_;
     }
 
+    // Executes the statement without blocking the calling thread, see
+    // execute_future. The statement and its session must not be used until
+    // the returned future becomes ready, after which got_data() returns the
+    // result of this execution.
+    execute_future execute_async(bool withDataExchange = false)
+    {
+        async_ = impl_->execute_async(withDataExchange);
+        return async_;
+    }
+
     long long get_affected_rows()
     {
         return impl_->get_affected_rows();
@@ -224,11 +366,15 @@ public:
 
     bool fetch()
     {
+        async_ = execute_future();
         gotData_ = impl_->fetch();
         return gotData_;
     }
 
-    bool got_data() const { return gotData_; }
+    bool got_data() const
+    {
+        return async_.valid() ? async_.wait_got_data() : gotData_;
+    }
 
     void describe()       { impl_->describe(); }
     void set_row(row * r) { impl_->set_row(r); }
@@ -244,6 +390,22 @@ public:
         impl_->exchange_for_rowset(i);
     }
 
+    bool find_cached_results(details::shared_query const & query,
+        bool & gotData)
+    {
+        return impl_->find_cached_results(query, gotData);
+    }
+
+    void store_cached_results(bool gotData)
+    {
+        impl_->store_cached_results(gotData);
+    }
+
+    bool batch_write(details::shared_query const & query)
+    {
+        return impl_->batch_write(query);
+    }
+
     // for diagnostics and advanced users
     // (downcast it to expected back-end statement class)
     details::statement_backend * get_backend()
@@ -279,6 +441,10 @@ public:
 private:
     details::statement_impl * impl_;
     bool gotData_;
+
+    // The last asynchronous execution, if it was done after any synchronous
+    // execute() or fetch().
+    execute_future async_;
 };
 
 namespace details
@@ -0,0 +1,746 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_STRUCT_MAPPING_H_INCLUDED
+#define SOCI_STRUCT_MAPPING_H_INCLUDED
+
+#include "soci/bind-values.h"
+#include "soci/exchange-traits.h"
+#include "soci/into.h"
+#include "soci/type-conversion.h"
+#include "soci/use.h"
+// std
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Map the fields of a struct to the columns of a query at compile time:
+//
+//  SOCI_MAP_STRUCT_BEGIN(person)
+//      SOCI_MAP_FIELD(id)
+//      SOCI_MAP_FIELD(name)
+//  SOCI_MAP_STRUCT_END()
+//
+// must be used in the global namespace and allows to use person, as well as
+// std::vector<person>, with into() and use(). Each field is then bound as
+// if it were used directly, in the order of the declaration, so the query
+// must use the positional placeholders or the placeholders with the names in
+// the same order as the fields.
+#define SOCI_MAP_STRUCT_BEGIN(S) \
+    namespace soci \
+    { \
+    template <> \
+    struct type_conversion<S> \
+    { \
+        typedef details::mapped_struct_tag base_type; \
+        typedef S mapped_type; \
+        \
+        template <typename Visitor> \
+        static void for_each_field(Visitor & v) \
+        {
+
+#define SOCI_MAP_FIELD(field) \
+            v(&mapped_type::field, #field);
+
+#define SOCI_MAP_STRUCT_END() \
+        } \
+    }; \
+    }
+
+namespace soci
+{
+
+namespace details
+{
+
+// Base type of the type_conversion defined by SOCI_MAP_STRUCT_BEGIN(), only
+// used to select the elements defined below for the mapped structs.
+struct mapped_struct_tag {};
+
+template <>
+struct exchange_traits<mapped_struct_tag>
+{
+    typedef basic_type_tag type_family;
+
+    // dummy value to satisfy the template engine, never used
+    enum { x_type = 0 };
+};
+
+// Fields visitors creating the elements for all fields of a single struct.
+
+template <typename T>
+class struct_into_fields
+{
+public:
+    struct_into_fields(T & s, into_type_vector & intos)
+        : s_(s), intos_(intos) {}
+
+    template <typename F>
+    void operator()(F T::* field, char const * /* name */)
+    {
+        intos_.exchange(into(s_.*field));
+    }
+
+private:
+    T & s_;
+    into_type_vector & intos_;
+
+    SOCI_NOT_ASSIGNABLE(struct_into_fields)
+};
+
+// S is either T or T const, in which case the fields are read-only.
+template <typename T, typename S>
+class struct_use_fields
+{
+public:
+    struct_use_fields(S & s, use_type_vector & uses,
+        std::vector<char const *> & names)
+        : s_(s), uses_(uses), names_(names) {}
+
+    template <typename F>
+    void operator()(F T::* field, char const * name)
+    {
+        uses_.exchange(use(s_.*field));
+        names_.push_back(name);
+    }
+
+private:
+    S & s_;
+    use_type_vector & uses_;
+    std::vector<char const *> & names_;
+
+    SOCI_NOT_ASSIGNABLE(struct_use_fields)
+};
+
+inline std::string make_fields_name(std::vector<char const *> const & names)
+{
+    std::ostringstream oss;
+
+    oss << "(";
+    for (std::size_t n = 0; n != names.size(); ++n)
+    {
+        if (n != 0)
+            oss << ", ";
+
+        oss << names[n];
+    }
+    oss << ")";
+
+    return oss.str();
+}
+
+template <typename T>
+class struct_into_type : public into_type_base
+{
+public:
+    struct_into_type(T & s)
+        : ind_(NULL)
+    {
+        struct_into_fields<T> v(s, fields_);
+        type_conversion<T>::for_each_field(v);
+    }
+
+    struct_into_type(T & s, indicator & ind)
+        : ind_(&ind)
+    {
+        struct_into_fields<T> v(s, fields_);
+        type_conversion<T>::for_each_field(v);
+    }
+
+    void define(statement_impl & st, int & position) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->define(st, position);
+        }
+    }
+
+    void pre_exec(int num) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_exec(num);
+        }
+    }
+
+    void pre_fetch() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_fetch();
+        }
+    }
+
+    void post_fetch(bool gotData, bool calledFromFetch) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->post_fetch(gotData, calledFromFetch);
+        }
+
+        // the whole struct is never NULL, only its fields can be
+        if (gotData && ind_ != NULL)
+        {
+            *ind_ = i_ok;
+        }
+    }
+
+    void clean_up() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->clean_up();
+        }
+    }
+
+    std::size_t size() const SOCI_OVERRIDE { return 1; }
+
+    std::size_t get_data_size() const SOCI_OVERRIDE
+    {
+        std::size_t sz = 0;
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            sz += fields_[i]->get_data_size();
+        }
+
+        return sz;
+    }
+
+private:
+    into_type_vector fields_;
+    indicator * ind_;
+
+    SOCI_NOT_COPYABLE(struct_into_type)
+};
+
+template <typename T>
+class struct_use_type : public use_type_base
+{
+public:
+    struct_use_type(T & s, std::string const & /* name */ = std::string())
+    {
+        struct_use_fields<T, T> v(s, fields_, names_);
+        type_conversion<T>::for_each_field(v);
+    }
+
+    struct_use_type(T const & s, std::string const & /* name */ = std::string())
+    {
+        struct_use_fields<T, T const> v(s, fields_, names_);
+        type_conversion<T>::for_each_field(v);
+    }
+
+    // we ignore the possibility to have the whole struct as NULL
+    struct_use_type(T & s, indicator & /* ind */,
+        std::string const & /* name */ = std::string())
+    {
+        struct_use_fields<T, T> v(s, fields_, names_);
+        type_conversion<T>::for_each_field(v);
+    }
+
+    struct_use_type(T const & s, indicator & /* ind */,
+        std::string const & /* name */ = std::string())
+    {
+        struct_use_fields<T, T const> v(s, fields_, names_);
+        type_conversion<T>::for_each_field(v);
+    }
+
+    void bind(statement_impl & st, int & position) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->bind(st, position);
+        }
+    }
+
+    std::string get_name() const SOCI_OVERRIDE
+    {
+        return make_fields_name(names_);
+    }
+
+    void dump_value(std::ostream& os) const SOCI_OVERRIDE
+    {
+        os << "(";
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            if (i != 0)
+                os << ", ";
+
+            fields_[i]->dump_value(os);
+        }
+        os << ")";
+    }
+
+    void pre_exec(int num) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_exec(num);
+        }
+    }
+
+    void pre_use() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_use();
+        }
+    }
+
+    void post_use(bool gotData) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->post_use(gotData);
+        }
+    }
+
+    void clean_up() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->clean_up();
+        }
+    }
+
+    std::size_t size() const SOCI_OVERRIDE { return 1; }
+
+    std::size_t get_data_size() const SOCI_OVERRIDE
+    {
+        std::size_t sz = 0;
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            sz += fields_[i]->get_data_size();
+        }
+
+        return sz;
+    }
+
+private:
+    use_type_vector fields_;
+    std::vector<char const *> names_;
+
+    SOCI_NOT_COPYABLE(struct_use_type)
+};
+
+// Bulk operations with std::vector of the mapped structs use a vector for
+// each field, which is bound as the usual vector element, and copy the
+// fields of all the rows into (or from) these vectors.
+
+template <typename T>
+class struct_column_base
+{
+public:
+    virtual ~struct_column_base() {}
+
+    virtual void resize(std::size_t sz) = 0;
+
+    // Copy the field from (or to) the rows starting at the given one.
+    virtual void from_rows(std::vector<T> const & rows, std::size_t begin) = 0;
+    virtual void to_rows(std::vector<T> & rows, std::size_t begin) const = 0;
+};
+
+template <typename T, typename F>
+class struct_column : public struct_column_base<T>
+{
+public:
+    explicit struct_column(F T::* field) : field_(field) {}
+
+    void resize(std::size_t sz) SOCI_OVERRIDE { values_.resize(sz); }
+
+    void from_rows(std::vector<T> const & rows, std::size_t begin) SOCI_OVERRIDE
+    {
+        std::size_t const sz = values_.size();
+        for (std::size_t i = 0; i != sz; ++i)
+        {
+            values_[i] = rows[begin + i].*field_;
+        }
+    }
+
+    void to_rows(std::vector<T> & rows, std::size_t begin) const SOCI_OVERRIDE
+    {
+        std::size_t const sz = values_.size();
+        for (std::size_t i = 0; i != sz; ++i)
+        {
+            rows[begin + i].*field_ = values_[i];
+        }
+    }
+
+    std::vector<F> values_;
+
+private:
+    F T::* field_;
+};
+
+// Owns the columns and deletes them when it is destroyed, which must happen
+// after destroying the elements bound to them.
+template <typename T>
+class struct_columns : public std::vector<struct_column_base<T> *>
+{
+public:
+    struct_columns() {}
+
+    ~struct_columns()
+    {
+        for (std::size_t i = 0; i != this->size(); ++i)
+        {
+            delete (*this)[i];
+        }
+    }
+
+    void resize_all(std::size_t sz) const
+    {
+        for (std::size_t i = 0; i != this->size(); ++i)
+        {
+            (*this)[i]->resize(sz);
+        }
+    }
+
+private:
+    SOCI_NOT_COPYABLE(struct_columns)
+};
+
+template <typename T>
+class struct_into_columns
+{
+public:
+    struct_into_columns(struct_columns<T> & columns, into_type_vector & intos,
+        std::size_t sz)
+        : columns_(columns), intos_(intos), sz_(sz) {}
+
+    template <typename F>
+    void operator()(F T::* field, char const * /* name */)
+    {
+        struct_column<T, F> * const column = new struct_column<T, F>(field);
+        columns_.push_back(column);
+
+        column->resize(sz_);
+        intos_.exchange(into(column->values_));
+    }
+
+private:
+    struct_columns<T> & columns_;
+    into_type_vector & intos_;
+    std::size_t sz_;
+
+    SOCI_NOT_ASSIGNABLE(struct_into_columns)
+};
+
+template <typename T>
+class struct_use_columns
+{
+public:
+    struct_use_columns(struct_columns<T> & columns, use_type_vector & uses,
+        std::vector<char const *> & names, std::size_t sz)
+        : columns_(columns), uses_(uses), names_(names), sz_(sz) {}
+
+    template <typename F>
+    void operator()(F T::* field, char const * name)
+    {
+        struct_column<T, F> * const column = new struct_column<T, F>(field);
+        columns_.push_back(column);
+
+        column->resize(sz_);
+        uses_.exchange(use(column->values_));
+        names_.push_back(name);
+    }
+
+private:
+    struct_columns<T> & columns_;
+    use_type_vector & uses_;
+    std::vector<char const *> & names_;
+    std::size_t sz_;
+
+    SOCI_NOT_ASSIGNABLE(struct_use_columns)
+};
+
+template <typename T>
+class struct_vector_into_type : public into_type_base
+{
+public:
+    struct_vector_into_type(std::vector<T> & v,
+        std::size_t begin = 0, std::size_t * end = NULL)
+        : v_(v), ind_(NULL), begin_(begin), end_(end)
+    {
+        struct_into_columns<T> c(columns_, fields_, rows());
+        type_conversion<T>::for_each_field(c);
+    }
+
+    struct_vector_into_type(std::vector<T> & v, std::vector<indicator> & ind,
+        std::size_t begin = 0, std::size_t * end = NULL)
+        : v_(v), ind_(&ind), begin_(begin), end_(end)
+    {
+        struct_into_columns<T> c(columns_, fields_, rows());
+        type_conversion<T>::for_each_field(c);
+    }
+
+    void define(statement_impl & st, int & position) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->define(st, position);
+        }
+    }
+
+    void pre_exec(int num) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_exec(num);
+        }
+    }
+
+    void pre_fetch() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_fetch();
+        }
+    }
+
+    void post_fetch(bool gotData, bool calledFromFetch) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->post_fetch(gotData, calledFromFetch);
+        }
+
+        if (gotData == false)
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i != columns_.size(); ++i)
+        {
+            columns_[i]->to_rows(v_, begin_);
+        }
+
+        // the whole struct is never NULL, only its fields can be
+        if (ind_ != NULL)
+        {
+            std::size_t const sz = rows();
+            for (std::size_t i = 0; i != sz; ++i)
+            {
+                (*ind_)[begin_ + i] = i_ok;
+            }
+        }
+    }
+
+    void clean_up() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->clean_up();
+        }
+    }
+
+    std::size_t size() const SOCI_OVERRIDE
+    {
+        // the user might have resized the vector in the meantime,
+        // so keep the columns (and the elements using them) of the same size
+        std::size_t const sz = rows();
+        columns_.resize_all(sz);
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->size();
+        }
+
+        return sz;
+    }
+
+    void resize(std::size_t sz) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->resize(sz);
+        }
+
+        if (end_ != NULL)
+        {
+            *end_ = begin_ + sz;
+        }
+        else
+        {
+            v_.resize(sz);
+            if (ind_ != NULL)
+            {
+                ind_->resize(sz);
+            }
+        }
+    }
+
+    std::size_t get_data_size() const SOCI_OVERRIDE
+    {
+        std::size_t sz = 0;
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            sz += fields_[i]->get_data_size();
+        }
+
+        return sz;
+    }
+
+private:
+    std::size_t rows() const
+    {
+        return end_ != NULL ? *end_ - begin_ : v_.size();
+    }
+
+    std::vector<T> & v_;
+    std::vector<indicator> * ind_;
+    std::size_t begin_;
+    std::size_t * end_;
+
+    // the columns must be declared before the elements using them
+    struct_columns<T> columns_;
+    into_type_vector fields_;
+
+    SOCI_NOT_COPYABLE(struct_vector_into_type)
+};
+
+template <typename T>
+class struct_vector_use_type : public use_type_base
+{
+public:
+    struct_vector_use_type(std::vector<T> & v,
+        std::string const & /* name */ = std::string())
+        : v_(v), begin_(0), end_(NULL)
+    {
+        add_fields();
+    }
+
+    struct_vector_use_type(std::vector<T> & v,
+        std::size_t begin, std::size_t * end,
+        std::string const & /* name */ = std::string())
+        : v_(v), begin_(begin), end_(end)
+    {
+        add_fields();
+    }
+
+    // we ignore the possibility to have the whole struct as NULL
+    struct_vector_use_type(std::vector<T> & v,
+        std::vector<indicator> & /* ind */,
+        std::string const & /* name */ = std::string())
+        : v_(v), begin_(0), end_(NULL)
+    {
+        add_fields();
+    }
+
+    struct_vector_use_type(std::vector<T> & v,
+        std::vector<indicator> & /* ind */,
+        std::size_t begin, std::size_t * end,
+        std::string const & /* name */ = std::string())
+        : v_(v), begin_(begin), end_(end)
+    {
+        add_fields();
+    }
+
+    void bind(statement_impl & st, int & position) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->bind(st, position);
+        }
+    }
+
+    std::string get_name() const SOCI_OVERRIDE
+    {
+        return make_fields_name(names_);
+    }
+
+    void dump_value(std::ostream& os) const SOCI_OVERRIDE
+    {
+        os << "<vector of structs>";
+    }
+
+    void pre_exec(int num) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_exec(num);
+        }
+    }
+
+    void pre_use() SOCI_OVERRIDE
+    {
+        columns_.resize_all(size());
+        for (std::size_t i = 0; i != columns_.size(); ++i)
+        {
+            columns_[i]->from_rows(v_, begin_);
+        }
+
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->pre_use();
+        }
+    }
+
+    void post_use(bool gotData) SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->post_use(gotData);
+        }
+    }
+
+    void clean_up() SOCI_OVERRIDE
+    {
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            fields_[i]->clean_up();
+        }
+    }
+
+    std::size_t size() const SOCI_OVERRIDE
+    {
+        return end_ != NULL ? *end_ - begin_ : v_.size();
+    }
+
+    std::size_t get_data_size() const SOCI_OVERRIDE
+    {
+        std::size_t sz = 0;
+        for (std::size_t i = 0; i != fields_.size(); ++i)
+        {
+            sz += fields_[i]->get_data_size();
+        }
+
+        return sz;
+    }
+
+private:
+    void add_fields()
+    {
+        struct_use_columns<T> c(columns_, fields_, names_, size());
+        type_conversion<T>::for_each_field(c);
+    }
+
+    std::vector<T> & v_;
+    std::size_t begin_;
+    std::size_t * end_;
+
+    // the columns must be declared before the elements using them
+    struct_columns<T> columns_;
+    use_type_vector fields_;
+    std::vector<char const *> names_;
+
+    SOCI_NOT_COPYABLE(struct_vector_use_type)
+};
+
+template <typename T>
+struct conversion_elements<T, mapped_struct_tag>
+{
+    typedef struct_into_type<T> into_element;
+    typedef struct_use_type<T> use_element;
+    typedef struct_vector_into_type<T> vector_into_element;
+    typedef struct_vector_use_type<T> vector_use_element;
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_STRUCT_MAPPING_H_INCLUDED
@@ -36,6 +36,23 @@ struct type_conversion
     }
 };
 
+// Specialize this trait with value set to true for the user-defined types T
+// which have exactly the same representation as type_conversion<T>::base_type,
+// which must be one of the basic types, and for which from_base() and
+// to_base() just copy the value, e.g. enums or wrappers around a single
+// number. The vectors of such types are then exchanged with the database
+// directly, instead of converting each element to or from a temporary vector
+// of the base type.
+//
+// Notice that from_base() is not called at all in this case, so the NULL
+// values are handled as for the base type itself: they can only be fetched if
+// the vector of indicators is provided.
+template <typename T>
+struct is_layout_compatible_with_base
+{
+    static bool const value = false;
+};
+
 } // namespace soci
 
 #endif // SOCI_TYPE_CONVERSION_TRAITS_H_INCLUDED
@@ -234,6 +234,14 @@ public:
         ind_.resize(actual_size);
     }
 
+    // the base vector is only resized together with the user one by the
+    // functions above, which require a defined element, so these vectors
+    // can't be restored from the result cache
+    bool append_cache_key(std::string & /* key */) const SOCI_OVERRIDE
+    {
+        return false;
+    }
+
 private:
     void convert_from_base() SOCI_OVERRIDE
     {
@@ -410,16 +418,164 @@ private:
     SOCI_NOT_COPYABLE(conversion_use_type)
 };
 
+// Helper used by the std::vector based elements for the types which are
+// layout compatible with their base type (see is_layout_compatible_with_base)
+// for using the user vector directly as the vector of the base type. This is
+// the same thing which is done for the vectors of unsigned types, which are
+// exchanged as the vectors of the corresponding signed ones.
+
+template <typename T>
+struct layout_compatible_vector
+{
+    typedef typename type_conversion<T>::base_type base_type;
+
+    // Give a compile-time error if the trait was specialized for a type with
+    // a different size.
+    typedef char size_check[sizeof(T) == sizeof(base_type) ? 1 : -1];
+
+    static std::vector<base_type> & get(std::vector<T> & v)
+    {
+        return *static_cast<std::vector<base_type> *>(static_cast<void *>(&v));
+    }
+
+    static std::vector<base_type> const & get(std::vector<T> const & v)
+    {
+        return *static_cast<std::vector<base_type> const *>(
+            static_cast<void const *>(&v));
+    }
+};
+
+// std::vector based into_type for the layout compatible types: the data is
+// fetched directly into the user vector, without any conversions.
+
+template <typename T>
+class layout_compatible_into_type
+    : public into_type<std::vector<typename type_conversion<T>::base_type> >
+{
+public:
+    typedef std::vector
+        <
+            typename type_conversion<T>::base_type
+        > base_type;
+
+    layout_compatible_into_type(std::vector<T> & value,
+        std::size_t begin = 0, std::size_t * end = NULL)
+        : into_type<base_type>(
+            layout_compatible_vector<T>::get(value), begin, end)
+    {
+    }
+
+    layout_compatible_into_type(std::vector<T> & value,
+        std::vector<indicator> & ind,
+        std::size_t begin = 0, std::size_t * end = NULL)
+        : into_type<base_type>(
+            layout_compatible_vector<T>::get(value), ind, begin, end)
+    {
+    }
+};
+
+// std::vector based use_type for the layout compatible types: the data is
+// taken directly from the user vector, without any conversions.
+
+template <typename T>
+class layout_compatible_use_type
+    : public use_type<std::vector<typename type_conversion<T>::base_type> >
+{
+public:
+    typedef std::vector
+        <
+            typename type_conversion<T>::base_type
+        > base_type;
+
+    layout_compatible_use_type(std::vector<T> const & value,
+        std::string const & name = std::string())
+        : use_type<base_type>(layout_compatible_vector<T>::get(value), name)
+    {
+    }
+
+    layout_compatible_use_type(std::vector<T> const & value,
+        std::size_t begin, std::size_t * end,
+        std::string const & name = std::string())
+        : use_type<base_type>(
+            layout_compatible_vector<T>::get(value), begin, end, name)
+    {
+    }
+
+    layout_compatible_use_type(std::vector<T> const & value,
+        std::vector<indicator> const & ind,
+        std::string const & name = std::string())
+        : use_type<base_type>(
+            layout_compatible_vector<T>::get(value), ind, name)
+    {
+    }
+
+    layout_compatible_use_type(std::vector<T> const & value,
+        std::vector<indicator> const & ind,
+        std::size_t begin, std::size_t * end,
+        std::string const & name = std::string())
+        : use_type<base_type>(
+            layout_compatible_vector<T>::get(value), ind, begin, end, name)
+    {
+    }
+};
+
+// Vector elements for the user types, which avoid all conversions for the
+// types layout compatible with their base type.
+
+template <typename T, bool LayoutCompatible = is_layout_compatible_with_base<T>::value>
+struct conversion_vector_elements
+{
+    typedef conversion_into_type<std::vector<T> > into_element;
+    typedef conversion_use_type<std::vector<T> > use_element;
+};
+
+template <typename T>
+struct conversion_vector_elements<T, true>
+{
+    typedef layout_compatible_into_type<T> into_element;
+    typedef layout_compatible_use_type<T> use_element;
+};
+
+// Elements used for the user types, which are different for the types mapped
+// to values (see values-exchange.h) or to their fields (see struct-mapping.h).
+
+template <typename T, typename Base = typename type_conversion<T>::base_type>
+struct conversion_elements
+{
+    typedef conversion_into_type<T> into_element;
+    typedef conversion_use_type<T> use_element;
+    typedef typename conversion_vector_elements<T>::into_element
+        vector_into_element;
+    typedef typename conversion_vector_elements<T>::use_element
+        vector_use_element;
+};
+
 template <typename T>
 into_type_ptr do_into(T & t, user_type_tag)
 {
-    return into_type_ptr(new conversion_into_type<T>(t));
+    return into_type_ptr(new typename conversion_elements<T>::into_element(t));
+}
+
+template <typename T>
+into_type_ptr do_into(std::vector<T> & t, user_type_tag)
+{
+    return into_type_ptr(
+        new typename conversion_elements<T>::vector_into_element(t));
+}
+
+template <typename T>
+into_type_ptr do_into(std::vector<T> & t, std::vector<indicator> & ind,
+    user_type_tag)
+{
+    return into_type_ptr(
+        new typename conversion_elements<T>::vector_into_element(t, ind));
 }
 
 template <typename T>
 into_type_ptr do_into(T & t, indicator & ind, user_type_tag)
 {
-    return into_type_ptr(new conversion_into_type<T>(t, ind));
+    return into_type_ptr(
+        new typename conversion_elements<T>::into_element(t, ind));
 }
 
 template <typename T>
@@ -427,7 +583,7 @@ into_type_ptr do_into(std::vector<T> & t,
     std::size_t begin, size_t * end, user_type_tag)
 {
     return into_type_ptr(
-        new conversion_into_type<std::vector<T> >(t, begin, end));
+        new typename conversion_elements<T>::vector_into_element(t, begin, end));
 }
 
 template <typename T>
@@ -435,33 +591,68 @@ into_type_ptr do_into(std::vector<T> & t, std::vector<indicator> & ind,
     std::size_t begin, size_t * end, user_type_tag)
 {
     return into_type_ptr(
-        new conversion_into_type<std::vector<T> >(t, ind, begin, end));
+        new typename conversion_elements<T>::vector_into_element(t, ind, begin, end));
 }
 
 template <typename T>
 use_type_ptr do_use(T & t, std::string const & name, user_type_tag)
 {
-    return use_type_ptr(new conversion_use_type<T>(t, name));
+    return use_type_ptr(
+        new typename conversion_elements<T>::use_element(t, name));
 }
 
 template <typename T>
 use_type_ptr do_use(T const & t, std::string const & name, user_type_tag)
 {
-    return use_type_ptr(new conversion_use_type<T>(t, name));
+    return use_type_ptr(
+        new typename conversion_elements<T>::use_element(t, name));
+}
+
+template <typename T>
+use_type_ptr do_use(std::vector<T> & t, std::string const & name, user_type_tag)
+{
+    return use_type_ptr(
+        new typename conversion_elements<T>::vector_use_element(t, name));
+}
+
+template <typename T>
+use_type_ptr do_use(std::vector<T> const & t, std::string const & name,
+    user_type_tag)
+{
+    return use_type_ptr(
+        new typename conversion_elements<T>::vector_use_element(t, name));
+}
+
+template <typename T>
+use_type_ptr do_use(std::vector<T> & t, std::vector<indicator> & ind,
+    std::string const & name, user_type_tag)
+{
+    return use_type_ptr(
+        new typename conversion_elements<T>::vector_use_element(t, ind, name));
+}
+
+template <typename T>
+use_type_ptr do_use(std::vector<T> const & t, std::vector<indicator> & ind,
+    std::string const & name, user_type_tag)
+{
+    return use_type_ptr(
+        new typename conversion_elements<T>::vector_use_element(t, ind, name));
 }
 
 template <typename T>
 use_type_ptr do_use(T & t, indicator & ind,
     std::string const & name, user_type_tag)
 {
-    return use_type_ptr(new conversion_use_type<T>(t, ind, name));
+    return use_type_ptr(
+        new typename conversion_elements<T>::use_element(t, ind, name));
 }
 
 template <typename T>
 use_type_ptr do_use(T const & t, indicator & ind,
     std::string const & name, user_type_tag)
 {
-    return use_type_ptr(new conversion_use_type<T>(t, ind, name));
+    return use_type_ptr(
+        new typename conversion_elements<T>::use_element(t, ind, name));
 }
 
 template <typename T>
@@ -470,7 +661,7 @@ use_type_ptr do_use(std::vector<T> & t,
     std::string const & name, user_type_tag)
 {
     return use_type_ptr(
-        new conversion_use_type<std::vector<T> >(t, begin, end, name));
+        new typename conversion_elements<T>::vector_use_element(t, begin, end, name));
 }
 
 template <typename T>
@@ -479,7 +670,7 @@ use_type_ptr do_use(const std::vector<T> & t,
     std::string const & name, user_type_tag)
 {
     return use_type_ptr(
-        new conversion_use_type<std::vector<T> >(t, begin, end, name));
+        new typename conversion_elements<T>::vector_use_element(t, begin, end, name));
 }
 
 template <typename T>
@@ -488,7 +679,7 @@ use_type_ptr do_use(std::vector<T> & t, std::vector<indicator> & ind,
     std::string const & name, user_type_tag)
 {
     return use_type_ptr(
-        new conversion_use_type<std::vector<T> >(t, ind, begin, end, name));
+        new typename conversion_elements<T>::vector_use_element(t, ind, begin, end, name));
 }
 
 template <typename T>
@@ -497,7 +688,7 @@ use_type_ptr do_use(const std::vector<T> & t, std::vector<indicator> & ind,
     std::string const & name, user_type_tag)
 {
     return use_type_ptr(
-        new conversion_use_type<std::vector<T> >(t, ind, begin, end, name));
+        new typename conversion_elements<T>::vector_use_element(t, ind, begin, end, name));
 }
 
 } // namespace details
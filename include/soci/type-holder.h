@@ -53,14 +53,25 @@ template <typename T>
 class type_holder : public holder
 {
 public:
-    type_holder(T * t) : t_(t) {}
-    ~type_holder() SOCI_OVERRIDE { delete t_; }
+    // The holder owns the value, unless it is used for a row fetched in
+    // bulk, in which case it refers to an element of the column vector.
+    type_holder(T * t, bool owned = true) : t_(t), owned_(owned) {}
+    ~type_holder() SOCI_OVERRIDE
+    {
+        if (owned_)
+        {
+            delete t_;
+        }
+    }
 
     template<typename TypeValue>
     TypeValue value() const { return *t_; }
 
+    void reset(T * t) { t_ = t; }
+
 private:
     T * t_;
+    bool owned_;
 };
 
 } // namespace details
@@ -21,6 +21,7 @@
 namespace soci { namespace details {
 
 class statement_impl;
+struct batched_value;
 
 // this is intended to be a base class for all classes that deal with
 // binding input data (and OUT PL/SQL variables)
@@ -38,6 +39,17 @@ public:
     virtual void clean_up() = 0;
 
     virtual std::size_t size() const = 0;  // returns the number of elements
+
+    // returns the size of the data, in bytes (used for instrumentation only)
+    virtual std::size_t get_data_size() const { return 0; }
+
+    // used by result_cache: append the value to the key of the cache entry
+    // or return false if it can't be used for caching
+    virtual bool append_cache_key(std::string & /* key */) { return false; }
+
+    // used by write batching: describe the single value to be copied into
+    // the batch or return false if it can't be batched
+    virtual bool get_batch_value(batched_value & /* value */) { return false; }
 };
 
 typedef type_ptr<use_type_base> use_type_ptr;
@@ -91,6 +103,9 @@ private:
     void post_use(bool gotData) SOCI_OVERRIDE;
     void clean_up() SOCI_OVERRIDE;
     std::size_t size() const SOCI_OVERRIDE { return 1; }
+    std::size_t get_data_size() const SOCI_OVERRIDE;
+    bool append_cache_key(std::string & key) SOCI_OVERRIDE;
+    bool get_batch_value(batched_value & value) SOCI_OVERRIDE;
 
     void* data_;
     exchange_type type_;
@@ -163,6 +178,7 @@ private:
     void post_use(bool) SOCI_OVERRIDE { /* nothing to do */ }
     void clean_up() SOCI_OVERRIDE;
     std::size_t size() const SOCI_OVERRIDE;
+    std::size_t get_data_size() const SOCI_OVERRIDE;
 
     void* data_;
     exchange_type type_;
@@ -12,6 +12,7 @@
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 #include "soci/row-exchange.h"
+#include "soci/type-conversion.h"
 // std
 #include <cstddef>
 #include <sstream>
@@ -104,7 +105,8 @@ private:
     SOCI_NOT_COPYABLE(use_type)
 };
 
-// this is not supposed to be used - no support for bulk ORM
+// this is not supposed to be used - bulk operations with values are only
+// supported for the user types, see bulk_values_use_type below
 template <>
 class use_type<std::vector<values> >
 {
@@ -135,7 +137,8 @@ private:
     SOCI_NOT_COPYABLE(into_type)
 };
 
-// this is not supposed to be used - no support for bulk ORM
+// this is not supposed to be used - bulk operations with values are only
+// supported for the user types, see bulk_values_into_type below
 template <>
 class into_type<std::vector<values> >
 {
@@ -143,6 +146,236 @@ private:
     into_type();
 };
 
+// Bulk operations with std::vector<T>, where T is mapped to values by its
+// type_conversion: instead of using a values object (and so allocating its
+// elements) for each row, all rows are converted into (or from) the columns
+// of a single values object, which are bound as the usual vector elements.
+
+template <typename T>
+class bulk_values_use_type : public use_type_base
+{
+public:
+    bulk_values_use_type(std::vector<T> const & v,
+        std::string const & /*name*/ = std::string())
+        : v_(v), ind_(NULL), begin_(0), end_(NULL)
+    {}
+
+    bulk_values_use_type(std::vector<T> const & v,
+        std::size_t begin, std::size_t * end,
+        std::string const & /*name*/ = std::string())
+        : v_(v), ind_(NULL), begin_(begin), end_(end)
+    {}
+
+    bulk_values_use_type(std::vector<T> const & v,
+        std::vector<indicator> const & ind,
+        std::string const & /*name*/ = std::string())
+        : v_(v), ind_(&ind), begin_(0), end_(NULL)
+    {}
+
+    bulk_values_use_type(std::vector<T> const & v,
+        std::vector<indicator> const & ind,
+        std::size_t begin, std::size_t * end,
+        std::string const & /*name*/ = std::string())
+        : v_(v), ind_(&ind), begin_(begin), end_(end)
+    {}
+
+    void bind(statement_impl & st, int & /*position*/) SOCI_OVERRIDE
+    {
+        std::size_t const sz = size();
+        if (sz == 0)
+        {
+            throw soci_error("Vectors of size 0 are not allowed.");
+        }
+
+        // the columns are defined by the values set for the first row
+        values_.bulkState_ = values::bulk_columns;
+        values_.resize_columns(sz);
+        convert_to_base(0);
+        values_.bulkState_ = values::bulk_rows;
+
+        for (std::size_t i = 0; i != values_.columns_.size(); ++i)
+        {
+            use_type_base * const u = values_.columns_[i]->make_use();
+            try
+            {
+                if (st.bind_values_column(u) == false)
+                {
+                    delete u;
+                }
+            }
+            catch (...)
+            {
+                delete u;
+                throw;
+            }
+        }
+    }
+
+    std::string get_name() const SOCI_OVERRIDE
+    {
+        std::ostringstream oss;
+
+        oss << "(";
+
+        std::size_t const num_columns = values_.get_number_of_columns();
+        for (std::size_t n = 0; n < num_columns; ++n)
+        {
+            if (n != 0)
+                oss << ", ";
+
+            oss << values_.get_properties(n).get_name();
+        }
+
+        oss << ")";
+
+        return oss.str();
+    }
+
+    void dump_value(std::ostream& os) const SOCI_OVERRIDE
+    {
+        os << "<vector of values>";
+    }
+
+    void pre_exec(int /* num */) SOCI_OVERRIDE {}
+
+    void pre_use() SOCI_OVERRIDE
+    {
+        std::size_t const sz = size();
+        values_.resize_columns(sz);
+
+        for (std::size_t i = 0; i != sz; ++i)
+        {
+            convert_to_base(i);
+        }
+    }
+
+    void post_use(bool /*gotData*/) SOCI_OVERRIDE {}
+    void clean_up() SOCI_OVERRIDE { values_.clean_up(); }
+
+    std::size_t size() const SOCI_OVERRIDE
+    {
+        return end_ != NULL ? *end_ - begin_ : v_.size();
+    }
+
+private:
+    void convert_to_base(std::size_t row)
+    {
+        values_.start_bulk_row(row);
+
+        // the whole values can't be NULL, the indicator is ignored
+        indicator ind = ind_ != NULL ? (*ind_)[begin_ + row] : i_ok;
+        type_conversion<T>::to_base(v_[begin_ + row], values_, ind);
+    }
+
+    std::vector<T> const & v_;
+    std::vector<indicator> const * ind_;
+    std::size_t begin_;
+    std::size_t * end_;
+
+    values values_;
+
+    SOCI_NOT_COPYABLE(bulk_values_use_type)
+};
+
+template <typename T>
+class bulk_values_into_type : public into_type_base
+{
+public:
+    bulk_values_into_type(std::vector<T> & v,
+        std::size_t begin = 0, std::size_t * end = NULL)
+        : v_(v), ind_(NULL), begin_(begin), end_(end)
+    {}
+
+    bulk_values_into_type(std::vector<T> & v, std::vector<indicator> & ind,
+        std::size_t begin = 0, std::size_t * end = NULL)
+        : v_(v), ind_(&ind), begin_(begin), end_(end)
+    {}
+
+    void define(statement_impl & st, int & /*position*/) SOCI_OVERRIDE
+    {
+        values_.bulkState_ = values::bulk_rows;
+        st.set_bulk_values(&values_);
+
+        // the columns are created by the row description performed as part
+        // of the statement execution, just as for row
+    }
+
+    void pre_exec(int /* num */) SOCI_OVERRIDE {}
+    void pre_fetch() SOCI_OVERRIDE {}
+
+    void post_fetch(bool gotData, bool /* calledFromFetch */) SOCI_OVERRIDE
+    {
+        if (gotData == false)
+        {
+            return;
+        }
+
+        std::size_t const sz = size();
+        for (std::size_t i = 0; i != sz; ++i)
+        {
+            values_.start_bulk_row(i);
+
+            // here we ignore the possibility the the whole object might be
+            // NULL, just as into_type<values> does
+            indicator ind = i_ok;
+            type_conversion<T>::from_base(values_, ind, v_[begin_ + i]);
+            if (ind_ != NULL)
+            {
+                (*ind_)[begin_ + i] = ind;
+            }
+        }
+    }
+
+    void clean_up() SOCI_OVERRIDE { values_.clean_up(); }
+
+    std::size_t size() const SOCI_OVERRIDE
+    {
+        // the user might have resized the vector in the meantime,
+        // so keep the columns of the same size
+        std::size_t const sz = end_ != NULL ? *end_ - begin_ : v_.size();
+        values_.resize_columns(sz);
+
+        return sz;
+    }
+
+    void resize(std::size_t sz) SOCI_OVERRIDE
+    {
+        if (end_ != NULL)
+        {
+            *end_ = begin_ + sz;
+        }
+        else
+        {
+            v_.resize(sz);
+            if (ind_ != NULL)
+            {
+                ind_->resize(sz);
+            }
+        }
+
+        values_.resize_columns(sz);
+    }
+
+private:
+    std::vector<T> & v_;
+    std::vector<indicator> * ind_;
+    std::size_t begin_;
+    std::size_t * end_;
+
+    values values_;
+
+    SOCI_NOT_COPYABLE(bulk_values_into_type)
+};
+
+template <typename T>
+struct conversion_elements<T, values>
+{
+    typedef conversion_into_type<T> into_element;
+    typedef conversion_use_type<T> use_element;
+    typedef bulk_values_into_type<T> vector_into_element;
+    typedef bulk_values_use_type<T> vector_use_element;
+};
+
 } // namespace details
 
 } // namespace soci
@@ -12,10 +12,12 @@
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 // std
+#include <cctype>
 #include <cstddef>
 #include <map>
 #include <sstream>
 #include <string>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -39,6 +41,68 @@ struct copy_holder : public copy_base
     T value_;
 };
 
+// Column of the values used for a bulk operation: contains the values of
+// this column and their indicators for all the rows of the operation.
+class values_column_base
+{
+public:
+    explicit values_column_base(column_properties const & props)
+        : props_(props), name_(props.get_name()) {}
+    virtual ~values_column_base() {}
+
+    column_properties const & get_properties() const { return props_; }
+    void set_properties(column_properties const & props)
+    {
+        props_ = props;
+        name_ = props.get_name();
+    }
+
+    // This is the same as get_properties().get_name(), but doesn't copy the
+    // name, as it's used for every row.
+    std::string const & get_name() const { return name_; }
+
+    virtual void resize(std::size_t sz) = 0;
+
+    // Creates the use element for inserting or updating this column.
+    virtual use_type_base * make_use() = 0;
+
+    std::vector<indicator> indicators_;
+
+private:
+    column_properties props_;
+    std::string name_;
+};
+
+template <typename T>
+class values_column : public values_column_base
+{
+public:
+    values_column(column_properties const & props, std::size_t sz)
+        : values_column_base(props), values_(sz)
+    {
+        indicators_.resize(sz, i_null);
+    }
+
+    void resize(std::size_t sz) SOCI_OVERRIDE
+    {
+        values_.resize(sz);
+        indicators_.resize(sz, i_null);
+    }
+
+    use_type_base * make_use() SOCI_OVERRIDE
+    {
+        return new use_type<std::vector<T> >(values_, indicators_, get_name());
+    }
+
+    std::vector<T> values_;
+};
+
+template <typename T>
+class bulk_values_into_type;
+
+template <typename T>
+class bulk_values_use_type;
+
 } // namespace details
 
 class SOCI_DECL values
@@ -47,9 +111,18 @@ class SOCI_DECL values
     friend class details::into_type<values>;
     friend class details::use_type<values>;
 
+    template <typename T>
+    friend class details::bulk_values_into_type;
+
+    template <typename T>
+    friend class details::bulk_values_use_type;
+
 public:
 
-    values() : row_(NULL), currentPos_(0), uppercaseColumnNames_(false) {}
+    values()
+        : row_(NULL), currentPos_(0), uppercaseColumnNames_(false),
+          bulkState_(bulk_none), bulkRow_(0), bulkSize_(0)
+    {}
 
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const & name) const;
@@ -61,6 +134,10 @@ public:
         {
             return row_->get<T>(pos);
         }
+        else if (bulkState_ != bulk_none)
+        {
+            return get_from_column<T>(get_column(pos), NULL);
+        }
         else if (*indicators_[pos] != i_null)
         {
             return get_from_uses<T>(pos);
@@ -82,6 +159,10 @@ public:
         {
             return row_->get<T>(pos, nullValue);
         }
+        else if (bulkState_ != bulk_none)
+        {
+            return get_from_column<T>(get_column(pos), &nullValue);
+        }
         else if (*indicators_[pos] == i_null)
         {
             return nullValue;
@@ -95,15 +176,31 @@ public:
     template <typename T>
     T get(std::string const & name) const
     {
-        return row_ != NULL ? row_->get<T>(name) : get_from_uses<T>(name);
+        if (row_ != NULL)
+        {
+            return row_->get<T>(name);
+        }
+        else if (bulkState_ != bulk_none)
+        {
+            return get_from_column<T>(get_column(name), NULL);
+        }
+
+        return get_from_uses<T>(name);
     }
 
     template <typename T>
     T get(std::string const & name, T const & nullValue) const
     {
-        return row_ != NULL
-            ? row_->get<T>(name, nullValue)
-            : get_from_uses<T>(name, nullValue);
+        if (row_ != NULL)
+        {
+            return row_->get<T>(name, nullValue);
+        }
+        else if (bulkState_ != bulk_none)
+        {
+            return get_from_column<T>(get_column(name), &nullValue);
+        }
+
+        return get_from_uses<T>(name, nullValue);
     }
 
     template <typename T>
@@ -116,6 +213,11 @@ public:
 
             *row_ >> value;
         }
+        else if (bulkState_ != bulk_none)
+        {
+            value = get_from_column<T>(get_column(currentPos_), NULL);
+            ++currentPos_;
+        }
         else if (*indicators_[currentPos_] != i_null)
         {
             // if there is no row object, then the data can be
@@ -165,6 +267,12 @@ public:
     template <typename T>
     void set(std::string const & name, T const & value, indicator indic = i_ok)
     {
+        if (bulkState_ != bulk_none)
+        {
+            set_in_column(name, value, indic);
+            return;
+        }
+
         typedef typename type_conversion<T>::base_type base_type;
         if (index_.find(name) == index_.end())
         {
@@ -200,6 +308,12 @@ public:
     template <typename T>
     void set(const T & value, indicator indic = i_ok)
     {
+        if (bulkState_ != bulk_none)
+        {
+            set_in_column(std::string(), value, indic);
+            return;
+        }
+
         indicator * pind = new indicator(indic);
         indicators_.push_back(pind);
 
@@ -229,7 +343,12 @@ public:
 
     std::size_t get_number_of_columns() const
     {
-        return row_ ? row_->size() : 0;
+        if (row_ != NULL)
+        {
+            return row_->size();
+        }
+
+        return bulkState_ != bulk_none ? columns_.size() : 0;
     }
 
     column_properties const& get_properties(std::size_t pos) const;
@@ -250,6 +369,22 @@ private:
 
     bool uppercaseColumnNames_;
 
+    // The values used for a bulk operation with std::vector<T>, where T is
+    // mapped to values, are stored in the columns containing the values of
+    // all rows and get() and set() access the current row of these columns
+    // instead of row_ or uses_.
+    enum bulk_state
+    {
+        bulk_none,      // not used for a bulk operation
+        bulk_columns,   // the columns are created by set() for the first row
+        bulk_rows       // the columns are already defined
+    };
+
+    std::vector<details::values_column_base *> columns_;
+    bulk_state bulkState_;
+    std::size_t bulkRow_;
+    mutable std::size_t bulkSize_;
+
     // When type_conversion::to() is called, a values object is created
     // without an underlying row object.  In that case, get_from_uses()
     // returns the underlying field values
@@ -307,6 +442,189 @@ private:
         }
     }
 
+    details::values_column_base const & get_column(std::size_t pos) const
+    {
+        if (pos >= columns_.size())
+        {
+            std::ostringstream msg;
+            msg << "Column at position "
+                << static_cast<unsigned long>(pos)
+                << " not found";
+            throw soci_error(msg.str());
+        }
+
+        return *columns_[pos];
+    }
+
+    details::values_column_base const & get_column(std::string const & name) const
+    {
+        std::map<std::string, std::size_t>::const_iterator pos = index_.find(name);
+        if (pos == index_.end())
+        {
+            throw soci_error("Column '" + name + "' not found");
+        }
+
+        return *columns_[pos->second];
+    }
+
+    // Just as row::get(), throws std::bad_cast if the column type is not the
+    // base type of T.
+    template <typename T>
+    T get_from_column(details::values_column_base const & column,
+        T const * nullValue) const
+    {
+        typedef typename type_conversion<T>::base_type base_type;
+
+        details::values_column<base_type> const * const c =
+            dynamic_cast<details::values_column<base_type> const *>(&column);
+        if (c == NULL)
+        {
+            throw std::bad_cast();
+        }
+
+        indicator ind = c->indicators_[bulkRow_];
+        if (ind == i_null)
+        {
+            if (nullValue != NULL)
+            {
+                return *nullValue;
+            }
+
+            throw soci_error("Column '" + column.get_name() +
+                "' contains NULL value and no default was provided");
+        }
+
+        T value;
+        type_conversion<T>::from_base(c->values_[bulkRow_], ind, value);
+        return value;
+    }
+
+    // Stores the value in the column with the given name, or the next column
+    // if the name is empty, at the current row.
+    template <typename T>
+    void set_in_column(std::string const & name, T const & value,
+        indicator indic)
+    {
+        typedef typename type_conversion<T>::base_type base_type;
+
+        // The columns are almost always set in the same order for all rows,
+        // so check the next one first to avoid looking up the name.
+        std::size_t pos = currentPos_;
+        if (pos >= columns_.size() ||
+            (name.empty() == false && columns_[pos]->get_name() != name))
+        {
+            std::map<std::string, std::size_t>::const_iterator const
+                it = name.empty() ? index_.end() : index_.find(name);
+            if (it != index_.end())
+            {
+                pos = it->second;
+            }
+            else if (bulkState_ == bulk_columns)
+            {
+                pos = columns_.size();
+
+                column_properties props;
+                props.set_name(name);
+                columns_.push_back(
+                    new details::values_column<base_type>(props, bulkSize_));
+
+                if (name.empty() == false)
+                {
+                    index_.insert(std::make_pair(name, pos));
+                }
+            }
+            else
+            {
+                std::ostringstream msg;
+                msg << "Value ";
+                if (name.empty())
+                {
+                    msg << "at position " << static_cast<unsigned long>(pos);
+                }
+                else
+                {
+                    msg << "named " << name;
+                }
+                msg << " was not set for the first row of the bulk operation";
+                throw soci_error(msg.str());
+            }
+        }
+
+        details::values_column<base_type> * const column =
+            dynamic_cast<details::values_column<base_type> *>(columns_[pos]);
+        if (column == NULL)
+        {
+            throw soci_error("Value named " + columns_[pos]->get_name() +
+                " was set using a different type for the first row"
+                " of the bulk operation");
+        }
+
+        indicator & ind = column->indicators_[bulkRow_];
+        ind = indic;
+        if (indic == i_ok)
+        {
+            type_conversion<T>::to_base(value, column->values_[bulkRow_], ind);
+        }
+
+        currentPos_ = pos + 1;
+    }
+
+    // these are called by statement_impl::describe() for the values used
+    // for a bulk select
+    template <typename T>
+    details::values_column<T> & add_column()
+    {
+        details::values_column<T> * const column =
+            new details::values_column<T>(column_properties(), bulkSize_);
+        columns_.push_back(column);
+
+        return *column;
+    }
+
+    void add_column_properties(column_properties const & props)
+    {
+        std::string columnName = props.get_name();
+        if (uppercaseColumnNames_)
+        {
+            for (std::size_t i = 0; i != columnName.size(); ++i)
+            {
+                columnName[i] = static_cast<char>(std::toupper(columnName[i]));
+            }
+        }
+
+        column_properties columnProps(props);
+        columnProps.set_name(columnName);
+
+        columns_.back()->set_properties(columnProps);
+        index_[columnName] = columns_.size() - 1;
+    }
+
+    void start_bulk_row(std::size_t row)
+    {
+        bulkRow_ = row;
+        currentPos_ = 0;
+    }
+
+    void resize_columns(std::size_t sz) const
+    {
+        bulkSize_ = sz;
+        for (std::size_t i = 0; i != columns_.size(); ++i)
+        {
+            columns_[i]->resize(sz);
+        }
+    }
+
+    void clear_columns()
+    {
+        for (std::size_t i = 0; i != columns_.size(); ++i)
+        {
+            delete columns_[i];
+        }
+
+        columns_.clear();
+        index_.clear();
+    }
+
     row& get_row()
     {
         row_ = new row();
@@ -343,6 +661,11 @@ private:
         {
             delete deepCopies_[i];
         }
+
+        if (bulkState_ != bulk_none)
+        {
+            clear_columns();
+        }
     }
 };
 
@@ -144,6 +144,20 @@ db2_statement_backend::execute(int  number )
     }
 
     cliRC = SQLExecute(hStmt);
+
+    // send the values of the parameters bound for data at execution time
+    while (cliRC == SQL_NEED_DATA)
+    {
+        SQLPOINTER token;
+        cliRC = SQLParamData(hStmt, &token);
+        if (cliRC == SQL_NEED_DATA)
+        {
+            db2_vector_use_type_backend * const * const p =
+                static_cast<db2_vector_use_type_backend * const *>(token);
+            (*p)->put_data(static_cast<std::size_t>(p - &(*p)->dataAtExecTokens[0]));
+        }
+    }
+
     if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO && cliRC != SQL_NO_DATA)
     {
         throw db2_soci_error(db2_soci_error::sqlState("Statement execution error",SQL_HANDLE_STMT,hStmt),cliRC);
@@ -26,6 +26,15 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace
+{
+
+// Maximal number of bytes which may be wasted by padding strings to the
+// length of the longest one before sending them at execution time instead.
+std::size_t const max_padding_size = 64 * 1024;
+
+} // namespace anonymous
+
 void db2_vector_use_type_backend::prepare_indicators(std::size_t size)
 {
     if (size == 0)
@@ -40,6 +49,8 @@ void db2_vector_use_type_backend::prepare_indicators(std::size_t size)
 void db2_vector_use_type_backend::prepare_for_bind(void *&data, SQLUINTEGER &size,
     SQLSMALLINT &sqlType, SQLSMALLINT &cType)
 {
+    dataAtExec = false;
+
     switch (type)
     {    // simple cases
     case x_short:
@@ -110,9 +121,9 @@ void db2_vector_use_type_backend::prepare_for_bind(void *&data, SQLUINTEGER &siz
             prepare_indicators(vsize);
 
             size = sizeof(char) * 2;
-            buf = new char[size * vsize];
+            buf.resize(size * vsize);
 
-            char *pos = buf;
+            char *pos = &buf[0];
 
             for (std::size_t i = 0; i != vsize; ++i)
             {
@@ -122,7 +133,7 @@ void db2_vector_use_type_backend::prepare_for_bind(void *&data, SQLUINTEGER &siz
 
             sqlType = SQL_CHAR;
             cType = SQL_C_CHAR;
-            data = buf;
+            data = &buf[0];
         }
         break;
     case x_stdstring:
@@ -135,6 +146,7 @@ void db2_vector_use_type_backend::prepare_for_bind(void *&data, SQLUINTEGER &siz
             std::vector<std::string> &v(*vp);
 
             std::size_t maxSize = 0;
+            std::size_t totalSize = 0;
             std::size_t const vecSize = v.size();
             prepare_indicators(vecSize);
             for (std::size_t i = 0; i != vecSize; ++i)
@@ -142,22 +154,43 @@ void db2_vector_use_type_backend::prepare_for_bind(void *&data, SQLUINTEGER &siz
                 std::size_t sz = v[i].length();
                 indVec[i] = static_cast<long>(sz);
                 maxSize = sz > maxSize ? sz : maxSize;
+                totalSize += sz + 1;
             }
 
             maxSize++; // For terminating nul.
 
-            buf = new char[maxSize * vecSize];
-            memset(buf, 0, maxSize * vecSize);
+            // Padding all strings to the longest one can waste a lot of
+            // memory when their lengths vary, so send them at execution time
+            // instead of copying them if too much space would be wasted.
+            dataAtExec = maxSize * vecSize - totalSize > max_padding_size;
 
-            char *pos = buf;
-            for (std::size_t i = 0; i != vecSize; ++i)
+            if (dataAtExec)
             {
-                memcpy(pos, v[i].c_str(), v[i].length());
-                pos += maxSize;
+                for (std::size_t i = 0; i != vecSize; ++i)
+                {
+                    indVec[i] = SQL_DATA_AT_EXEC;
+                }
+
+                dataAtExecTokens.assign(vecSize, this);
+
+                data = &dataAtExecTokens[0];
+                size = static_cast<SQLUINTEGER>(maxSize - 1);
             }
+            else
+            {
+                buf.resize(maxSize * vecSize);
+
+                char *pos = &buf[0];
+                for (std::size_t i = 0; i != vecSize; ++i)
+                {
+                    memcpy(pos, v[i].c_str(), v[i].length());
+                    pos[v[i].length()] = '\0';
+                    pos += maxSize;
+                }
 
-            data = buf;
-            size = static_cast<SQLINTEGER>(maxSize);
+                data = &buf[0];
+                size = static_cast<SQLUINTEGER>(maxSize);
+            }
         }
         break;
     case x_stdtm:
@@ -165,13 +198,32 @@ void db2_vector_use_type_backend::prepare_for_bind(void *&data, SQLUINTEGER &siz
             std::vector<std::tm> *vp
                 = static_cast<std::vector<std::tm> *>(data);
 
-            prepare_indicators(vp->size());
+            std::vector<std::tm> &v(*vp);
+            std::size_t const vsize = v.size();
 
-            buf = new char[sizeof(TIMESTAMP_STRUCT) * vp->size()];
+            prepare_indicators(vsize);
+
+            buf.resize(sizeof(TIMESTAMP_STRUCT) * vsize);
+
+            char *pos = &buf[0];
+            for (std::size_t i = 0; i != vsize; ++i)
+            {
+                std::tm t = v[i];
+                TIMESTAMP_STRUCT * ts = reinterpret_cast<TIMESTAMP_STRUCT*>(pos);
+
+                ts->year = static_cast<SQLSMALLINT>(t.tm_year + 1900);
+                ts->month = static_cast<SQLUSMALLINT>(t.tm_mon + 1);
+                ts->day = static_cast<SQLUSMALLINT>(t.tm_mday);
+                ts->hour = static_cast<SQLUSMALLINT>(t.tm_hour);
+                ts->minute = static_cast<SQLUSMALLINT>(t.tm_min);
+                ts->second = static_cast<SQLUSMALLINT>(t.tm_sec);
+                ts->fraction = 0;
+                pos += sizeof(TIMESTAMP_STRUCT);
+            }
 
             sqlType = SQL_TYPE_TIMESTAMP;
             cType = SQL_C_TYPE_TIMESTAMP;
-            data = buf;
+            data = &buf[0];
             size = 19; // This number is not the size in bytes, but the number
                       // of characters in the date if it was written out
                       // yyyy-mm-dd hh:mm:ss
@@ -193,23 +245,9 @@ void db2_vector_use_type_backend::bind_helper(int &position, void *data, details
     this->data = data; // for future reference
     this->type = type; // for future reference
 
-    SQLSMALLINT sqlType;
-    SQLSMALLINT cType;
-    SQLUINTEGER size;
-
-    prepare_for_bind(data, size, sqlType, cType);
-
-    SQLINTEGER arraySize = (SQLINTEGER)indVec.size();
-    SQLSetStmtAttr(statement_.hStmt, SQL_ATTR_PARAMSET_SIZE, db2::int_as_ptr(arraySize), 0);
-
-    SQLRETURN cliRC = SQLBindParameter(statement_.hStmt, static_cast<SQLUSMALLINT>(position++),
-                                    SQL_PARAM_INPUT, cType, sqlType, size, 0,
-                                    static_cast<SQLPOINTER>(data), size, indptr);
-
-    if ( cliRC != SQL_SUCCESS )
-    {
-        throw db2_soci_error("Error while binding value to column", cliRC);
-    }
+    // The parameter is actually bound in pre_use() as the vector may change
+    // between the executions of the statement.
+    this->position = position++;
 }
 
 void db2_vector_use_type_backend::bind_by_pos(int &position,
@@ -262,35 +300,17 @@ void db2_vector_use_type_backend::bind_by_name(
 void db2_vector_use_type_backend::pre_use(indicator const *ind)
 {
     // first deal with data
-    if (type == x_stdtm)
-    {
-        std::vector<std::tm> *vp
-             = static_cast<std::vector<std::tm> *>(data);
-
-        std::vector<std::tm> &v(*vp);
+    SQLSMALLINT sqlType;
+    SQLSMALLINT cType;
+    SQLUINTEGER size;
 
-        char *pos = buf;
-        std::size_t const vsize = v.size();
-        for (std::size_t i = 0; i != vsize; ++i)
-        {
-            std::tm t = v[i];
-            TIMESTAMP_STRUCT * ts = reinterpret_cast<TIMESTAMP_STRUCT*>(pos);
-
-            ts->year = static_cast<SQLSMALLINT>(t.tm_year + 1900);
-            ts->month = static_cast<SQLUSMALLINT>(t.tm_mon + 1);
-            ts->day = static_cast<SQLUSMALLINT>(t.tm_mday);
-            ts->hour = static_cast<SQLUSMALLINT>(t.tm_hour);
-            ts->minute = static_cast<SQLUSMALLINT>(t.tm_min);
-            ts->second = static_cast<SQLUSMALLINT>(t.tm_sec);
-            ts->fraction = 0;
-            pos += sizeof(TIMESTAMP_STRUCT);
-        }
-    }
+    void *bindData = data;
+    prepare_for_bind(bindData, size, sqlType, cType);
 
     // then handle indicators
     if (ind != NULL)
     {
-        std::size_t const vsize = size();
+        std::size_t const vsize = indVec.size();
         for (std::size_t i = 0; i != vsize; ++i, ++ind)
         {
             if (*ind == i_null)
@@ -310,7 +330,7 @@ void db2_vector_use_type_backend::pre_use(indicator const *ind)
     else
     {
         // no indicators - treat all fields as OK
-        std::size_t const vsize = size();
+        std::size_t const vsize = indVec.size();
         for (std::size_t i = 0; i != vsize; ++i)
         {
             // for strings we have already set the values
@@ -320,6 +340,40 @@ void db2_vector_use_type_backend::pre_use(indicator const *ind)
             }
         }
     }
+
+    SQLINTEGER arraySize = (SQLINTEGER)indVec.size();
+    SQLSetStmtAttr(statement_.hStmt, SQL_ATTR_PARAMSET_SIZE, db2::int_as_ptr(arraySize), 0);
+
+    // when sending data at execution time, the buffer contains the tokens
+    SQLLEN const bufferLength = dataAtExec
+        ? static_cast<SQLLEN>(sizeof(db2_vector_use_type_backend*))
+        : static_cast<SQLLEN>(size);
+
+    SQLRETURN cliRC = SQLBindParameter(statement_.hStmt, static_cast<SQLUSMALLINT>(position),
+                                    SQL_PARAM_INPUT, cType, sqlType, size, 0,
+                                    static_cast<SQLPOINTER>(bindData), bufferLength, indptr);
+
+    if ( cliRC != SQL_SUCCESS )
+    {
+        throw db2_soci_error("Error while binding value to column", cliRC);
+    }
+}
+
+void db2_vector_use_type_backend::put_data(std::size_t row)
+{
+    std::vector<std::string> *vp
+        = static_cast<std::vector<std::string> *>(data);
+    std::string const &s = (*vp)[row];
+
+    SQLRETURN cliRC = SQLPutData(statement_.hStmt,
+                                 const_cast<char *>(s.c_str()),
+                                 static_cast<SQLLEN>(s.length()));
+
+    if (cliRC != SQL_SUCCESS && cliRC != SQL_SUCCESS_WITH_INFO)
+    {
+        throw db2_soci_error(db2_soci_error::sqlState("Error while sending parameter data",
+            SQL_HANDLE_STMT, statement_.hStmt), cliRC);
+    }
 }
 
 std::size_t db2_vector_use_type_backend::size()
@@ -394,9 +448,6 @@ std::size_t db2_vector_use_type_backend::size()
 
 void db2_vector_use_type_backend::clean_up()
 {
-    if (buf != NULL)
-    {
-        delete [] buf;
-        buf = NULL;
-    }
+    std::vector<char>().swap(buf);
+    std::vector<db2_vector_use_type_backend*>().swap(dataAtExecTokens);
 }
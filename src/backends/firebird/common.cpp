@@ -8,6 +8,7 @@
 #include "soci/soci-platform.h"
 #include "firebird/common.h"
 #include "soci/soci-backend.h"
+#include "soci-text-codec.h"
 #include <ibase.h> // FireBird
 #include <cstddef>
 #include <cstring>
@@ -46,6 +47,17 @@ char * allocBuffer(XSQLVAR* var)
     return new char[size];
 }
 
+std::size_t getDataSize(XSQLVAR const * var)
+{
+    std::size_t size = var->sqllen;
+    if ((var->sqltype & ~1) == SQL_VARYING)
+    {
+        size += sizeof(short);
+    }
+
+    return size;
+}
+
 void tmEncode(short type, std::tm * src, void * dst)
 {
     switch (type & ~1)
@@ -133,46 +145,12 @@ void setTextParam(char const * s, std::size_t size, char * buf_,
         parse_decimal<long long, unsigned long long>(buf_, var, s);
     }
     else if (sqltype == SQL_TIMESTAMP
-            || sqltype == SQL_TYPE_DATE)
-    {
-        unsigned short year, month, day, hour, min, sec;
-        if (std::sscanf(s, "%hu-%hu-%hu %hu:%hu:%hu",
-                    &year, &month, &day, &hour, &min, &sec) != 6)
-        {
-            if (std::sscanf(s, "%hu-%hu-%huT%hu:%hu:%hu",
-                        &year, &month, &day, &hour, &min, &sec) != 6)
-            {
-                hour = min = sec = 0;
-                if (std::sscanf(s, "%hu-%hu-%hu", &year, &month, &day) != 3)
-                {
-                    throw soci_error("Could not parse timestamp value.");
-                }
-            }
-        }
-        std::tm t;
-        std::memset(&t, 0, sizeof(t));
-        t.tm_year = year - 1900;
-        t.tm_mon = month - 1;
-        t.tm_mday = day;
-        t.tm_hour = hour;
-        t.tm_min = min;
-        t.tm_sec = sec;
-        std::memcpy(buf_, &t, sizeof(t));
-        tmEncode(var->sqltype, &t, buf_);
-    }
-    else if (sqltype == SQL_TYPE_TIME)
+            || sqltype == SQL_TYPE_DATE
+            || sqltype == SQL_TYPE_TIME)
     {
-        unsigned short hour, min, sec;
-        if (std::sscanf(s, "%hu:%hu:%hu", &hour, &min, &sec) != 3)
-        {
-            throw soci_error("Could not parse timestamp value.");
-        }
         std::tm t;
         std::memset(&t, 0, sizeof(t));
-        t.tm_hour = hour;
-        t.tm_min = min;
-        t.tm_sec = sec;
-        std::memcpy(buf_, &t, sizeof(t));
+        parse_std_tm(s, t);
         tmEncode(var->sqltype, &t, buf_);
     }
     else
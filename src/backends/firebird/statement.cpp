@@ -8,7 +8,11 @@
 #define SOCI_FIREBIRD_SOURCE
 #include "soci/firebird/soci-firebird.h"
 #include "firebird/error-firebird.h"
+#include "firebird/common.h"
+#include <algorithm>
 #include <cctype>
+#include <climits>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 
@@ -19,7 +23,8 @@ using namespace soci::details::firebird;
 firebird_statement_backend::firebird_statement_backend(firebird_session_backend &session)
     : session_(session), stmtp_(0), sqldap_(NULL), sqlda2p_(NULL),
         boundByName_(false), boundByPos_(false), rowsFetched_(0), endOfRowSet_(false), rowsAffectedBulk_(-1LL),
-            intoType_(eStandard), useType_(eStandard), procedure_(false)
+            intoType_(eStandard), useType_(eStandard), procedure_(false),
+                stmtType_(0), rowsPerBlock_(-1)
 {}
 
 void firebird_statement_backend::prepareSQLDA(XSQLDA ** sqldap, short size)
@@ -51,6 +56,9 @@ void firebird_statement_backend::clean_up()
 {
     rowsAffectedBulk_ = -1LL;
 
+    freeBlock(blocks_[0]);
+    freeBlock(blocks_[1]);
+
     ISC_STATUS stat[stat_size];
 
     if (stmtp_ != 0)
@@ -234,6 +242,7 @@ void firebird_statement_backend::rewriteQuery(
 
     // get statement type
     int stType = statementType(tmpStmtp);
+    stmtType_ = stType;
 
     // free temporary prepared statement
     if (isc_dsql_free_statement(stat, &tmpStmtp, DSQL_drop))
@@ -293,11 +302,17 @@ void firebird_statement_backend::prepare(std::string const & query,
     // clear named parametes
     names_.clear();
 
+    // blocks prepared for the previous query can't be reused
+    freeBlock(blocks_[0]);
+    freeBlock(blocks_[1]);
+    rowsPerBlock_ = -1;
+
     std::vector<char> queryBuffer;
 
     // modify query's syntax and prepare buffer for use with
     // firebird's api
     rewriteQuery(query, queryBuffer);
+    queryText_.assign(&queryBuffer[0]);
 
     ISC_STATUS stat[stat_size];
 
@@ -354,6 +369,178 @@ void firebird_statement_backend::prepare(std::string const & query,
     uses_.resize(0);
 }
 
+namespace
+{
+    // Return the number of rows affected by the last execution of the given
+    // statement.
+    long long getRowsAffected(isc_stmt_handle stmt)
+    {
+        ISC_STATUS_ARRAY stat;
+        char type_item[] = { isc_info_sql_records };
+        char res_buffer[256];
+
+        if (isc_dsql_sql_info(stat, &stmt, sizeof(type_item), type_item,
+                              sizeof(res_buffer), res_buffer))
+        {
+            throw_iscerror(stat);
+        }
+
+        // We must get back a isc_info_sql_records block, that we parse below,
+        // followed by isc_info_end.
+        if (res_buffer[0] != isc_info_sql_records)
+        {
+            throw soci_error("Can't determine the number of affected rows");
+        }
+
+        char* sql_rec_buf = res_buffer + 1;
+        const int length = isc_vax_integer(sql_rec_buf, 2);
+        sql_rec_buf += 2;
+
+        if (sql_rec_buf[length] != isc_info_end)
+        {
+            throw soci_error("Unexpected isc_info_sql_records return format");
+        }
+
+        // Examine the 4 sub-blocks each of which has a header indicating the
+        // block type, its value length in bytes and the value itself.
+        long long row_count = 0;
+
+        for ( char* p = sql_rec_buf; !row_count && p < sql_rec_buf + length; )
+        {
+            switch (*p++)
+            {
+                case isc_info_req_select_count:
+                case isc_info_req_insert_count:
+                case isc_info_req_update_count:
+                case isc_info_req_delete_count:
+                    {
+                        int len = isc_vax_integer(p, 2);
+                        p += 2;
+
+                        row_count += isc_vax_integer(p, static_cast<short>(len));
+                        p += len;
+                    }
+                    break;
+
+                case isc_info_end:
+                    break;
+
+                default:
+                    throw soci_error("Unknown record counter");
+            }
+        }
+
+        return row_count;
+    }
+
+    // Maximal number of rows grouped in a single EXECUTE BLOCK.
+    std::size_t const maxRowsPerBlock = 100;
+
+    // Firebird versions before 3.0 limit both the statement text and the
+    // input message to 64KiB, stay well below it.
+    std::size_t const maxBlockSize = 60000;
+
+    std::size_t alignedSize(std::size_t size)
+    {
+        return (size + 7) & ~static_cast<std::size_t>(7);
+    }
+
+    // Return the declaration of the EXECUTE BLOCK parameter of the same type
+    // as the given one or an empty string if it can't be declared.
+    std::string paramDeclaration(XSQLVAR const * var)
+    {
+        std::ostringstream decl;
+
+        switch (var->sqltype & ~1)
+        {
+        case SQL_TEXT:
+        case SQL_VARYING:
+            decl << ((var->sqltype & ~1) == SQL_TEXT ? "char(" : "varchar(")
+                << var->sqllen << ")";
+
+            // character set OCTETS (1) must be preserved for binary strings
+            if ((var->sqlsubtype & 0xff) == 1)
+            {
+                decl << " character set octets";
+            }
+            break;
+        case SQL_SHORT:
+        case SQL_LONG:
+        case SQL_INT64:
+            if (var->sqlscale < 0)
+            {
+                int const precision = (var->sqltype & ~1) == SQL_SHORT ? 4
+                    : (var->sqltype & ~1) == SQL_LONG ? 9 : 18;
+                decl << "numeric(" << precision << "," << -var->sqlscale << ")";
+            }
+            else
+            {
+                decl << ((var->sqltype & ~1) == SQL_SHORT ? "smallint"
+                    : (var->sqltype & ~1) == SQL_LONG ? "integer" : "bigint");
+            }
+            break;
+        case SQL_FLOAT:
+            decl << "float";
+            break;
+        case SQL_DOUBLE:
+            decl << "double precision";
+            break;
+        case SQL_TIMESTAMP:
+            decl << "timestamp";
+            break;
+        case SQL_TYPE_DATE:
+            decl << "date";
+            break;
+        case SQL_TYPE_TIME:
+            decl << "time";
+            break;
+        default:
+            // blobs and any other types are not supported
+            break;
+        }
+
+        return decl.str();
+    }
+
+    // Replace the question marks in the query (outside of quotes) with the
+    // names of the parameters corresponding to the given row, returns the
+    // number of replaced parameters.
+    int appendRowStatement(std::string const & query, std::size_t row,
+        std::string & dst)
+    {
+        char quote = '\0';
+        int position = 0;
+
+        for (std::string::const_iterator it = query.begin(), end = query.end();
+            it != end; ++it)
+        {
+            if (quote != '\0')
+            {
+                if (*it == quote)
+                {
+                    quote = '\0';
+                }
+            }
+            else if (*it == '\'' || *it == '"')
+            {
+                quote = *it;
+            }
+            else if (*it == '?')
+            {
+                std::ostringstream name;
+                name << ":p" << row << "_" << position++;
+                dst += name.str();
+                continue;
+            }
+
+            dst += *it;
+        }
+
+        dst += ";\n";
+
+        return position;
+    }
+}
 
 namespace
 {
@@ -411,10 +598,16 @@ firebird_statement_backend::execute(int number)
     {
         long long rowsAffectedBulkTemp = 0;
 
-        // Here we have to explicitly loop to achieve the
-        // effect of inserting or updating with vector use elements.
         std::size_t rows = static_cast<firebird_vector_use_type_backend*>(uses_[0])->size();
-        for (std::size_t row=0; row < rows; ++row)
+
+        // Execute as many rows as possible in blocks, this avoids the round
+        // trips needed for executing each row and querying the number of
+        // rows affected by it separately.
+        std::size_t row = executeBlocks(rows, rowsAffectedBulkTemp);
+
+        // Here we have to explicitly loop to achieve the
+        // effect of inserting or updating with the remaining rows.
+        for (; row < rows; ++row)
         {
             // first we have to prepare input parameters
             for (std::size_t col=0; col<usize; ++col)
@@ -473,6 +666,273 @@ firebird_statement_backend::execute(int number)
     }
 }
 
+int firebird_statement_backend::getRowsPerBlock()
+{
+    if (rowsPerBlock_ != -1)
+    {
+        return rowsPerBlock_;
+    }
+
+    rowsPerBlock_ = 0;
+
+    // Only DML statements not returning anything can be grouped.
+    if (stmtType_ != isc_info_sql_stmt_insert &&
+        stmtType_ != isc_info_sql_stmt_update &&
+        stmtType_ != isc_info_sql_stmt_delete)
+    {
+        return rowsPerBlock_;
+    }
+
+    if (sqldap_->sqld != 0 || sqlda2p_->sqld == 0)
+    {
+        return rowsPerBlock_;
+    }
+
+    std::size_t const cols = static_cast<std::size_t>(sqlda2p_->sqld);
+
+    std::size_t rowData = 0;
+    std::size_t rowText = 0;
+    for (std::size_t col = 0; col < cols; ++col)
+    {
+        XSQLVAR const * var = sqlda2p_->sqlvar + col;
+
+        std::string const decl = paramDeclaration(var);
+        if (decl.empty())
+        {
+            return rowsPerBlock_;
+        }
+
+        rowData += alignedSize(getDataSize(var)) + sizeof(short);
+
+        // leave enough space for the parameter name, i.e. ":pNNN_NNN = ?, "
+        rowText += decl.size() + 32;
+    }
+
+    // The statement must be usable as a part of the block.
+    std::string::size_type const len =
+        queryText_.find_last_not_of(" \t\r\n;");
+    if (len == std::string::npos)
+    {
+        return rowsPerBlock_;
+    }
+    queryText_.erase(len + 1);
+
+    std::string check;
+    if (appendRowStatement(queryText_, 0, check) != static_cast<int>(cols))
+    {
+        return rowsPerBlock_;
+    }
+    rowText += check.size() + cols * 8;
+
+    std::size_t rows = maxRowsPerBlock;
+    rows = std::min(rows, maxBlockSize / rowData);
+    rows = std::min(rows, maxBlockSize / rowText);
+
+    // XSQLDA can't have more than SHRT_MAX variables.
+    rows = std::min(rows, static_cast<std::size_t>(SHRT_MAX) / cols);
+
+    // It's not worth using blocks containing a single row.
+    if (rows > 1)
+    {
+        rowsPerBlock_ = static_cast<int>(rows);
+    }
+
+    return rowsPerBlock_;
+}
+
+void firebird_statement_backend::freeBlock(firebird_block_statement & block)
+{
+    if (block.stmtp_ != 0)
+    {
+        ISC_STATUS stat[stat_size];
+
+        if (isc_dsql_free_statement(stat, &block.stmtp_, DSQL_drop))
+        {
+            throw_iscerror(stat);
+        }
+        block.stmtp_ = 0;
+    }
+
+    if (block.sqldap_ != NULL)
+    {
+        free(block.sqldap_);
+        block.sqldap_ = NULL;
+    }
+
+    block.rows_ = 0;
+}
+
+void firebird_statement_backend::prepareBlock(
+    firebird_block_statement & block, std::size_t rows)
+{
+    freeBlock(block);
+
+    std::size_t const cols = static_cast<std::size_t>(sqlda2p_->sqld);
+
+    // build the block, declaring input parameters for all rows
+    std::string query("execute block (");
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        for (std::size_t col = 0; col < cols; ++col)
+        {
+            std::ostringstream param;
+            if (row != 0 || col != 0)
+            {
+                param << ", ";
+            }
+            param << "p" << row << "_" << col << " "
+                << paramDeclaration(sqlda2p_->sqlvar + col) << " = ?";
+            query += param.str();
+        }
+    }
+    query += ") as begin\n";
+    for (std::size_t row = 0; row < rows; ++row)
+    {
+        appendRowStatement(queryText_, row, query);
+    }
+    query += "end";
+
+    ISC_STATUS stat[stat_size];
+
+    if (isc_dsql_allocate_statement(stat, &session_.dbhp_, &block.stmtp_))
+    {
+        throw_iscerror(stat);
+    }
+
+    if (isc_dsql_prepare(stat, session_.current_transaction(), &block.stmtp_,
+        0, const_cast<char*>(query.c_str()), SQL_DIALECT_V6, NULL))
+    {
+        throw_iscerror(stat);
+    }
+
+    std::size_t const params = rows * cols;
+
+    prepareSQLDA(&block.sqldap_, static_cast<short>(params));
+
+    if (isc_dsql_describe_bind(stat, &block.stmtp_, SQL_DIALECT_V6,
+        block.sqldap_))
+    {
+        throw_iscerror(stat);
+    }
+
+    checkSize(static_cast<std::size_t>(block.sqldap_->sqld), params, "block");
+
+    // Use the same types as for the original statement parameters, so that
+    // their data can be simply copied, and lay out all of them in a single
+    // buffer.
+    std::size_t offset = 0;
+    for (std::size_t col = 0; col < cols; ++col)
+    {
+        offset += alignedSize(getDataSize(sqlda2p_->sqlvar + col));
+    }
+
+    block.data_.resize(offset * rows);
+    block.inds_.resize(params);
+
+    offset = 0;
+    for (std::size_t i = 0; i < params; ++i)
+    {
+        XSQLVAR const * src = sqlda2p_->sqlvar + i % cols;
+        XSQLVAR * var = block.sqldap_->sqlvar + i;
+
+        var->sqltype = static_cast<short>(src->sqltype | 1);
+        var->sqlsubtype = src->sqlsubtype;
+        var->sqlscale = src->sqlscale;
+        var->sqllen = src->sqllen;
+        var->sqldata = &block.data_[offset];
+        var->sqlind = &block.inds_[i];
+
+        offset += alignedSize(getDataSize(src));
+    }
+
+    block.rows_ = rows;
+}
+
+std::size_t firebird_statement_backend::executeBlocks(std::size_t rows,
+    long long & rowsAffected)
+{
+    int const rowsPerBlock = getRowsPerBlock();
+    if (rowsPerBlock == 0 || rows < 2)
+    {
+        return 0;
+    }
+
+    std::size_t const cols = static_cast<std::size_t>(sqlda2p_->sqld);
+    std::size_t const usize = uses_.size();
+
+    std::size_t row = 0;
+    while (row < rows)
+    {
+        std::size_t const blockRows = std::min(rows - row,
+            static_cast<std::size_t>(rowsPerBlock));
+
+        // use the first statement for full blocks and the second one for the
+        // last incomplete block, so that both are reused by the next execution
+        firebird_block_statement & block =
+            blocks_[blockRows == static_cast<std::size_t>(rowsPerBlock) ? 0 : 1];
+
+        if (block.rows_ != blockRows)
+        {
+            try
+            {
+                prepareBlock(block, blockRows);
+            }
+            catch (soci_error const &)
+            {
+                // This server doesn't support EXECUTE BLOCK or the block
+                // exceeds some of its limits, don't use blocks any more and
+                // let the caller execute the remaining rows one by one.
+                freeBlock(block);
+                rowsPerBlock_ = 0;
+                return row;
+            }
+        }
+
+        for (std::size_t i = 0; i < blockRows; ++i)
+        {
+            for (std::size_t col = 0; col < usize; ++col)
+            {
+                static_cast<firebird_vector_use_type_backend*>(uses_[col])->exchangeData(row + i);
+            }
+
+            for (std::size_t col = 0; col < cols; ++col)
+            {
+                XSQLVAR const * src = sqlda2p_->sqlvar + col;
+                XSQLVAR * var = block.sqldap_->sqlvar + i * cols + col;
+
+                std::memcpy(var->sqldata, src->sqldata, getDataSize(src));
+
+                if ((src->sqltype & 1) != 0 && src->sqlind != NULL)
+                {
+                    *var->sqlind = *src->sqlind;
+                }
+                else
+                {
+                    *var->sqlind = 0;
+                }
+            }
+        }
+
+        ISC_STATUS stat[stat_size];
+
+        if (isc_dsql_execute(stat, session_.current_transaction(),
+            &block.stmtp_, SQL_DIALECT_V6, block.sqldap_))
+        {
+            // The block is executed atomically, so only the rows of the
+            // previous blocks were affected.
+            rowsAffectedBulk_ = rowsAffected;
+            throw_iscerror(stat);
+        }
+
+        // a single request for all rows of the block
+        rowsAffected += getRowsAffected(block.stmtp_);
+
+        row += blockRows;
+    }
+
+    return row;
+}
+
 statement_backend::exec_fetch_result
 firebird_statement_backend::fetch(int number)
 {
@@ -486,9 +946,24 @@ firebird_statement_backend::fetch(int number)
         inds_[i].resize(number > 0 ? number : 1);
     }
 
+    // Vector into elements don't convert the data of each row immediately
+    // but only save it and then convert all rows of the same column at
+    // once, after fetching them.
+    bool const staged = intoType_ == eVector;
+    if (staged)
+    {
+        for (std::size_t i = 0; i < intos_.size(); ++i)
+        {
+            firebird_vector_into_type_backend * into =
+                static_cast<firebird_vector_into_type_backend*>(intos_[i]);
+            into->staging_.resize(into->stride_ * number);
+        }
+    }
+
     // Here we have to explicitly loop to achieve the effect of fetching
     // vector into elements. After each fetch, we have to exchange data
     // with into buffers.
+    exec_fetch_result res = ef_success;
     rowsFetched_ = 0;
     for (int i = 0; i < number; ++i)
     {
@@ -499,12 +974,20 @@ firebird_statement_backend::fetch(int number)
         if (fetch_stat == 0)
         {
             ++rowsFetched_;
-            exchangeData(true, i);
+            if (staged)
+            {
+                stageData(i);
+            }
+            else
+            {
+                exchangeData(true, i);
+            }
         }
         else if (fetch_stat == 100L)
         {
             endOfRowSet_ = true;
-            return ef_no_data;
+            res = ef_no_data;
+            break;
         }
         else
         {
@@ -515,7 +998,40 @@ firebird_statement_backend::fetch(int number)
         }
     } // for
 
-    return ef_success;
+    if (staged)
+    {
+        for (std::size_t i = 0; i < intos_.size(); ++i)
+        {
+            static_cast<firebird_vector_into_type_backend*>(
+                intos_[i])->exchangeStagedData(rowsFetched_);
+        }
+    }
+
+    return res;
+}
+
+namespace
+{
+    indicator getIndicator(XSQLVAR const * var)
+    {
+        if ((var->sqltype & 1) == 0)
+        {
+            // there is no indicator for this column
+            return i_ok;
+        }
+        else if (*(var->sqlind) == 0)
+        {
+            return i_ok;
+        }
+        else if (*(var->sqlind) == -1)
+        {
+            return i_null;
+        }
+        else
+        {
+            throw soci_error("Unknown state in firebird_statement_backend::exchangeData()");
+        }
+    }
 }
 
 // here we put data fetched from database into user buffers
@@ -526,23 +1042,7 @@ void firebird_statement_backend::exchangeData(bool gotData, int row)
         for (size_t i = 0; i < static_cast<unsigned int>(sqldap_->sqld); ++i)
         {
             // first save indicators
-            if (((sqldap_->sqlvar+i)->sqltype & 1) == 0)
-            {
-                // there is no indicator for this column
-                inds_[i][row] = i_ok;
-            }
-            else if (*((sqldap_->sqlvar+i)->sqlind) == 0)
-            {
-                inds_[i][row] = i_ok;
-            }
-            else if (*((sqldap_->sqlvar+i)->sqlind) == -1)
-            {
-                inds_[i][row] = i_null;
-            }
-            else
-            {
-                throw soci_error("Unknown state in firebird_statement_backend::exchangeData()");
-            }
+            inds_[i][row] = getIndicator(sqldap_->sqlvar+i);
 
             // then deal with data
             if (inds_[i][row] != i_null)
@@ -562,69 +1062,29 @@ void firebird_statement_backend::exchangeData(bool gotData, int row)
     }
 }
 
-long long firebird_statement_backend::get_affected_rows()
+// here we only save the data fetched from database for vector into elements
+void firebird_statement_backend::stageData(int row)
 {
-    if (rowsAffectedBulk_ >= 0)
+    for (size_t i = 0; i < static_cast<unsigned int>(sqldap_->sqld); ++i)
     {
-        return rowsAffectedBulk_;
-    }
-
-    ISC_STATUS_ARRAY stat;
-    char type_item[] = { isc_info_sql_records };
-    char res_buffer[256];
-
-    if (isc_dsql_sql_info(stat, &stmtp_, sizeof(type_item), type_item,
-                          sizeof(res_buffer), res_buffer))
-    {
-        throw_iscerror(stat);
-    }
-
-    // We must get back a isc_info_sql_records block, that we parse below,
-    // followed by isc_info_end.
-    if (res_buffer[0] != isc_info_sql_records)
-    {
-        throw soci_error("Can't determine the number of affected rows");
-    }
-
-    char* sql_rec_buf = res_buffer + 1;
-    const int length = isc_vax_integer(sql_rec_buf, 2);
-    sql_rec_buf += 2;
+        inds_[i][row] = getIndicator(sqldap_->sqlvar+i);
 
-    if (sql_rec_buf[length] != isc_info_end)
-    {
-        throw soci_error("Unexpected isc_info_sql_records return format");
+        if (inds_[i][row] != i_null)
+        {
+            static_cast<firebird_vector_into_type_backend*>(
+                intos_[i])->stageData(row);
+        }
     }
+}
 
-    // Examine the 4 sub-blocks each of which has a header indicating the block
-    // type, its value length in bytes and the value itself.
-    long long row_count = 0;
-
-    for ( char* p = sql_rec_buf; !row_count && p < sql_rec_buf + length; )
+long long firebird_statement_backend::get_affected_rows()
+{
+    if (rowsAffectedBulk_ >= 0)
     {
-        switch (*p++)
-        {
-            case isc_info_req_select_count:
-            case isc_info_req_insert_count:
-            case isc_info_req_update_count:
-            case isc_info_req_delete_count:
-                {
-                    int len = isc_vax_integer(p, 2);
-                    p += 2;
-
-                    row_count += isc_vax_integer(p, static_cast<short>(len));
-                    p += len;
-                }
-                break;
-
-            case isc_info_end:
-                break;
-
-            default:
-                throw soci_error("Unknown record counter");
-        }
+        return rowsAffectedBulk_;
     }
 
-    return row_count;
+    return getRowsAffected(stmtp_);
 }
 
 int firebird_statement_backend::get_number_of_rows()
@@ -30,6 +30,8 @@ void firebird_vector_into_type_backend::define_by_pos(
     buf_ = allocBuffer(var);
     var->sqldata = buf_;
     var->sqlind = &indISCHolder_;
+
+    stride_ = getDataSize(var);
 }
 
 void firebird_vector_into_type_backend::pre_fetch()
@@ -49,6 +51,62 @@ void setIntoVector(void *p, std::size_t indx, T const &val)
     v[indx] = val;
 }
 
+// Convert all non-null values of a numeric column in one pass.
+template <typename T, typename IscType>
+void setIntoVectorFromIsc(void *p, char const *src, std::size_t stride,
+    std::vector<indicator> const &inds, std::size_t rows, T tens)
+{
+    T *dest = &(*static_cast<std::vector<T> *>(p))[0];
+
+    for (std::size_t i = 0; i < rows; ++i, src += stride)
+    {
+        if (inds[i] == i_null)
+            continue;
+
+        IscType val;
+        std::memcpy(&val, src, sizeof(val));
+        dest[i] = static_cast<T>(val/tens);
+    }
+}
+
+// This is the column-wise equivalent of from_isc<T>().
+template <typename T>
+void setIntoVectorFromIsc(void *p, XSQLVAR const *var, char const *src,
+    std::size_t stride, std::vector<indicator> const &inds, std::size_t rows)
+{
+    T tens = 1;
+
+    if (var->sqlscale < 0)
+    {
+        cond_from_isc<std::numeric_limits<T>::is_integer>::checkInteger(var->sqlscale);
+        for (int i = 0; i > var->sqlscale; --i)
+        {
+            tens *= 10;
+        }
+    }
+
+    switch (var->sqltype & ~1)
+    {
+    case SQL_SHORT:
+        setIntoVectorFromIsc<T, short>(p, src, stride, inds, rows, tens);
+        break;
+    case SQL_LONG:
+        setIntoVectorFromIsc<T, int>(p, src, stride, inds, rows, tens);
+        break;
+    case SQL_INT64:
+        setIntoVectorFromIsc<T, long long>(p, src, stride, inds, rows, tens);
+        break;
+    case SQL_FLOAT:
+        setIntoVectorFromIsc<T, float>(p, src, stride, inds, rows, 1);
+        break;
+    case SQL_DOUBLE:
+        setIntoVectorFromIsc<T, double>(p, src, stride, inds, rows, 1);
+        break;
+    default:
+        throw soci_error("Incorrect data type for numeric conversion");
+    }
+}
+
 } // namespace anonymous
 
 // this will exchange data with vector user buffers
@@ -105,11 +163,78 @@ void firebird_vector_into_type_backend::exchangeData(std::size_t row)
 
 }
 
+void firebird_vector_into_type_backend::stageData(std::size_t row)
+{
+    std::memcpy(&staging_[row * stride_], buf_, stride_);
+}
+
+void firebird_vector_into_type_backend::exchangeStagedData(std::size_t rows)
+{
+    if (rows == 0)
+        return;
+
+    XSQLVAR const *var = statement_.sqldap_->sqlvar+position_;
+    std::vector<indicator> const &inds = statement_.inds_[position_];
+    char const *src = &staging_[0];
+
+    switch (type_)
+    {
+        // numeric types don't need any per-row dispatching
+    case x_short:
+        setIntoVectorFromIsc<short>(data_, var, src, stride_, inds, rows);
+        break;
+    case x_integer:
+        setIntoVectorFromIsc<int>(data_, var, src, stride_, inds, rows);
+        break;
+    case x_long_long:
+        setIntoVectorFromIsc<long long>(data_, var, src, stride_, inds, rows);
+        break;
+    case x_double:
+        setIntoVectorFromIsc<double>(data_, var, src, stride_, inds, rows);
+        break;
+
+        // other types are converted using a copy of the variable
+        // pointing to the staged data of each row in turn
+    case x_char:
+    case x_stdstring:
+    case x_stdtm:
+        {
+            XSQLVAR tmp = *var;
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                if (inds[i] == i_null)
+                    continue;
+
+                tmp.sqldata = &staging_[i * stride_];
+
+                if (type_ == x_char)
+                {
+                    setIntoVector(data_, i, getTextParam(&tmp)[0]);
+                }
+                else if (type_ == x_stdstring)
+                {
+                    setIntoVector(data_, i, getTextParam(&tmp));
+                }
+                else
+                {
+                    std::tm data = std::tm();
+                    tmDecode(tmp.sqltype, tmp.sqldata, &data);
+                    setIntoVector(data_, i, data);
+                }
+            }
+        }
+        break;
+
+    default:
+        throw soci_error("Into vector element used with non-supported type.");
+    } // switch
+}
+
 void firebird_vector_into_type_backend::post_fetch(
     bool gotData, indicator * ind)
 {
     // Here we have to set indicators only. Data was exchanged with user
-    // buffers during fetch()
+    // buffers at the end of fetch()
     if (gotData)
     {
         std::size_t rows = statement_.rowsFetched_;
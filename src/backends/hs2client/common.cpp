@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2004-2006 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_HS2CLIENT_SOURCE
+#include "hs2client/common.h"
+#include "soci-exchange-cast.h"
+
+#include <cstdio>
+
+using namespace soci;
+using namespace soci::details;
+using namespace soci::details::hs2client_columns;
+using namespace soci::details::hs2client_parameters;
+
+namespace
+{
+	const int64_t seconds_per_day = 86400;
+
+	inline int64_t floor_div(int64_t value, int64_t divisor)
+	{
+		return (value >= 0 ? value : value - divisor + 1) / divisor;
+	}
+
+	/* The following two are the 'days_from_civil' and 'civil_from_days' algorithms described at
+	   http://howardhinnant.github.io/date_algorithms.html */
+	int64_t days_from_civil(int64_t y, unsigned m, unsigned d)
+	{
+		y -= m <= 2;
+		const int64_t era = (y >= 0 ? y : y - 399) / 400;
+		const unsigned yoe = static_cast<unsigned>(y - era * 400);
+		const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+		const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+		return era * 146097 + static_cast<int64_t>(doe) - 719468;
+	}
+
+	void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d)
+	{
+		z += 719468;
+		const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+		const unsigned doe = static_cast<unsigned>(z - era * 146097);
+		const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		const unsigned mp = (5 * doy + 2) / 153;
+
+		d = doy - (153 * mp + 2) / 5 + 1;
+		m = mp < 10 ? mp + 3 : mp - 9;
+		y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+	}
+
+	/* The offset of the local time from UTC at the given time */
+	int64_t get_utc_offset(int64_t seconds, int& isdst)
+	{
+		time_t time = static_cast<time_t>(seconds);
+		std::tm local;
+		localtime_r(&time, &local);
+
+		isdst = local.tm_isdst;
+
+		int64_t local_seconds = days_from_civil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday) * seconds_per_day +
+								local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+
+		return local_seconds - seconds;
+	}
+}
+
+void local_time_converter::from_utc_seconds(int64_t seconds, std::tm& out)
+{
+	const int64_t days = floor_div(seconds, seconds_per_day);
+	const int64_t seconds_of_day = seconds - days * seconds_per_day;
+
+	int64_t year;
+	unsigned month, day;
+	civil_from_days(days, year, month, day);
+
+	out.tm_year = static_cast<int>(year - 1900);
+	out.tm_mon = static_cast<int>(month) - 1;
+	out.tm_mday = static_cast<int>(day);
+	out.tm_hour = static_cast<int>(seconds_of_day / 3600);
+	out.tm_min = static_cast<int>((seconds_of_day % 3600) / 60);
+	out.tm_sec = static_cast<int>(seconds_of_day % 60);
+	out.tm_wday = static_cast<int>(days + 4 - floor_div(days + 4, 7) * 7); // 1970-01-01 was a Thursday
+	out.tm_yday = static_cast<int>(days - days_from_civil(year, 1, 1));
+	out.tm_isdst = 0;
+}
+
+void local_time_converter::convert(int64_t seconds, std::tm& out)
+{
+	const int64_t day = floor_div(seconds, seconds_per_day);
+	if (day != _day) lookup_offset(day);
+
+	if (_uniform == false)
+	{
+		time_t time = static_cast<time_t>(seconds);
+		localtime_r(&time, &out);
+		return;
+	}
+
+	from_utc_seconds(seconds + _offset, out);
+	out.tm_isdst = _isdst;
+}
+
+void local_time_converter::lookup_offset(int64_t day)
+{
+	int first_isdst, last_isdst;
+	int64_t first_offset = get_utc_offset(day * seconds_per_day, first_isdst);
+	int64_t last_offset = get_utc_offset((day + 1) * seconds_per_day - 1, last_isdst);
+
+	_day = day;
+	_offset = first_offset;
+	_isdst = first_isdst;
+	_uniform = (first_offset == last_offset && first_isdst == last_isdst);
+}
+
+/* The numbers are formatted on the stack, so that assigning them doesn't allocate once the buffers of the
+   parameter values are large enough. */
+void hs2client_parameters::render_value(exchange_type type, void* data, std::string& out)
+{
+	char buf[32];
+	int length = 0;
+
+	switch (type)
+	{
+		/* We have to treat char as int8_t */
+		case x_char:
+			length = snprintf(buf, sizeof(buf), "%d", static_cast<int>(exchange_type_cast<x_char>(data)));
+			break;
+
+		case x_stdstring:
+			soci::utils::escape_string_to_buffer(exchange_type_cast<x_stdstring>(data), out);
+			return;
+
+		case x_short:
+			length = snprintf(buf, sizeof(buf), "%d", static_cast<int>(exchange_type_cast<x_short>(data)));
+			break;
+
+		case x_integer:
+			length = snprintf(buf, sizeof(buf), "%d", exchange_type_cast<x_integer>(data));
+			break;
+
+		case x_long_long:
+			length = snprintf(buf, sizeof(buf), "%" LL_FMT_FLAGS "d", exchange_type_cast<x_long_long>(data));
+			break;
+
+		case x_unsigned_long_long:
+			length = snprintf(buf, sizeof(buf), "%" LL_FMT_FLAGS "u", exchange_type_cast<x_unsigned_long_long>(data));
+			break;
+
+		case x_double:
+		{
+			/* The same as 'double_to_cstring', although without the temporary string */
+			length = snprintf(buf, sizeof(buf), "%.20g", exchange_type_cast<x_double>(data));
+
+			char* comma = static_cast<char*>(std::memchr(buf, ',', length));
+			if (comma != nullptr) *comma = '.';
+		}
+		break;
+
+		case x_stdtm:
+			length = snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(mktime(&exchange_type_cast<x_stdtm>(data))));
+			break;
+
+		default:
+			throw soci_error("Use element used with non-supported type.");
+	}
+
+	out.assign(buf, length);
+}
@@ -0,0 +1,91 @@
+//
+// Copyright (C) 2004-2006 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_HS2CLIENT_SOURCE
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include "soci/hs2client/soci-hs2client.h"
+
+using namespace soci;
+using namespace soci::details;
+
+void hs2client_backoff::sleep()
+{
+	std::this_thread::sleep_for(std::chrono::microseconds(_interval));
+
+	/* Doubling the interval for the next round, although not beyond the maximum */
+	_interval = std::min(std::max(_interval, 1u) * 2, std::max(_policy.max_interval, _policy.initial_interval));
+}
+
+void hs2client_operation_poller::add(hs2client::Operation& operation, completion_handler handler)
+{
+	_pending.push_back(pending_operation{ &operation, handler, 0 });
+}
+
+size_t hs2client_operation_poller::poll()
+{
+	hs2client::Operation::State state = hs2client::Operation::State::UNKNOWN;
+
+	for (std::list<pending_operation>::iterator itr = _pending.begin(); itr != _pending.end(); )
+	{
+		if (_operation_mutex != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(*_operation_mutex);
+			itr->operation->GetState(&state);
+		}
+		else itr->operation->GetState(&state);
+
+		itr->poll_count++;
+
+		if (is_pending(state))
+		{
+			++itr;
+			continue;
+		}
+
+		/* Removing the operation before invoking the handler, so that the handler could add further operations */
+		pending_operation completed = *itr;
+		itr = _pending.erase(itr);
+		_completed_count++;
+
+		if (completed.handler) completed.handler(state, completed.poll_count);
+	}
+
+	return _pending.size();
+}
+
+size_t hs2client_operation_poller::wait_any()
+{
+	poll_until(_completed_count + 1);
+	return _pending.size();
+}
+
+void hs2client_operation_poller::wait_all()
+{
+	poll_until(std::numeric_limits<uint64_t>::max());
+}
+
+/* Keeps polling until the given number of operations completed overall, or nothing is left pending. The handlers
+   could add new operations while polling, thus the completions are counted rather than the pending operations. */
+void hs2client_operation_poller::poll_until(uint64_t completed_count)
+{
+	hs2client_backoff backoff(_policy);
+
+	while (_pending.empty() == false)
+	{
+		uint64_t previous_count = _completed_count;
+
+		poll();
+		if (_completed_count >= completed_count || _pending.empty()) break;
+
+		if (_completed_count != previous_count) backoff.reset();
+		backoff.sleep();
+	}
+}
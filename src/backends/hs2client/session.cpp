@@ -83,11 +83,15 @@ bool contains(const std::map<std::string, std::string>& parameters, const std::s
 /* The parameters 'connectionString', 'host' and 'portNumber', 'user' are all required, while the 'connectionTimeout' and the 'protocolVersion'
 are not. Thus if either of these 'optional' parameters are not mentioned under the connection string, they will default to the
 values mentioned on the first two line of this method. */
-void parse_connection_string(const std::string& connection_string, std::string& host, int& port_number, std::string& user, int& connection_timeout, int& protocol_version, int& bulk_read_size, std::shared_ptr<hs2client::HS2ClientConfig>& security_configs, boost::optional<std::string>* database = nullptr)
+void parse_connection_string(const std::string& connection_string, std::string& host, int& port_number, std::string& user, int& connection_timeout, int& protocol_version, int& bulk_read_size, int& bulk_insert_size, int& max_statement_length, hs2client_poll_policy& poll_policy, int& prefetch_depth, std::shared_ptr<hs2client::HS2ClientConfig>& security_configs, boost::optional<std::string>* database = nullptr)
 {
 	connection_timeout = 0;
 	protocol_version = static_cast<int>(hs2client::ProtocolVersion::HS2CLIENT_PROTOCOL_V7);
 	bulk_read_size = 10000;
+	bulk_insert_size = 1000;
+	max_statement_length = 16 * 1024 * 1024; // Impala's default 'MAX_STATEMENT_LENGTH_BYTES'
+	poll_policy = hs2client_poll_policy();
+	prefetch_depth = 1;
 	if (database != nullptr) *database = boost::none;
 
 	std::map<std::string, std::string> parameters;
@@ -100,6 +104,11 @@ void parse_connection_string(const std::string& connection_string, std::string&
 	static const char* param_protocol_version = "protocol-version";
 	static const char* param_database = "database";
 	static const char* param_bulk_read_size = "rowsfetchedperblock";
+	static const char* param_bulk_insert_size = "bulkinsertsize";
+	static const char* param_max_statement_length = "maxstatementlength";
+	static const char* param_poll_interval = "pollinterval";
+	static const char* param_max_poll_interval = "maxpollinterval";
+	static const char* param_prefetch_depth = "prefetchdepth";
 
 	// security related settings (SSL)
 	static const char* param_enable_ssl = "ssl";
@@ -147,6 +156,38 @@ void parse_connection_string(const std::string& connection_string, std::string&
 		if (cast_to_int(tmp_value, bulk_read_size) == false)
 			throw soci_error("Invalid connection string (Details='Bulk read size (RowsFetchedPerBlock) should be a positive number')");
 
+	if (contains(parameters, param_bulk_insert_size, tmp_value))
+		if (cast_to_int(tmp_value, bulk_insert_size) == false || bulk_insert_size <= 0)
+			throw soci_error("Invalid connection string (Details='Bulk insert size (BulkInsertSize) should be a positive number')");
+
+	if (contains(parameters, param_max_statement_length, tmp_value))
+		if (cast_to_int(tmp_value, max_statement_length) == false || max_statement_length <= 0)
+			throw soci_error("Invalid connection string (Details='Maximum statement length (MaxStatementLength) should be a positive number')");
+
+	int poll_interval = 0;
+	if (contains(parameters, param_poll_interval, tmp_value))
+	{
+		if (cast_to_int(tmp_value, poll_interval) == false || poll_interval <= 0)
+			throw soci_error("Invalid connection string (Details='Poll interval (PollInterval) should be a positive number of microseconds')");
+
+		poll_policy.initial_interval = poll_interval;
+	}
+
+	if (contains(parameters, param_max_poll_interval, tmp_value))
+	{
+		if (cast_to_int(tmp_value, poll_interval) == false || poll_interval <= 0)
+			throw soci_error("Invalid connection string (Details='Maximum poll interval (MaxPollInterval) should be a positive number of microseconds')");
+
+		poll_policy.max_interval = poll_interval;
+	}
+
+	if (poll_policy.max_interval < poll_policy.initial_interval)
+		throw soci_error("Invalid connection string (Details='Maximum poll interval (MaxPollInterval) should not be less than the poll interval (PollInterval)')");
+
+	if (contains(parameters, param_prefetch_depth, tmp_value))
+		if (cast_to_int(tmp_value, prefetch_depth) == false || prefetch_depth < 0)
+			throw soci_error("Invalid connection string (Details='Prefetch depth (PrefetchDepth) should be zero or a positive number')");
+
 	if (contains(parameters, param_enable_ssl, tmp_value) && tmp_value == "1")
 	{
 		security_configs.reset(new hs2client::HS2ClientConfig());
@@ -213,11 +254,20 @@ host=<host-name or ip-address>, port=<port-number>, connection-timeout=<connecti
 However the parameters, 'connection-timeout' and 'protocol-version' are optional and will default to,
 - connection-timeout = 5
 - protocol-version   = 6 (which corresponds to ProtocolVersion::HS2CLIENT_PROTOCOL_V7. You can find the rest at 'hs2client\service.h')
+- BulkInsertSize     = 1000 (the number of rows rendered into a single multi-row INSERT, 1 disables it)
+- MaxStatementLength = 16777216 (the length in bytes a multi-row INSERT is not allowed to exceed)
+- PollInterval       = 50 (the initial interval in microseconds between polls of a pending operation)
+- MaxPollInterval    = 100000 (the interval in microseconds the polling backs off to)
+- PrefetchDepth      = 1 (the number of result batches fetched in the background ahead of the current one, 0 disables it)
 */
 hs2client_session_backend::hs2client_session_backend(const connection_parameters& params) :
 _service(nullptr),
 _session(nullptr),
-_bulk_read_size(10000)
+_bulk_read_size(10000),
+_bulk_insert_size(1000),
+_max_statement_length(16 * 1024 * 1024),
+_poll_policy(),
+_prefetch_depth(1)
 {
 	std::string host;
 	int port;
@@ -225,15 +275,21 @@ _bulk_read_size(10000)
 	int connection_timeout = 0;
 	int protocol_version = static_cast<int>(hs2client::ProtocolVersion::HS2CLIENT_PROTOCOL_V7);
 	int bulk_read_size = 10000;
+	int bulk_insert_size = 1000;
+	int max_statement_length = 16 * 1024 * 1024;
+	int prefetch_depth = 1;
 	boost::optional<std::string> database;
 	std::shared_ptr<hs2client::HS2ClientConfig> security_configs;
 
-	parse_connection_string(params.get_connect_string(), host, port, user, connection_timeout, protocol_version, bulk_read_size, security_configs, &database);
+	parse_connection_string(params.get_connect_string(), host, port, user, connection_timeout, protocol_version, bulk_read_size, bulk_insert_size, max_statement_length, _poll_policy, prefetch_depth, security_configs, &database);
 
 	hs2client::HS2ClientConfig config;
 	if (database) config.SetOption("use:database", database.get());
 
 	_bulk_read_size = bulk_read_size;
+	_bulk_insert_size = bulk_insert_size;
+	_max_statement_length = max_statement_length;
+	_prefetch_depth = prefetch_depth;
 
 	hs2client::Status status = hs2client::Service::Connect(host, port, connection_timeout, static_cast<hs2client::ProtocolVersion>(protocol_version), security_configs, &_service);
 	if (status.ok() == false)
@@ -260,6 +316,7 @@ hs2client_session_backend::~hs2client_session_backend()
 
 hs2client::Status hs2client_session_backend::execute_statement(const std::string& statement, std::unique_ptr<hs2client::Operation>* operation) const
 {
+	std::lock_guard<std::mutex> lock(_operation_mutex);
 	return _session->ExecuteStatement(statement, operation);
 }
 
@@ -7,6 +7,7 @@
 
 #define SOCI_HS2CLIENT_SOURCE
 #include "soci/hs2client/soci-hs2client.h"
+#include "hs2client/common.h"
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -83,8 +84,8 @@ void hs2client_standard_into_type_backend::post_fetch(bool got_data, bool called
 			std::unique_ptr<hs2client::Int64Column> col = results.GetCol<hs2client::Int64Column>(column_index);
 			if (col->length() > row_index && col->IsNull(row_index) == false) 
 			{
-				time_t time = col->GetData(row_index);
-				(*(static_cast<std::tm*>(_data))) = *localtime(&time);
+				hs2client_columns::local_time_converter converter;
+				converter.convert(col->GetData(row_index), *static_cast<std::tm*>(_data));
 
 				if (ind != nullptr) *ind = i_ok;
 			} 
@@ -8,13 +8,7 @@
 #define SOCI_HS2CLIENT_SOURCE
 
 #include "soci/hs2client/soci-hs2client.h"
-
-#include <cstring>
-#include <limits>
-#include <time.h>
-#include <algorithm>
-#include "soci-exchange-cast.h"
-#include "soci-dtocstr.h"
+#include "hs2client/common.h"
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -42,104 +36,28 @@ void hs2client_standard_use_type_backend::bind_by_name(const std::string& name,
 
 void hs2client_standard_use_type_backend::pre_use(const indicator* ind)
 {
-	if (ind != NULL && *ind == i_null)
-	{
-		_buf = new char[5];
-		std::strcpy(_buf, "NULL");
-	}
-	else
-	{
-		switch (_type)
-		{
-			/* We have to treat char as int8_t */
-			case x_char:			
-			{
-				const std::size_t buf_size = std::numeric_limits<char>::digits10 + 3;
-				_buf = new char[buf_size];
-
-				snprintf(_buf, buf_size, "%d", static_cast<int>(exchange_type_cast<x_char>(_data)));
-			}
-			break;
-
-			case x_stdstring:
-			{
-				const std::string& s = exchange_type_cast<x_stdstring>(_data);
-				soci::utils::escape_string_to_buffer(s, _buf);
-			}
-			break;
-
-			case x_short:
-			{
-				const std::size_t buf_size = std::numeric_limits<short>::digits10 + 3;
-				_buf = new char[buf_size];
-
-				snprintf(_buf, buf_size, "%d", static_cast<int>(exchange_type_cast<x_short>(_data)));
-			}
-			break;
-
-			case x_integer:				
-			{
-				const std::size_t buf_size = std::numeric_limits<int>::digits10 + 3;
-				_buf = new char[buf_size];
-				
-				snprintf(_buf, buf_size, "%d", exchange_type_cast<x_integer>(_data));
-			}
-			break;
-
-			case x_long_long:			
-			{				
-				const std::size_t buf_size = std::numeric_limits<long long>::digits10 + 3;
-				_buf = new char[buf_size];
-
-				snprintf(_buf, buf_size, "%" LL_FMT_FLAGS "d", exchange_type_cast<x_long_long>(_data));
-			}
-			break;
-
-			case x_unsigned_long_long:
-			{
-				const std::size_t buf_size = std::numeric_limits<unsigned long long>::digits10 + 3;
-				_buf = new char[buf_size];
-
-				snprintf(_buf, buf_size, "%" LL_FMT_FLAGS "u", exchange_type_cast<x_unsigned_long_long>(_data));
-			}
-			break;
-
-			case x_double:			
-			{				
-				const double d = exchange_type_cast<x_double>(_data);
-				const std::string s = double_to_cstring(d);
-
-				_buf = new char[s.size() + 1];
-				std::strcpy(_buf, s.c_str());
-			}
-			break;
-
-			case x_stdtm:			
-			{
-				std::tm& time = exchange_type_cast<x_stdtm>(_data);
-				const std::size_t buf_size = std::numeric_limits<unsigned long long>::digits10 + 3;
-
-				_buf = new char[buf_size];
-				snprintf(_buf, buf_size, "%li", mktime(&time));
-			}
-			break;
-
-			default:
-				throw soci_error("Use element used with non-supported type.");
-		}
-	}
+	std::string* value = nullptr;
 
 	if (_position > 0)
 	{
 		// binding by index, although we are just emulating it
 		_statement.get_current_statement().clear_parameter_values(_position);
-		_statement.get_current_statement().add_parameter_value(_position, _buf);
+		value = &_statement.get_current_statement().add_parameter_value(_position);
 	}
 	else
 	{
 		// binding by name
 		_statement.get_current_statement().clear_parameter_values(_name);
-		_statement.get_current_statement().add_parameter_value(_name, _buf);
+		value = &_statement.get_current_statement().add_parameter_value(_name);
+	}
+
+	if (ind != NULL && *ind == i_null)
+	{
+		value->assign("NULL");
+	}
+	else
+	{
+		hs2client_parameters::render_value(_type, _data, *value);
 	}
 }
 
@@ -150,7 +68,6 @@ void hs2client_standard_use_type_backend::post_use(bool /* got_data */, indicato
 
 void hs2client_standard_use_type_backend::clean_up()
 {
-	// Nothing to do here, because all the new '_buf'
-	// allocations are sent to the _statement.get_current_statement()
-	// and they should be deleted there.
+	// Nothing to do here, because the rendered values are
+	// kept (and reused) by the _statement.get_current_statement()
 }
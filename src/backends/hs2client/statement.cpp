@@ -8,7 +8,7 @@
 #define SOCI_HS2CLIENT_SOURCE
 
 #include <time.h>
-#include <unistd.h>
+#include <algorithm>
 #include <boost/foreach.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/algorithm/string.hpp>
@@ -28,6 +28,28 @@ using namespace soci::details;
 
 std::atomic_ulong hs2client_statement_backend::_variable_index(0);
 
+namespace
+{
+
+const char* operation_state_name(hs2client::Operation::State state)
+{
+	switch (state)
+	{
+		case hs2client::Operation::State::INITIALIZED: return "INITIALIZED";
+		case hs2client::Operation::State::RUNNING: return "RUNNING";
+		case hs2client::Operation::State::FINISHED: return "FINISHED";
+		case hs2client::Operation::State::CANCELED: return "CANCELED";
+		case hs2client::Operation::State::CLOSED: return "CLOSED";
+		case hs2client::Operation::State::ERROR: return "ERROR";
+		case hs2client::Operation::State::PENDING: return "PENDING";
+		case hs2client::Operation::State::UNKNOWN: break;
+	}
+
+	return "UNKNOWN";
+}
+
+} // namespace anonymous
+
 hs2client_statement_backend::hs2client_statement_backend::sql_statement::sql_statement(const std::string& sql_statement) :
 _query(sql_statement),
 _query_chunks(),
@@ -39,26 +61,7 @@ _parameter_values_by_name()
 
 hs2client_statement_backend::sql_statement::~sql_statement()
 {
-	for (std::pair<int, std::vector<char*>> itr : _parameter_values_by_index)
-	{
-		for (char* data : itr.second)
-			if (data != nullptr)
-				delete[] data;
-
-		itr.second.clear();
-	}
-
-	for (std::pair<std::string, std::vector<char*>> itr : _parameter_values_by_name)
-	{
-		for (char* data : itr.second)
-			if (data != nullptr)
-				delete[] data;
-
-		itr.second.clear();
-	}
-
-	_parameter_values_by_index.clear();
-	_parameter_values_by_name.clear();
+	clear_all_parameter_values();
 }
 
 /* This is a copy-paste of whats on 'soci\src\backends\mysql\statement.cpp',
@@ -137,9 +140,89 @@ void hs2client_statement_backend::sql_statement::prepare()
 	{
 		_names.push_back(name);
 	}
+
+	detect_bulk_insert();
+}
+
+/* A statement qualifies for bulk inserting when it is a plain 'INSERT/UPSERT ... VALUES (...)' with a single
+   tuple holding all of the parameters, in which case the rows of a batch can be rendered as additional tuples
+   of the same statement. Anything else (INSERT ... SELECT, parameters outside of the tuple etc.) is executed
+   row by row as before. */
+void hs2client_statement_backend::sql_statement::detect_bulk_insert()
+{
+	_is_bulk_insert = false;
+	_values_start_offset = _values_end_offset = 0;
+
+	if (_names.empty() || _query_chunks.size() != _names.size() + 1) return;
+
+	const std::string& head = _query_chunks.front();
+	std::string lowered_head = boost::algorithm::to_lower_copy(head);
+
+	size_t start = lowered_head.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos) return;
+	if (lowered_head.compare(start, 6, "insert") != 0 && lowered_head.compare(start, 6, "upsert") != 0) return;
+
+	/* Looking for the 'values' keyword outside of quotes, followed by the opening '(' */
+	bool in_quotes = false, escaped = false;
+	for (size_t i = start; i < lowered_head.size() && _values_start_offset == 0; i++)
+	{
+		char c = lowered_head[i];
+		if (in_quotes)
+		{
+			if (c == '\'' && !escaped) in_quotes = false;
+			escaped = c == '\\' && !escaped;
+			continue;
+		}
+
+		if (c == '\'') { in_quotes = true; continue; }
+		if (lowered_head.compare(i, 6, "values") != 0) continue;
+		if (i > 0 && (std::isalnum(lowered_head[i - 1]) || lowered_head[i - 1] == '_')) continue;
+		if (i + 6 < lowered_head.size() && (std::isalnum(lowered_head[i + 6]) || lowered_head[i + 6] == '_')) continue;
+
+		size_t open = lowered_head.find_first_not_of(" \t\r\n", i + 6);
+		if (open == std::string::npos || lowered_head[open] != '(') return;
+
+		_values_start_offset = open;
+	}
+
+	if (_values_start_offset == 0) return;
+
+	/* Finding the ')' closing the tuple. Placeholders are never within quotes, so the quote state
+	   can be carried across chunks as is. */
+	int depth = 0;
+	in_quotes = escaped = false;
+
+	for (size_t chunk = 0; chunk < _query_chunks.size(); chunk++)
+	{
+		const std::string& text = _query_chunks[chunk];
+		for (size_t i = (chunk == 0 ? _values_start_offset : 0); i < text.size(); i++)
+		{
+			char c = text[i];
+			if (in_quotes)
+			{
+				if (c == '\'' && !escaped) in_quotes = false;
+				escaped = c == '\\' && !escaped;
+				continue;
+			}
+
+			if (c == '\'') in_quotes = true;
+			else if (c == '(') depth++;
+			else if (c == ')' && --depth == 0)
+			{
+				/* The tuple must be the last thing within the statement */
+				if (chunk != _query_chunks.size() - 1) return;
+				if (text.find_first_not_of(" \t\r\n;", i + 1) != std::string::npos) return;
+
+				_values_end_offset = i;
+				_is_bulk_insert = true;
+				return;
+			}
+		}
+	}
 }
 
-/* This is a copy-paste of whats on 'soci\src\backends\mysql\statement.cpp' */
+/* Based on whats on 'soci\src\backends\mysql\statement.cpp', although the total length is computed upfront
+   and the statement is rendered into the provided buffer, which doesn't allocate once it is large enough. */
 void hs2client_statement_backend::sql_statement::get_statement(std::string& out_statement, int index)
 {
 	if (index == -1) 
@@ -148,23 +231,28 @@ void hs2client_statement_backend::sql_statement::get_statement(std::string& out_
 		return; /* returns the original query as is. */
 	}
 
-	std::vector<char*> values;
-	fill_parameter_values_into_list(values, index);
+	fill_parameter_values_into_list(_values, index);
 
-	if (_query_chunks.size() != values.size() &&
-		_query_chunks.size() != values.size() + 1)
+	if (_query_chunks.size() != _values.size() &&
+		_query_chunks.size() != _values.size() + 1)
 	{
 		throw soci_error("Wrong number of parameters.");
 	}
 
-	out_statement = "";
+	size_t length = 0;
+	for (const std::string& chunk : _query_chunks) length += chunk.size();
+	for (const std::string* value : _values) length += value->size();
+
+	out_statement.clear();
+	out_statement.reserve(length);
+
 	std::vector<std::string>::const_iterator ci = _query_chunks.begin();
-	std::vector<char*>::const_iterator end = values.end();
+	std::vector<const std::string*>::const_iterator end = _values.end();
 
-	for (std::vector<char*>::const_iterator pi = values.begin(); pi != end; ++ci, ++pi)
+	for (std::vector<const std::string*>::const_iterator pi = _values.begin(); pi != end; ++ci, ++pi)
 	{
 		out_statement += *ci;
-		out_statement += *pi;
+		out_statement += **pi;
 	}
 
 	if (ci != _query_chunks.end())
@@ -173,6 +261,50 @@ void hs2client_statement_backend::sql_statement::get_statement(std::string& out_
 	}
 }
 
+/* Renders up-to 'count' rows, starting from the row 'index', as the tuples of a single multi-row statement.
+   The rendering stops early if the next tuple would make the statement longer than 'max_length', although
+   at least one row is always rendered. Returns the number of rows rendered. */
+int hs2client_statement_backend::sql_statement::get_bulk_statement(std::string& out_statement, int index, int count, size_t max_length)
+{
+	if (_is_bulk_insert == false) throw soci_error("The statement does not support bulk inserting.");
+
+	const std::string& head = _query_chunks.front();
+	const std::string& tail = _query_chunks.back();
+	const size_t trailer_length = tail.size() - _values_end_offset - 1;
+
+	out_statement.assign(head, 0, _values_start_offset);
+
+	int rendered = 0;
+	for (; rendered < count; rendered++)
+	{
+		fill_parameter_values_into_list(_values, index + rendered);
+
+		if (_values.size() != _names.size())
+			throw soci_error("Wrong number of parameters.");
+
+		const size_t row_offset = out_statement.size();
+		if (rendered > 0) out_statement += ", ";
+
+		out_statement.append(head, _values_start_offset, std::string::npos);
+		for (size_t i = 0; i < _values.size(); i++)
+		{
+			out_statement += *_values[i];
+
+			if (i + 1 < _values.size()) out_statement += _query_chunks[i + 1];
+			else out_statement.append(tail, 0, _values_end_offset + 1);
+		}
+
+		if (rendered > 0 && out_statement.size() + trailer_length > max_length)
+		{
+			out_statement.resize(row_offset);
+			break;
+		}
+	}
+
+	out_statement.append(tail, _values_end_offset + 1, std::string::npos);
+	return rendered;
+}
+
 const std::string& hs2client_statement_backend::sql_statement::get_parameter_name(int index) const
 {
 	return _names[index];
@@ -181,17 +313,17 @@ const std::string& hs2client_statement_backend::sql_statement::get_parameter_nam
 /* These two methods will be called by 'standard-use-type', 'standard-into-type',
   'vector-use-type' and 'vector-into-type' depending on the query.
 */
-void hs2client_statement_backend::sql_statement::add_parameter_value(int index, char* value)
+std::string& hs2client_statement_backend::sql_statement::add_parameter_value(int index)
 {
-	_parameter_values_by_index[index].push_back(value);
+	return _parameter_values_by_index[index].add();
 }
 
-void hs2client_statement_backend::sql_statement::add_parameter_value(const std::string& parameter_name, char* value)
+std::string& hs2client_statement_backend::sql_statement::add_parameter_value(const std::string& parameter_name)
 {
-	_parameter_values_by_name[parameter_name].push_back(value);
+	return _parameter_values_by_name[parameter_name].add();
 }
 
-void hs2client_statement_backend::sql_statement::fill_parameter_values_into_list(std::vector<char*>& values, int index)
+void hs2client_statement_backend::sql_statement::fill_parameter_values_into_list(std::vector<const std::string*>& values, int index)
 {
 	values.clear();
 
@@ -205,26 +337,187 @@ void hs2client_statement_backend::sql_statement::fill_parameter_values_into_list
 	{
 		for (std::string& name : _names)
 		{
-			values.push_back(_parameter_values_by_name[name][index]);
+			const parameter_values& parameter = _parameter_values_by_name[name];
+			if (static_cast<size_t>(index) >= parameter.count) throw soci_error("Wrong number of parameters.");
+
+			values.push_back(&parameter.values[index]);
 		}
 	}
 	else if (usesParameterByIndex)
 	{
-		for (std::pair<int, std::vector<char*>> itr : _parameter_values_by_index)
+		for (const std::pair<const int, parameter_values>& itr : _parameter_values_by_index)
+		{
+			if (static_cast<size_t>(index) >= itr.second.count) throw soci_error("Wrong number of parameters.");
+
+			values.push_back(&itr.second.values[index]);
+		}
+	}
+}
+
+bool hs2client_statement_backend::segmented_result::fetch_next(hs2client::Operation& operation, int container_size, const hs2client_poll_policy& poll_policy, uint64_t* poll_count)
+{
+	bool data_pending = is_more_data_pending();
+	cleanup();
+
+	_segment_size = container_size;
+	{
+		/* The worker reads the batch size for each of the batches it fetches. */
+		std::lock_guard<std::mutex> lock(_prefetch_mutex);
+		if (_segment_size > _bulk_read_size) _bulk_read_size = _segment_size;
+	}
+
+	if (data_pending == false) return false;
+
+	fetched_batch batch;
+	if (_prefetch_depth == 0)
+	{
+		try
+		{
+			fetch_batch(operation, _bulk_read_size, poll_policy, batch);
+		}
+		catch (...)
+		{
+			_has_more_data = false;
+			throw;
+		}
+	}
+	else
+	{
+		std::unique_lock<std::mutex> lock(_prefetch_mutex);
+
+		if (_prefetch_thread.joinable() == false)
+		{
+			_stop_prefetching = false;
+			_prefetch_thread = std::thread(&segmented_result::prefetch, this, std::ref(operation), poll_policy);
+		}
+
+		_prefetch_condition.wait(lock, [this]() { return _prefetched_batches.empty() == false || _prefetch_error; });
+
+		/* The batches fetched before the failing one are still returned first. The worker has stopped after
+		   the failure, so there is nothing more to wait for once the error has been reported. */
+		if (_prefetched_batches.empty())
+		{
+			std::exception_ptr error = _prefetch_error;
+			_prefetch_error = nullptr;
+			_has_more_data = false;
+
+			lock.unlock();
+			_prefetch_condition.notify_all();
+
+			std::rethrow_exception(error);
+		}
+
+		batch = std::move(_prefetched_batches.front());
+		_prefetched_batches.pop_front();
+
+		lock.unlock();
+		_prefetch_condition.notify_all();
+	}
+
+	if (poll_count != nullptr) (*poll_count) += batch.poll_count;
+
+	_current_result = std::move(batch.results);
+	_has_more_data = batch.has_more_data;
+	_fetched_record_count = batch.record_count;
+	_total_fetched_record_count += _fetched_record_count;
+
+	return (_fetched_record_count > 0);
+}
+
+void hs2client_statement_backend::segmented_result::fetch_batch(hs2client::Operation& operation, uint32_t batch_size, const hs2client_poll_policy& poll_policy, fetched_batch& batch)
+{
+	std::unique_lock<std::mutex> lock;
+	if (_operation_mutex != nullptr) lock = std::unique_lock<std::mutex>(*_operation_mutex);
+
+	operation.Fetch(batch_size, hs2client::FetchOrientation::NEXT, &batch.results, &batch.has_more_data);
+	if (lock.owns_lock()) lock.unlock();
+
+	/* AFAIK Fetching is a blocking operation and most likely doesn't require this. But... */
+	hs2client::Operation::State status = wait_for_operation_to_complete(operation, poll_policy, &batch.poll_count, _operation_mutex);
+	if (status != hs2client::Operation::State::FINISHED)
+	{
+		/* When fetching on the prefetch worker, this error is stored and rethrown to the consumer by 'fetch_next' */
+		std::stringstream str_error;
+		str_error << "Failed to fetch results, the operation is in the " << operation_state_name(status) << " state";
+
+		throw soci_error(str_error.str());
+	}
+
+	if (_operation_mutex != nullptr) lock.lock();
+	batch.record_count = hs2client_statement_backend::get_fetched_row_count(operation, *batch.results);
+}
+
+/* Runs on the background worker, fetching up-to '_prefetch_depth' batches ahead of the one being consumed. The
+   fetches are done one after another, as each of them continues from where the previous one stopped. */
+void hs2client_statement_backend::segmented_result::prefetch(hs2client::Operation& operation, hs2client_poll_policy poll_policy)
+{
+	while (true)
+	{
+		uint32_t batch_size = 0;
+		{
+			std::unique_lock<std::mutex> lock(_prefetch_mutex);
+			_prefetch_condition.wait(lock, [this]() { return _stop_prefetching || _prefetched_batches.size() < _prefetch_depth; });
+
+			if (_stop_prefetching) return;
+			batch_size = _bulk_read_size;
+		}
+
+		fetched_batch batch;
+		try
+		{
+			fetch_batch(operation, batch_size, poll_policy, batch);
+		}
+		catch (...)
 		{
-			values.push_back(itr.second[index]);
+			{
+				std::lock_guard<std::mutex> lock(_prefetch_mutex);
+				_prefetch_error = std::current_exception();
+			}
+			_prefetch_condition.notify_all();
+
+			return;
 		}
+
+		bool is_last_batch = (batch.has_more_data == false);
+		{
+			std::lock_guard<std::mutex> lock(_prefetch_mutex);
+			_prefetched_batches.push_back(std::move(batch));
+		}
+		_prefetch_condition.notify_all();
+
+		if (is_last_batch) return;
 	}
 }
 
+void hs2client_statement_backend::segmented_result::stop_prefetching()
+{
+	if (_prefetch_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(_prefetch_mutex);
+			_stop_prefetching = true;
+		}
+		_prefetch_condition.notify_all();
+
+		_prefetch_thread.join();
+	}
+
+	_prefetched_batches.clear();
+	_prefetch_error = nullptr;
+	_stop_prefetching = false;
+}
+
 hs2client_statement_backend::hs2client_statement_backend(hs2client_session_backend &session) : 
 _session(session),
 _current_statement(nullptr),
 _current_operation(nullptr),
 _bulk_read_size(session.get_bulk_read_size()),
+_bulk_insert_size(session.get_bulk_insert_size()),
+_max_statement_length(session.get_max_statement_length()),
+_poll_policy(session.get_poll_policy()),
 _just_described(false),
 _affected_row_count(-1),
-_current_result(_bulk_read_size)
+_current_result(_bulk_read_size, session.get_prefetch_depth(), &session.get_operation_mutex())
 {
 }
 
@@ -245,14 +538,18 @@ void hs2client_statement_backend::alloc()
 
 void hs2client_statement_backend::clean_up()
 {
+	/* The background fetches (if any) have to be stopped before closing their operation */
+	_current_result.reset();
+
 	if (_current_operation.get() != nullptr)
 	{
+		std::lock_guard<std::mutex> lock(_session.get_operation_mutex());
+
 		_current_operation->Close();
 		_current_operation.release();
 	}
 
 	if (_current_statement != nullptr) _current_statement->clear_all_parameter_values();
-	_current_result.reset();
 }
 
 void hs2client_statement_backend::prepare(const std::string& query, statement_type /* eType */)
@@ -265,64 +562,79 @@ void hs2client_statement_backend::execute_statements(int number)
 {
 	if (_session.is_connected() == false) throw soci_error("Unable to execute query via a closed connection.");
 
-	std::vector<std::string*> statements_to_execute;
+	_affected_row_count = -1;
+	_state_poll_count = 0;
+
+	/* The statements are rendered into the same buffer, which is kept across the executions */
+	std::string& statement = _statement_buffer;
 	if (_use_element_count == element_count::none)
 	{
-		std::string* statement = new std::string();
-		_current_statement->get_statement(*statement);
+		_current_statement->get_statement(statement);
+		execute_single_statement(statement);
+	}
+	else if (number > 1 && _bulk_insert_size > 1 && _current_statement->is_bulk_insert())
+	{
+		/* Rendering the batch into multi-row 'INSERT ... VALUES (...), (...)' statements, so that each chunk
+		   of rows is ingested by a single operation instead of an operation per row. */
+		for (int i = 0; i < number; )
+		{
+			int count = std::min(number - i, static_cast<int>(_bulk_insert_size));
 
-		statements_to_execute.push_back(statement);
+			i += _current_statement->get_bulk_statement(statement, i, count, _max_statement_length);
+			execute_single_statement(statement);
+		}
 	}
 	else /* Just of readability's sake */
 	{
 		for (int i = 0; i < number; i++)
 		{
-			std::string* statement = new std::string();
-			_current_statement->get_statement(*statement, i);
-
-			statements_to_execute.push_back(statement);
+			_current_statement->get_statement(statement, i);
+			execute_single_statement(statement);
 		}
 	}
+}
 
-	for (std::string* statement : statements_to_execute)
+void hs2client_statement_backend::execute_single_statement(const std::string& statement)
+{
+	if (_current_operation.get() != nullptr)
 	{
-		if (_current_operation.get() != nullptr)
-			_current_operation->Close();
+		std::lock_guard<std::mutex> lock(_session.get_operation_mutex());
+		_current_operation->Close();
+	}
 
-		_session.execute_statement(*statement, &_current_operation);
+	_session.execute_statement(statement, &_current_operation);
 
-		hs2client::Operation::State status = wait_for_operation_to_complete(*_current_operation);
-		if (status != hs2client::Operation::State::FINISHED)
-		{
-			std::stringstream str_error;
-			str_error << "Failed to execute query/statement '" << *statement << "'";
+	hs2client::Operation::State status = wait_for_operation_to_complete(*_current_operation, _poll_policy, &_state_poll_count, &_session.get_operation_mutex());
+	if (status != hs2client::Operation::State::FINISHED)
+	{
+		std::stringstream str_error;
+		str_error << "Failed to execute query/statement '" << statement << "'";
 
-			delete statement;
-			throw soci_error(str_error.str());
-		}
+		throw soci_error(str_error.str());
+	}
 
-		#ifdef ENABLE_MODIFIED_COUNT_FETCHING
-			std::string profile_output_string;
+	#ifdef ENABLE_MODIFIED_COUNT_FETCHING
+		std::string profile_output_string;
+		{
+			std::lock_guard<std::mutex> lock(_session.get_operation_mutex());
 			_current_operation->GetProfile(&profile_output_string);
+		}
 
-			int modified_count, error_count;
-			get_affected_row_count_from_profile(profile_output_string, modified_count, error_count);
+		int modified_count, error_count;
+		get_affected_row_count_from_profile(profile_output_string, modified_count, error_count);
 
-			_affected_row_count = modified_count;
-			if (error_count > 0)
-			{
-				std::stringstream str_error;
-				str_error << "Some errors were thrown during the execution of query/statement '" << *statement << "'. Please consult the log for more details.";
+		/* A bulk execution could be split into several statements, hence accumulating */
+		if (modified_count >= 0)
+			_affected_row_count = (_affected_row_count < 0 ? 0 : _affected_row_count) + modified_count;
 
-				delete statement;
-				throw soci_error(str_error.str());
-			}
-		#else
-			_affected_row_count = -1;
-		#endif
+		if (error_count > 0)
+		{
+			std::stringstream str_error;
+			str_error << "Some errors were thrown during the execution of query/statement '" << statement << "'. Please consult the log for more details.";
 
-		delete statement;
-	}
+			throw soci_error(str_error.str());
+		}
+	#endif
 }
 
 /* The parameter 'number' is somewhat misleading. The following is the much better description
@@ -332,8 +644,8 @@ Called to execute the query; if number is zero, the intent is not to exchange da
 user-provided objects (into and use elements); positive values mean the number of rows to
 exchange (more than 1 is used only for bulk operations).
 
-Initially we are going to process bulk inserts as separate individual queries. So,
-TODO : Fix the bulk entry situation
+Bulk inserts of the form 'INSERT ... VALUES (...)' are rendered into multi-row statements of up-to
+'BulkInsertSize' rows each, while the rest of the bulk operations are processed as separate individual queries.
 */
 statement_backend::exec_fetch_result hs2client_statement_backend::execute(int number)
 {
@@ -356,7 +668,10 @@ statement_backend::exec_fetch_result hs2client_statement_backend::execute(int nu
 	}
 
 	std::vector<hs2client::ColumnDesc> columns;
-	_current_operation->GetResultSetMetadata(&columns);
+	{
+		std::lock_guard<std::mutex> lock(_session.get_operation_mutex());
+		_current_operation->GetResultSetMetadata(&columns);
+	}
 
 	bool is_a_fetch_query = (columns.empty() == false); // Whether the query fetches data
 
@@ -384,7 +699,7 @@ statement_backend::exec_fetch_result hs2client_statement_backend::fetch(int numb
 
 	if (_current_result.is_buffer_empty())
 	{
-		bool found_data = _current_result.fetch_next(*_current_operation, number);
+		bool found_data = _current_result.fetch_next(*_current_operation, number, _poll_policy, &_state_poll_count);
 		if (found_data == false) return ef_no_data;
 	}
 
@@ -422,7 +737,10 @@ int hs2client_statement_backend::prepare_for_describe()
 	_just_described = true;
 
 	std::vector<hs2client::ColumnDesc> column_descriptions;
-	_current_operation->GetResultSetMetadata(&column_descriptions);
+	{
+		std::lock_guard<std::mutex> lock(_session.get_operation_mutex());
+		_current_operation->GetResultSetMetadata(&column_descriptions);
+	}
 
 	return column_descriptions.size();
 }
@@ -484,7 +802,10 @@ void hs2client_statement_backend::describe_column(int column_index, data_type& d
 	}
 
 	std::vector<hs2client::ColumnDesc> column_descriptions;
-	_current_operation->GetResultSetMetadata(&column_descriptions);
+	{
+		std::lock_guard<std::mutex> lock(_session.get_operation_mutex());
+		_current_operation->GetResultSetMetadata(&column_descriptions);
+	}
 
 	// Because apparently these column indexes start from 1
 	column_index -= 1;
@@ -552,15 +873,26 @@ hs2client_vector_use_type_backend * hs2client_statement_backend::make_vector_use
     return new hs2client_vector_use_type_backend(*this);
 }
 
-hs2client::Operation::State hs2client_statement_backend::wait_for_operation_to_complete(hs2client::Operation& operation)
+/* Polls the state of the operation with an exponentially growing interval (capped by the poll policy), so that
+   long running queries aren't polled thousands of times a second, while short ones still complete promptly. */
+hs2client::Operation::State hs2client_statement_backend::wait_for_operation_to_complete(hs2client::Operation& operation, const hs2client_poll_policy& poll_policy, uint64_t* poll_count, std::mutex* operation_mutex)
 {
+	hs2client_backoff backoff(poll_policy);
 	hs2client::Operation::State current_state = hs2client::Operation::State::UNKNOWN;
-	while (current_state == hs2client::Operation::State::PENDING ||
-		   current_state == hs2client::Operation::State::RUNNING ||
-		   current_state == hs2client::Operation::State::UNKNOWN)
+
+	while (true)
 	{
-		operation.GetState(&current_state);
-		usleep(50);
+		if (operation_mutex != nullptr)
+		{
+			std::lock_guard<std::mutex> lock(*operation_mutex);
+			operation.GetState(&current_state);
+		}
+		else operation.GetState(&current_state);
+
+		if (poll_count != nullptr) (*poll_count)++;
+
+		if (hs2client_operation_poller::is_pending(current_state) == false) break;
+		backoff.sleep();
 	}
 
 	return current_state;
@@ -7,27 +7,24 @@
 
 #define SOCI_HS2CLIENT_SOURCE
 #include "soci/hs2client/soci-hs2client.h"
+#include "hs2client/common.h"
 
 using namespace soci;
 using namespace soci::details;
 
-#define FETCH_AND_PUT_VALUE(data_type, column_value, column_index, indicators, row_count)	\
-		std::vector<data_type>* data_vector = (static_cast<std::vector<data_type>*>(_data)); \
-		if (container_row_index == 0) \
-		{ \
-			data_vector->clear(); \
-			data_vector->resize(row_count); \
-		} \
-		\
-		if (column_value->length() > container_row_index && column_value->IsNull(segment_row_index) == false) \
-		{ \
-			if (data_vector->size() <= static_cast<size_t>(container_row_index)) \
-				data_vector->resize(container_row_index + 1); \
-			\
-			(*data_vector)[container_row_index] = column_value->GetData(segment_row_index); \
-			if (indicators != nullptr) indicators[container_row_index] = i_ok; \
-		} \
-		else if (indicators != nullptr) indicators[container_row_index] = i_null;
+namespace
+{
+	/* Decodes the current segment of a column in one go, fetching the column object only once */
+	template <typename T, typename Column>
+	void decode_column(const hs2client::ColumnarRowSet& results, int column_index, uint32_t start, uint32_t end, void* data, indicator* ind)
+	{
+		std::unique_ptr<Column> column = results.GetCol<Column>(column_index);
+		const Column& col = *column;
+
+		hs2client_columns::decode_fixed_width_column(col.data().data(), col.length(), [&col](std::size_t i) { return col.IsNull(i); },
+			start, end, *static_cast<std::vector<T>*>(data), ind);
+	}
+}
 
 void hs2client_vector_into_type_backend::define_by_pos(int& position, void* data, exchange_type type)
 {
@@ -52,97 +49,44 @@ void hs2client_vector_into_type_backend::post_fetch(bool got_data, indicator* in
 	const hs2client_statement_backend::segmented_result& segment = _statement.get_current_results();
 	const hs2client::ColumnarRowSet& current_results = segment.get_results();
 
-	/* We don't really have a direct way of getting the result length.
-	So we are going to read the first row to get an idea. The issue
-	with this method is that, each column could return different
-	result lengths. Unfortunately we don't have any other way of doing this
-	*/
-	int row_count = segment.get_segment_size();
-	uint32_t segment_row_index = segment.get_segment_start_offset();
-	uint32_t container_row_index = 0;
+	const uint32_t start = segment.get_segment_start_offset();
+	const uint32_t end = segment.get_segment_end_offset();
 
-	for (; segment_row_index < segment.get_segment_end_offset(); segment_row_index++, container_row_index++)
+	switch (_type)
 	{
-		switch (_type)
+		/* We have to treat char as int8_t */
+		case x_char:				decode_column<char, hs2client::ByteColumn>(current_results, column_index, start, end, _data, ind); break;
+		case x_short:				decode_column<short, hs2client::Int16Column>(current_results, column_index, start, end, _data, ind); break;
+		case x_integer:				decode_column<int, hs2client::Int32Column>(current_results, column_index, start, end, _data, ind); break;
+		case x_long_long:			decode_column<long long, hs2client::Int64Column>(current_results, column_index, start, end, _data, ind); break;
+		// TODO : Not entire sure whether there should be a warning here.
+		case x_unsigned_long_long:	decode_column<unsigned long long, hs2client::Int64Column>(current_results, column_index, start, end, _data, ind); break;
+		case x_double:				decode_column<double, hs2client::DoubleColumn>(current_results, column_index, start, end, _data, ind); break;
+
+		case x_stdstring:
 		{
-			case x_char:
-			{
-				std::unique_ptr<hs2client::ByteColumn> col = current_results.GetCol<hs2client::ByteColumn>(column_index);
-				FETCH_AND_PUT_VALUE(char, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_stdstring:
-			{
-				std::unique_ptr<hs2client::StringColumn> col = current_results.GetCol<hs2client::StringColumn>(column_index);
-				FETCH_AND_PUT_VALUE(std::string, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_short:
-			{
-				std::unique_ptr<hs2client::Int16Column> col = current_results.GetCol<hs2client::Int16Column>(column_index);
-				FETCH_AND_PUT_VALUE(int16_t, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_integer:
-			{
-				std::unique_ptr<hs2client::Int32Column> col = current_results.GetCol<hs2client::Int32Column>(column_index);
-				FETCH_AND_PUT_VALUE(int32_t, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_long_long:
-			{
-				std::unique_ptr<hs2client::Int64Column> col = current_results.GetCol<hs2client::Int64Column>(column_index);
-				FETCH_AND_PUT_VALUE(int64_t, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_unsigned_long_long:
-			{
-				// TODO : Not entire sure whether there should be a warning here.
-				std::unique_ptr<hs2client::Int64Column> col = current_results.GetCol<hs2client::Int64Column>(column_index);
-				FETCH_AND_PUT_VALUE(int64_t, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_double:
-			{
-				std::unique_ptr<hs2client::DoubleColumn> col = current_results.GetCol<hs2client::DoubleColumn>(column_index);
-				FETCH_AND_PUT_VALUE(double, col, column_index, ind, row_count);
-			}
-			break;
-
-			case x_stdtm:
-			{
-				/* We expect the date & time columns to be of type long(int64),
-				and we expect the time in UTC, GMT, 0 in both directions */
-				std::unique_ptr<hs2client::Int64Column> column_value = current_results.GetCol<hs2client::Int64Column>(column_index);
-				std::vector<std::tm>* data_vector = (static_cast<std::vector<std::tm>*>(_data));
-
-				if (container_row_index == 0)
-				{ 
-					data_vector->clear(); 
-					data_vector->resize(row_count);
-				} 
-				
-				if (column_value->length() > container_row_index && column_value->IsNull(segment_row_index) == false)
-				{
-					time_t time = column_value->GetData(segment_row_index);
-					(*data_vector)[container_row_index] = *localtime(&time);
-
-					if (ind != nullptr) ind[container_row_index] = i_ok;
-				} 
-				else if (ind != nullptr) ind[container_row_index] = i_null;
-			}
-			break;
-			break;
-
-			default:
-				throw soci_error("Into element used with non-supported type.");
+			std::unique_ptr<hs2client::StringColumn> column = current_results.GetCol<hs2client::StringColumn>(column_index);
+			const hs2client::StringColumn& col = *column;
+
+			hs2client_columns::decode_string_column(col.data().data(), col.length(), [&col](std::size_t i) { return col.IsNull(i); },
+				start, end, *static_cast<std::vector<std::string>*>(_data), ind);
+		}
+		break;
+
+		case x_stdtm:
+		{
+			/* We expect the date & time columns to be of type long(int64),
+			and we expect the time in UTC, GMT, 0 in both directions */
+			std::unique_ptr<hs2client::Int64Column> column = current_results.GetCol<hs2client::Int64Column>(column_index);
+			const hs2client::Int64Column& col = *column;
+
+			hs2client_columns::decode_time_column(col.data().data(), col.length(), [&col](std::size_t i) { return col.IsNull(i); },
+				start, end, *static_cast<std::vector<std::tm>*>(_data), ind);
 		}
+		break;
+
+		default:
+			throw soci_error("Into element used with non-supported type.");
 	}
 }
 
@@ -7,11 +7,7 @@
 
 #define SOCI_HS2CLIENT_SOURCE
 #include "soci/hs2client/soci-hs2client.h"
-
-#include <cstring>
-#include <limits>
-#include "soci-exchange-cast.h"
-#include "soci-dtocstr.h"
+#include "hs2client/common.h"
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
@@ -51,125 +47,30 @@ void hs2client_vector_use_type_backend::pre_use(const indicator* ind)
 	const std::size_t vsize = size();
 	for (size_t i = 0; i != vsize; ++i)
 	{
-		char* buf;
+		std::string& value = (_position > 0) ?
+			_statement.get_current_statement().add_parameter_value(_position) : // binding by position
+			_statement.get_current_statement().add_parameter_value(_name); // binding by name
 
 		// the data in vector can be either i_ok or i_null
 		if (ind != NULL && ind[i] == i_null)
 		{
-			buf = new char[5];
-			std::strcpy(buf, "NULL");
-		}
-		else
-		{
-			// allocate and fill the buffer with text-formatted client data
-			switch (_type)
-			{
-				/* We have to treat char as int8_t */
-				case x_char:
-				{
-					std::vector<char> *pv = static_cast<std::vector<char> *>(_data);
-					std::vector<char> &v = *pv;
-
-					const std::size_t buf_size = std::numeric_limits<char>::digits10 + 3;
-					buf = new char[buf_size];
-
-					snprintf(buf, buf_size, "%d", static_cast<int>(exchange_type_cast<x_char>(&v[i])));
-				}
-				break;
-
-				case x_stdstring:
-				{
-					std::vector<std::string> *pv = static_cast<std::vector<std::string> *>(_data);
-					std::vector<std::string> &v = *pv;
-
-					const std::string& s = v[i];
-					soci::utils::escape_string_to_buffer(s, buf);
-				}
-				break;
-
-				case x_short:
-				{
-					std::vector<short> *pv = static_cast<std::vector<short> *>(_data);
-					std::vector<short> &v = *pv;
-					const std::size_t buf_size = std::numeric_limits<short>::digits10 + 3;
-					buf = new char[buf_size];
-
-					snprintf(buf, buf_size, "%d", static_cast<int>(v[i]));
-				}
-				break;
-
-				case x_integer:
-				{
-					std::vector<int> *pv = static_cast<std::vector<int> *>(_data);
-					std::vector<int> &v = *pv;
-					const std::size_t buf_size = std::numeric_limits<int>::digits10 + 3;
-					buf = new char[buf_size];
-
-					snprintf(buf, buf_size, "%d", v[i]);
-				}
-				break;
-
-				case x_long_long:
-				{
-					std::vector<long long> *pv = static_cast<std::vector<long long> *>(_data);
-					std::vector<long long> &v = *pv;
-					const std::size_t buf_size = std::numeric_limits<long long>::digits10 + 3;
-					buf = new char[buf_size];
-
-					snprintf(buf, buf_size, "%" LL_FMT_FLAGS "d", v[i]);
-				}
-				break;
-
-				case x_unsigned_long_long:
-				{
-					std::vector<unsigned long long> *pv = static_cast<std::vector<unsigned long long> *>(_data);
-					std::vector<unsigned long long> &v = *pv; 
-					const std::size_t buf_size = std::numeric_limits<unsigned long long>::digits10 + 3;
-					buf = new char[buf_size];
-
-					snprintf(buf, buf_size, "%" LL_FMT_FLAGS "u", v[i]);
-				}
-				break;
-
-				case x_double:
-				{
-					std::vector<double> *pv = static_cast<std::vector<double> *>(_data);
-					std::vector<double> &v = *pv;
-
-					const std::string s = double_to_cstring(v[i]);
-
-					buf = new char[s.size() + 1];
-					std::strcpy(buf, s.c_str());
-				}
-				break;
-
-				case x_stdtm:
-				{
-					std::vector<std::tm> *pv = static_cast<std::vector<std::tm> *>(_data);
-					std::vector<std::tm> &v = *pv;
-
-					std::tm& time = exchange_type_cast<x_stdtm>(&v[i]);
-					const std::size_t buf_size = std::numeric_limits<unsigned long long>::digits10 + 3;
-
-					buf = new char[buf_size];
-					snprintf(buf, buf_size, "%li", mktime(&time));
-				}
-				break;
-
-				default:
-					throw soci_error("Use vector element used with non-supported type.");
-			}
+			value.assign("NULL");
+			continue;
 		}
 
-		if (_position > 0)
-		{
-			// binding by position
-			_statement.get_current_statement().add_parameter_value(_position, buf);
-		}
-		else
+		switch (_type)
 		{
-			// binding by name
-			_statement.get_current_statement().add_parameter_value(_name, buf);
+			case x_char:				hs2client_parameters::render_value(_type, &(*static_cast<std::vector<char>*>(_data))[i], value); break;
+			case x_stdstring:			hs2client_parameters::render_value(_type, &(*static_cast<std::vector<std::string>*>(_data))[i], value); break;
+			case x_short:				hs2client_parameters::render_value(_type, &(*static_cast<std::vector<short>*>(_data))[i], value); break;
+			case x_integer:				hs2client_parameters::render_value(_type, &(*static_cast<std::vector<int>*>(_data))[i], value); break;
+			case x_long_long:			hs2client_parameters::render_value(_type, &(*static_cast<std::vector<long long>*>(_data))[i], value); break;
+			case x_unsigned_long_long:	hs2client_parameters::render_value(_type, &(*static_cast<std::vector<unsigned long long>*>(_data))[i], value); break;
+			case x_double:				hs2client_parameters::render_value(_type, &(*static_cast<std::vector<double>*>(_data))[i], value); break;
+			case x_stdtm:				hs2client_parameters::render_value(_type, &(*static_cast<std::vector<std::tm>*>(_data))[i], value); break;
+
+			default:
+				throw soci_error("Use vector element used with non-supported type.");
 		}
 	}
 }
@@ -11,11 +11,11 @@
 #include "soci/mysql/soci-mysql.h"
 #include "soci-cstrtod.h"
 #include "soci-compiler.h"
+#include "soci-text-codec.h"
 // std
 #include <cstddef>
 #include <ctime>
-#include <locale>
-#include <sstream>
+#include <string>
 #include <vector>
 
 namespace soci
@@ -51,9 +51,7 @@ bool is_infinity_or_nan(T x)
 template <typename T>
 void parse_num(char const *buf, T &x)
 {
-    std::istringstream iss(buf);
-    iss >> x;
-    if (iss.fail() || (iss.eof() == false))
+    if (!parse_integer(buf, x))
     {
         throw soci_error("Cannot convert data.");
     }
@@ -70,6 +68,20 @@ void parse_num(char const *buf, double &x)
     }
 }
 
+// helper for formatting dates as quoted strings, the returned buffer must be
+// deleted by the caller
+inline
+char * quote_std_tm(std::tm const &t)
+{
+    char *buf = new char[std_tm_text_buffer_size + 2];
+    buf[0] = '\'';
+    std::size_t const len = format_std_tm(t, buf + 1);
+    buf[len + 1] = '\'';
+    buf[len + 2] = '\0';
+
+    return buf;
+}
+
 // helper for escaping strings
 char * quote(MYSQL * conn, const char *s, size_t len);
 
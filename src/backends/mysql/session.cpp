@@ -9,6 +9,7 @@
 #define SOCI_MYSQL_SOURCE
 #include "soci/mysql/soci-mysql.h"
 #include "soci/connection-parameters.h"
+#include "soci-text-codec.h"
 // std
 #include <cctype>
 #include <cerrno>
@@ -173,7 +174,9 @@ void parse_connect_string(const string & connectString,
     string *charset, bool *charset_p,
     unsigned int *connect_timeout, bool *connect_timeout_p,
     unsigned int *read_timeout, bool *read_timeout_p,
-    unsigned int *write_timeout, bool *write_timeout_p)
+    unsigned int *write_timeout, bool *write_timeout_p,
+    int *bulk_batching, bool *bulk_batching_p,
+    int *stream_results, bool *stream_results_p)
 {
     *host_p = false;
     *user_p = false;
@@ -189,6 +192,8 @@ void parse_connect_string(const string & connectString,
     *connect_timeout_p = false;
     *read_timeout_p = false;
     *write_timeout_p = false;
+    *bulk_batching_p = false;
+    *stream_results_p = false;
     string err = "Malformed connection string.";
     string::const_iterator i = connectString.begin(),
         end = connectString.end();
@@ -302,6 +307,32 @@ void parse_connect_string(const string & connectString,
             *write_timeout = std::strtoul(val.c_str(), &end, 10);
             *write_timeout_p = true;
         }
+        else if (par == "bulk_batching" && !*bulk_batching_p)
+        {
+            if (!valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *bulk_batching = std::atoi(val.c_str());
+            if (*bulk_batching != 0 && *bulk_batching != 1)
+            {
+                throw soci_error(err);
+            }
+            *bulk_batching_p = true;
+        }
+        else if (par == "stream_results" && !*stream_results_p)
+        {
+            if (!valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *stream_results = std::atoi(val.c_str());
+            if (*stream_results != 0 && *stream_results != 1)
+            {
+                throw soci_error(err);
+            }
+            *stream_results_p = true;
+        }
         else
         {
             throw soci_error(err);
@@ -325,14 +356,16 @@ void parse_connect_string(const string & connectString,
 
 mysql_session_backend::mysql_session_backend(
     connection_parameters const & parameters)
+    : bulkBatching_(true), streamResults_(false), maxAllowedPacket_(0)
 {
     string host, user, password, db, unix_socket, ssl_ca, ssl_cert, ssl_key,
         charset;
-    int port, local_infile;
+    int port, local_infile, bulk_batching, stream_results;
     unsigned int connect_timeout, read_timeout, write_timeout;
     bool host_p, user_p, password_p, db_p, unix_socket_p, port_p,
         ssl_ca_p, ssl_cert_p, ssl_key_p, local_infile_p, charset_p,
-        connect_timeout_p, read_timeout_p, write_timeout_p;
+        connect_timeout_p, read_timeout_p, write_timeout_p, bulk_batching_p,
+        stream_results_p;
     parse_connect_string(parameters.get_connect_string(), &host, &host_p, &user, &user_p,
         &password, &password_p, &db, &db_p,
         &unix_socket, &unix_socket_p, &port, &port_p,
@@ -340,7 +373,17 @@ mysql_session_backend::mysql_session_backend(
         &local_infile, &local_infile_p, &charset, &charset_p,
         &connect_timeout, &connect_timeout_p,
         &read_timeout, &read_timeout_p,
-        &write_timeout, &write_timeout_p);
+        &write_timeout, &write_timeout_p,
+        &bulk_batching, &bulk_batching_p,
+        &stream_results, &stream_results_p);
+    if (bulk_batching_p)
+    {
+        bulkBatching_ = bulk_batching == 1;
+    }
+    if (stream_results_p)
+    {
+        streamResults_ = stream_results == 1;
+    }
     conn_ = mysql_init(NULL);
     if (conn_ == NULL)
     {
@@ -470,6 +513,34 @@ bool mysql_session_backend::get_last_insert_id(
     return true;
 }
 
+std::size_t mysql_session_backend::get_max_allowed_packet()
+{
+    if (maxAllowedPacket_ == 0)
+    {
+        hard_exec(conn_, "SELECT @@max_allowed_packet");
+
+        MYSQL_RES *res = mysql_store_result(conn_);
+        if (res == NULL)
+        {
+            throw mysql_soci_error(mysql_error(conn_), mysql_errno(conn_));
+        }
+
+        MYSQL_ROW row = mysql_fetch_row(res);
+        unsigned long long value = 0;
+        if (row == NULL || row[0] == NULL || !parse_integer(row[0], value))
+        {
+            // This is the smallest default value used by the server.
+            value = 1024 * 1024;
+        }
+
+        mysql_free_result(res);
+
+        maxAllowedPacket_ = static_cast<std::size_t>(value);
+    }
+
+    return maxAllowedPacket_;
+}
+
 void mysql_session_backend::clean_up()
 {
     if (conn_ != NULL)
@@ -54,10 +54,7 @@ void mysql_standard_into_type_backend::post_fetch(
     if (gotData)
     {
         int pos = position_ - 1;
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
-        MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+        MYSQL_ROW row = statement_.get_row(statement_.currentRow_);
         if (row[pos] == NULL)
         {
             if (ind == NULL)
@@ -84,8 +81,7 @@ void mysql_standard_into_type_backend::post_fetch(
         case x_stdstring:
             {
                 std::string& dest = exchange_type_cast<x_stdstring>(data_);
-                unsigned long * lengths =
-                    mysql_fetch_lengths(statement_.result_);
+                unsigned long * lengths = statement_.get_row_lengths();
                 dest.assign(buf, lengths[pos]);
             }
             break;
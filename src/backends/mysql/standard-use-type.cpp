@@ -10,7 +10,6 @@
 #include "soci/mysql/soci-mysql.h"
 #include "common.h"
 #include "soci/soci-platform.h"
-#include "soci-dtocstr.h"
 #include "soci-exchange-cast.h"
 // std
 #include <ciso646>
@@ -65,38 +64,20 @@ void mysql_standard_use_type_backend::pre_use(indicator const *ind)
             }
             break;
         case x_short:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<short>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    static_cast<int>(exchange_type_cast<x_short>(data_)));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_short>(data_), buf_);
             break;
         case x_integer:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<int>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d", exchange_type_cast<x_integer>(data_));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_integer>(data_), buf_);
             break;
         case x_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<long long>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "d", exchange_type_cast<x_long_long>(data_));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_long_long>(data_), buf_);
             break;
         case x_unsigned_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long long>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "u",
-                         exchange_type_cast<x_unsigned_long_long>(data_));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_unsigned_long_long>(data_), buf_);
             break;
 
         case x_double:
@@ -108,23 +89,12 @@ void mysql_standard_use_type_backend::pre_use(indicator const *ind)
                         "not supported by the MySQL server.");
                 }
 
-                std::string const s = double_to_cstring(d);
-
-                buf_ = new char[s.size() + 1];
-                std::strcpy(buf_, s.c_str());
+                buf_ = new char[number_text_buffer_size];
+                format_double(d, buf_);
             }
             break;
         case x_stdtm:
-            {
-                std::size_t const bufSize = 80;
-                buf_ = new char[bufSize];
-
-                std::tm const& t = exchange_type_cast<x_stdtm>(data_);
-                snprintf(buf_, bufSize,
-                    "\'%d-%02d-%02d %02d:%02d:%02d\'",
-                    t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
-                    t.tm_hour, t.tm_min, t.tm_sec);
-            }
+            buf_ = quote_std_tm(exchange_type_cast<x_stdtm>(data_));
             break;
         default:
             throw soci_error("Use element used with non-supported type.");
@@ -8,6 +8,7 @@
 
 #define SOCI_MYSQL_SOURCE
 #include "soci/mysql/soci-mysql.h"
+#include <algorithm>
 #include <cctype>
 #include <ciso646>
 
@@ -15,11 +16,246 @@ using namespace soci;
 using namespace soci::details;
 using std::string;
 
+namespace // anonymous
+{
+
+bool is_identifier_char(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+// Check whether the given keyword, in lower case, occurs in the query at the
+// given position as a separate word.
+bool is_keyword_at(std::string const &query, std::size_t pos,
+    char const *keyword)
+{
+    if (pos != 0 && is_identifier_char(query[pos - 1]))
+    {
+        return false;
+    }
+
+    for (; *keyword != '\0'; ++keyword, ++pos)
+    {
+        if (pos == query.size() ||
+            std::tolower(static_cast<unsigned char>(query[pos])) != *keyword)
+        {
+            return false;
+        }
+    }
+
+    return pos == query.size() || !is_identifier_char(query[pos]);
+}
+
+std::size_t skip_space(std::string const &query, std::size_t pos)
+{
+    while (pos < query.size() &&
+        std::isspace(static_cast<unsigned char>(query[pos])))
+    {
+        ++pos;
+    }
+
+    return pos;
+}
+
+// Return the position of the quote closing the string, identifier or name
+// starting with the quote at the given position or npos if it's not closed.
+std::size_t skip_quoted(std::string const &query, std::size_t pos)
+{
+    char const quote = query[pos];
+    for (++pos; pos < query.size(); ++pos)
+    {
+        if (query[pos] == '\\' && quote != '`')
+        {
+            ++pos;
+        }
+        else if (query[pos] == quote)
+        {
+            return pos;
+        }
+    }
+
+    return std::string::npos;
+}
+
+// Return the position after the parenthesis matching the one at the given
+// position or npos if it's not closed.
+std::size_t skip_parenthesized(std::string const &query, std::size_t pos)
+{
+    int depth = 0;
+    for (; pos < query.size(); ++pos)
+    {
+        switch (query[pos])
+        {
+        case '\'':
+        case '"':
+        case '`':
+            pos = skip_quoted(query, pos);
+            if (pos == std::string::npos)
+            {
+                return pos;
+            }
+            break;
+        case '(':
+            ++depth;
+            break;
+        case ')':
+            if (--depth == 0)
+            {
+                return pos + 1;
+            }
+            break;
+        }
+    }
+
+    return std::string::npos;
+}
+
+// Find the row values in "INSERT ... VALUES (...)" query, which can be
+// repeated to insert several rows using a single statement.
+//
+// Returns false if the query doesn't have this form, e.g. because it uses
+// INSERT ... SELECT or has an ON DUPLICATE KEY UPDATE clause.
+bool find_insert_values(std::string const &query,
+    std::size_t &valuesPos, std::size_t &valuesTail)
+{
+    std::size_t pos = skip_space(query, 0);
+    if (!is_keyword_at(query, pos, "insert"))
+    {
+        return false;
+    }
+
+    // Find the VALUES keyword outside of the columns list.
+    int depth = 0;
+    for (;; ++pos)
+    {
+        if (pos >= query.size())
+        {
+            return false;
+        }
+
+        char const c = query[pos];
+        if (c == '\'' || c == '"' || c == '`')
+        {
+            pos = skip_quoted(query, pos);
+            if (pos == std::string::npos)
+            {
+                return false;
+            }
+        }
+        else if (c == '(')
+        {
+            ++depth;
+        }
+        else if (c == ')')
+        {
+            --depth;
+        }
+        else if (depth == 0)
+        {
+            if (is_keyword_at(query, pos, "values"))
+            {
+                pos += 6;
+                break;
+            }
+
+            if (is_keyword_at(query, pos, "value"))
+            {
+                pos += 5;
+                break;
+            }
+        }
+    }
+
+    pos = skip_space(query, pos);
+    if (pos == query.size() || query[pos] != '(')
+    {
+        return false;
+    }
+
+    valuesPos = pos;
+
+    for (;;)
+    {
+        pos = skip_parenthesized(query, pos);
+        if (pos == std::string::npos)
+        {
+            return false;
+        }
+
+        std::size_t const end = pos;
+
+        pos = skip_space(query, pos);
+        if (pos < query.size() && query[pos] == ',')
+        {
+            pos = skip_space(query, pos + 1);
+            if (pos == query.size() || query[pos] != '(')
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        // Nothing but the optional semicolon can follow the values.
+        if (pos < query.size() && query[pos] == ';')
+        {
+            pos = skip_space(query, pos + 1);
+        }
+
+        if (pos != query.size())
+        {
+            return false;
+        }
+
+        valuesTail = query.size() - end;
+        return true;
+    }
+}
+
+// Enables multiple statements in the same query during its lifetime, if they
+// are not enabled yet, and restores the previous state when it ends.
+class multi_statements_guard
+{
+public:
+    multi_statements_guard(MYSQL *conn, bool enable)
+        : conn_(conn),
+          wasEnabled_((conn->client_flag & CLIENT_MULTI_STATEMENTS) != 0),
+          enabled_(wasEnabled_)
+    {
+        if (enable && !enabled_)
+        {
+            enabled_ = mysql_set_server_option(conn,
+                MYSQL_OPTION_MULTI_STATEMENTS_ON) == 0;
+        }
+    }
+
+    ~multi_statements_guard()
+    {
+        if (enabled_ && !wasEnabled_)
+        {
+            mysql_set_server_option(conn_, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+        }
+    }
+
+    bool enabled() const { return enabled_; }
+
+private:
+    MYSQL *conn_;
+    bool const wasEnabled_;
+    bool enabled_;
+
+    SOCI_NOT_COPYABLE(multi_statements_guard)
+};
+
+} // namespace anonymous
+
 
 mysql_statement_backend::mysql_statement_backend(
     mysql_session_backend &session)
     : session_(session), result_(NULL),
-       rowsAffectedBulk_(-1LL), justDescribed_(false),
+       rowsAffectedBulk_(-1LL), bulkMode_(bulk_one_by_one),
+       valuesPos_(0), valuesTail_(0), justDescribed_(false),
+       streamEnded_(false), rowValuesPos_(0),
        hasIntoElements_(false), hasVectorIntoElements_(false),
        hasUseElements_(false), hasVectorUseElements_(false)
 {
@@ -117,6 +353,26 @@ void mysql_statement_backend::prepare(std::string const & query,
     {
         names_.push_back(name);
     }
+
+    // The values of all the rows must follow the common part of the query,
+    // which must not contain any parameters.
+    bulkMode_ = bulk_one_by_one;
+    if (find_insert_values(query, valuesPos_, valuesTail_) &&
+        valuesPos_ < queryChunks_.front().size())
+    {
+        bulkMode_ = bulk_multi_row_insert;
+    }
+    else
+    {
+        std::size_t const start = skip_space(query, 0);
+        if (is_keyword_at(query, start, "insert") ||
+            is_keyword_at(query, start, "update") ||
+            is_keyword_at(query, start, "delete") ||
+            is_keyword_at(query, start, "replace"))
+        {
+            bulkMode_ = bulk_multi_statement;
+        }
+    }
 /*
   cerr << "Chunks: ";
   for (std::vector<std::string>::iterator i = queryChunks_.begin();
@@ -163,104 +419,18 @@ mysql_statement_backend::execute(int number)
                     "Binding for use elements must be either by position "
                     "or by name.");
             }
-            long long rowsAffectedBulkTemp = -1;
-            for (int i = 0; i != numberOfExecutions; ++i)
-            {
-                std::vector<char *> paramValues;
 
-                if (not useByPosBuffers_.empty())
-                {
-                    // use elements bind by position
-                    // the map of use buffers can be traversed
-                    // in its natural order
-
-                    for (UseByPosBuffersMap::iterator
-                             it = useByPosBuffers_.begin(),
-                             end = useByPosBuffers_.end();
-                         it != end; ++it)
-                    {
-                        char **buffers = it->second;
-                        //cerr<<"i: "<<i<<", buffers[i]: "<<buffers[i]<<endl;
-                        paramValues.push_back(buffers[i]);
-                    }
-                }
-                else
-                {
-                    // use elements bind by name
-
-                    for (std::vector<std::string>::iterator
-                             it = names_.begin(), end = names_.end();
-                         it != end; ++it)
-                    {
-                        UseByNameBuffersMap::iterator b
-                            = useByNameBuffers_.find(*it);
-                        if (b == useByNameBuffers_.end())
-                        {
-                            std::string msg(
-                                "Missing use element for bind by name (");
-                            msg += *it;
-                            msg += ").";
-                            throw soci_error(msg);
-                        }
-                        char **buffers = b->second;
-                        paramValues.push_back(buffers[i]);
-                    }
-                }
-                //cerr << "queryChunks_.size(): "<<queryChunks_.size()<<endl;
-                //cerr << "paramValues.size(): "<<paramValues.size()<<endl;
-                if (queryChunks_.size() != paramValues.size()
-                    and queryChunks_.size() != paramValues.size() + 1)
-                {
-                    throw soci_error("Wrong number of parameters.");
-                }
+            std::vector<char **> buffers;
+            get_use_buffers(buffers);
 
-                std::vector<std::string>::const_iterator ci
-                    = queryChunks_.begin();
-                for (std::vector<char*>::const_iterator
-                         pi = paramValues.begin(), end = paramValues.end();
-                     pi != end; ++ci, ++pi)
-                {
-                    query += *ci;
-                    query += *pi;
-                }
-                if (ci != queryChunks_.end())
-                {
-                    query += *ci;
-                }
-                if (numberOfExecutions > 1)
-                {
-                    // bulk operation
-                    //std::cerr << "bulk operation:\n" << query << std::endl;
-                    if (0 != mysql_real_query(session_.conn_, query.c_str(),
-                            static_cast<unsigned long>(query.size())))
-                    {
-                        // preserve the number of rows affected so far.
-                        rowsAffectedBulk_ = rowsAffectedBulkTemp;
-                        throw mysql_soci_error(mysql_error(session_.conn_),
-                            mysql_errno(session_.conn_));
-                    }
-                    else
-                    {
-                        if(rowsAffectedBulkTemp == -1)
-                        {
-                            rowsAffectedBulkTemp = 0;
-                        }
-                        rowsAffectedBulkTemp += static_cast<long long>(mysql_affected_rows(session_.conn_));
-                    }
-                    if (mysql_field_count(session_.conn_) != 0)
-                    {
-                        throw soci_error("The query shouldn't have returned"
-                            " any data but it did.");
-                    }
-                    query.clear();
-                }
-            }
-            rowsAffectedBulk_ = rowsAffectedBulkTemp;
             if (numberOfExecutions > 1)
             {
-                // bulk
+                // bulk operation
+                execute_bulk(buffers, numberOfExecutions);
                 return ef_no_data;
             }
+
+            append_row_query(query, buffers, 0);
         }
         else
         {
@@ -274,13 +444,15 @@ mysql_statement_backend::execute(int number)
             throw mysql_soci_error(mysql_error(session_.conn_),
                 mysql_errno(session_.conn_));
         }
-        result_ = mysql_store_result(session_.conn_);
+        result_ = session_.streamResults_
+            ? mysql_use_result(session_.conn_)
+            : mysql_store_result(session_.conn_);
         if (result_ == NULL and mysql_field_count(session_.conn_) != 0)
         {
             throw mysql_soci_error(mysql_error(session_.conn_),
                 mysql_errno(session_.conn_));
         }
-        if (result_ != NULL)
+        if (result_ != NULL and not session_.streamResults_)
         {
             // Cache the rows offsets to have random access to the rows later.
             // [mysql_data_seek() is O(n) so we don't want to use it].
@@ -303,6 +475,15 @@ mysql_statement_backend::execute(int number)
         currentRow_ = 0;
         rowsToConsume_ = 0;
 
+        if (session_.streamResults_)
+        {
+            // the number of rows is unknown until they are all fetched
+            numberOfRows_ = 0;
+            streamEnded_ = false;
+
+            return number > 0 ? fetch(number) : ef_success;
+        }
+
         numberOfRows_ = static_cast<int>(mysql_num_rows(result_));
         if (numberOfRows_ == 0)
         {
@@ -329,6 +510,205 @@ mysql_statement_backend::execute(int number)
     }
 }
 
+void mysql_statement_backend::get_use_buffers(std::vector<char **> &buffers)
+{
+    if (not useByPosBuffers_.empty())
+    {
+        // use elements bind by position
+        // the map of use buffers can be traversed
+        // in its natural order
+
+        for (UseByPosBuffersMap::iterator
+                 it = useByPosBuffers_.begin(),
+                 end = useByPosBuffers_.end();
+             it != end; ++it)
+        {
+            buffers.push_back(it->second);
+        }
+    }
+    else
+    {
+        // use elements bind by name
+
+        for (std::vector<std::string>::iterator
+                 it = names_.begin(), end = names_.end();
+             it != end; ++it)
+        {
+            UseByNameBuffersMap::iterator b
+                = useByNameBuffers_.find(*it);
+            if (b == useByNameBuffers_.end())
+            {
+                std::string msg(
+                    "Missing use element for bind by name (");
+                msg += *it;
+                msg += ").";
+                throw soci_error(msg);
+            }
+            buffers.push_back(b->second);
+        }
+    }
+
+    if (queryChunks_.size() != buffers.size()
+        and queryChunks_.size() != buffers.size() + 1)
+    {
+        throw soci_error("Wrong number of parameters.");
+    }
+}
+
+void mysql_statement_backend::append_row_query(std::string &query,
+    std::vector<char **> const &buffers, int row)
+{
+    std::vector<std::string>::const_iterator ci = queryChunks_.begin();
+    for (std::vector<char **>::const_iterator
+             bi = buffers.begin(), end = buffers.end();
+         bi != end; ++ci, ++bi)
+    {
+        query += *ci;
+        query += (*bi)[row];
+    }
+    if (ci != queryChunks_.end())
+    {
+        query += *ci;
+    }
+}
+
+void mysql_statement_backend::execute_bulk(
+    std::vector<char **> const &buffers, int rows)
+{
+    bulk_mode mode = session_.bulkBatching_ ? bulkMode_ : bulk_one_by_one;
+
+    multi_statements_guard multiStatements(session_.conn_,
+        mode == bulk_multi_statement);
+    if (mode == bulk_multi_statement && !multiStatements.enabled())
+    {
+        mode = bulk_one_by_one;
+    }
+
+    std::string query;
+    if (mode == bulk_one_by_one)
+    {
+        for (int i = 0; i != rows; ++i)
+        {
+            query.clear();
+            append_row_query(query, buffers, i);
+            execute_bulk_query(query);
+        }
+
+        return;
+    }
+
+    // Combine as many rows as fit into a single packet, leaving some space
+    // for its header.
+    std::size_t const maxPacket = session_.get_max_allowed_packet();
+    std::size_t const maxQuerySize
+        = maxPacket - std::min<std::size_t>(maxPacket / 2, 1024);
+
+    std::string row;
+    bool empty = true;
+    for (int i = 0; i != rows; ++i)
+    {
+        row.clear();
+        append_row_query(row, buffers, i);
+
+        // The part of this row query to append to the combined query.
+        std::size_t start = 0;
+        std::size_t length = row.size();
+        char const *separator;
+        if (mode == bulk_multi_row_insert)
+        {
+            start = valuesPos_;
+            length -= valuesPos_ + valuesTail_;
+            separator = ", ";
+        }
+        else
+        {
+            while (length != 0 && (row[length - 1] == ';' ||
+                std::isspace(static_cast<unsigned char>(row[length - 1]))))
+            {
+                --length;
+            }
+            // Start the separator with a new line to terminate the
+            // comment which may end the previous statement.
+            separator = "\n;";
+        }
+
+        if (!empty && query.size() + 2 + length > maxQuerySize)
+        {
+            execute_bulk_query(query);
+            empty = true;
+        }
+
+        if (empty)
+        {
+            // For INSERT, this is the common part preceding the values.
+            query.assign(row, 0, start);
+            empty = false;
+        }
+        else
+        {
+            query += separator;
+        }
+
+        query.append(row, start, length);
+    }
+
+    execute_bulk_query(query);
+}
+
+void mysql_statement_backend::execute_bulk_query(std::string const &query)
+{
+    if (0 != mysql_real_query(session_.conn_, query.c_str(),
+            static_cast<unsigned long>(query.size())))
+    {
+        throw mysql_soci_error(mysql_error(session_.conn_),
+            mysql_errno(session_.conn_));
+    }
+
+    // With multiple statements, the results of all of them must be consumed
+    // before returning, even if one of them fails.
+    bool gotData = false;
+    for (;;)
+    {
+        if (mysql_field_count(session_.conn_) != 0)
+        {
+            MYSQL_RES *res = mysql_store_result(session_.conn_);
+            if (res != NULL)
+            {
+                mysql_free_result(res);
+            }
+            gotData = true;
+        }
+        else
+        {
+            // preserve the number of rows affected so far in case of error.
+            if (rowsAffectedBulk_ == -1)
+            {
+                rowsAffectedBulk_ = 0;
+            }
+            rowsAffectedBulk_ += static_cast<long long>(
+                mysql_affected_rows(session_.conn_));
+        }
+
+        int const status = mysql_next_result(session_.conn_);
+        if (status == -1)
+        {
+            break;
+        }
+
+        if (status > 0)
+        {
+            throw mysql_soci_error(mysql_error(session_.conn_),
+                mysql_errno(session_.conn_));
+        }
+    }
+
+    if (gotData)
+    {
+        throw soci_error("The query shouldn't have returned"
+            " any data but it did.");
+    }
+}
+
 statement_backend::exec_fetch_result
 mysql_statement_backend::fetch(int number)
 {
@@ -341,6 +721,11 @@ mysql_statement_backend::fetch(int number)
     // forward the "cursor" from the last fetch
     currentRow_ += rowsToConsume_;
 
+    if (session_.streamResults_)
+    {
+        return fetch_streamed(number);
+    }
+
     if (currentRow_ >= numberOfRows_)
     {
         // all rows were already consumed
@@ -365,6 +750,95 @@ mysql_statement_backend::fetch(int number)
     }
 }
 
+statement_backend::exec_fetch_result
+mysql_statement_backend::fetch_streamed(int number)
+{
+    // The values returned by mysql_fetch_row() for a result retrieved with
+    // mysql_use_result() are only valid until the next call to it, so copy
+    // the values of the rows of this fetch, and only them, to our buffer.
+    rowsToConsume_ = 0;
+    streamData_.clear();
+    streamOffsets_.clear();
+    streamLengths_.clear();
+
+    if (result_ == NULL || streamEnded_)
+    {
+        return ef_no_data;
+    }
+
+    unsigned int const numFields = mysql_num_fields(result_);
+    while (rowsToConsume_ < number)
+    {
+        MYSQL_ROW row = mysql_fetch_row(result_);
+        if (row == NULL)
+        {
+            if (mysql_errno(session_.conn_) != 0)
+            {
+                throw mysql_soci_error(mysql_error(session_.conn_),
+                    mysql_errno(session_.conn_));
+            }
+
+            streamEnded_ = true;
+            break;
+        }
+
+        unsigned long const * const lengths = mysql_fetch_lengths(result_);
+        for (unsigned int i = 0; i != numFields; ++i)
+        {
+            streamLengths_.push_back(lengths[i]);
+            if (row[i] == NULL)
+            {
+                streamOffsets_.push_back(std::string::npos);
+                continue;
+            }
+
+            streamOffsets_.push_back(streamData_.size());
+            streamData_.insert(streamData_.end(), row[i], row[i] + lengths[i]);
+            streamData_.push_back('\0');
+        }
+
+        ++rowsToConsume_;
+    }
+
+    // now that the buffer won't be reallocated any more, point to the values
+    streamValues_.resize(streamOffsets_.size());
+    for (std::size_t i = 0; i != streamOffsets_.size(); ++i)
+    {
+        streamValues_[i] = streamOffsets_[i] == std::string::npos
+            ? NULL : &streamData_[streamOffsets_[i]];
+    }
+
+    numberOfRows_ = currentRow_ + rowsToConsume_;
+
+    // as above, ef_no_data is returned when EOF is hit, even if some rows
+    // were fetched
+    return streamEnded_ ? ef_no_data : ef_success;
+}
+
+MYSQL_ROW mysql_statement_backend::get_row(int row)
+{
+    if (session_.streamResults_)
+    {
+        std::size_t const numFields = mysql_num_fields(result_);
+        rowValuesPos_ = static_cast<std::size_t>(row - currentRow_) * numFields;
+
+        return &streamValues_[rowValuesPos_];
+    }
+
+    mysql_row_seek(result_, resultRowOffsets_[row]);
+    return mysql_fetch_row(result_);
+}
+
+unsigned long * mysql_statement_backend::get_row_lengths()
+{
+    if (session_.streamResults_)
+    {
+        return &streamLengths_[rowValuesPos_];
+    }
+
+    return mysql_fetch_lengths(result_);
+}
+
 long long mysql_statement_backend::get_affected_rows()
 {
     if (rowsAffectedBulk_ >= 0)
@@ -394,7 +868,9 @@ std::string mysql_statement_backend::rewrite_for_procedure_call(
 
 int mysql_statement_backend::prepare_for_describe()
 {
-    execute(1);
+    // don't consume any rows of the streamed results, as they couldn't be
+    // fetched again when the statement is executed after describing it
+    execute(session_.streamResults_ ? 0 : 1);
     justDescribed_ = true;
 
     int columns = mysql_field_count(session_.conn_);
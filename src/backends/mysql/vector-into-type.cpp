@@ -58,13 +58,10 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
 
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
         for (int curRow = statement_.currentRow_, i = 0;
              curRow != endRow; ++curRow, ++i)
         {
-            MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+            MYSQL_ROW row = statement_.get_row(curRow);
             // first, deal with indicators
             if (row[pos] == NULL)
             {
@@ -97,8 +94,7 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
                 break;
             case x_stdstring:
                 {
-                    unsigned long * lengths =
-                        mysql_fetch_lengths(statement_.result_);
+                    unsigned long * lengths = statement_.get_row_lengths();
                     // Not sure if it's necessary, but the code below is used
                     // instead of
                     // set_invector_(data_, i, std::string(buf, lengths[pos]);
@@ -10,8 +10,8 @@
 #include "soci/odbc/soci-odbc.h"
 #include "soci-exchange-cast.h"
 #include "soci-mktime.h"
+#include "soci-text-codec.h"
 #include <ctime>
-#include <stdio.h>  // sscanf()
 
 using namespace soci;
 using namespace soci::details;
@@ -182,7 +182,7 @@ void odbc_standard_into_type_backend::post_fetch(
         else if (type_ == x_long_long && use_string_for_bigint())
         {
           long long& ll = exchange_type_cast<x_long_long>(data_);
-          if (sscanf(buf_, "%" LL_FMT_FLAGS "d", &ll) != 1)
+          if (!parse_integer(buf_, ll))
           {
             throw soci_error("Failed to parse the returned 64-bit integer value");
           }
@@ -190,7 +190,7 @@ void odbc_standard_into_type_backend::post_fetch(
         else if (type_ == x_unsigned_long_long && use_string_for_bigint())
         {
           unsigned long long& ll = exchange_type_cast<x_unsigned_long_long>(data_);
-          if (sscanf(buf_, "%" LL_FMT_FLAGS "u", &ll) != 1)
+          if (!parse_integer(buf_, ll))
           {
             throw soci_error("Failed to parse the returned 64-bit integer value");
           }
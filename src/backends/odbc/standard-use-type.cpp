@@ -7,6 +7,7 @@
 #include "soci/soci-platform.h"
 #include "soci/odbc/soci-odbc.h"
 #include "soci-exchange-cast.h"
+#include "soci-text-codec.h"
 #include <cctype>
 #include <cstdio>
 #include <cstring>
@@ -39,8 +40,7 @@ void* odbc_standard_use_type_backend::prepare_for_bind(
           cType = SQL_C_CHAR;
           size = max_bigint_length;
           buf_ = new char[size];
-          snprintf(buf_, size, "%" LL_FMT_FLAGS "d",
-                   exchange_type_cast<x_long_long>(data_));
+          format_integer(exchange_type_cast<x_long_long>(data_), buf_);
           indHolder_ = SQL_NTS;
         }
         else // Normal case, use ODBC support.
@@ -57,8 +57,7 @@ void* odbc_standard_use_type_backend::prepare_for_bind(
           cType = SQL_C_CHAR;
           size = max_bigint_length;
           buf_ = new char[size];
-          snprintf(buf_, size, "%" LL_FMT_FLAGS "u",
-                   exchange_type_cast<x_unsigned_long_long>(data_));
+          format_integer(exchange_type_cast<x_unsigned_long_long>(data_), buf_);
           indHolder_ = SQL_NTS;
         }
         else // Normal case, use ODBC support.
@@ -9,6 +9,7 @@
 #include "soci/soci-platform.h"
 #include "soci/odbc/soci-odbc.h"
 #include "soci-static-assert.h"
+#include "soci-text-codec.h"
 #include <cctype>
 #include <cstdio>
 #include <cstring>
@@ -343,7 +344,7 @@ void odbc_vector_use_type_backend::pre_use(indicator const *ind)
                 std::size_t const vsize = v.size();
                 for (std::size_t i = 0; i != vsize; ++i)
                 {
-                    snprintf(pos, max_bigint_length, "%" LL_FMT_FLAGS "d", v[i]);
+                    format_integer(v[i], pos);
                     pos += max_bigint_length;
                 }
 
@@ -362,7 +363,7 @@ void odbc_vector_use_type_backend::pre_use(indicator const *ind)
                 std::size_t const vsize = v.size();
                 for (std::size_t i = 0; i != vsize; ++i)
                 {
-                    snprintf(pos, max_bigint_length, "%" LL_FMT_FLAGS "u", v[i]);
+                    format_integer(v[i], pos);
                     pos += max_bigint_length;
                 }
 
@@ -11,8 +11,8 @@
 #include "soci/rowid.h"
 #include "soci/type-wrappers.h"
 #include "soci/soci-platform.h"
-#include "soci-dtocstr.h"
 #include "soci-exchange-cast.h"
+#include "soci-text-codec.h"
 #include <libpq/libpq-fs.h> // libpq
 #include <cctype>
 #include <cstdio>
@@ -68,54 +68,28 @@ void postgresql_standard_use_type_backend::pre_use(indicator const * ind)
             copy_from_string(exchange_type_cast<x_stdstring>(data_));
             break;
         case x_short:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<short>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    static_cast<int>(exchange_type_cast<x_short>(data_)));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_short>(data_), buf_);
             break;
         case x_integer:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<int>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    exchange_type_cast<x_integer>(data_));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_integer>(data_), buf_);
             break;
         case x_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<long long>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "d",
-                    exchange_type_cast<x_long_long>(data_));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_long_long>(data_), buf_);
             break;
         case x_unsigned_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long long>::digits10 + 2;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "u",
-                    exchange_type_cast<x_unsigned_long_long>(data_));
-            }
+            buf_ = new char[number_text_buffer_size];
+            format_integer(exchange_type_cast<x_unsigned_long_long>(data_), buf_);
             break;
         case x_double:
-            copy_from_string(double_to_cstring(exchange_type_cast<x_double>(data_)));
+            buf_ = new char[number_text_buffer_size];
+            format_double(exchange_type_cast<x_double>(data_), buf_);
             break;
         case x_stdtm:
-            {
-                std::size_t const bufSize = 80;
-                buf_ = new char[bufSize];
-
-                std::tm const& t = exchange_type_cast<x_stdtm>(data_);
-                snprintf(buf_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                    t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
-                    t.tm_hour, t.tm_min, t.tm_sec);
-            }
+            buf_ = new char[std_tm_text_buffer_size];
+            format_std_tm(exchange_type_cast<x_stdtm>(data_), buf_);
             break;
         case x_rowid:
             {
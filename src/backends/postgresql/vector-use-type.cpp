@@ -8,7 +8,7 @@
 #define SOCI_POSTGRESQL_SOURCE
 #include "soci/soci-platform.h"
 #include "soci/postgresql/soci-postgresql.h"
-#include "soci-dtocstr.h"
+#include "soci-text-codec.h"
 #include "common.h"
 #include "soci/type-wrappers.h"
 #include <libpq/libpq-fs.h> // libpq
@@ -104,10 +104,8 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
                         = static_cast<std::vector<short> *>(data_);
                     std::vector<short> & v = *pv;
 
-                    std::size_t const bufSize
-                        = std::numeric_limits<short>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", static_cast<int>(v[i]));
+                    buf = new char[number_text_buffer_size];
+                    format_integer(v[i], buf);
                 }
                 break;
             case x_integer:
@@ -116,10 +114,8 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
                         = static_cast<std::vector<int> *>(data_);
                     std::vector<int> & v = *pv;
 
-                    std::size_t const bufSize
-                        = std::numeric_limits<int>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", v[i]);
+                    buf = new char[number_text_buffer_size];
+                    format_integer(v[i], buf);
                 }
                 break;
             case x_long_long:
@@ -128,10 +124,8 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
                         = static_cast<std::vector<long long>*>(data_);
                     std::vector<long long>& v = *pv;
 
-                    std::size_t const bufSize
-                        = std::numeric_limits<long long>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "d", v[i]);
+                    buf = new char[number_text_buffer_size];
+                    format_integer(v[i], buf);
                 }
                 break;
             case x_unsigned_long_long:
@@ -140,10 +134,8 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
                         = static_cast<std::vector<unsigned long long>*>(data_);
                     std::vector<unsigned long long>& v = *pv;
 
-                    std::size_t const bufSize
-                        = std::numeric_limits<unsigned long long>::digits10 + 2;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "u", v[i]);
+                    buf = new char[number_text_buffer_size];
+                    format_integer(v[i], buf);
                 }
                 break;
             case x_double:
@@ -152,10 +144,8 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
                         = static_cast<std::vector<double> *>(data_);
                     std::vector<double> & v = *pv;
 
-                    std::string const s = double_to_cstring(v[i]);
-
-                    buf = new char[s.size() + 1];
-                    std::strcpy(buf, s.c_str());
+                    buf = new char[number_text_buffer_size];
+                    format_double(v[i], buf);
                 }
                 break;
             case x_stdtm:
@@ -164,12 +154,8 @@ void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
                         = static_cast<std::vector<std::tm> *>(data_);
                     std::vector<std::tm> & v = *pv;
 
-                    std::size_t const bufSize = 80;
-                    buf = new char[bufSize];
-
-                    snprintf(buf, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        v[i].tm_year + 1900, v[i].tm_mon + 1, v[i].tm_mday,
-                        v[i].tm_hour, v[i].tm_min, v[i].tm_sec);
+                    buf = new char[std_tm_text_buffer_size];
+                    format_std_tm(v[i], buf);
                 }
                 break;
             case x_xmltype:
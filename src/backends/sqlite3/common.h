@@ -9,12 +9,11 @@
 #define SOCI_SQLITE3_COMMON_H_INCLUDED
 
 #include "soci/error.h"
+#include "soci-text-codec.h"
 #include <cstddef>
-#include <cstdio>
-#include <cstring>
 #include <ctime>
-#include <vector>
 #include <limits>
+#include <vector>
 
 namespace soci { namespace details { namespace sqlite3 {
 
@@ -37,46 +36,50 @@ void resize_vector(void *p, std::size_t sz)
 template <typename T>
 T string_to_integer(char const * buf)
 {
-    long long t(0);
-    int n(0);
-    int const converted = std::sscanf(buf, "%" LL_FMT_FLAGS "d%n", &t, &n);
-    if (converted == 1 && static_cast<std::size_t>(n) == std::strlen(buf))
+    T t;
+    if (!parse_integer(buf, t))
     {
-        // successfully converted to long long
-        // and no other characters were found in the buffer
-
-        const T max = (std::numeric_limits<T>::max)();
-        const T min = (std::numeric_limits<T>::min)();
-        if (t <= static_cast<long long>(max) &&
-            t >= static_cast<long long>(min))
-        {
-            return static_cast<T>(t);
-        }
+        throw soci_error("Cannot convert data.");
     }
 
-    throw soci_error("Cannot convert data.");
+    return t;
 }
 
 // helper function for parsing unsigned integers
 template <typename T>
 T string_to_unsigned_integer(char const * buf)
 {
-    unsigned long long t(0);
-    int n(0);
-    int const converted = std::sscanf(buf, "%" LL_FMT_FLAGS "u%n", &t, &n);
-    if (converted == 1 && static_cast<std::size_t>(n) == std::strlen(buf))
+    // negative values wrap around, as with strtoull()
+    T t;
+    if (!parse_unsigned_integer(buf, t))
     {
-        // successfully converted to unsigned long long
-        // and no other characters were found in the buffer
+        throw soci_error("Cannot convert data.");
+    }
+
+    return t;
+}
 
-        T const max = (std::numeric_limits<T>::max)();
-        if (t <= static_cast<unsigned long long>(max))
-        {
-            return static_cast<T>(t);
-        }
+// helper function for parsing numbers of any type stored as text
+template <typename T>
+T string_to_number(char const * buf)
+{
+    return std::numeric_limits<T>::is_signed
+        ? string_to_integer<T>(buf)
+        : string_to_unsigned_integer<T>(buf);
+}
+
+// specialization for the floating point values stored as text
+template <>
+inline
+double string_to_number<double>(char const * buf)
+{
+    double d;
+    if (!parse_double(buf, d))
+    {
+        throw soci_error("Cannot convert data.");
     }
 
-    throw soci_error("Cannot convert data.");
+    return d;
 }
 
 }}} // namespace soci::details::sqlite3
@@ -10,7 +10,7 @@
 #include "soci/sqlite3/soci-sqlite3.h"
 #include "soci/rowid.h"
 #include "soci/blob.h"
-#include "soci-dtocstr.h"
+#include "soci-text-codec.h"
 #include "soci-exchange-cast.h"
 // std
 #include <cstdio>
@@ -138,16 +138,10 @@ void sqlite3_standard_use_type_backend::pre_use(indicator const * ind)
         case x_stdtm:
         {
             col.type_ = dt_date;
-            static const size_t bufSize = 20;
             std::tm &t = exchange_type_cast<x_stdtm>(data_);
 
-            col.buffer_.data_ = new char[bufSize];
-            col.buffer_.size_
-                = snprintf(
-                    col.buffer_.data_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                    t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
-                    t.tm_hour, t.tm_min, t.tm_sec
-                );
+            col.buffer_.data_ = new char[std_tm_text_buffer_size];
+            col.buffer_.size_ = format_std_tm(t, col.buffer_.data_);
             break;
         }
 
@@ -23,6 +23,16 @@ using namespace soci;
 using namespace soci::details;
 using namespace sqlite_api;
 
+namespace // anonymous
+{
+
+// The maximal size of the buffer for the text and blob values kept between
+// the fetches, to avoid keeping the memory used by a big fetch allocated for
+// the lifetime of the statement.
+std::size_t const max_kept_cache_buffer_size = 1024 * 1024;
+
+} // namespace anonymous
+
 sqlite3_statement_backend::sqlite3_statement_backend(
     sqlite3_session_backend &session)
     : session_(session)
@@ -123,6 +133,18 @@ sqlite3_statement_backend::load_rowset(int totalRows)
     }
     else
     {
+        // Only the rows of this fetch are stored, and they're loaded from the
+        // database one by one, so the memory used is bounded by the batch
+        // size, but don't keep it if it was needed for a big batch before.
+        if (dataCacheBuffer_.capacity() > max_kept_cache_buffer_size)
+        {
+            std::vector<char>().swap(dataCacheBuffer_);
+        }
+        else
+        {
+            dataCacheBuffer_.clear();
+        }
+
         // make the vector big enough to hold the data we need
         dataCache_.resize(totalRows);
         for (sqlite3_recordset::iterator it = dataCache_.begin(),
@@ -161,10 +183,15 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                     {
                         case dt_string:
                         case dt_date:
+                        {
+                            // the pointer is set once all the rows are loaded
                             col.buffer_.size_ = sqlite3_column_bytes(stmt_, c);
-                            col.buffer_.data_ = new char[col.buffer_.size_+1];
-                            memcpy(col.buffer_.data_, sqlite3_column_text(stmt_, c), col.buffer_.size_+1);
+                            char const* const text =
+                                reinterpret_cast<char const*>(sqlite3_column_text(stmt_, c));
+                            dataCacheBuffer_.insert(dataCacheBuffer_.end(),
+                                text, text + col.buffer_.size_ + 1);
                             break;
+                        }
 
                         case dt_double:
                             col.double_ = sqlite3_column_double(stmt_, c);
@@ -180,10 +207,14 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                             break;
 
                         case dt_blob:
+                        {
                             col.buffer_.size_ = sqlite3_column_bytes(stmt_, c);
-                            col.buffer_.data_ = (col.buffer_.size_ > 0 ? new char[col.buffer_.size_] : NULL);
-                            memcpy(col.buffer_.data_, sqlite3_column_blob(stmt_, c), col.buffer_.size_);
+                            char const* const blob =
+                                static_cast<char const*>(sqlite3_column_blob(stmt_, c));
+                            dataCacheBuffer_.insert(dataCacheBuffer_.end(),
+                                blob, blob + col.buffer_.size_);
                             break;
+                        }
 
                         case dt_xml:
                             throw soci_error("XML data type is not supported");
@@ -203,6 +234,38 @@ sqlite3_statement_backend::load_rowset(int totalRows)
     // if we read less than requested then shrink the vector
     dataCache_.resize(i);
 
+    // now that the buffer won't be reallocated any more, make the text and
+    // blob values point to their data in it, in the order they were stored
+    char* data = dataCacheBuffer_.empty() ? NULL : &dataCacheBuffer_[0];
+    for (int r = 0; r < i; ++r)
+    {
+        for (int c = 0; c < numCols; ++c)
+        {
+            sqlite3_column &col = dataCache_[r][c];
+            if (col.isNull_)
+            {
+                continue;
+            }
+
+            switch (col.type_)
+            {
+                case dt_string:
+                case dt_date:
+                    col.buffer_.data_ = data;
+                    data += col.buffer_.size_ + 1;
+                    break;
+
+                case dt_blob:
+                    col.buffer_.data_ = col.buffer_.size_ > 0 ? data : NULL;
+                    data += col.buffer_.size_;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
     return retVal;
 }
 
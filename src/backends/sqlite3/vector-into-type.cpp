@@ -53,6 +53,14 @@ void set_in_vector(void* p, int indx, T const& val)
     v[indx] = val;
 }
 
+// Avoid creating a temporary string, the existing vector element can often
+// reuse its buffer.
+void set_string_in_vector(void* p, int indx, char const* s, std::size_t len)
+{
+    std::vector<std::string> &v = *static_cast<std::vector<std::string>*>(p);
+    v[indx].assign(s, len);
+}
+
 template <typename T>
 void set_number_in_vector(void *p, int idx, const sqlite3_column &col)
 {
@@ -64,7 +72,7 @@ void set_number_in_vector(void *p, int idx, const sqlite3_column &col)
         case dt_date:
         case dt_string:
         case dt_blob:
-            set_in_vector(p, idx, string_to_integer<T>(col.buffer_.size_ > 0 ? col.buffer_.constData_ : ""));
+            set_in_vector(p, idx, string_to_number<T>(col.buffer_.size_ > 0 ? col.buffer_.constData_ : ""));
             break;
 
         case dt_double:
@@ -138,18 +146,18 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
 
                     case dt_integer:
                     {
-                        std::ostringstream ss;
-                        ss << col.int32_;
-                        set_in_vector(data_, i, ss.str()[0]);
+                        char buf[number_text_buffer_size];
+                        format_integer(col.int32_, buf);
+                        set_in_vector(data_, i, buf[0]);
                         break;
                     }
 
                     case dt_long_long:
                     case dt_unsigned_long_long:
                     {
-                        std::ostringstream ss;
-                        ss << col.int64_;
-                        set_in_vector(data_, i, ss.str()[0]);
+                        char buf[number_text_buffer_size];
+                        format_integer(col.int64_, buf);
+                        set_in_vector(data_, i, buf[0]);
                         break;
                     }
 
@@ -166,7 +174,7 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
                     case dt_date:
                     case dt_string:
                     case dt_blob:
-                        set_in_vector(data_, i, std::string(col.buffer_.constData_, col.buffer_.size_));
+                        set_string_in_vector(data_, i, col.buffer_.constData_, col.buffer_.size_);
                         break;
 
                     case dt_double:
@@ -175,18 +183,18 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
 
                     case dt_integer:
                     {
-                        std::ostringstream ss;
-                        ss << col.int32_;
-                        set_in_vector(data_, i, ss.str());
+                        char buf[number_text_buffer_size];
+                        set_in_vector(data_, i,
+                            std::string(buf, format_integer(col.int32_, buf)));
                         break;
                     }
 
                     case dt_long_long:
                     case dt_unsigned_long_long:
                     {
-                        std::ostringstream ss;
-                        ss << col.int64_;
-                        set_in_vector(data_, i, ss.str());
+                        char buf[number_text_buffer_size];
+                        set_in_vector(data_, i,
+                            std::string(buf, format_integer(col.int64_, buf)));
                         break;
                     }
 
@@ -247,26 +255,6 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
             default:
                 throw soci_error("Into element used with non-supported type.");
         }
-
-        // cleanup data
-        switch (col.type_)
-        {
-            case dt_date:
-            case dt_string:
-            case dt_blob:
-                delete[] col.buffer_.data_;
-                col.buffer_.data_ = NULL;
-                break;
-
-            case dt_double:
-            case dt_integer:
-            case dt_long_long:
-            case dt_unsigned_long_long:
-                break;
-
-            case dt_xml:
-                throw soci_error("XML data type is not supported");
-        }
     }
 }
 
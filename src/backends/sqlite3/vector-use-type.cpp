@@ -9,7 +9,7 @@
 #include "soci-exchange-cast.h"
 #include "soci/soci-platform.h"
 #include "soci/sqlite3/soci-sqlite3.h"
-#include "soci-dtocstr.h"
+#include "soci-text-codec.h"
 #include "common.h"
 // std
 #include <cstdio>
@@ -139,15 +139,10 @@ void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
             case x_stdtm:
             {
                 std::tm &tm = (*static_cast<std::vector<exchange_type_traits<x_stdtm>::value_type> *>(data_))[i];
-                static const size_t bufSize = 20;
 
                 col.type_ = dt_date;
-                col.buffer_.data_ = new char[bufSize];
-                col.buffer_.size_
-                    = snprintf(col.buffer_.data_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
-                        tm.tm_hour, tm.tm_min, tm.tm_sec
-                    );
+                col.buffer_.data_ = new char[std_tm_text_buffer_size];
+                col.buffer_.size_ = format_std_tm(tm, col.buffer_.data_);
                 break;
             }
 
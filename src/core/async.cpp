@@ -0,0 +1,553 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/async.h"
+#include "soci/error.h"
+#include "soci/metrics.h"
+#include "soci/session.h"
+#include "soci/statement.h"
+#include "soci-thread.h"
+
+#include <deque>
+#include <vector>
+
+using namespace soci;
+using namespace soci::details;
+
+struct async_executor::async_executor_impl
+{
+    explicit async_executor_impl(std::size_t maxPending)
+        : maxPending_(maxPending), stopping_(false)
+    {
+    }
+
+    // Waits until all the submitted tasks are done and stops the workers.
+    void stop()
+    {
+        {
+            scoped_lock lock(mtx_);
+            stopping_ = true;
+        }
+
+        hasTasks_.notify_all();
+
+        for (std::size_t i = 0; i != threads_.size(); ++i)
+        {
+            threads_[i]->join();
+            delete threads_[i];
+        }
+
+        threads_.clear();
+    }
+
+    static void worker(void * arg)
+    {
+        static_cast<async_executor_impl *>(arg)->run_tasks();
+    }
+
+    void run_tasks()
+    {
+        for (;;)
+        {
+            async_task * task;
+            {
+                scoped_lock lock(mtx_);
+                while (tasks_.empty() && stopping_ == false)
+                {
+                    hasTasks_.wait(mtx_);
+                }
+
+                // All the submitted tasks are run before stopping.
+                if (tasks_.empty())
+                {
+                    return;
+                }
+
+                task = tasks_.front();
+                tasks_.pop_front();
+            }
+
+            hasRoom_.notify_one();
+
+            try
+            {
+                task->run();
+            }
+            catch (...)
+            {
+                // The tasks are not supposed to throw, there is nobody to
+                // report the error to anyhow.
+            }
+
+            delete task;
+        }
+    }
+
+    std::size_t const maxPending_;
+
+    mutex mtx_;
+    condition hasTasks_;
+    condition hasRoom_;
+    std::deque<async_task *> tasks_;
+    bool stopping_;
+
+    std::vector<thread *> threads_;
+};
+
+async_executor::async_executor(std::size_t threads, std::size_t maxPending)
+{
+    if (threads == 0)
+    {
+        throw soci_error("Invalid number of executor threads");
+    }
+
+    pimpl_ = new async_executor_impl(maxPending);
+
+    try
+    {
+        for (std::size_t i = 0; i != threads; ++i)
+        {
+            pimpl_->threads_.push_back(
+                new thread(&async_executor_impl::worker, pimpl_));
+        }
+    }
+    catch (...)
+    {
+        pimpl_->stop();
+        delete pimpl_;
+        throw;
+    }
+}
+
+async_executor::~async_executor()
+{
+    pimpl_->stop();
+    delete pimpl_;
+}
+
+void async_executor::submit(async_task * task)
+{
+    {
+        scoped_lock lock(pimpl_->mtx_);
+        if (pimpl_->maxPending_ != 0)
+        {
+            while (pimpl_->tasks_.size() >= pimpl_->maxPending_)
+            {
+                pimpl_->hasRoom_.wait(pimpl_->mtx_);
+            }
+        }
+
+        pimpl_->tasks_.push_back(task);
+    }
+
+    pimpl_->hasTasks_.notify_one();
+}
+
+namespace soci
+{
+
+namespace details
+{
+
+// State shared by all copies of execute_future and the task executing the
+// statement in a worker thread, if any.
+struct async_execute_state
+{
+    async_execute_state(statement_impl & st, bool withDataExchange)
+        : st_(st), withDataExchange_(withDataExchange), num_(0),
+          events_(logger_impl::statement_events_none), start_(0),
+          instrumented_(false), native_(false),
+          refs_(1), futures_(1), done_(false), gotData_(false), error_(NULL)
+    {
+        st_.inc_ref();
+    }
+
+    ~async_execute_state()
+    {
+        delete error_;
+    }
+
+    // Called by the futures in the thread which started the execution.
+    void add_future()
+    {
+        scoped_lock lock(mtx_);
+        ++refs_;
+        ++futures_;
+    }
+
+    void release_future()
+    {
+        bool last;
+        {
+            scoped_lock lock(mtx_);
+            last = --futures_ == 0;
+        }
+
+        if (last)
+        {
+            // The statement can't be released before it's not used any more
+            // and it must be released in the thread which created it, as its
+            // reference count is not thread-safe.
+            wait();
+            st_.dec_ref();
+        }
+
+        release();
+    }
+
+    // Called by both the futures and the task.
+    void release()
+    {
+        bool last;
+        {
+            scoped_lock lock(mtx_);
+            last = --refs_ == 0;
+        }
+
+        if (last)
+        {
+            delete this;
+        }
+    }
+
+    // Performs the part of the execution before the backend call, in the
+    // calling thread. Returns true if the execution must continue in a
+    // worker thread.
+    bool start()
+    {
+        try
+        {
+            // Handle the write batching as statement_impl::execute() does.
+            if (st_.session_.get_write_batch_size() != 0)
+            {
+                if (withDataExchange_ && st_.batch_write(st_.query_))
+                {
+                    complete(false, NULL);
+                    return false;
+                }
+
+                // the queued statements must be executed before this one
+                st_.session_.flush_batched_writes();
+            }
+
+            int const events = st_.session_.get_logger().get_statement_events();
+            if (events != logger_impl::statement_events_none ||
+                st_.session_.get_metrics() != NULL)
+            {
+                start_ = st_.start_operation(so_execute, st_.query_.str(), events);
+                events_ = events;
+                instrumented_ = true;
+            }
+
+            try
+            {
+                num_ = st_.pre_execute(withDataExchange_);
+                native_ = st_.backEnd_->start_execute(num_);
+            }
+            catch (...)
+            {
+                st_.rethrow_current_exception_with_context("executing");
+            }
+        }
+        catch (...)
+        {
+            fail(capture_current_error());
+            return false;
+        }
+
+        return native_ == false;
+    }
+
+    // Performs the rest of the execution, in a worker thread or, for the
+    // natively asynchronous backends, in the calling thread.
+    void finish()
+    {
+        bool gotData = false;
+        soci_error * error = NULL;
+
+        try
+        {
+            try
+            {
+                gotData = st_.post_execute(num_, st_.backEnd_->execute(num_));
+            }
+            catch (...)
+            {
+                st_.rethrow_current_exception_with_context("executing");
+            }
+        }
+        catch (...)
+        {
+            fail(capture_current_error());
+            return;
+        }
+
+        if (instrumented_)
+        {
+            try
+            {
+                st_.end_operation(so_execute, st_.query_.str(), events_, start_,
+                    st_.get_executed_rows(withDataExchange_, gotData), false);
+            }
+            catch (...)
+            {
+                error = capture_current_error();
+            }
+        }
+
+        complete(gotData, error);
+    }
+
+    void fail(soci_error * error)
+    {
+        if (instrumented_)
+        {
+            try
+            {
+                st_.end_operation(so_execute, st_.query_.str(), events_, start_,
+                    0, true);
+            }
+            catch (...)
+            {
+                // Keep the original error.
+            }
+        }
+
+        complete(false, error);
+    }
+
+    void complete(bool gotData, soci_error * error)
+    {
+        {
+            scoped_lock lock(mtx_);
+            gotData_ = gotData;
+            error_ = error;
+            done_ = true;
+        }
+
+        done_cond_.notify_all();
+    }
+
+    bool is_done()
+    {
+        scoped_lock lock(mtx_);
+        return done_;
+    }
+
+    bool wait_for(int timeout)
+    {
+        if (native_)
+        {
+            if (is_done() == false)
+            {
+                if (st_.backEnd_->wait_execute(timeout) == false)
+                {
+                    return false;
+                }
+
+                finish();
+            }
+
+            return true;
+        }
+
+        scoped_lock lock(mtx_);
+        if (timeout < 0)
+        {
+            while (done_ == false)
+            {
+                done_cond_.wait(mtx_);
+            }
+        }
+        else if (done_ == false)
+        {
+            done_cond_.wait_for(mtx_, timeout);
+        }
+
+        return done_;
+    }
+
+    void wait()
+    {
+        wait_for(-1);
+    }
+
+    statement_impl & st_;
+    bool const withDataExchange_;
+
+    // Only used by the thread performing the corresponding execution step.
+    int num_;
+    int events_;
+    long long start_;
+    bool instrumented_;
+    bool native_;
+
+    mutex mtx_;
+    condition done_cond_;
+    int refs_;
+    int futures_;
+    bool done_;
+    bool gotData_;
+    soci_error * error_;
+};
+
+} // namespace details
+
+} // namespace soci
+
+namespace // anonymous
+{
+
+class execute_task : public async_task
+{
+public:
+    explicit execute_task(async_execute_state * state)
+        : state_(state)
+    {
+    }
+
+    ~execute_task()
+    {
+        state_->release();
+    }
+
+    virtual void run() SOCI_OVERRIDE
+    {
+        state_->finish();
+    }
+
+private:
+    async_execute_state * const state_;
+
+    SOCI_NOT_COPYABLE(execute_task)
+};
+
+} // namespace anonymous
+
+execute_future statement_impl::execute_async(bool withDataExchange)
+{
+    async_execute_state * const state =
+        new async_execute_state(*this, withDataExchange);
+    execute_future future(state);
+
+    if (state->start())
+    {
+        // The task holds its own reference to the state.
+        {
+            scoped_lock lock(state->mtx_);
+            ++state->refs_;
+        }
+
+        cxx_details::auto_ptr<async_task> task(new execute_task(state));
+        try
+        {
+            session_.get_executor().submit(task.get());
+        }
+        catch (...)
+        {
+            state->fail(capture_current_error());
+            return future;
+        }
+
+        task.release();
+    }
+
+    return future;
+}
+
+execute_future::execute_future()
+    : state_(NULL)
+{
+}
+
+execute_future::execute_future(async_execute_state * state)
+    : state_(state)
+{
+}
+
+execute_future::execute_future(execute_future const & other)
+    : state_(other.state_)
+{
+    if (state_ != NULL)
+    {
+        state_->add_future();
+    }
+}
+
+execute_future & execute_future::operator=(execute_future const & other)
+{
+    if (other.state_ != NULL)
+    {
+        other.state_->add_future();
+    }
+
+    if (state_ != NULL)
+    {
+        state_->release_future();
+    }
+
+    state_ = other.state_;
+
+    return *this;
+}
+
+execute_future::~execute_future()
+{
+    if (state_ != NULL)
+    {
+        state_->release_future();
+    }
+}
+
+bool execute_future::ready() const
+{
+    if (state_ == NULL)
+    {
+        throw soci_error("Invalid execute_future");
+    }
+
+    return state_->wait_for(0);
+}
+
+void execute_future::wait() const
+{
+    if (state_ == NULL)
+    {
+        throw soci_error("Invalid execute_future");
+    }
+
+    state_->wait();
+}
+
+bool execute_future::wait_for(int timeout) const
+{
+    if (state_ == NULL)
+    {
+        throw soci_error("Invalid execute_future");
+    }
+
+    return state_->wait_for(timeout);
+}
+
+bool execute_future::get() const
+{
+    wait();
+
+    if (state_->error_ != NULL)
+    {
+        state_->error_->raise();
+    }
+
+    return state_->gotData_;
+}
+
+bool execute_future::wait_got_data() const
+{
+    state_->wait();
+
+    return state_->gotData_;
+}
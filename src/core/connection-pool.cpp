@@ -9,6 +9,8 @@
 #include "soci/connection-pool.h"
 #include "soci/error.h"
 #include "soci/session.h"
+#include "soci/metrics.h"
+#include "soci-monotonic-clock.h"
 #include <vector>
 #include <utility>
 
@@ -37,10 +39,56 @@ struct connection_pool::connection_pool_impl
         return false;
     }
 
+    void lock()
+    {
+        if (pthread_mutex_lock(&mtx_) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    void unlock()
+    {
+        pthread_mutex_unlock(&mtx_);
+    }
+
+    // Apply the pool settings to the session at the given position, which
+    // must not be in use.
+    void update_session(std::size_t pos)
+    {
+        sessions_[pos].second->set_metrics(metrics_);
+        sessions_[pos].second->set_result_cache(resultCache_);
+        outdated_[pos] = false;
+    }
+
+    // Apply the pool settings to all the free sessions, the leased ones are
+    // updated when they're given back to avoid changing them while they may
+    // be used by another thread. Must be called with the mutex locked.
+    void update_sessions()
+    {
+        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        {
+            if (sessions_[i].first)
+            {
+                update_session(i);
+            }
+            else
+            {
+                outdated_[i] = true;
+            }
+        }
+    }
+
     // by convention, first == true means the entry is free (not used)
     std::vector<std::pair<bool, session *> > sessions_;
     pthread_mutex_t mtx_;
     pthread_cond_t cond_;
+
+    // true for the leased sessions which must be updated when given back
+    std::vector<bool> outdated_;
+
+    metrics_registry * metrics_;
+    result_cache * resultCache_;
 };
 
 connection_pool::connection_pool(std::size_t size)
@@ -51,7 +99,10 @@ connection_pool::connection_pool(std::size_t size)
     }
 
     pimpl_ = new connection_pool_impl();
+    pimpl_->metrics_ = NULL;
+    pimpl_->resultCache_ = NULL;
     pimpl_->sessions_.resize(size);
+    pimpl_->outdated_.resize(size, false);
     for (std::size_t i = 0; i != size; ++i)
     {
         pimpl_->sessions_[i] = std::make_pair(true, new session());
@@ -83,7 +134,7 @@ connection_pool::~connection_pool()
     delete pimpl_;
 }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
+bool connection_pool::do_try_lease(std::size_t & pos, int timeout)
 {
     struct timespec tm;
     if (timeout >= 0)
@@ -169,6 +220,11 @@ void connection_pool::give_back(std::size_t pos)
         throw soci_error("Cannot release pool entry (already free)");
     }
 
+    if (pimpl_->outdated_[pos])
+    {
+        pimpl_->update_session(pos);
+    }
+
     pimpl_->sessions_[pos].first = true;
 
     pthread_mutex_unlock(&(pimpl_->mtx_));
@@ -199,11 +255,54 @@ struct connection_pool::connection_pool_impl
         return false;
     }
 
+    void lock()
+    {
+        EnterCriticalSection(&mtx_);
+    }
+
+    void unlock()
+    {
+        LeaveCriticalSection(&mtx_);
+    }
+
+    // Apply the pool settings to the session at the given position, which
+    // must not be in use.
+    void update_session(std::size_t pos)
+    {
+        sessions_[pos].second->set_metrics(metrics_);
+        sessions_[pos].second->set_result_cache(resultCache_);
+        outdated_[pos] = false;
+    }
+
+    // Apply the pool settings to all the free sessions, the leased ones are
+    // updated when they're given back to avoid changing them while they may
+    // be used by another thread. Must be called with the mutex locked.
+    void update_sessions()
+    {
+        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        {
+            if (sessions_[i].first)
+            {
+                update_session(i);
+            }
+            else
+            {
+                outdated_[i] = true;
+            }
+        }
+    }
+
     // by convention, first == true means the entry is free (not used)
     std::vector<std::pair<bool, session *> > sessions_;
 
     CRITICAL_SECTION mtx_;
     HANDLE sem_;
+
+    // true for the leased sessions which must be updated when given back
+    std::vector<bool> outdated_;
+
+    metrics_registry * metrics_;
+    result_cache * resultCache_;
 };
 
 connection_pool::connection_pool(std::size_t size)
@@ -214,7 +313,10 @@ connection_pool::connection_pool(std::size_t size)
     }
 
     pimpl_ = new connection_pool_impl();
+    pimpl_->metrics_ = NULL;
+    pimpl_->resultCache_ = NULL;
     pimpl_->sessions_.resize(size);
+    pimpl_->outdated_.resize(size, false);
     for (std::size_t i = 0; i != size; ++i)
     {
         pimpl_->sessions_[i] = std::make_pair(true, new session());
@@ -246,7 +348,7 @@ connection_pool::~connection_pool()
     delete pimpl_;
 }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
+bool connection_pool::do_try_lease(std::size_t & pos, int timeout)
 {
     DWORD cc = WaitForSingleObject(pimpl_->sem_,
         timeout >= 0 ? static_cast<DWORD>(timeout) : INFINITE);
@@ -293,6 +395,11 @@ void connection_pool::give_back(std::size_t pos)
         throw soci_error("Cannot release pool entry (already free)");
     }
 
+    if (pimpl_->outdated_[pos])
+    {
+        pimpl_->update_session(pos);
+    }
+
     pimpl_->sessions_[pos].first = true;
 
     LeaveCriticalSection(&(pimpl_->mtx_));
@@ -323,4 +430,51 @@ std::size_t connection_pool::lease()
     return pos;
 }
 
+bool connection_pool::try_lease(std::size_t & pos, int timeout)
+{
+    metrics_registry * const metrics = get_metrics();
+    if (metrics == NULL)
+    {
+        return do_try_lease(pos, timeout);
+    }
+
+    long long const start = details::get_monotonic_time_ns();
+    bool const leased = do_try_lease(pos, timeout);
+    metrics->record_pool_lease(details::get_monotonic_time_ns() - start, !leased);
+
+    return leased;
+}
+
+void connection_pool::set_metrics(metrics_registry * metrics)
+{
+    pimpl_->lock();
+    pimpl_->metrics_ = metrics;
+    pimpl_->update_sessions();
+    pimpl_->unlock();
+}
+
+metrics_registry * connection_pool::get_metrics() const
+{
+    pimpl_->lock();
+    metrics_registry * const metrics = pimpl_->metrics_;
+    pimpl_->unlock();
+
+    return metrics;
+}
 
+void connection_pool::set_result_cache(result_cache * cache)
+{
+    pimpl_->lock();
+    pimpl_->resultCache_ = cache;
+    pimpl_->update_sessions();
+    pimpl_->unlock();
+}
+
+result_cache * connection_pool::get_result_cache() const
+{
+    pimpl_->lock();
+    result_cache * const cache = pimpl_->resultCache_;
+    pimpl_->unlock();
+
+    return cache;
+}
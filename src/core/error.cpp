@@ -144,4 +144,14 @@ void soci_error::add_context(std::string const& context)
     info_->add_context(context);
 }
 
+soci_error* soci_error::clone() const
+{
+    return new soci_error(*this);
+}
+
+void soci_error::raise() const
+{
+    throw *this;
+}
+
 } // namespace soci
@@ -8,6 +8,8 @@
 #define SOCI_SOURCE
 #include "soci/into-type.h"
 #include "soci/statement.h"
+#include "soci-exchange-cast.h"
+#include "soci-result-cache.h"
 
 using namespace soci;
 using namespace soci::details;
@@ -56,6 +58,36 @@ void standard_into_type::clean_up()
     }
 }
 
+std::size_t standard_into_type::get_data_size() const
+{
+    if (ind_ != NULL && *ind_ == i_null)
+    {
+        return 0;
+    }
+
+    return exchange_data_size(type_, data_);
+}
+
+bool standard_into_type::append_cache_key(std::string & key) const
+{
+    return cache_append_into_key(key, type_);
+}
+
+bool standard_into_type::save_to_cache(std::string & buf, bool gotData) const
+{
+    // nothing is fetched into the single values if there is no data
+    return gotData == false || cache_save_value(buf, type_, data_, ind_);
+}
+
+void standard_into_type::load_from_cache(char const * & p, bool gotData)
+{
+    if (gotData)
+    {
+        cache_load_value(p, type_, data_, ind_);
+        convert_from_base();
+    }
+}
+
 vector_into_type::~vector_into_type()
 {
     delete backEnd_;
@@ -120,6 +152,33 @@ std::size_t vector_into_type::size() const
     return backEnd_->size();
 }
 
+std::size_t vector_into_type::get_data_size() const
+{
+    return exchange_vector_data_size(type_, data_, begin_, end_);
+}
+
+bool vector_into_type::append_cache_key(std::string & key) const
+{
+    // the vectors used with bulk iterators are not cached, as only a part of
+    // them is fetched into
+    return end_ == NULL && cache_append_vector_into_key(key, type_, data_);
+}
+
+bool vector_into_type::save_to_cache(std::string & buf, bool /* gotData */) const
+{
+    return cache_save_vector(buf, type_, data_, indVec_);
+}
+
+void vector_into_type::load_from_cache(char const * & p, bool gotData)
+{
+    cache_load_vector(p, type_, data_, indVec_);
+
+    if (gotData)
+    {
+        convert_from_base();
+    }
+}
+
 void vector_into_type::clean_up()
 {
     if (backEnd_ != NULL)
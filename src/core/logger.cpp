@@ -38,6 +38,24 @@ logger_impl::~logger_impl()
 {
 }
 
+int logger_impl::get_statement_events() const
+{
+    return statement_events_none;
+}
+
+void logger_impl::start_shared_query(details::shared_query const & query)
+{
+    start_query(query.str());
+}
+
+void logger_impl::start_operation(statement_event const &)
+{
+}
+
+void logger_impl::end_operation(statement_event const &)
+{
+}
+
 void logger_impl::set_stream(std::ostream *)
 {
     throw_not_supported();
@@ -66,10 +84,12 @@ logger::logger(logger_impl * impl)
     {
         throw soci_error("Null logger implementation not allowed.");
     }
+
+    m_events = m_impl->get_statement_events();
 }
 
 logger::logger(logger const & other)
-    : m_impl(other.m_impl->clone())
+    : m_impl(other.m_impl->clone()), m_events(other.m_events)
 {
 }
 
@@ -77,6 +97,7 @@ logger& logger::operator=(logger const & other)
 {
     logger_impl * const implOld = m_impl;
     m_impl = other.m_impl->clone();
+    m_events = other.m_events;
     delete implOld;
 
     return *this;
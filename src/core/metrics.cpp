@@ -0,0 +1,907 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/metrics.h"
+#include "soci-thread.h"
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <map>
+#include <sstream>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+// Atomic operations on the 64 bit counters. This code must compile in C++98
+// mode, so we can't use std::atomic and rely on the compiler intrinsics.
+
+typedef unsigned long long volatile atomic_counter;
+
+#if defined(_MSC_VER)
+
+inline unsigned long long atomic_compare_exchange(atomic_counter & target,
+    unsigned long long expected, unsigned long long desired)
+{
+    return static_cast<unsigned long long>(InterlockedCompareExchange64(
+        reinterpret_cast<LONGLONG volatile *>(&target),
+        static_cast<LONGLONG>(desired), static_cast<LONGLONG>(expected)));
+}
+
+inline void atomic_add(atomic_counter & target, unsigned long long value)
+{
+    unsigned long long current = target;
+    for (;;)
+    {
+        unsigned long long const previous =
+            atomic_compare_exchange(target, current, current + value);
+        if (previous == current)
+        {
+            break;
+        }
+
+        current = previous;
+    }
+}
+
+inline unsigned long long atomic_load(atomic_counter & target)
+{
+    return atomic_compare_exchange(target, 0, 0);
+}
+
+#elif defined(__GNUC__)
+
+inline unsigned long long atomic_compare_exchange(atomic_counter & target,
+    unsigned long long expected, unsigned long long desired)
+{
+    return __sync_val_compare_and_swap(&target, expected, desired);
+}
+
+inline void atomic_add(atomic_counter & target, unsigned long long value)
+{
+    __sync_fetch_and_add(&target, value);
+}
+
+inline unsigned long long atomic_load(atomic_counter & target)
+{
+    return __sync_fetch_and_add(&target, 0);
+}
+
+#else
+
+// No atomic operations available, the registry is only safe to use from a
+// single thread.
+
+inline unsigned long long atomic_compare_exchange(atomic_counter & target,
+    unsigned long long expected, unsigned long long desired)
+{
+    unsigned long long const previous = target;
+    if (previous == expected)
+    {
+        target = desired;
+    }
+
+    return previous;
+}
+
+inline void atomic_add(atomic_counter & target, unsigned long long value)
+{
+    target += value;
+}
+
+inline unsigned long long atomic_load(atomic_counter & target)
+{
+    return target;
+}
+
+#endif
+
+inline void atomic_reset(atomic_counter & target, unsigned long long value)
+{
+    unsigned long long current = atomic_load(target);
+    for (;;)
+    {
+        unsigned long long const previous =
+            atomic_compare_exchange(target, current, value);
+        if (previous == current)
+        {
+            break;
+        }
+
+        current = previous;
+    }
+}
+
+// Stores the value if it is less than the current one (if isMin) or greater
+// than it (otherwise).
+inline void atomic_update_extreme(atomic_counter & target,
+    unsigned long long value, bool isMin)
+{
+    unsigned long long current = atomic_load(target);
+    while (isMin ? value < current : value > current)
+    {
+        unsigned long long const previous =
+            atomic_compare_exchange(target, current, value);
+        if (previous == current)
+        {
+            break;
+        }
+
+        current = previous;
+    }
+}
+
+inline unsigned long long to_counter(long long value)
+{
+    return value > 0 ? static_cast<unsigned long long>(value) : 0;
+}
+
+// The values below 2^sub_bucket_bits have buckets of their own, the others
+// use sub_bucket_count buckets per power of two.
+int const sub_bucket_bits = 3;
+long long const sub_bucket_count = 1 << sub_bucket_bits;
+
+// Position of the most significant bit of a positive value.
+inline int get_msb_position(unsigned long long value)
+{
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int position = 0;
+    while (value >>= 1)
+    {
+        ++position;
+    }
+    return position;
+#endif
+}
+
+// Helpers for writing the Prometheus text format.
+
+void write_prometheus_header(std::ostream & os, std::string const & name,
+    char const * type, char const * help)
+{
+    os << "# HELP " << name << ' ' << help << '\n'
+       << "# TYPE " << name << ' ' << type << '\n';
+}
+
+void write_prometheus_counter(std::ostream & os, std::string const & name,
+    char const * help, unsigned long long value)
+{
+    write_prometheus_header(os, name, "counter", help);
+    os << name << ' ' << value << '\n';
+}
+
+std::string escape_prometheus_label(std::string const & value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    {
+        switch (*it)
+        {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            default:
+                escaped += *it;
+        }
+    }
+
+    return escaped;
+}
+
+// Bucket boundaries, in seconds, used for the Prometheus histograms.
+double const prometheus_buckets[] =
+{
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+    0.25, 0.5, 1, 2.5, 5, 10
+};
+
+void write_prometheus_histogram(std::ostream & os, std::string const & name,
+    std::string const & labels, latency_histogram const & h)
+{
+    std::string const separator = labels.empty() ? "" : ",";
+
+    std::size_t const count =
+        sizeof(prometheus_buckets) / sizeof(prometheus_buckets[0]);
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        long long const ns = static_cast<long long>(prometheus_buckets[i] * 1e9);
+        os << name << "_bucket{" << labels << separator
+           << "le=\"" << prometheus_buckets[i] << "\"} "
+           << h.get_cumulative_count(ns) << '\n';
+    }
+
+    os << name << "_bucket{" << labels << separator << "le=\"+Inf\"} "
+       << h.get_count() << '\n';
+
+    std::string const braced = labels.empty() ? "" : "{" + labels + "}";
+    os << name << "_sum" << braced << ' ' << h.get_sum_ns() / 1e9 << '\n'
+       << name << "_count" << braced << ' ' << h.get_count() << '\n';
+}
+
+} // namespace anonymous
+
+namespace soci
+{
+
+namespace details
+{
+
+// Histogram updated concurrently, see latency_histogram for the buckets.
+struct live_histogram
+{
+    live_histogram()
+    {
+        reset();
+    }
+
+    void record(long long ns)
+    {
+        atomic_add(buckets_[latency_histogram::get_bucket_index(ns)], 1);
+        atomic_add(count_, 1);
+        atomic_add(sum_, to_counter(ns));
+        atomic_update_extreme(min_, to_counter(ns), true);
+        atomic_update_extreme(max_, to_counter(ns), false);
+    }
+
+    void reset()
+    {
+        for (std::size_t i = 0; i != latency_histogram::bucket_count; ++i)
+        {
+            atomic_reset(buckets_[i], 0);
+        }
+
+        atomic_reset(count_, 0);
+        atomic_reset(sum_, 0);
+        atomic_reset(min_, std::numeric_limits<unsigned long long>::max());
+        atomic_reset(max_, 0);
+    }
+
+    void copy_to(latency_histogram & h)
+    {
+        for (std::size_t i = 0; i != latency_histogram::bucket_count; ++i)
+        {
+            h.buckets_[i] = atomic_load(buckets_[i]);
+        }
+
+        h.count_ = atomic_load(count_);
+        h.sum_ = atomic_load(sum_);
+        h.min_ = static_cast<long long>(atomic_load(min_));
+        h.max_ = static_cast<long long>(atomic_load(max_));
+    }
+
+    atomic_counter buckets_[latency_histogram::bucket_count];
+    atomic_counter count_;
+    atomic_counter sum_;
+    atomic_counter min_;
+    atomic_counter max_;
+};
+
+struct metrics_query_entry
+{
+    metrics_query_entry(std::string const & q, metrics_query_entry * p)
+        : query(q), parent(p)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        atomic_reset(executions, 0);
+        atomic_reset(fetches, 0);
+        atomic_reset(rowsFetched, 0);
+        atomic_reset(rowsSent, 0);
+        atomic_reset(errors, 0);
+        executeLatency.reset();
+    }
+
+    std::string const query;
+
+    // The entry for the same query in the parent registry, if any.
+    metrics_query_entry * const parent;
+
+    atomic_counter executions;
+    atomic_counter fetches;
+    atomic_counter rowsFetched;
+    atomic_counter rowsSent;
+    atomic_counter errors;
+    live_histogram executeLatency;
+};
+
+} // namespace details
+
+} // namespace soci
+
+struct metrics_registry::metrics_registry_impl
+{
+    explicit metrics_registry_impl(std::size_t maxQueries)
+        : maxQueries_(maxQueries), other_(NULL)
+    {
+        reset();
+    }
+
+    ~metrics_registry_impl()
+    {
+        for (std::list<metrics_query_entry *>::iterator it = entries_.begin();
+            it != entries_.end(); ++it)
+        {
+            delete *it;
+        }
+    }
+
+    void reset()
+    {
+        atomic_reset(statementsPrepared_, 0);
+        atomic_reset(executions_, 0);
+        atomic_reset(fetches_, 0);
+        atomic_reset(rowsFetched_, 0);
+        atomic_reset(rowsSent_, 0);
+        atomic_reset(errors_, 0);
+        atomic_reset(reconnects_, 0);
+        atomic_reset(poolLeases_, 0);
+        atomic_reset(poolLeaseTimeouts_, 0);
+        atomic_reset(poolWaitNs_, 0);
+        atomic_reset(cacheHits_, 0);
+        atomic_reset(cacheMisses_, 0);
+
+        executeLatency_.reset();
+        fetchLatency_.reset();
+        poolWait_.reset();
+    }
+
+    std::size_t const maxQueries_;
+
+    // The entries are never removed, so that the pointers to them cached by
+    // the statements remain valid.
+    details::mutex mtx_;
+    std::map<std::string, metrics_query_entry *> index_;
+    std::list<metrics_query_entry *> entries_;
+    metrics_query_entry * other_;
+
+    atomic_counter statementsPrepared_;
+    atomic_counter executions_;
+    atomic_counter fetches_;
+    atomic_counter rowsFetched_;
+    atomic_counter rowsSent_;
+    atomic_counter errors_;
+    atomic_counter reconnects_;
+    atomic_counter poolLeases_;
+    atomic_counter poolLeaseTimeouts_;
+    atomic_counter poolWaitNs_;
+    atomic_counter cacheHits_;
+    atomic_counter cacheMisses_;
+
+    live_histogram executeLatency_;
+    live_histogram fetchLatency_;
+    live_histogram poolWait_;
+};
+
+latency_histogram::latency_histogram()
+    : buckets_(bucket_count), count_(0), sum_(0), min_(0), max_(0)
+{
+}
+
+std::size_t latency_histogram::get_bucket_index(long long ns)
+{
+    if (ns < sub_bucket_count)
+    {
+        return ns > 0 ? static_cast<std::size_t>(ns) : 0;
+    }
+
+    int const msb = get_msb_position(static_cast<unsigned long long>(ns));
+    int const shift = msb - sub_bucket_bits;
+    std::size_t const index = static_cast<std::size_t>(
+        (shift + 1) * sub_bucket_count + ((ns >> shift) & (sub_bucket_count - 1)));
+
+    return index < bucket_count ? index : bucket_count - 1;
+}
+
+long long latency_histogram::get_bucket_upper_bound(std::size_t index)
+{
+    if (index < static_cast<std::size_t>(sub_bucket_count))
+    {
+        return static_cast<long long>(index);
+    }
+
+    if (index >= bucket_count - 1)
+    {
+        return std::numeric_limits<long long>::max();
+    }
+
+    int const shift = static_cast<int>(index / sub_bucket_count) - 1;
+    long long const sub = static_cast<long long>(index % sub_bucket_count);
+    long long const lower = (sub_bucket_count + sub) << shift;
+
+    return lower + (1LL << shift) - 1;
+}
+
+long long latency_histogram::get_percentile_ns(double percentile) const
+{
+    if (count_ == 0)
+    {
+        return 0;
+    }
+
+    if (percentile < 0)
+    {
+        percentile = 0;
+    }
+    else if (percentile > 100)
+    {
+        percentile = 100;
+    }
+
+    unsigned long long target = static_cast<unsigned long long>(
+        percentile / 100 * static_cast<double>(count_) + 0.5);
+    if (target == 0)
+    {
+        target = 1;
+    }
+
+    unsigned long long seen = 0;
+    for (std::size_t i = 0; i != bucket_count; ++i)
+    {
+        seen += buckets_[i];
+        if (seen >= target)
+        {
+            long long const bound = get_bucket_upper_bound(i);
+            return bound < max_ ? bound : max_;
+        }
+    }
+
+    return max_;
+}
+
+unsigned long long latency_histogram::get_cumulative_count(long long ns) const
+{
+    unsigned long long count = 0;
+    for (std::size_t i = 0; i != bucket_count; ++i)
+    {
+        if (get_bucket_upper_bound(i) > ns)
+        {
+            break;
+        }
+
+        count += buckets_[i];
+    }
+
+    return count;
+}
+
+metrics_counters::metrics_counters()
+    : statements_prepared(0), executions(0), fetches(0),
+      rows_fetched(0), rows_sent(0), errors(0), reconnects(0),
+      pool_leases(0), pool_lease_timeouts(0), pool_wait_ns(0),
+      cache_hits(0), cache_misses(0)
+{
+}
+
+query_metrics::query_metrics()
+    : executions(0), fetches(0), rows_fetched(0), rows_sent(0), errors(0)
+{
+}
+
+void metrics_snapshot::write_prometheus(std::ostream & os,
+    std::string const & prefix) const
+{
+    write_prometheus_counter(os, prefix + "_statements_prepared_total",
+        "Number of statements prepared.", counters.statements_prepared);
+    write_prometheus_counter(os, prefix + "_executions_total",
+        "Number of statement executions.", counters.executions);
+    write_prometheus_counter(os, prefix + "_fetches_total",
+        "Number of fetch round trips.", counters.fetches);
+    write_prometheus_counter(os, prefix + "_rows_fetched_total",
+        "Number of rows fetched from the database.", counters.rows_fetched);
+    write_prometheus_counter(os, prefix + "_rows_sent_total",
+        "Number of rows of parameters sent to the database.", counters.rows_sent);
+    write_prometheus_counter(os, prefix + "_errors_total",
+        "Number of failed statement operations.", counters.errors);
+    write_prometheus_counter(os, prefix + "_reconnects_total",
+        "Number of session reconnections.", counters.reconnects);
+    write_prometheus_counter(os, prefix + "_pool_leases_total",
+        "Number of sessions leased from the connection pool.",
+        counters.pool_leases);
+    write_prometheus_counter(os, prefix + "_pool_lease_timeouts_total",
+        "Number of connection pool leases which timed out.",
+        counters.pool_lease_timeouts);
+    write_prometheus_counter(os, prefix + "_result_cache_hits_total",
+        "Number of queries whose results were found in the result cache.",
+        counters.cache_hits);
+    write_prometheus_counter(os, prefix + "_result_cache_misses_total",
+        "Number of cacheable queries whose results were not cached.",
+        counters.cache_misses);
+
+    std::string name = prefix + "_execute_duration_seconds";
+    write_prometheus_header(os, name, "histogram",
+        "Duration of the statement executions.");
+    write_prometheus_histogram(os, name, std::string(), execute_latency);
+
+    name = prefix + "_fetch_duration_seconds";
+    write_prometheus_header(os, name, "histogram",
+        "Duration of the fetches.");
+    write_prometheus_histogram(os, name, std::string(), fetch_latency);
+
+    name = prefix + "_pool_wait_duration_seconds";
+    write_prometheus_header(os, name, "histogram",
+        "Time spent waiting for a session from the connection pool.");
+    write_prometheus_histogram(os, name, std::string(), pool_wait);
+
+    if (queries.empty())
+    {
+        return;
+    }
+
+    std::vector<std::string> labels;
+    labels.reserve(queries.size());
+    for (std::size_t i = 0; i != queries.size(); ++i)
+    {
+        labels.push_back("query=\"" + escape_prometheus_label(queries[i].query) + "\"");
+    }
+
+    name = prefix + "_query_executions_total";
+    write_prometheus_header(os, name, "counter",
+        "Number of executions of the query.");
+    for (std::size_t i = 0; i != queries.size(); ++i)
+    {
+        os << name << '{' << labels[i] << "} " << queries[i].executions << '\n';
+    }
+
+    name = prefix + "_query_errors_total";
+    write_prometheus_header(os, name, "counter",
+        "Number of failed operations of the query.");
+    for (std::size_t i = 0; i != queries.size(); ++i)
+    {
+        os << name << '{' << labels[i] << "} " << queries[i].errors << '\n';
+    }
+
+    name = prefix + "_query_rows_fetched_total";
+    write_prometheus_header(os, name, "counter",
+        "Number of rows fetched by the query.");
+    for (std::size_t i = 0; i != queries.size(); ++i)
+    {
+        os << name << '{' << labels[i] << "} " << queries[i].rows_fetched << '\n';
+    }
+
+    name = prefix + "_query_duration_seconds";
+    write_prometheus_header(os, name, "histogram",
+        "Duration of the executions of the query.");
+    for (std::size_t i = 0; i != queries.size(); ++i)
+    {
+        write_prometheus_histogram(os, name, labels[i],
+            queries[i].execute_latency);
+    }
+}
+
+metrics_registry::metrics_registry(metrics_registry * parent,
+    std::size_t maxQueries)
+    : pimpl_(new metrics_registry_impl(maxQueries)), parent_(parent)
+{
+}
+
+metrics_registry::~metrics_registry()
+{
+    delete pimpl_;
+}
+
+metrics_snapshot metrics_registry::get_snapshot() const
+{
+    metrics_snapshot snapshot;
+
+    metrics_counters & c = snapshot.counters;
+    c.statements_prepared = atomic_load(pimpl_->statementsPrepared_);
+    c.executions = atomic_load(pimpl_->executions_);
+    c.fetches = atomic_load(pimpl_->fetches_);
+    c.rows_fetched = atomic_load(pimpl_->rowsFetched_);
+    c.rows_sent = atomic_load(pimpl_->rowsSent_);
+    c.errors = atomic_load(pimpl_->errors_);
+    c.reconnects = atomic_load(pimpl_->reconnects_);
+    c.pool_leases = atomic_load(pimpl_->poolLeases_);
+    c.pool_lease_timeouts = atomic_load(pimpl_->poolLeaseTimeouts_);
+    c.pool_wait_ns = atomic_load(pimpl_->poolWaitNs_);
+    c.cache_hits = atomic_load(pimpl_->cacheHits_);
+    c.cache_misses = atomic_load(pimpl_->cacheMisses_);
+
+    pimpl_->executeLatency_.copy_to(snapshot.execute_latency);
+    pimpl_->fetchLatency_.copy_to(snapshot.fetch_latency);
+    pimpl_->poolWait_.copy_to(snapshot.pool_wait);
+
+    std::vector<metrics_query_entry *> entries;
+    {
+        scoped_lock lock(pimpl_->mtx_);
+        entries.assign(pimpl_->entries_.begin(), pimpl_->entries_.end());
+    }
+
+    snapshot.queries.resize(entries.size());
+    for (std::size_t i = 0; i != entries.size(); ++i)
+    {
+        metrics_query_entry & e = *entries[i];
+        query_metrics & q = snapshot.queries[i];
+
+        q.query = e.query;
+        q.executions = atomic_load(e.executions);
+        q.fetches = atomic_load(e.fetches);
+        q.rows_fetched = atomic_load(e.rowsFetched);
+        q.rows_sent = atomic_load(e.rowsSent);
+        q.errors = atomic_load(e.errors);
+        e.executeLatency.copy_to(q.execute_latency);
+    }
+
+    return snapshot;
+}
+
+void metrics_registry::reset()
+{
+    pimpl_->reset();
+
+    scoped_lock lock(pimpl_->mtx_);
+    for (std::list<metrics_query_entry *>::iterator it = pimpl_->entries_.begin();
+        it != pimpl_->entries_.end(); ++it)
+    {
+        (*it)->reset();
+    }
+}
+
+std::string metrics_registry::normalize_query(std::string const & query)
+{
+    std::string normalized;
+    normalized.reserve(query.size());
+
+    std::size_t const size = query.size();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        char const c = query[i];
+        unsigned char const uc = static_cast<unsigned char>(c);
+
+        if (std::isspace(uc))
+        {
+            if (normalized.empty() == false &&
+                normalized[normalized.size() - 1] != ' ')
+            {
+                normalized += ' ';
+            }
+        }
+        else if (c == '\'')
+        {
+            // String literal, with the quotes escaped by doubling them.
+            for (++i; i < size; ++i)
+            {
+                if (query[i] == '\'')
+                {
+                    if (i + 1 < size && query[i + 1] == '\'')
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+            }
+
+            normalized += '?';
+        }
+        else if (c == '"' || c == '`')
+        {
+            // Quoted identifier, kept as is.
+            std::size_t const end = query.find(c, i + 1);
+            std::size_t const last = end == std::string::npos ? size - 1 : end;
+            normalized.append(query, i, last - i + 1);
+            i = last;
+        }
+        else if (std::isdigit(uc))
+        {
+            // Digits which are part of identifiers or of placeholders such as
+            // ":1" or "$1" are kept, the numbers are replaced.
+            char const prev = normalized.empty()
+                ? ' ' : normalized[normalized.size() - 1];
+            unsigned char const uprev = static_cast<unsigned char>(prev);
+            if (std::isalnum(uprev) || prev == '_' || prev == ':' || prev == '$')
+            {
+                normalized += c;
+                continue;
+            }
+
+            while (i + 1 < size &&
+                (std::isalnum(static_cast<unsigned char>(query[i + 1])) ||
+                 query[i + 1] == '.'))
+            {
+                ++i;
+            }
+
+            normalized += '?';
+        }
+        else
+        {
+            normalized += c;
+        }
+    }
+
+    if (normalized.empty() == false && normalized[normalized.size() - 1] == ' ')
+    {
+        normalized.erase(normalized.size() - 1);
+    }
+
+    return normalized;
+}
+
+metrics_query_entry * metrics_registry::get_query_entry(std::string const & query)
+{
+    std::string const normalized = normalize_query(query);
+
+    scoped_lock lock(pimpl_->mtx_);
+
+    std::map<std::string, metrics_query_entry *>::const_iterator const
+        it = pimpl_->index_.find(normalized);
+    if (it != pimpl_->index_.end())
+    {
+        return it->second;
+    }
+
+    if (pimpl_->index_.size() >= pimpl_->maxQueries_)
+    {
+        if (pimpl_->other_ == NULL)
+        {
+            metrics_query_entry * const parentEntry =
+                parent_ != NULL ? parent_->get_query_entry("(other)") : NULL;
+            pimpl_->other_ = new metrics_query_entry("(other)", parentEntry);
+            pimpl_->entries_.push_back(pimpl_->other_);
+        }
+
+        return pimpl_->other_;
+    }
+
+    metrics_query_entry * const parentEntry =
+        parent_ != NULL ? parent_->get_query_entry(normalized) : NULL;
+
+    cxx_details::auto_ptr<metrics_query_entry>
+        entry(new metrics_query_entry(normalized, parentEntry));
+    pimpl_->entries_.push_back(entry.get());
+    pimpl_->index_[normalized] = entry.get();
+
+    return entry.release();
+}
+
+void metrics_registry::record_prepare(metrics_query_entry * entry, bool failed)
+{
+    atomic_add(pimpl_->statementsPrepared_, 1);
+
+    if (failed)
+    {
+        atomic_add(pimpl_->errors_, 1);
+        if (entry != NULL)
+        {
+            atomic_add(entry->errors, 1);
+        }
+    }
+
+    if (parent_ != NULL)
+    {
+        parent_->record_prepare(entry != NULL ? entry->parent : NULL, failed);
+    }
+}
+
+void metrics_registry::record_execute(metrics_query_entry * entry, long long ns,
+    long long rowsFetched, long long rowsSent, bool failed)
+{
+    atomic_add(pimpl_->executions_, 1);
+    atomic_add(pimpl_->rowsFetched_, to_counter(rowsFetched));
+    atomic_add(pimpl_->rowsSent_, to_counter(rowsSent));
+    pimpl_->executeLatency_.record(ns);
+
+    if (failed)
+    {
+        atomic_add(pimpl_->errors_, 1);
+    }
+
+    if (entry != NULL)
+    {
+        atomic_add(entry->executions, 1);
+        atomic_add(entry->rowsFetched, to_counter(rowsFetched));
+        atomic_add(entry->rowsSent, to_counter(rowsSent));
+        entry->executeLatency.record(ns);
+
+        if (failed)
+        {
+            atomic_add(entry->errors, 1);
+        }
+    }
+
+    if (parent_ != NULL)
+    {
+        parent_->record_execute(entry != NULL ? entry->parent : NULL,
+            ns, rowsFetched, rowsSent, failed);
+    }
+}
+
+void metrics_registry::record_fetch(metrics_query_entry * entry, long long ns,
+    long long rowsFetched, bool failed)
+{
+    atomic_add(pimpl_->fetches_, 1);
+    atomic_add(pimpl_->rowsFetched_, to_counter(rowsFetched));
+    pimpl_->fetchLatency_.record(ns);
+
+    if (failed)
+    {
+        atomic_add(pimpl_->errors_, 1);
+    }
+
+    if (entry != NULL)
+    {
+        atomic_add(entry->fetches, 1);
+        atomic_add(entry->rowsFetched, to_counter(rowsFetched));
+
+        if (failed)
+        {
+            atomic_add(entry->errors, 1);
+        }
+    }
+
+    if (parent_ != NULL)
+    {
+        parent_->record_fetch(entry != NULL ? entry->parent : NULL,
+            ns, rowsFetched, failed);
+    }
+}
+
+void metrics_registry::record_reconnect()
+{
+    atomic_add(pimpl_->reconnects_, 1);
+
+    if (parent_ != NULL)
+    {
+        parent_->record_reconnect();
+    }
+}
+
+void metrics_registry::record_pool_lease(long long waitNs, bool timedOut)
+{
+    if (timedOut)
+    {
+        atomic_add(pimpl_->poolLeaseTimeouts_, 1);
+    }
+    else
+    {
+        atomic_add(pimpl_->poolLeases_, 1);
+    }
+
+    atomic_add(pimpl_->poolWaitNs_, to_counter(waitNs));
+    pimpl_->poolWait_.record(waitNs);
+
+    if (parent_ != NULL)
+    {
+        parent_->record_pool_lease(waitNs, timedOut);
+    }
+}
+
+void metrics_registry::record_cache_lookup(bool hit)
+{
+    if (hit)
+    {
+        atomic_add(pimpl_->cacheHits_, 1);
+    }
+    else
+    {
+        atomic_add(pimpl_->cacheMisses_, 1);
+    }
+
+    if (parent_ != NULL)
+    {
+        parent_->record_cache_lookup(hit);
+    }
+}
@@ -0,0 +1,175 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/object-cache.h"
+#include "soci/session.h"
+
+#include <new>
+
+using namespace soci;
+using namespace soci::details;
+
+struct object_cache::block_header
+{
+    // NULL for the uncached blocks.
+    object_cache * cache;
+
+    // size_class_count for the blocks too big to be cached.
+    std::size_t sizeClass;
+
+    // Only used while the block is in the free list.
+    block_header * next;
+};
+
+namespace // anonymous
+{
+
+// Keep the objects following the header suitably aligned.
+std::size_t const header_size = 2 * sizeof(long double) > 32
+    ? 2 * sizeof(long double) : 32;
+
+inline void * get_object(void * block)
+{
+    return static_cast<char *>(block) + header_size;
+}
+
+} // namespace anonymous
+
+object_cache::object_cache()
+    : outstanding_(0), closed_(false)
+{
+    for (std::size_t i = 0; i != size_class_count; ++i)
+    {
+        free_[i] = NULL;
+        freeCounts_[i] = 0;
+    }
+}
+
+object_cache::~object_cache()
+{
+    for (std::size_t i = 0; i != size_class_count; ++i)
+    {
+        while (free_[i] != NULL)
+        {
+            block_header * const next = free_[i]->next;
+            ::operator delete(free_[i]);
+            free_[i] = next;
+        }
+    }
+}
+
+void * object_cache::allocate(std::size_t size)
+{
+    std::size_t const sizeClass = size == 0 ? 0 : (size - 1) / granularity;
+
+    block_header * block;
+    if (sizeClass < size_class_count && free_[sizeClass] != NULL)
+    {
+        block = free_[sizeClass];
+        free_[sizeClass] = block->next;
+        --freeCounts_[sizeClass];
+    }
+    else if (sizeClass < size_class_count)
+    {
+        block = static_cast<block_header *>(::operator new(
+            header_size + (sizeClass + 1) * granularity));
+        block->sizeClass = sizeClass;
+    }
+    else
+    {
+        block = static_cast<block_header *>(::operator new(header_size + size));
+        block->sizeClass = size_class_count;
+    }
+
+    block->cache = this;
+    ++outstanding_;
+
+    return get_object(block);
+}
+
+void * object_cache::allocate_uncached(std::size_t size)
+{
+    block_header * const block =
+        static_cast<block_header *>(::operator new(header_size + size));
+    block->cache = NULL;
+    block->sizeClass = size_class_count;
+
+    return get_object(block);
+}
+
+void object_cache::deallocate(void * p)
+{
+    if (p == NULL)
+    {
+        return;
+    }
+
+    block_header * const block = reinterpret_cast<block_header *>(
+        static_cast<char *>(p) - header_size);
+
+    if (block->cache == NULL)
+    {
+        ::operator delete(block);
+    }
+    else
+    {
+        block->cache->release(block);
+    }
+}
+
+void object_cache::release(block_header * block)
+{
+    --outstanding_;
+
+    std::size_t const sizeClass = block->sizeClass;
+    if (closed_ == false && sizeClass < size_class_count &&
+        freeCounts_[sizeClass] < max_cached_blocks)
+    {
+        block->next = free_[sizeClass];
+        free_[sizeClass] = block;
+        ++freeCounts_[sizeClass];
+    }
+    else
+    {
+        ::operator delete(block);
+    }
+
+    if (closed_ && outstanding_ == 0)
+    {
+        delete this;
+    }
+}
+
+void object_cache::close()
+{
+    closed_ = true;
+
+    if (outstanding_ == 0)
+    {
+        delete this;
+    }
+}
+
+void * cached_object::operator new(std::size_t size, session & s)
+{
+    return s.get_object_cache().allocate(size);
+}
+
+void cached_object::operator delete(void * p, session & /* s */)
+{
+    object_cache::deallocate(p);
+}
+
+void * cached_object::operator new(std::size_t size)
+{
+    return object_cache::allocate_uncached(size);
+}
+
+void cached_object::operator delete(void * p)
+{
+    object_cache::deallocate(p);
+}
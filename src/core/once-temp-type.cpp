@@ -14,10 +14,10 @@ using namespace soci;
 using namespace soci::details;
 
 once_temp_type::once_temp_type(session & s)
-    : rcst_(new ref_counted_statement(s))
+    : rcst_(new (s) ref_counted_statement(s))
 {
     // this is the beginning of new query
-    s.get_query_stream().str("");
+    s.get_query_builder().clear();
 }
 
 once_temp_type::once_temp_type(once_temp_type const & o)
@@ -37,7 +37,12 @@ once_temp_type & once_temp_type::operator=(once_temp_type const & o)
 
 once_temp_type::~once_temp_type() SOCI_NOEXCEPT_FALSE
 {
-    rcst_->dec_ref();
+    // the statement is executed when the last copy is destroyed, but not
+    // when the object was moved from
+    if (rcst_ != NULL)
+    {
+        rcst_->dec_ref();
+    }
 }
 
 once_temp_type & once_temp_type::operator,(into_type_ptr const & i)
@@ -53,10 +58,10 @@ once_temp_type & once_temp_type::operator,(use_type_ptr const & u)
 }
 
 ddl_type::ddl_type(session & s)
-    : s_(&s), rcst_(new ref_counted_statement(s))
+    : s_(&s), rcst_(new (s) ref_counted_statement(s))
 {
     // this is the beginning of new query
-    s.get_query_stream().str("");
+    s.get_query_builder().clear();
 }
 
 ddl_type::ddl_type(const ddl_type & d)
@@ -77,7 +82,10 @@ ddl_type & ddl_type::operator=(const ddl_type & d)
 
 ddl_type::~ddl_type() SOCI_NOEXCEPT_FALSE
 {
-    rcst_->dec_ref();
+    if (rcst_ != NULL)
+    {
+        rcst_->dec_ref();
+    }
 }
 
 void ddl_type::create_table(const std::string & tableName)
@@ -0,0 +1,369 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/partitioned-query.h"
+#include "soci/async.h"
+#include "soci/connection-pool.h"
+#include "soci/error.h"
+#include "soci/prepare-temp-type.h"
+#include "soci/row.h"
+#include "soci/row-exchange.h"
+#include "soci/session.h"
+#include "soci/statement.h"
+#include "soci/use.h"
+#include "soci-thread.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+std::size_t const default_partition_batch_size = 100;
+
+// Batch of rows fetched by a worker and waiting to be consumed in the thread
+// executing the query.
+struct pending_batch
+{
+    pending_batch(std::size_t partition, row & rows)
+        : partition_(partition), rows_(rows), taken_(false), consumed_(false)
+    {}
+
+    std::size_t const partition_;
+    row & rows_;
+
+    // Both flags are protected by the execution mutex.
+    bool taken_;
+    bool consumed_;
+};
+
+// State shared by the thread executing the query and the tasks executing its
+// partitions.
+class partitioned_execution
+{
+public:
+    partitioned_execution(std::size_t partitions,
+        partition_batch_consumer * batchConsumer)
+        : batchConsumer_(batchConsumer), running_(partitions),
+          cancelled_(false), error_(NULL)
+    {}
+
+    ~partitioned_execution()
+    {
+        delete error_;
+    }
+
+    bool is_cancelled()
+    {
+        scoped_lock lock(mtx_);
+        return cancelled_;
+    }
+
+    // Stops all the partitions, the ones still running stop after their
+    // current batch.
+    void cancel()
+    {
+        {
+            scoped_lock lock(mtx_);
+            cancelled_ = true;
+        }
+
+        changed_.notify_all();
+    }
+
+    // Must be called from a catch clause, remembers the first error and
+    // stops all the other partitions.
+    void fail()
+    {
+        soci_error * const error = capture_current_error();
+        {
+            scoped_lock lock(mtx_);
+            if (error_ == NULL)
+            {
+                error_ = error;
+            }
+            else
+            {
+                delete error;
+            }
+
+            cancelled_ = true;
+        }
+
+        changed_.notify_all();
+    }
+
+    void partition_done()
+    {
+        {
+            scoped_lock lock(mtx_);
+            --running_;
+        }
+
+        changed_.notify_all();
+    }
+
+    // Called by the workers for each fetched batch, returns false if they
+    // must stop.
+    bool deliver(std::size_t partition, row & rows)
+    {
+        if (batchConsumer_ != NULL)
+        {
+            batchConsumer_->consume(partition, rows);
+            return is_cancelled() == false;
+        }
+
+        pending_batch batch(partition, rows);
+
+        scoped_lock lock(mtx_);
+        if (cancelled_)
+        {
+            return false;
+        }
+
+        ready_.push_back(&batch);
+        changed_.notify_all();
+
+        // The rows can't be fetched into again, nor destroyed, while the
+        // consuming thread may still use them.
+        while (batch.consumed_ == false)
+        {
+            if (cancelled_ && batch.taken_ == false)
+            {
+                ready_.erase(std::find(ready_.begin(), ready_.end(), &batch));
+                return false;
+            }
+
+            changed_.wait(mtx_);
+        }
+
+        return cancelled_ == false;
+    }
+
+    // Passes the rows delivered by the workers to the consumer until all the
+    // partitions are done or cancelled.
+    void consume(partition_row_consumer & consumer)
+    {
+        for (;;)
+        {
+            pending_batch * batch;
+            {
+                scoped_lock lock(mtx_);
+                while (ready_.empty() && running_ != 0 && cancelled_ == false)
+                {
+                    changed_.wait(mtx_);
+                }
+
+                if (ready_.empty() || cancelled_)
+                {
+                    return;
+                }
+
+                batch = ready_.front();
+                ready_.pop_front();
+                batch->taken_ = true;
+            }
+
+            try
+            {
+                row & rows = batch->rows_;
+                std::size_t const size = rows.get_bulk_size();
+                for (std::size_t i = 0; i != size; ++i)
+                {
+                    rows.select_bulk_row(i);
+                    consumer.consume(batch->partition_, rows);
+                }
+            }
+            catch (...)
+            {
+                release(*batch, true);
+                throw;
+            }
+
+            release(*batch, false);
+        }
+    }
+
+    // Waits until all the partitions are done and rethrows the error, if any.
+    void wait()
+    {
+        scoped_lock lock(mtx_);
+        while (running_ != 0)
+        {
+            changed_.wait(mtx_);
+        }
+
+        if (error_ != NULL)
+        {
+            error_->raise();
+        }
+    }
+
+private:
+    void release(pending_batch & batch, bool cancel)
+    {
+        {
+            scoped_lock lock(mtx_);
+            batch.consumed_ = true;
+            if (cancel)
+            {
+                cancelled_ = true;
+            }
+        }
+
+        changed_.notify_all();
+    }
+
+    partition_batch_consumer * const batchConsumer_;
+
+    mutex mtx_;
+    condition changed_;
+    std::deque<pending_batch *> ready_;
+    std::size_t running_;
+    bool cancelled_;
+    soci_error * error_;
+};
+
+// Executes a single partition in a worker thread.
+class partition_task : public async_task
+{
+public:
+    partition_task(partitioned_execution & execution, connection_pool & pool,
+        std::string const & query, std::size_t partition,
+        partition_range const & range, std::size_t batchSize)
+        : execution_(execution), pool_(pool), query_(query),
+          partition_(partition), range_(range), batchSize_(batchSize)
+    {}
+
+    void run() SOCI_OVERRIDE
+    {
+        try
+        {
+            if (execution_.is_cancelled() == false)
+            {
+                execute();
+            }
+        }
+        catch (...)
+        {
+            execution_.fail();
+        }
+
+        execution_.partition_done();
+    }
+
+private:
+    void execute()
+    {
+        session sql(pool_);
+
+        long long begin = range_.begin;
+        long long end = range_.end;
+
+        // The rows must outlive the statement fetching into them.
+        row rows;
+        statement st = (sql.prepare << query_, use(begin), use(end));
+        st.exchange_for_rowset(
+            into_type_ptr(new bulk_row_into_type(rows, batchSize_)));
+
+        st.execute();
+        while (st.fetch())
+        {
+            if (execution_.deliver(partition_, rows) == false)
+            {
+                return;
+            }
+        }
+    }
+
+    partitioned_execution & execution_;
+    connection_pool & pool_;
+    std::string const & query_;
+    std::size_t const partition_;
+    partition_range const range_;
+    std::size_t const batchSize_;
+};
+
+} // namespace anonymous
+
+partitioned_query::partitioned_query(connection_pool & pool,
+    std::string const & query, std::size_t parallelism)
+    : pool_(pool), query_(query), parallelism_(parallelism),
+      batchSize_(default_partition_batch_size)
+{
+    if (parallelism == 0)
+    {
+        throw soci_error("Invalid number of concurrently executed partitions");
+    }
+}
+
+void partitioned_query::add_partition(long long begin, long long end)
+{
+    partitions_.push_back(partition_range(begin, end));
+}
+
+void partitioned_query::set_batch_size(std::size_t size)
+{
+    if (size == 0)
+    {
+        throw soci_error("Partition batch size must be positive");
+    }
+
+    batchSize_ = size;
+}
+
+void partitioned_query::for_each_row(partition_row_consumer & consumer)
+{
+    execute(&consumer, NULL);
+}
+
+void partitioned_query::for_each_batch(partition_batch_consumer & consumer)
+{
+    execute(NULL, &consumer);
+}
+
+void partitioned_query::execute(partition_row_consumer * rowConsumer,
+    partition_batch_consumer * batchConsumer)
+{
+    if (partitions_.empty())
+    {
+        return;
+    }
+
+    partitioned_execution execution(partitions_.size(), batchConsumer);
+
+    {
+        // The executor waits for all the tasks when it is destroyed, so that
+        // nothing refers to the execution state any more after this scope.
+        async_executor executor((std::min)(parallelism_, partitions_.size()));
+
+        try
+        {
+            for (std::size_t i = 0; i != partitions_.size(); ++i)
+            {
+                executor.submit(new partition_task(execution, pool_, query_,
+                    i, partitions_[i], batchSize_));
+            }
+        }
+        catch (...)
+        {
+            // Don't let the already submitted tasks wait for the consumer.
+            execution.cancel();
+            throw;
+        }
+
+        if (rowConsumer != NULL)
+        {
+            execution.consume(*rowConsumer);
+        }
+    }
+
+    execution.wait();
+}
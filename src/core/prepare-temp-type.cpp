@@ -14,10 +14,10 @@ using namespace soci;
 using namespace soci::details;
 
 prepare_temp_type::prepare_temp_type(session & s)
-    : rcpi_(new ref_counted_prepare_info(s))
+    : rcpi_(new (s) ref_counted_prepare_info(s))
 {
     // this is the beginning of new query
-    s.get_query_stream().str("");
+    s.get_query_builder().clear();
 }
 
 prepare_temp_type::prepare_temp_type(prepare_temp_type const & o)
@@ -37,7 +37,10 @@ prepare_temp_type & prepare_temp_type::operator=(prepare_temp_type const & o)
 
 prepare_temp_type::~prepare_temp_type()
 {
-    rcpi_->dec_ref();
+    if (rcpi_ != NULL)
+    {
+        rcpi_->dec_ref();
+    }
 }
 
 prepare_temp_type & prepare_temp_type::operator,(into_type_ptr const & i)
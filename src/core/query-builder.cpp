@@ -0,0 +1,196 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/query-builder.h"
+#include "soci-text-codec.h"
+
+#include <cfloat>
+#include <locale>
+#include <stdio.h>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+std::string const empty_query;
+
+// The format flags of a newly created stream.
+std::ios_base::fmtflags const default_stream_flags =
+    std::ios_base::dec | std::ios_base::skipws;
+
+// The default precision of a newly created stream.
+std::streamsize const default_stream_precision = 6;
+
+// Replace the comma which may be used as decimal separator by the current
+// locale with a point, see double_to_cstring().
+void fix_decimal_separator(char * buf, int len)
+{
+    for (int i = 0; i < len; ++i)
+    {
+        if (buf[i] == ',')
+        {
+            buf[i] = '.';
+            break;
+        }
+    }
+}
+
+} // namespace anonymous
+
+shared_query::shared_query(std::string const & text)
+    : body_(new body(text))
+{
+}
+
+std::string const & shared_query::str() const
+{
+    return body_ != NULL ? body_->text : empty_query;
+}
+
+query_builder::~query_builder()
+{
+    delete stream_;
+}
+
+void query_builder::clear()
+{
+    text_.clear();
+
+    if (stream_ != NULL && (customized_ || streamOnly_))
+    {
+        stream_->str(std::string());
+        stream_->clear();
+        stream_->flags(default_stream_flags);
+        stream_->precision(default_stream_precision);
+        stream_->width(0);
+        stream_->fill(' ');
+    }
+
+    customized_ = false;
+    streamOnly_ = false;
+}
+
+std::string const & query_builder::str() const
+{
+    if (streamOnly_)
+    {
+        text_ = stream_->str();
+    }
+
+    return text_;
+}
+
+std::ostringstream & query_builder::get_stream()
+{
+    if (stream_ == NULL)
+    {
+        create_stream();
+    }
+
+    if (streamOnly_ == false)
+    {
+        // The stream is always empty here, as everything output to it is
+        // immediately moved to the text.
+        stream_->write(text_.data(), static_cast<std::streamsize>(text_.size()));
+        text_.clear();
+
+        streamOnly_ = true;
+        customized_ = true;
+    }
+
+    return *stream_;
+}
+
+void query_builder::create_stream()
+{
+    stream_ = new std::ostringstream();
+
+    // Just as the numbers output by this class directly, the values output to
+    // the stream shouldn't depend on the current locale.
+    stream_->imbue(std::locale::classic());
+}
+
+void query_builder::flush_stream()
+{
+    if (streamOnly_)
+    {
+        return;
+    }
+
+    text_ += stream_->str();
+    stream_->str(std::string());
+
+    customized_ = stream_->flags() != default_stream_flags ||
+        stream_->precision() != default_stream_precision ||
+        stream_->width() != 0;
+}
+
+query_builder & query_builder::append_signed(long long n)
+{
+    if (customized_)
+    {
+        return append_streamed(n);
+    }
+
+    char buf[number_text_buffer_size];
+    text_.append(buf, format_integer(n, buf));
+    return *this;
+}
+
+query_builder & query_builder::append_unsigned(unsigned long long n)
+{
+    if (customized_)
+    {
+        return append_streamed(n);
+    }
+
+    char buf[number_text_buffer_size];
+    text_.append(buf, format_integer(n, buf));
+    return *this;
+}
+
+query_builder & query_builder::append_double(double d)
+{
+    if (customized_)
+    {
+        return append_streamed(d);
+    }
+
+    char buf[number_text_buffer_size];
+    text_.append(buf, format_double(d, buf));
+    return *this;
+}
+
+query_builder & query_builder::append_float(float d)
+{
+    if (customized_)
+    {
+        return append_streamed(d);
+    }
+
+    char buf[number_text_buffer_size];
+    text_.append(buf, format_float(d, buf));
+    return *this;
+}
+
+query_builder & query_builder::operator<<(long double d)
+{
+    if (customized_)
+    {
+        return append_streamed(d);
+    }
+
+    // Use enough digits to represent any long double value exactly.
+    char buf[64];
+    int const len = snprintf(buf, sizeof(buf), "%.*Lg", LDBL_DIG + 3, d);
+    fix_decimal_separator(buf, len);
+
+    text_.append(buf, len);
+    return *this;
+}
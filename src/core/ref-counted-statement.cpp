@@ -22,10 +22,24 @@ void ref_counted_statement::final_action()
     try
     {
         st_.alloc();
-        st_.prepare(session_.get_query(), st_one_time_query);
-        st_.define_and_bind();
 
-        const bool gotData = st_.execute(true);
+        details::shared_query const query = session_.get_shared_query();
+
+        bool gotData = false;
+        if (st_.batch_write(query))
+        {
+            session_.log_query(query);
+        }
+        else if (st_.find_cached_results(query, gotData) == false)
+        {
+            st_.prepare(query, st_one_time_query);
+            st_.define_and_bind();
+
+            gotData = st_.execute(true);
+
+            st_.store_cached_results(gotData);
+        }
+
         session_.set_got_data(gotData);
     }
     catch (...)
@@ -37,7 +51,7 @@ void ref_counted_statement::final_action()
     st_.clean_up();
 }
 
-std::ostringstream& ref_counted_statement_base::get_query_stream()
+query_builder & ref_counted_statement_base::get_query_builder()
 {
-    return session_.get_query_stream();
+    return session_.get_query_builder();
 }
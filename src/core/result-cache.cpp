@@ -0,0 +1,858 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/result-cache.h"
+#include "soci/type-wrappers.h"
+#include "soci-monotonic-clock.h"
+#include "soci-result-cache.h"
+#include "soci-thread.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <list>
+#include <map>
+#include <utility>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+// Approximate memory overhead of an entry and of each of its tables, which is
+// added to the size of the stored strings when checking the memory budget.
+std::size_t const entry_overhead = 128;
+std::size_t const table_overhead = 64;
+
+template <typename T>
+void save_bytes(std::string & buf, T const & value)
+{
+    buf.append(reinterpret_cast<char const *>(&value), sizeof(T));
+}
+
+template <typename T>
+void load_bytes(char const * & p, T & value)
+{
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+}
+
+void save_string(std::string & buf, std::string const & s)
+{
+    save_bytes(buf, s.size());
+    buf += s;
+}
+
+void load_string(char const * & p, std::string & s)
+{
+    std::size_t len;
+    load_bytes(p, len);
+    s.assign(p, len);
+    p += len;
+}
+
+// Overloads for all the types which can be cached.
+template <typename T>
+void save_value(std::string & buf, T const & value) { save_bytes(buf, value); }
+
+void save_value(std::string & buf, std::string const & s) { save_string(buf, s); }
+void save_value(std::string & buf, long_string const & s) { save_string(buf, s.value); }
+void save_value(std::string & buf, xml_type const & s) { save_string(buf, s.value); }
+
+template <typename T>
+void load_value(char const * & p, T & value) { load_bytes(p, value); }
+
+void load_value(char const * & p, std::string & s) { load_string(p, s); }
+void load_value(char const * & p, long_string & s) { load_string(p, s.value); }
+void load_value(char const * & p, xml_type & s) { load_string(p, s.value); }
+
+bool is_cacheable(exchange_type type)
+{
+    switch (type)
+    {
+        case x_char:
+        case x_stdstring:
+        case x_short:
+        case x_integer:
+        case x_long_long:
+        case x_unsigned_long_long:
+        case x_double:
+        case x_stdtm:
+        case x_longstring:
+        case x_xmltype:
+            return true;
+
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+
+    return false;
+}
+
+// Arguments of the operations below, not all of them are used by all of them.
+struct cache_io
+{
+    std::string * buf;
+    char const * * p;
+    void * data;
+    std::vector<indicator> * ind;
+};
+
+template <typename T>
+struct save_value_op
+{
+    static void run(cache_io & io)
+    {
+        save_value(*io.buf, *static_cast<T *>(io.data));
+    }
+};
+
+template <typename T>
+struct load_value_op
+{
+    static void run(cache_io & io)
+    {
+        load_value(*io.p, *static_cast<T *>(io.data));
+    }
+};
+
+template <typename T>
+struct save_vector_op
+{
+    static void run(cache_io & io)
+    {
+        std::vector<T> const & v = *static_cast<std::vector<T> *>(io.data);
+
+        std::size_t const size = v.size();
+        save_bytes(*io.buf, size);
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            char const ind = static_cast<char>(io.ind != NULL ? (*io.ind)[i] : i_ok);
+            *io.buf += ind;
+            if (ind != i_null)
+            {
+                save_value(*io.buf, v[i]);
+            }
+        }
+    }
+};
+
+template <typename T>
+struct load_vector_op
+{
+    static void run(cache_io & io)
+    {
+        std::vector<T> & v = *static_cast<std::vector<T> *>(io.data);
+
+        std::size_t size;
+        load_bytes(*io.p, size);
+        v.resize(size);
+        if (io.ind != NULL)
+        {
+            io.ind->resize(size);
+        }
+
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            indicator const ind = static_cast<indicator>(*(*io.p)++);
+            if (io.ind != NULL)
+            {
+                (*io.ind)[i] = ind;
+            }
+
+            if (ind != i_null)
+            {
+                load_value(*io.p, v[i]);
+            }
+        }
+    }
+};
+
+template <typename T>
+struct vector_key_op
+{
+    static void run(cache_io & io)
+    {
+        save_bytes(*io.buf, static_cast<std::vector<T> *>(io.data)->size());
+    }
+};
+
+// Calls the operation for the C++ type corresponding to the given one, which
+// must be cacheable.
+template <template <typename> class Op>
+void dispatch(exchange_type type, cache_io & io)
+{
+    switch (type)
+    {
+        case x_char:
+            Op<char>::run(io);
+            break;
+        case x_stdstring:
+            Op<std::string>::run(io);
+            break;
+        case x_short:
+            Op<short>::run(io);
+            break;
+        case x_integer:
+            Op<int>::run(io);
+            break;
+        case x_long_long:
+            Op<long long>::run(io);
+            break;
+        case x_unsigned_long_long:
+            Op<unsigned long long>::run(io);
+            break;
+        case x_double:
+            Op<double>::run(io);
+            break;
+        case x_stdtm:
+            Op<std::tm>::run(io);
+            break;
+        case x_longstring:
+            Op<long_string>::run(io);
+            break;
+        case x_xmltype:
+            Op<xml_type>::run(io);
+            break;
+
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+}
+
+cache_io make_cache_io(std::string * buf, char const * * p, void * data,
+    std::vector<indicator> * ind)
+{
+    cache_io io;
+    io.buf = buf;
+    io.p = p;
+    io.data = data;
+    io.ind = ind;
+    return io;
+}
+
+char to_lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+        c == '\v';
+}
+
+bool is_name_char(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (c >= '0' && c <= '9') || c == '_' || c == '$' || c == '#' || c == '@';
+}
+
+bool is_quote(char c)
+{
+    return c == '\'' || c == '"' || c == '`';
+}
+
+// Returns the position just after the quoted string or identifier starting
+// at the given one.
+std::size_t skip_quoted(std::string const & query, std::size_t pos)
+{
+    std::size_t const end = query.find(query[pos], pos + 1);
+    return end == std::string::npos ? query.size() : end + 1;
+}
+
+// Token of the query as seen by analyze_query().
+struct query_token
+{
+    enum kind
+    {
+        token_keyword,  // Unquoted name without schema, in lower case.
+        token_name,     // Any other, possibly qualified, name.
+        token_other     // Literal or punctuation.
+    };
+
+    kind kind_;
+
+    // For the names, the last component, in lower case and without quotes.
+    std::string text_;
+};
+
+class query_lexer
+{
+public:
+    explicit query_lexer(std::string const & query)
+        : query_(query), pos_(0)
+    {}
+
+    bool next(query_token & token)
+    {
+        while (pos_ < query_.size() && is_space(query_[pos_]))
+        {
+            ++pos_;
+        }
+
+        if (pos_ == query_.size())
+        {
+            return false;
+        }
+
+        char const c = query_[pos_];
+        if (c == '\'')
+        {
+            pos_ = skip_quoted(query_, pos_);
+            token.kind_ = query_token::token_other;
+            token.text_.clear();
+            return true;
+        }
+
+        if (is_name_char(c) == false && c != '"' && c != '`')
+        {
+            ++pos_;
+            token.kind_ = query_token::token_other;
+            token.text_.assign(1, c);
+            return true;
+        }
+
+        // Read all the components of the name, keeping only the last one.
+        bool quoted = false;
+        bool qualified = false;
+        for (;;)
+        {
+            token.text_.clear();
+            if (query_[pos_] == '"' || query_[pos_] == '`')
+            {
+                std::size_t const end = skip_quoted(query_, pos_);
+                for (std::size_t i = pos_ + 1; i < end - 1; ++i)
+                {
+                    token.text_ += to_lower(query_[i]);
+                }
+
+                pos_ = end;
+                quoted = true;
+            }
+            else
+            {
+                while (pos_ < query_.size() && is_name_char(query_[pos_]))
+                {
+                    token.text_ += to_lower(query_[pos_++]);
+                }
+            }
+
+            if (pos_ + 1 < query_.size() && query_[pos_] == '.' &&
+                (is_name_char(query_[pos_ + 1]) || query_[pos_ + 1] == '"' ||
+                    query_[pos_ + 1] == '`'))
+            {
+                ++pos_;
+                qualified = true;
+                continue;
+            }
+
+            break;
+        }
+
+        token.kind_ = quoted || qualified
+            ? query_token::token_name
+            : query_token::token_keyword;
+        return true;
+    }
+
+private:
+    std::string const & query_;
+    std::size_t pos_;
+};
+
+bool is_one_of(std::string const & word, char const * const * words)
+{
+    for (; *words != NULL; ++words)
+    {
+        if (word == *words)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// The keywords followed by a table name.
+char const * const table_keywords[] =
+{
+    "from", "join", "into", "update", "table", "truncate", "delete", "insert",
+    "using", NULL
+};
+
+// The keywords which may appear between the keywords above and the table.
+char const * const table_prefix_keywords[] =
+{
+    "only", "if", "not", "exists", "lateral", "of", "ignore", "low_priority",
+    NULL
+};
+
+// The keywords ending the list of tables following FROM.
+char const * const from_end_keywords[] =
+{
+    "where", "group", "order", "having", "limit", "union", "on", "select",
+    "set", "values", "window", "offset", "fetch", "for", "intersect",
+    "except", "returning", NULL
+};
+
+// The keywords indicating that a query starting as a read modifies data, as
+// data modifying CTEs do, unless they follow FOR, as in SELECT FOR UPDATE.
+char const * const embedded_write_keywords[] =
+{
+    "insert", "update", "delete", "merge", "into", NULL
+};
+
+char const * const read_keywords[] =
+{
+    "select", "with", "values", "show", "explain", "describe", "desc", NULL
+};
+
+char const * const write_keywords[] =
+{
+    "insert", "update", "delete", "replace", "merge", "upsert", "truncate",
+    "drop", "alter", "create", "rename", NULL
+};
+
+} // namespace anonymous
+
+namespace soci
+{
+
+namespace details
+{
+
+bool cache_save_value(std::string & buf, exchange_type type, void * data,
+    indicator const * ind)
+{
+    if (is_cacheable(type) == false)
+    {
+        return false;
+    }
+
+    char const i = static_cast<char>(ind != NULL ? *ind : i_ok);
+    buf += i;
+    if (i != i_null)
+    {
+        cache_io io = make_cache_io(&buf, NULL, data, NULL);
+        dispatch<save_value_op>(type, io);
+    }
+
+    return true;
+}
+
+void cache_load_value(char const * & p, exchange_type type, void * data,
+    indicator * ind)
+{
+    indicator const i = static_cast<indicator>(*p++);
+    if (ind != NULL)
+    {
+        *ind = i;
+    }
+
+    if (i != i_null)
+    {
+        cache_io io = make_cache_io(NULL, &p, data, NULL);
+        dispatch<load_value_op>(type, io);
+    }
+}
+
+bool cache_save_vector(std::string & buf, exchange_type type, void * data,
+    std::vector<indicator> const * ind)
+{
+    if (is_cacheable(type) == false)
+    {
+        return false;
+    }
+
+    cache_io io = make_cache_io(&buf, NULL, data,
+        const_cast<std::vector<indicator> *>(ind));
+    dispatch<save_vector_op>(type, io);
+
+    return true;
+}
+
+void cache_load_vector(char const * & p, exchange_type type, void * data,
+    std::vector<indicator> * ind)
+{
+    cache_io io = make_cache_io(NULL, &p, data, ind);
+    dispatch<load_vector_op>(type, io);
+}
+
+bool cache_append_into_key(std::string & key, exchange_type type)
+{
+    if (is_cacheable(type) == false)
+    {
+        return false;
+    }
+
+    key += static_cast<char>(type);
+    return true;
+}
+
+bool cache_append_vector_into_key(std::string & key, exchange_type type,
+    void * data)
+{
+    if (cache_append_into_key(key, type) == false)
+    {
+        return false;
+    }
+
+    cache_io io = make_cache_io(&key, NULL, data, NULL);
+    dispatch<vector_key_op>(type, io);
+
+    return true;
+}
+
+} // namespace details
+
+} // namespace soci
+
+result_cache_stats::result_cache_stats()
+    : hits(0), misses(0), insertions(0), evictions(0), expirations(0),
+      invalidations(0), entries(0), bytes(0)
+{
+}
+
+double result_cache_stats::get_hit_rate() const
+{
+    unsigned long long const lookups = hits + misses;
+    return lookups != 0 ? static_cast<double>(hits) / lookups : 0.;
+}
+
+struct result_cache::result_cache_impl
+{
+    struct entry
+    {
+        // Points to the key of the index element referring to this entry.
+        std::string const * key_;
+        std::string data_;
+        std::vector<std::string> tables_;
+        long long expires_;
+        std::size_t bytes_;
+    };
+
+    // The most recently used entries come first.
+    typedef std::list<entry> entries_list;
+    typedef std::map<std::string, entries_list::iterator> entries_index;
+    typedef std::multimap<std::string, entries_list::iterator> tables_index;
+
+    explicit result_cache_impl(std::size_t maxBytes)
+        : maxBytes_(maxBytes), generation_(0)
+    {
+    }
+
+    void remove(entries_list::iterator it)
+    {
+        for (std::size_t i = 0; i != it->tables_.size(); ++i)
+        {
+            std::pair<tables_index::iterator, tables_index::iterator> const
+                range = tables_.equal_range(it->tables_[i]);
+            for (tables_index::iterator t = range.first; t != range.second; ++t)
+            {
+                if (t->second == it)
+                {
+                    tables_.erase(t);
+                    break;
+                }
+            }
+        }
+
+        stats_.bytes -= it->bytes_;
+        --stats_.entries;
+
+        index_.erase(*it->key_);
+        entries_.erase(it);
+    }
+
+    void invalidate(std::string const & table)
+    {
+        ++generation_;
+
+        for (;;)
+        {
+            tables_index::iterator const t = tables_.find(table);
+            if (t == tables_.end())
+            {
+                break;
+            }
+
+            remove(t->second);
+            ++stats_.invalidations;
+        }
+    }
+
+    std::size_t const maxBytes_;
+
+    mutex mtx_;
+    entries_list entries_;
+    entries_index index_;
+    tables_index tables_;
+    result_cache_stats stats_;
+
+    // Incremented by every invalidation.
+    unsigned long long generation_;
+};
+
+result_cache::result_cache(std::size_t maxBytes, int ttl)
+    : pimpl_(new result_cache_impl(maxBytes)), maxBytes_(maxBytes), ttl_(ttl)
+{
+}
+
+result_cache::~result_cache()
+{
+    delete pimpl_;
+}
+
+void result_cache::invalidate_table(std::string const & table)
+{
+    // Use the same normalization as analyze_query() does.
+    std::vector<std::string> tables;
+    analyze_query("drop table " + table, tables);
+    if (tables.empty())
+    {
+        return;
+    }
+
+    scoped_lock lock(pimpl_->mtx_);
+    pimpl_->invalidate(tables.front());
+}
+
+void result_cache::clear()
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    ++pimpl_->generation_;
+    pimpl_->stats_.invalidations += pimpl_->entries_.size();
+    pimpl_->entries_.clear();
+    pimpl_->index_.clear();
+    pimpl_->tables_.clear();
+    pimpl_->stats_.entries = 0;
+    pimpl_->stats_.bytes = 0;
+}
+
+result_cache_stats result_cache::get_stats() const
+{
+    scoped_lock lock(pimpl_->mtx_);
+    return pimpl_->stats_;
+}
+
+bool result_cache::find(std::string const & key, std::string & data,
+    unsigned long long & generation)
+{
+    scoped_lock lock(pimpl_->mtx_);
+
+    generation = pimpl_->generation_;
+
+    result_cache_impl::entries_index::iterator const it =
+        pimpl_->index_.find(key);
+    if (it == pimpl_->index_.end())
+    {
+        ++pimpl_->stats_.misses;
+        return false;
+    }
+
+    result_cache_impl::entries_list::iterator const e = it->second;
+    if (e->expires_ != 0 && get_monotonic_time_ns() >= e->expires_)
+    {
+        pimpl_->remove(e);
+        ++pimpl_->stats_.expirations;
+        ++pimpl_->stats_.misses;
+        return false;
+    }
+
+    pimpl_->entries_.splice(pimpl_->entries_.begin(), pimpl_->entries_, e);
+    data = e->data_;
+
+    ++pimpl_->stats_.hits;
+    return true;
+}
+
+void result_cache::store(std::string const & key, std::string const & data,
+    std::vector<std::string> const & tables, unsigned long long generation)
+{
+    std::size_t bytes = entry_overhead + key.size() + data.size();
+    for (std::size_t i = 0; i != tables.size(); ++i)
+    {
+        bytes += table_overhead + tables[i].size();
+    }
+
+    if (bytes > maxBytes_)
+    {
+        return;
+    }
+
+    long long const expires = ttl_ != 0
+        ? get_monotonic_time_ns() + ttl_ * 1000000LL
+        : 0;
+
+    scoped_lock lock(pimpl_->mtx_);
+
+    if (generation != pimpl_->generation_)
+    {
+        return;
+    }
+
+    result_cache_impl::entries_index::iterator const existing =
+        pimpl_->index_.find(key);
+    if (existing != pimpl_->index_.end())
+    {
+        pimpl_->remove(existing->second);
+    }
+
+    while (pimpl_->stats_.bytes + bytes > maxBytes_)
+    {
+        pimpl_->remove(--pimpl_->entries_.end());
+        ++pimpl_->stats_.evictions;
+    }
+
+    pimpl_->entries_.push_front(result_cache_impl::entry());
+    result_cache_impl::entries_list::iterator const e = pimpl_->entries_.begin();
+    e->data_ = data;
+    e->tables_ = tables;
+    e->expires_ = expires;
+    e->bytes_ = bytes;
+    e->key_ = &pimpl_->index_.insert(std::make_pair(key, e)).first->first;
+
+    for (std::size_t i = 0; i != tables.size(); ++i)
+    {
+        pimpl_->tables_.insert(std::make_pair(tables[i], e));
+    }
+
+    pimpl_->stats_.bytes += bytes;
+    ++pimpl_->stats_.entries;
+    ++pimpl_->stats_.insertions;
+}
+
+std::string result_cache::normalize_query(std::string const & query)
+{
+    std::string normalized;
+    normalized.reserve(query.size());
+
+    bool space = false;
+    for (std::size_t pos = 0; pos < query.size(); )
+    {
+        char const c = query[pos];
+        if (is_space(c))
+        {
+            space = true;
+            ++pos;
+            continue;
+        }
+
+        if (space && normalized.empty() == false)
+        {
+            normalized += ' ';
+        }
+        space = false;
+
+        if (is_quote(c))
+        {
+            std::size_t const end = skip_quoted(query, pos);
+            normalized.append(query, pos, end - pos);
+            pos = end;
+        }
+        else
+        {
+            normalized += c;
+            ++pos;
+        }
+    }
+
+    return normalized;
+}
+
+result_cache::query_kind result_cache::analyze_query(
+    std::string const & query, std::vector<std::string> & tables)
+{
+    tables.clear();
+
+    query_lexer lexer(query);
+    query_token token;
+    if (lexer.next(token) == false ||
+        token.kind_ != query_token::token_keyword)
+    {
+        return query_unknown;
+    }
+
+    query_kind kind;
+    if (is_one_of(token.text_, read_keywords))
+    {
+        kind = query_read;
+    }
+    else if (is_one_of(token.text_, write_keywords))
+    {
+        kind = query_write;
+    }
+    else
+    {
+        return query_unknown;
+    }
+
+    bool expectTable = false;
+    bool inFrom = false;
+    std::string previous;
+    do
+    {
+        if (token.kind_ == query_token::token_keyword)
+        {
+            // Data modifying CTEs and SELECT INTO are not just reads.
+            if (kind == query_read && previous != "for" &&
+                is_one_of(token.text_, embedded_write_keywords))
+            {
+                kind = query_write;
+            }
+
+            previous = token.text_;
+
+            if (is_one_of(token.text_, table_keywords))
+            {
+                expectTable = true;
+                inFrom = token.text_ == "from";
+                continue;
+            }
+
+            if (expectTable && is_one_of(token.text_, table_prefix_keywords))
+            {
+                continue;
+            }
+
+            if (is_one_of(token.text_, from_end_keywords))
+            {
+                expectTable = false;
+                inFrom = false;
+                continue;
+            }
+        }
+
+        if (expectTable)
+        {
+            if (token.kind_ != query_token::token_other)
+            {
+                tables.push_back(token.text_);
+            }
+
+            expectTable = false;
+        }
+        else if (inFrom && token.kind_ == query_token::token_other &&
+            token.text_ == ",")
+        {
+            expectTable = true;
+        }
+    }
+    while (lexer.next(token));
+
+    std::sort(tables.begin(), tables.end());
+    tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+
+    return kind;
+}
@@ -17,7 +17,9 @@ using namespace soci;
 using namespace details;
 
 row::row()
-    : uppercaseColumnNames_(false)
+    : bulk_(false)
+    , bulkSize_(0)
+    , uppercaseColumnNames_(false)
     , currentPos_(0)
 {}
 
@@ -68,15 +70,51 @@ void row::clean_up()
     for (std::size_t i = 0; i != hsize; ++i)
     {
         delete holders_[i];
-        delete indicators_[i];
+
+        // in bulk mode the indicators are owned by the columns
+        if (bulkColumns_.empty())
+        {
+            delete indicators_[i];
+        }
+    }
+
+    std::size_t const csize = bulkColumns_.size();
+    for (std::size_t i = 0; i != csize; ++i)
+    {
+        delete bulkColumns_[i];
     }
 
     columns_.clear();
+    bulkColumns_.clear();
     holders_.clear();
     indicators_.clear();
     index_.clear();
 }
 
+void row::set_bulk_size(std::size_t sz)
+{
+    bulk_ = true;
+    bulkSize_ = sz;
+
+    std::size_t const csize = bulkColumns_.size();
+    for (std::size_t i = 0; i != csize; ++i)
+    {
+        bulkColumns_[i]->resize(sz);
+    }
+}
+
+void row::select_bulk_row(std::size_t i)
+{
+    std::size_t const csize = bulkColumns_.size();
+    for (std::size_t c = 0; c != csize; ++c)
+    {
+        bulkColumns_[c]->select(i);
+        indicators_[c] = &bulkColumns_[c]->indicators_[i];
+    }
+
+    currentPos_ = 0;
+}
+
 indicator row::get_indicator(std::size_t pos) const
 {
     return *indicators_.at(pos);
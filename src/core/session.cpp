@@ -9,8 +9,14 @@
 #include "soci/session.h"
 #include "soci/connection-parameters.h"
 #include "soci/connection-pool.h"
+#include "soci/metrics.h"
+#include "soci/result-cache.h"
+#include "soci/async.h"
+#include "soci/object-cache.h"
 #include "soci/soci-backend.h"
 #include "soci/query_transformation.h"
+#include "soci-monotonic-clock.h"
+#include "soci-write-batch.h"
 
 using namespace soci;
 using namespace soci::details;
@@ -18,6 +24,10 @@ using namespace soci::details;
 namespace // anonymous
 {
 
+// The number of rows fetched at once by rowset by default: bulk fetching is
+// opt-in, as not all types and backends support it in the same way.
+std::size_t const default_rowset_batch_size = 1;
+
 void ensureConnected(session_backend * backEnd)
 {
     if (backEnd == NULL)
@@ -36,10 +46,15 @@ public:
     }
 
     virtual void start_query(std::string const & query)
+    {
+        start_shared_query(details::shared_query(query));
+    }
+
+    virtual void start_shared_query(details::shared_query const & query)
     {
         if (logStream_ != NULL)
         {
-            *logStream_ << query << '\n';
+            *logStream_ << query.str() << '\n';
         }
 
         lastQuery_ = query;
@@ -57,7 +72,7 @@ public:
 
     virtual std::string get_last_query() const
     {
-        return lastQuery_;
+        return lastQuery_.str();
     }
 
 private:
@@ -67,7 +82,7 @@ private:
     }
 
     std::ostream * logStream_;
-    std::string lastQuery_;
+    details::shared_query lastQuery_;
 };
 
 } // namespace anonymous
@@ -75,8 +90,14 @@ private:
 session::session()
     : once(this), prepare(this), query_transformation_(NULL),
       logger_(new standard_logger_impl),
-      uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      uppercaseColumnNames_(false), rowsetBatchSize_(default_rowset_batch_size),
+      backEnd_(NULL),
+      metrics_(NULL), resultCache_(NULL),
+      inTransaction_(false), invalidateAllOnCommit_(false),
+      writeBatchSize_(0), writeBatchDelay_(0), writeBatch_(NULL),
+      writeBatchStart_(0), writeBatchQueued_(0),
+      executor_(NULL), defaultExecutor_(NULL),
+      objectCache_(NULL), isFromPool_(false), pool_(NULL)
 {
 }
 
@@ -84,8 +105,14 @@ session::session(connection_parameters const & parameters)
     : once(this), prepare(this), query_transformation_(NULL),
       logger_(new standard_logger_impl),
       lastConnectParameters_(parameters),
-      uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      uppercaseColumnNames_(false), rowsetBatchSize_(default_rowset_batch_size),
+      backEnd_(NULL),
+      metrics_(NULL), resultCache_(NULL),
+      inTransaction_(false), invalidateAllOnCommit_(false),
+      writeBatchSize_(0), writeBatchDelay_(0), writeBatch_(NULL),
+      writeBatchStart_(0), writeBatchQueued_(0),
+      executor_(NULL), defaultExecutor_(NULL),
+      objectCache_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
@@ -95,8 +122,14 @@ session::session(backend_factory const & factory,
     : once(this), prepare(this), query_transformation_(NULL),
     logger_(new standard_logger_impl),
       lastConnectParameters_(factory, connectString),
-      uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      uppercaseColumnNames_(false), rowsetBatchSize_(default_rowset_batch_size),
+      backEnd_(NULL),
+      metrics_(NULL), resultCache_(NULL),
+      inTransaction_(false), invalidateAllOnCommit_(false),
+      writeBatchSize_(0), writeBatchDelay_(0), writeBatch_(NULL),
+      writeBatchStart_(0), writeBatchQueued_(0),
+      executor_(NULL), defaultExecutor_(NULL),
+      objectCache_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
@@ -106,8 +139,14 @@ session::session(std::string const & backendName,
     : once(this), prepare(this), query_transformation_(NULL),
       logger_(new standard_logger_impl),
       lastConnectParameters_(backendName, connectString),
-      uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      uppercaseColumnNames_(false), rowsetBatchSize_(default_rowset_batch_size),
+      backEnd_(NULL),
+      metrics_(NULL), resultCache_(NULL),
+      inTransaction_(false), invalidateAllOnCommit_(false),
+      writeBatchSize_(0), writeBatchDelay_(0), writeBatch_(NULL),
+      writeBatchStart_(0), writeBatchQueued_(0),
+      executor_(NULL), defaultExecutor_(NULL),
+      objectCache_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
@@ -116,8 +155,14 @@ session::session(std::string const & connectString)
     : once(this), prepare(this), query_transformation_(NULL),
       logger_(new standard_logger_impl),
       lastConnectParameters_(connectString),
-      uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      uppercaseColumnNames_(false), rowsetBatchSize_(default_rowset_batch_size),
+      backEnd_(NULL),
+      metrics_(NULL), resultCache_(NULL),
+      inTransaction_(false), invalidateAllOnCommit_(false),
+      writeBatchSize_(0), writeBatchDelay_(0), writeBatch_(NULL),
+      writeBatchStart_(0), writeBatchQueued_(0),
+      executor_(NULL), defaultExecutor_(NULL),
+      objectCache_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
@@ -125,7 +170,13 @@ session::session(std::string const & connectString)
 session::session(connection_pool & pool)
     : query_transformation_(NULL),
       logger_(new standard_logger_impl),
-      isFromPool_(true), pool_(&pool)
+      rowsetBatchSize_(default_rowset_batch_size),
+      metrics_(NULL), resultCache_(NULL),
+      inTransaction_(false), invalidateAllOnCommit_(false),
+      writeBatchSize_(0), writeBatchDelay_(0), writeBatch_(NULL),
+      writeBatchStart_(0), writeBatchQueued_(0),
+      executor_(NULL), defaultExecutor_(NULL),
+      objectCache_(NULL), isFromPool_(true), pool_(&pool)
 {
     poolPosition_ = pool.lease();
     session & pooledSession = pool.at(poolPosition_);
@@ -137,6 +188,9 @@ session::session(connection_pool & pool)
 
 session::~session()
 {
+    // Wait for any pending asynchronous operations before closing.
+    delete defaultExecutor_;
+
     if (isFromPool_)
     {
         pool_->give_back(poolPosition_);
@@ -146,6 +200,13 @@ session::~session()
         delete query_transformation_;
         delete backEnd_;
     }
+
+    if (objectCache_ != NULL)
+    {
+        objectCache_->close();
+    }
+
+    delete writeBatch_;
 }
 
 void session::open(connection_parameters const & parameters)
@@ -200,6 +261,8 @@ void session::close()
     {
         delete backEnd_;
         backEnd_ = NULL;
+
+        end_transaction();
     }
 }
 
@@ -224,42 +287,112 @@ void session::reconnect()
         }
 
         backEnd_ = lastFactory->make_session(lastConnectParameters_);
+
+        if (metrics_ != NULL)
+        {
+            metrics_->record_reconnect();
+        }
     }
 }
 
 void session::begin()
 {
-    ensureConnected(backEnd_);
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).begin();
+    }
+    else
+    {
+        ensureConnected(backEnd_);
+
+        backEnd_->begin();
 
-    backEnd_->begin();
+        inTransaction_ = true;
+    }
 }
 
 void session::commit()
 {
-    ensureConnected(backEnd_);
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).commit();
+    }
+    else
+    {
+        ensureConnected(backEnd_);
+
+        flush_batched_writes();
+
+        backEnd_->commit();
+
+        if (inTransaction_ && resultCache_ != NULL)
+        {
+            if (invalidateAllOnCommit_)
+            {
+                resultCache_->clear();
+            }
+            else
+            {
+                for (std::size_t i = 0; i != invalidateOnCommit_.size(); ++i)
+                {
+                    resultCache_->invalidate_table(invalidateOnCommit_[i]);
+                }
+            }
+        }
 
-    backEnd_->commit();
+        end_transaction();
+    }
 }
 
 void session::rollback()
 {
-    ensureConnected(backEnd_);
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).rollback();
+    }
+    else
+    {
+        ensureConnected(backEnd_);
 
-    backEnd_->rollback();
+        backEnd_->rollback();
+
+        end_transaction();
+    }
 }
 
-std::ostringstream & session::get_query_stream()
+void session::end_transaction()
+{
+    inTransaction_ = false;
+    invalidateAllOnCommit_ = false;
+    invalidateOnCommit_.clear();
+
+    discard_batched_writes();
+    writeBatchQueued_ = 0;
+}
+
+void session::discard_batched_writes()
+{
+    delete writeBatch_;
+    writeBatch_ = NULL;
+}
+
+details::query_builder & session::get_query_builder()
 {
     if (isFromPool_)
     {
-        return pool_->at(poolPosition_).get_query_stream();
+        return pool_->at(poolPosition_).get_query_builder();
     }
     else
     {
-        return query_stream_;
+        return query_builder_;
     }
 }
 
+std::ostringstream & session::get_query_stream()
+{
+    return get_query_builder().get_stream();
+}
+
 std::string session::get_query() const
 {
     if (isFromPool_)
@@ -268,16 +401,29 @@ std::string session::get_query() const
     }
     else
     {
-        // preserve logical constness of get_query,
-        // stream used as read-only here,
-        session* pthis = const_cast<session*>(this);
-
         // sole place where any user-defined query transformation is applied
         if (query_transformation_)
         {
-            return (*query_transformation_)(pthis->get_query_stream().str());
+            return (*query_transformation_)(query_builder_.str());
         }
-        return pthis->get_query_stream().str();
+        return query_builder_.str();
+    }
+}
+
+details::shared_query session::get_shared_query() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_shared_query();
+    }
+    else
+    {
+        if (query_transformation_)
+        {
+            return details::shared_query(
+                (*query_transformation_)(query_builder_.str()));
+        }
+        return details::shared_query(query_builder_.str());
     }
 }
 
@@ -319,6 +465,153 @@ logger const & session::get_logger() const
     }
 }
 
+void session::set_metrics(metrics_registry * metrics)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_metrics(metrics);
+    }
+    else
+    {
+        metrics_ = metrics;
+    }
+}
+
+metrics_registry * session::get_metrics() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_metrics();
+    }
+    else
+    {
+        return metrics_;
+    }
+}
+
+void session::set_result_cache(result_cache * cache)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_result_cache(cache);
+    }
+    else
+    {
+        resultCache_ = cache;
+    }
+}
+
+result_cache * session::get_result_cache() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_result_cache();
+    }
+    else
+    {
+        return resultCache_;
+    }
+}
+
+void session::invalidate_cached_results(
+    std::vector<std::string> const & tables)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).invalidate_cached_results(tables);
+        return;
+    }
+
+    if (resultCache_ == NULL)
+    {
+        return;
+    }
+
+    if (tables.empty())
+    {
+        resultCache_->clear();
+    }
+    else
+    {
+        for (std::size_t i = 0; i != tables.size(); ++i)
+        {
+            resultCache_->invalidate_table(tables[i]);
+        }
+    }
+
+    if (inTransaction_)
+    {
+        if (tables.empty())
+        {
+            invalidateAllOnCommit_ = true;
+        }
+        else if (invalidateAllOnCommit_ == false)
+        {
+            invalidateOnCommit_.insert(invalidateOnCommit_.end(),
+                tables.begin(), tables.end());
+        }
+    }
+}
+
+bool session::is_in_transaction() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).is_in_transaction();
+    }
+    else
+    {
+        return inTransaction_;
+    }
+}
+
+void session::set_executor(async_executor * executor)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_executor(executor);
+    }
+    else
+    {
+        executor_ = executor;
+    }
+}
+
+async_executor & session::get_executor()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_executor();
+    }
+
+    if (executor_ != NULL)
+    {
+        return *executor_;
+    }
+
+    if (defaultExecutor_ == NULL)
+    {
+        defaultExecutor_ = new async_executor();
+    }
+
+    return *defaultExecutor_;
+}
+
+details::object_cache & session::get_object_cache()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_object_cache();
+    }
+
+    if (objectCache_ == NULL)
+    {
+        objectCache_ = new object_cache();
+    }
+
+    return *objectCache_;
+}
+
 void session::set_log_stream(std::ostream * s)
 {
     if (isFromPool_)
@@ -355,6 +648,18 @@ void session::log_query(std::string const & query)
     }
 }
 
+void session::log_query(details::shared_query const & query)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).log_query(query);
+    }
+    else
+    {
+        logger_.start_shared_query(query);
+    }
+}
+
 std::string session::get_last_query() const
 {
     if (isFromPool_)
@@ -415,10 +720,154 @@ bool session::get_uppercase_column_names() const
     }
 }
 
+void session::set_rowset_batch_size(std::size_t size)
+{
+    if (size == 0)
+    {
+        throw soci_error("Rowset batch size must be positive.");
+    }
+
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_rowset_batch_size(size);
+    }
+    else
+    {
+        rowsetBatchSize_ = size;
+    }
+}
+
+std::size_t session::get_rowset_batch_size() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_rowset_batch_size();
+    }
+    else
+    {
+        return rowsetBatchSize_;
+    }
+}
+
+void session::set_write_batch_size(std::size_t size)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_write_batch_size(size);
+    }
+    else
+    {
+        if (size == 0)
+        {
+            flush_batched_writes();
+        }
+
+        writeBatchSize_ = size;
+    }
+}
+
+std::size_t session::get_write_batch_size() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_write_batch_size();
+    }
+    else
+    {
+        return writeBatchSize_;
+    }
+}
+
+void session::set_write_batch_delay(int delay)
+{
+    if (delay < 0)
+    {
+        throw soci_error("Write batch delay can't be negative.");
+    }
+
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_write_batch_delay(delay);
+    }
+    else
+    {
+        writeBatchDelay_ = delay;
+    }
+}
+
+int session::get_write_batch_delay() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_write_batch_delay();
+    }
+    else
+    {
+        return writeBatchDelay_;
+    }
+}
+
+void session::flush_batched_writes()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).flush_batched_writes();
+        return;
+    }
+
+    if (writeBatch_ == NULL)
+    {
+        return;
+    }
+
+    // Detach the batch first, so that the statement executing it doesn't
+    // flush it again.
+    cxx_details::auto_ptr<details::write_batch> batch(writeBatch_);
+    writeBatch_ = NULL;
+
+    batch->execute(*this);
+}
+
+void session::queue_batched_write(std::string const & query,
+    std::vector<details::batched_value> const & values)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).queue_batched_write(query, values);
+        return;
+    }
+
+    if (writeBatch_ != NULL && writeBatch_->matches(query, values) == false)
+    {
+        flush_batched_writes();
+    }
+
+    ++writeBatchQueued_;
+    if (writeBatch_ == NULL)
+    {
+        writeBatch_ = new details::write_batch(query, values,
+            writeBatchQueued_);
+        writeBatchStart_ = get_monotonic_time_ns();
+    }
+    else
+    {
+        writeBatch_->add(values);
+    }
+
+    if (writeBatch_->size() >= writeBatchSize_ ||
+        (writeBatchDelay_ != 0 && get_monotonic_time_ns() - writeBatchStart_ >=
+            writeBatchDelay_ * 1000000LL))
+    {
+        flush_batched_writes();
+    }
+}
+
 bool session::get_next_sequence_value(std::string const & sequence, long long & value)
 {
     ensureConnected(backEnd_);
 
+    flush_batched_writes();
+
     return backEnd_->get_next_sequence_value(*this, sequence, value);
 }
 
@@ -426,6 +875,8 @@ bool session::get_last_insert_id(std::string const & sequence, long long & value
 {
     ensureConnected(backEnd_);
 
+    flush_batched_writes();
+
     return backEnd_->get_last_insert_id(*this, sequence, value);
 }
 
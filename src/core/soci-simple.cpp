@@ -295,7 +295,7 @@ struct statement_wrapper
 {
     statement_wrapper(session & _sql)
         : sql(_sql), st(sql), statement_state(clean), into_kind(empty), use_kind(empty),
-          next_position(0), is_ok(true) {}
+          next_position(0), into_version(1), is_ok(true) {}
 
     ~statement_wrapper();
 
@@ -305,23 +305,44 @@ struct statement_wrapper
     enum state { clean, defining, executing } statement_state;
     enum kind { empty, single, bulk } into_kind, use_kind;
 
-    // into elements
+    // into elements, the values are indexed by position and only the
+    // elements of the vector corresponding to the type of the element at the
+    // given position are used
     int next_position;
     std::vector<data_type> into_types; // for both single and bulk
     std::vector<indicator> into_indicators;
-    std::map<int, std::string> into_strings;
-    std::map<int, int> into_ints;
-    std::map<int, long long> into_longlongs;
-    std::map<int, double> into_doubles;
-    std::map<int, std::tm> into_dates;
+    std::vector<std::string> into_strings;
+    std::vector<int> into_ints;
+    std::vector<long long> into_longlongs;
+    std::vector<double> into_doubles;
+    std::vector<std::tm> into_dates;
     std::map<int, blob_wrapper *> into_blob;
 
     std::vector<std::vector<indicator> > into_indicators_v;
-    std::map<int, std::vector<std::string> > into_strings_v;
-    std::map<int, std::vector<int> > into_ints_v;
-    std::map<int, std::vector<long long> > into_longlongs_v;
-    std::map<int, std::vector<double> > into_doubles_v;
-    std::map<int, std::vector<std::tm> > into_dates_v;
+    std::vector<std::vector<std::string> > into_strings_v;
+    std::vector<std::vector<int> > into_ints_v;
+    std::vector<std::vector<long long> > into_longlongs_v;
+    std::vector<std::vector<double> > into_doubles_v;
+    std::vector<std::vector<std::tm> > into_dates_v;
+
+    // incremented whenever the values of the into elements may change, i.e.
+    // by each execution and fetch
+    unsigned long into_version;
+
+    // buffers returned by soci_get_into_column_v(), also indexed by position,
+    // they are only filled once for the given into_version
+    struct column_buffer
+    {
+        column_buffer() : version(0) {}
+
+        unsigned long version;
+        soci_column column;
+        std::vector<unsigned char> validity;
+        std::vector<size_t> offsets;
+        std::string data;
+        std::vector<int> dates;
+    };
+    std::vector<column_buffer> into_columns_v;
 
     // use elements
     std::map<std::string, indicator> use_indicators;
@@ -761,7 +782,7 @@ SOCI_DECL int soci_into_string(statement_handle st)
 
     wrapper->into_types.push_back(dt_string);
     wrapper->into_indicators.push_back(i_ok);
-    wrapper->into_strings[wrapper->next_position]; // create new entry
+    wrapper->into_strings.resize(wrapper->next_position + 1); // create new entry
     return wrapper->next_position++;
 }
 
@@ -779,7 +800,7 @@ SOCI_DECL int soci_into_int(statement_handle st)
 
     wrapper->into_types.push_back(dt_integer);
     wrapper->into_indicators.push_back(i_ok);
-    wrapper->into_ints[wrapper->next_position]; // create new entry
+    wrapper->into_ints.resize(wrapper->next_position + 1); // create new entry
     return wrapper->next_position++;
 }
 
@@ -797,7 +818,7 @@ SOCI_DECL int soci_into_long_long(statement_handle st)
 
     wrapper->into_types.push_back(dt_long_long);
     wrapper->into_indicators.push_back(i_ok);
-    wrapper->into_longlongs[wrapper->next_position]; // create new entry
+    wrapper->into_longlongs.resize(wrapper->next_position + 1); // create new entry
     return wrapper->next_position++;
 }
 
@@ -815,7 +836,7 @@ SOCI_DECL int soci_into_double(statement_handle st)
 
     wrapper->into_types.push_back(dt_double);
     wrapper->into_indicators.push_back(i_ok);
-    wrapper->into_doubles[wrapper->next_position]; // create new entry
+    wrapper->into_doubles.resize(wrapper->next_position + 1); // create new entry
     return wrapper->next_position++;
 }
 
@@ -833,7 +854,7 @@ SOCI_DECL int soci_into_date(statement_handle st)
 
     wrapper->into_types.push_back(dt_date);
     wrapper->into_indicators.push_back(i_ok);
-    wrapper->into_dates[wrapper->next_position]; // create new entry
+    wrapper->into_dates.resize(wrapper->next_position + 1); // create new entry
     return wrapper->next_position++;
 }
 
@@ -869,7 +890,7 @@ SOCI_DECL int soci_into_string_v(statement_handle st)
 
     wrapper->into_types.push_back(dt_string);
     wrapper->into_indicators_v.push_back(std::vector<indicator>());
-    wrapper->into_strings_v[wrapper->next_position];
+    wrapper->into_strings_v.resize(wrapper->next_position + 1);
     return wrapper->next_position++;
 }
 
@@ -887,7 +908,7 @@ SOCI_DECL int soci_into_int_v(statement_handle st)
 
     wrapper->into_types.push_back(dt_integer);
     wrapper->into_indicators_v.push_back(std::vector<indicator>());
-    wrapper->into_ints_v[wrapper->next_position];
+    wrapper->into_ints_v.resize(wrapper->next_position + 1);
     return wrapper->next_position++;
 }
 
@@ -905,7 +926,7 @@ SOCI_DECL int soci_into_long_long_v(statement_handle st)
 
     wrapper->into_types.push_back(dt_long_long);
     wrapper->into_indicators_v.push_back(std::vector<indicator>());
-    wrapper->into_longlongs_v[wrapper->next_position];
+    wrapper->into_longlongs_v.resize(wrapper->next_position + 1);
     return wrapper->next_position++;
 }
 
@@ -923,7 +944,7 @@ SOCI_DECL int soci_into_double_v(statement_handle st)
 
     wrapper->into_types.push_back(dt_double);
     wrapper->into_indicators_v.push_back(std::vector<indicator>());
-    wrapper->into_doubles_v[wrapper->next_position];
+    wrapper->into_doubles_v.resize(wrapper->next_position + 1);
     return wrapper->next_position++;
 }
 
@@ -941,7 +962,7 @@ SOCI_DECL int soci_into_date_v(statement_handle st)
 
     wrapper->into_types.push_back(dt_date);
     wrapper->into_indicators_v.push_back(std::vector<indicator>());
-    wrapper->into_dates_v[wrapper->next_position];
+    wrapper->into_dates_v.resize(wrapper->next_position + 1);
     return wrapper->next_position++;
 }
 
@@ -1078,6 +1099,8 @@ SOCI_DECL void soci_into_resize_v(statement_handle st, int new_size)
         return;
     }
 
+    ++wrapper->into_version;
+
     for (int i = 0; i != wrapper->next_position; ++i)
     {
         wrapper->into_indicators_v[i].resize(new_size);
@@ -1230,6 +1253,146 @@ SOCI_DECL char const * soci_get_into_date_v(statement_handle st, int position, i
     return format_date(*wrapper, v[index]);
 }
 
+namespace // unnamed
+{
+
+// helper for getting the pointer to the vector data, which is NULL if the
+// vector is empty
+template <typename T>
+T const * data_of(std::vector<T> const & v)
+{
+    return v.empty() ? NULL : &v[0];
+}
+
+} // namespace unnamed
+
+SOCI_DECL int soci_get_into_column_v(statement_handle st, int position,
+    soci_column * column)
+{
+    statement_wrapper * wrapper = static_cast<statement_wrapper *>(st);
+
+    if (wrapper->into_kind != statement_wrapper::bulk)
+    {
+        wrapper->is_ok = false;
+        wrapper->error_message = "No vector into elements.";
+        return -1;
+    }
+
+    if (position < 0 || position >= wrapper->next_position)
+    {
+        wrapper->is_ok = false;
+        wrapper->error_message = "Invalid position.";
+        return -1;
+    }
+
+    // all elements are known by now, as the statement must have been
+    // prepared to fetch anything
+    if (static_cast<int>(wrapper->into_columns_v.size()) != wrapper->next_position)
+    {
+        wrapper->into_columns_v.resize(wrapper->next_position);
+    }
+
+    statement_wrapper::column_buffer & buf = wrapper->into_columns_v[position];
+    if (buf.version == wrapper->into_version)
+    {
+        *column = buf.column;
+
+        wrapper->is_ok = true;
+        return column->size;
+    }
+
+    std::vector<indicator> const & inds = wrapper->into_indicators_v[position];
+    int const size = static_cast<int>(inds.size());
+
+    // bit i is set if the i-th value is not null
+    buf.validity.assign((size + 7) / 8, 0);
+    for (int i = 0; i != size; ++i)
+    {
+        if (inds[i] != i_null)
+        {
+            buf.validity[i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+        }
+    }
+
+    column->size = size;
+    column->validity = data_of(buf.validity);
+    column->values = NULL;
+    column->offsets = NULL;
+    column->data = NULL;
+
+    switch (wrapper->into_types[position])
+    {
+    case dt_string:
+        {
+            std::vector<std::string> const & v = wrapper->into_strings_v[position];
+
+            std::size_t total = 0;
+            for (int i = 0; i != size; ++i)
+            {
+                total += v[i].size();
+            }
+
+            buf.data.clear();
+            buf.data.reserve(total);
+            buf.offsets.resize(size + 1);
+            buf.offsets[0] = 0;
+            for (int i = 0; i != size; ++i)
+            {
+                if (inds[i] != i_null)
+                {
+                    buf.data += v[i];
+                }
+                buf.offsets[i + 1] = buf.data.size();
+            }
+
+            column->offsets = &buf.offsets[0];
+            column->data = buf.data.c_str();
+        }
+        break;
+    case dt_integer:
+        column->values = data_of(wrapper->into_ints_v[position]);
+        break;
+    case dt_long_long:
+    case dt_unsigned_long_long:
+        column->values = data_of(wrapper->into_longlongs_v[position]);
+        break;
+    case dt_double:
+        column->values = data_of(wrapper->into_doubles_v[position]);
+        break;
+    case dt_date:
+        {
+            std::vector<std::tm> const & v = wrapper->into_dates_v[position];
+
+            // format is: year, month, day, hour, minute, second
+            buf.dates.resize(6 * size);
+            for (int i = 0; i != size; ++i)
+            {
+                std::tm const & d = v[i];
+                int * const p = &buf.dates[6 * i];
+                p[0] = d.tm_year + 1900;
+                p[1] = d.tm_mon + 1;
+                p[2] = d.tm_mday;
+                p[3] = d.tm_hour;
+                p[4] = d.tm_min;
+                p[5] = d.tm_sec;
+            }
+
+            column->values = data_of(buf.dates);
+        }
+        break;
+    case dt_blob:
+    case dt_xml:
+        // no support for bulk blob and xml
+        break;
+    }
+
+    buf.column = *column;
+    buf.version = wrapper->into_version;
+
+    wrapper->is_ok = true;
+    return size;
+}
+
 SOCI_DECL void soci_use_string(statement_handle st, char const * name)
 {
     statement_wrapper * wrapper = static_cast<statement_wrapper *>(st);
@@ -2075,6 +2238,7 @@ SOCI_DECL int soci_execute(statement_handle st, int withDataExchange)
 
     try
     {
+        ++wrapper->into_version;
         bool const gotData = wrapper->st.execute(withDataExchange != 0);
 
         wrapper->is_ok = true;
@@ -2103,6 +2267,7 @@ SOCI_DECL int soci_fetch(statement_handle st)
 
     try
     {
+        ++wrapper->into_version;
         bool const gotData = wrapper->st.fetch();
 
         wrapper->is_ok = true;
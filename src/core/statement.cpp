@@ -11,7 +11,11 @@
 #include "soci/into-type.h"
 #include "soci/use-type.h"
 #include "soci/values.h"
+#include "soci/metrics.h"
+#include "soci/prepare-temp-type.h"
 #include "soci-compiler.h"
+#include "soci-monotonic-clock.h"
+#include "soci-write-batch.h"
 #include <ctime>
 #include <cctype>
 
@@ -19,17 +23,37 @@ using namespace soci;
 using namespace soci::details;
 
 
+statement::statement(session & s)
+    : impl_(new (s) details::statement_impl(s)), gotData_(false)
+{
+}
+
+statement::statement(prepare_temp_type const & prep)
+    : impl_(new (prep.get_prepare_info()->get_session())
+        details::statement_impl(prep)),
+      gotData_(false)
+{
+}
+
 statement_impl::statement_impl(session & s)
-    : session_(s), refCount_(1), row_(0),
+    : session_(s), refCount_(1), row_(0), bulkValues_(NULL),
       fetchSize_(1), initialFetchSize_(1),
-      alreadyDescribed_(false)
+      alreadyDescribed_(false),
+      metricsRegistry_(NULL), metricsQuery_(NULL),
+      cacheAnalyzed_(false), cacheQueryKind_(result_cache::query_unknown),
+      cacheGeneration_(0)
 {
     backEnd_ = s.make_statement_backend();
 }
 
 statement_impl::statement_impl(prepare_temp_type const & prep)
     : session_(prep.get_prepare_info()->session_),
-      refCount_(1), row_(0), fetchSize_(1), alreadyDescribed_(false)
+      refCount_(1), row_(0), bulkValues_(NULL),
+      fetchSize_(1), initialFetchSize_(1),
+      alreadyDescribed_(false),
+      metricsRegistry_(NULL), metricsQuery_(NULL),
+      cacheAnalyzed_(false), cacheQueryKind_(result_cache::query_unknown),
+      cacheGeneration_(0)
 {
     backEnd_ = session_.make_statement_backend();
 
@@ -43,10 +67,9 @@ statement_impl::statement_impl(prepare_temp_type const & prep)
     alloc();
 
     // prepare the statement
-    query_ = prepInfo->get_query();
     try
     {
-        prepare(query_);
+        prepare(session_.get_shared_query());
     }
     catch(...)
     {
@@ -81,10 +104,8 @@ void statement_impl::bind(values & values)
             // - or positional
 
             std::string const& useName = (*it)->get_name();
-            if (useName.empty())
+            if (useName.empty() || has_placeholder(useName))
             {
-                // positional use element
-
                 int position = static_cast<int>(uses_.size());
                 (*it)->bind(*this, position);
                 uses_.push_back(*it);
@@ -92,38 +113,7 @@ void statement_impl::bind(values & values)
             }
             else
             {
-                // named use element - check if it is used
-                std::string const placeholder = ":" + useName;
-
-                std::size_t pos = query_.find(placeholder);
-                while (pos != std::string::npos)
-                {
-                    // Retrieve next char after placeholder
-                    // make sure we do not go out of range on the string
-                    const char nextChar = (pos + placeholder.size()) < query_.size() ?
-                                          query_[pos + placeholder.size()] : '\0';
-
-                    if (std::isalnum(nextChar))
-                    {
-                        // We got a partial match only,
-                        // keep looking for the placeholder
-                        pos = query_.find(placeholder, pos + placeholder.size());
-                    }
-                    else
-                    {
-                        int position = static_cast<int>(uses_.size());
-                        (*it)->bind(*this, position);
-                        uses_.push_back(*it);
-                        indicators_.push_back(values.indicators_[cnt]);
-                        // Ok we found it, done
-                        break;
-                    }
-                }
-                // In case we couldn't find the placeholder
-                if (pos == std::string::npos)
-                {
-                    values.add_unused(*it, values.indicators_[cnt]);
-                }
+                values.add_unused(*it, values.indicators_[cnt]);
             }
 
             cnt++;
@@ -140,6 +130,47 @@ void statement_impl::bind(values & values)
     }
 }
 
+bool statement_impl::bind_values_column(use_type_base * u)
+{
+    std::string const& useName = u->get_name();
+    if (useName.empty() == false && has_placeholder(useName) == false)
+    {
+        return false;
+    }
+
+    int position = static_cast<int>(uses_.size());
+    u->bind(*this, position);
+    uses_.push_back(u);
+
+    return true;
+}
+
+bool statement_impl::has_placeholder(std::string const & name) const
+{
+    std::string const& query = query_.str();
+    std::string const placeholder = ":" + name;
+
+    std::size_t pos = query.find(placeholder);
+    while (pos != std::string::npos)
+    {
+        // Retrieve next char after placeholder
+        // make sure we do not go out of range on the string
+        std::size_t const next = pos + placeholder.size();
+        const char nextChar = next < query.size() ? query[next] : '\0';
+
+        if (std::isalnum(nextChar) == 0)
+        {
+            return true;
+        }
+
+        // We got a partial match only,
+        // keep looking for the placeholder
+        pos = query.find(placeholder, next);
+    }
+
+    return false;
+}
+
 void statement_impl::bind_clean_up()
 {
     // deallocate all bind and define objects
@@ -175,6 +206,7 @@ void statement_impl::bind_clean_up()
     }
 
     row_ = NULL;
+    bulkValues_ = NULL;
     alreadyDescribed_ = false;
 }
 
@@ -191,13 +223,48 @@ void statement_impl::clean_up()
 
 void statement_impl::prepare(std::string const & query,
     statement_type eType)
+{
+    prepare(shared_query(query), eType);
+}
+
+void statement_impl::prepare(shared_query const & sharedQuery,
+    statement_type eType)
+{
+    std::string const & query = sharedQuery.str();
+
+    int const events = session_.get_logger().get_statement_events();
+    if (events == logger_impl::statement_events_none &&
+        session_.get_metrics() == NULL)
+    {
+        do_prepare(sharedQuery, eType);
+        return;
+    }
+
+    long long const start = start_operation(so_prepare, query, events);
+
+    try
+    {
+        do_prepare(sharedQuery, eType);
+    }
+    catch (...)
+    {
+        end_operation(so_prepare, query, events, start, 0, true);
+        throw;
+    }
+
+    end_operation(so_prepare, query, events, start, 0, false);
+}
+
+void statement_impl::do_prepare(shared_query const & query,
+    statement_type eType)
 {
     try
     {
         query_ = query;
+        cacheAnalyzed_ = false;
         session_.log_query(query);
 
-        backEnd_->prepare(query, eType);
+        backEnd_->prepare(query.str(), eType);
     }
     catch (...)
     {
@@ -260,102 +327,325 @@ void statement_impl::undefine_and_bind()
 
 bool statement_impl::execute(bool withDataExchange)
 {
+    if (session_.get_write_batch_size() != 0)
+    {
+        if (withDataExchange && batch_write(query_))
+        {
+            return false;
+        }
+
+        // the queued statements must be executed before this one
+        session_.flush_batched_writes();
+    }
+
+    int const events = session_.get_logger().get_statement_events();
+    if (events == logger_impl::statement_events_none &&
+        session_.get_metrics() == NULL)
+    {
+        return do_execute(withDataExchange);
+    }
+
+    long long const start = start_operation(so_execute, query_.str(), events);
+
+    bool gotData;
     try
     {
-        initialFetchSize_ = intos_size();
+        gotData = do_execute(withDataExchange);
+    }
+    catch (...)
+    {
+        end_operation(so_execute, query_.str(), events, start, 0, true);
+        throw;
+    }
+
+    end_operation(so_execute, query_.str(), events, start,
+        get_executed_rows(withDataExchange, gotData), false);
 
-        if (intos_.empty() == false && initialFetchSize_ == 0)
+    return gotData;
+}
+
+long long statement_impl::get_executed_rows(bool withDataExchange,
+    bool gotData)
+{
+    if (intos_.empty())
+    {
+        if (withDataExchange && uses_.empty() == false)
         {
-            // this can happen only with into-vectors elements
-            // and is not allowed when calling execute
-            throw soci_error("Vectors of size 0 are not allowed.");
+            return static_cast<long long>(uses_size());
         }
+    }
+    else if (gotData)
+    {
+        return static_cast<long long>(intos_size());
+    }
+
+    return 0;
+}
 
-        fetchSize_ = initialFetchSize_;
+bool statement_impl::do_execute(bool withDataExchange)
+{
+    try
+    {
+        int const num = pre_execute(withDataExchange);
 
-        // pre-use should be executed before inspecting the sizes of use
-        // elements, as they can be resized in type conversion routines
+        return post_execute(num, backEnd_->execute(num));
+    }
+    catch (...)
+    {
+        rethrow_current_exception_with_context("executing");
+    }
+}
+
+int statement_impl::pre_execute(bool withDataExchange)
+{
+    initialFetchSize_ = intos_size();
+
+    if (intos_.empty() == false && initialFetchSize_ == 0)
+    {
+        // this can happen only with into-vectors elements
+        // and is not allowed when calling execute
+        throw soci_error("Vectors of size 0 are not allowed.");
+    }
 
-        pre_use();
+    fetchSize_ = initialFetchSize_;
 
-        std::size_t const bindSize = uses_size();
+    // pre-use should be executed before inspecting the sizes of use
+    // elements, as they can be resized in type conversion routines
 
-        if (bindSize > 1 && fetchSize_ > 1)
+    pre_use();
+
+    std::size_t const bindSize = uses_size();
+
+    if (bindSize > 1 && fetchSize_ > 1)
+    {
+        throw soci_error(
+             "Bulk insert/update and bulk select not allowed in same query");
+    }
+
+    // looks like a hack and it is - row description should happen
+    // *after* the use elements were completely prepared
+    // and *before* the into elements are touched, so that the row
+    // description process can inject more into elements for
+    // implicit data exchange
+    if ((row_ != NULL || bulkValues_ != NULL) && alreadyDescribed_ == false)
+    {
+        describe();
+        define_for_row();
+    }
+
+    int num = 0;
+    if (withDataExchange)
+    {
+        num = 1;
+
+        pre_fetch();
+
+        if (static_cast<int>(fetchSize_) > num)
         {
-            throw soci_error(
-                 "Bulk insert/update and bulk select not allowed in same query");
+            num = static_cast<int>(fetchSize_);
         }
-
-        // looks like a hack and it is - row description should happen
-        // *after* the use elements were completely prepared
-        // and *before* the into elements are touched, so that the row
-        // description process can inject more into elements for
-        // implicit data exchange
-        if (row_ != NULL && alreadyDescribed_ == false)
+        if (static_cast<int>(bindSize) > num)
         {
-            describe();
-            define_for_row();
+            num = static_cast<int>(bindSize);
         }
+    }
+    
+    pre_exec(num);
 
-        int num = 0;
-        if (withDataExchange)
-        {
-            num = 1;
+    return num;
+}
 
-            pre_fetch();
+bool statement_impl::post_execute(int num,
+    statement_backend::exec_fetch_result res)
+{
+    bool gotData = false;
 
-            if (static_cast<int>(fetchSize_) > num)
-            {
-                num = static_cast<int>(fetchSize_);
-            }
-            if (static_cast<int>(bindSize) > num)
-            {
-                num = static_cast<int>(bindSize);
-            }
+    if (res == statement_backend::ef_success)
+    {
+        // the "success" means that the statement executed correctly
+        // and for select statement this also means that some rows were read
+
+        if (num > 0)
+        {
+            gotData = true;
+
+            // ensure into vectors have correct size
+            resize_intos(static_cast<std::size_t>(num));
         }
-        
-        pre_exec(num);
+    }
+    else // res == ef_no_data
+    {
+        // the "no data" means that the end-of-rowset condition was hit
+        // but still some rows might have been read (the last bunch of rows)
+        // it can also mean that the statement did not produce any results
 
-        statement_backend::exec_fetch_result res = backEnd_->execute(num);
+        gotData = fetchSize_ > 1 ? resize_intos() : false;
+    }
 
-        bool gotData = false;
+    if (num > 0)
+    {
+        post_fetch(gotData, false);
+    }
 
-        if (res == statement_backend::ef_success)
-        {
-            // the "success" means that the statement executed correctly
-            // and for select statement this also means that some rows were read
+    post_use(gotData);
 
-            if (num > 0)
-            {
-                gotData = true;
+    if (session_.get_result_cache() != NULL)
+    {
+        invalidate_cached_results();
+    }
 
-                // ensure into vectors have correct size
-                resize_intos(static_cast<std::size_t>(num));
-            }
+    session_.set_got_data(gotData);
+    return gotData;
+}
+
+void statement_impl::analyze_for_cache(std::string const & query)
+{
+    if (cacheAnalyzed_ == false)
+    {
+        cacheQueryKind_ = result_cache::analyze_query(query, cacheTables_);
+        cacheAnalyzed_ = true;
+    }
+}
+
+void statement_impl::invalidate_cached_results()
+{
+    analyze_for_cache(query_.str());
+
+    switch (cacheQueryKind_)
+    {
+        case result_cache::query_read:
+            break;
+
+        case result_cache::query_write:
+            // if the modified tables couldn't be found, all of them are
+            // invalidated
+            session_.invalidate_cached_results(cacheTables_);
+            break;
+
+        case result_cache::query_unknown:
+            session_.invalidate_cached_results(std::vector<std::string>());
+            break;
+    }
+}
+
+bool statement_impl::find_cached_results(shared_query const & query,
+    bool & gotData)
+{
+    cacheKey_.clear();
+
+    result_cache * const cache = session_.get_result_cache();
+
+    // the results read inside a transaction may depend on its uncommitted
+    // modifications, so they are neither used nor stored
+    if (cache == NULL || intos_.empty() || session_.is_in_transaction())
+    {
+        return false;
+    }
+
+    std::string const & text = query.str();
+    analyze_for_cache(text);
+    if (cacheQueryKind_ != result_cache::query_read || cacheTables_.empty())
+    {
+        return false;
+    }
+
+    std::string key = result_cache::normalize_query(text);
+    key += '\0';
+    for (std::size_t i = 0; i != uses_.size(); ++i)
+    {
+        if (uses_[i]->append_cache_key(key) == false)
+        {
+            return false;
         }
-        else // res == ef_no_data
+    }
+    key += '\0';
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        if (intos_[i]->append_cache_key(key) == false)
         {
-            // the "no data" means that the end-of-rowset condition was hit
-            // but still some rows might have been read (the last bunch of rows)
-            // it can also mean that the statement did not produce any results
-
-            gotData = fetchSize_ > 1 ? resize_intos() : false;
+            return false;
         }
+    }
 
-        if (num > 0)
+    std::string data;
+    bool const found = cache->find(key, data, cacheGeneration_);
+
+    metrics_registry * const metrics = session_.get_metrics();
+    if (metrics != NULL)
+    {
+        metrics->record_cache_lookup(found);
+    }
+
+    if (found == false)
+    {
+        cacheKey_.swap(key);
+        return false;
+    }
+
+    char const * p = data.data();
+    gotData = *p++ != 0;
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        intos_[i]->load_from_cache(p, gotData);
+    }
+
+    query_ = query;
+    session_.log_query(query);
+
+    return true;
+}
+
+bool statement_impl::batch_write(shared_query const & query)
+{
+    if (session_.get_write_batch_size() == 0 ||
+        session_.is_in_transaction() == false ||
+        intos_.empty() == false || intosForRow_.empty() == false ||
+        row_ != NULL || uses_.empty())
+    {
+        return false;
+    }
+
+    std::string const & text = query.str();
+    if (is_batchable_query(text) == false)
+    {
+        return false;
+    }
+
+    std::vector<batched_value> values(uses_.size());
+    for (std::size_t i = 0; i != uses_.size(); ++i)
+    {
+        if (uses_[i]->get_batch_value(values[i]) == false)
         {
-            post_fetch(gotData, false);
+            return false;
         }
+    }
 
-        post_use(gotData);
+    session_.queue_batched_write(text, values);
+    session_.set_got_data(false);
 
-        session_.set_got_data(gotData);
-        return gotData;
+    return true;
+}
+
+void statement_impl::store_cached_results(bool gotData)
+{
+    result_cache * const cache = session_.get_result_cache();
+    if (cacheKey_.empty() || cache == NULL)
+    {
+        return;
     }
-    catch (...)
+
+    std::string data(1, gotData ? '\1' : '\0');
+    for (std::size_t i = 0; i != intos_.size(); ++i)
     {
-        rethrow_current_exception_with_context("executing");
+        if (intos_[i]->save_to_cache(data, gotData) == false)
+        {
+            cacheKey_.clear();
+            return;
+        }
     }
+
+    cache->store(cacheKey_, data, cacheTables_, cacheGeneration_);
+    cacheKey_.clear();
 }
 
 long long statement_impl::get_affected_rows()
@@ -371,6 +661,34 @@ long long statement_impl::get_affected_rows()
 }
 
 bool statement_impl::fetch()
+{
+    int const events = session_.get_logger().get_statement_events();
+    if (events == logger_impl::statement_events_none &&
+        session_.get_metrics() == NULL)
+    {
+        return do_fetch();
+    }
+
+    long long const start = start_operation(so_fetch, query_.str(), events);
+
+    bool gotData;
+    try
+    {
+        gotData = do_fetch();
+    }
+    catch (...)
+    {
+        end_operation(so_fetch, query_.str(), events, start, 0, true);
+        throw;
+    }
+
+    long long const rows = gotData ? static_cast<long long>(intos_size()) : 0;
+    end_operation(so_fetch, query_.str(), events, start, rows, false);
+
+    return gotData;
+}
+
+bool statement_impl::do_fetch()
 {
     try
     {
@@ -442,11 +760,117 @@ bool statement_impl::fetch()
     }
 }
 
+long long statement_impl::start_operation(statement_operation op,
+    std::string const & query, int events)
+{
+    if (events != logger_impl::statement_events_none)
+    {
+        if (backendName_.empty())
+        {
+            backendName_ = session_.get_backend_name();
+        }
+
+        session_.get_logger().start_operation(
+            statement_event(op, query, backendName_));
+    }
+
+    // Start measuring only now, so that the time taken by the logger itself
+    // is not included in the operation duration.
+    return get_monotonic_time_ns();
+}
+
+void statement_impl::end_operation(statement_operation op,
+    std::string const & query, int events, long long start,
+    long long rows, bool failed)
+{
+    long long const duration = get_monotonic_time_ns() - start;
+
+    metrics_registry * const metrics = session_.get_metrics();
+    if (metrics != NULL)
+    {
+        // The query entry is looked up only once, unless the statement is
+        // prepared again or the registry changes.
+        if (metrics != metricsRegistry_ || op == so_prepare)
+        {
+            metricsRegistry_ = metrics;
+            metricsQuery_ = metrics->get_query_entry(query);
+        }
+
+        switch (op)
+        {
+            case so_prepare:
+                metrics->record_prepare(metricsQuery_, failed);
+                break;
+
+            case so_execute:
+                if (intos_.empty() && intosForRow_.empty())
+                {
+                    metrics->record_execute(metricsQuery_, duration,
+                        0, rows, failed);
+                }
+                else
+                {
+                    metrics->record_execute(metricsQuery_, duration,
+                        rows, 0, failed);
+                }
+                break;
+
+            case so_fetch:
+                metrics->record_fetch(metricsQuery_, duration, rows, failed);
+                break;
+        }
+    }
+
+    if (events == logger_impl::statement_events_none)
+    {
+        return;
+    }
+
+    statement_event event(op, query, backendName_);
+    event.duration_ns = duration;
+    event.rows = rows;
+    event.failed = failed;
+
+    if (op != so_prepare && failed == false)
+    {
+        event.bulk = initialFetchSize_ > 1 ||
+            (op == so_execute && uses_.empty() == false && uses_size() > 1);
+    }
+
+    if ((events & logger_impl::statement_events_bytes) && failed == false)
+    {
+        std::size_t bytes = 0;
+        if (rows > 0)
+        {
+            for (std::size_t i = 0; i != intos_.size(); ++i)
+            {
+                bytes += intos_[i]->get_data_size();
+            }
+            for (std::size_t i = 0; i != intosForRow_.size(); ++i)
+            {
+                bytes += intosForRow_[i]->get_data_size();
+            }
+        }
+        if (op == so_execute)
+        {
+            for (std::size_t i = 0; i != uses_.size(); ++i)
+            {
+                bytes += uses_[i]->get_data_size();
+            }
+        }
+
+        event.bytes = bytes;
+    }
+
+    session_.get_logger().end_operation(event);
+}
+
 std::size_t statement_impl::intos_size()
 {
     // this function does not need to take into account intosForRow_ elements,
     // since their sizes are always 1 (which is the same and the primary
-    // into(row) element, which has injected them)
+    // into(row) element, which has injected them) or the same as the size of
+    // the bulk values or bulk row into element, which keeps them in sync
 
     std::size_t intos_size = 0;
     std::size_t const isize = intos_.size();
@@ -502,7 +926,8 @@ std::size_t statement_impl::uses_size()
 bool statement_impl::resize_intos(std::size_t upperBound)
 {
     // this function does not need to take into account the intosForRow_
-    // elements, since they are never used for bulk operations
+    // elements, since they are never used for bulk operations, except for
+    // the columns of the bulk values or row, which are resized by their element
 
     int rows = backEnd_->get_number_of_rows();
     if (rows < 0)
@@ -627,6 +1052,24 @@ namespace details
 
 // Map data_types to stock types for dynamic result set support
 
+template <typename T>
+void statement_impl::into_bulk_values()
+{
+    // The column has the current number of rows when it's created and is
+    // then resized together with the vector of the bulk values into element.
+    details::values_column<T> & column = bulkValues_->add_column<T>();
+    exchange_for_row(into(column.values_, column.indicators_));
+}
+
+template <typename T>
+void statement_impl::into_bulk_row()
+{
+    // Just as for the bulk values, the columns are resized together with the
+    // row by the bulk row into element.
+    details::row_column<T> & column = row_->add_bulk_holder<T>();
+    exchange_for_row(into(column.values_, column.indicators_));
+}
+
 template<>
 void statement_impl::bind_into<dt_string>()
 {
@@ -665,7 +1108,14 @@ void statement_impl::bind_into<dt_date>()
 
 void statement_impl::describe()
 {
-    row_->clean_up();
+    if (bulkValues_ != NULL)
+    {
+        bulkValues_->clear_columns();
+    }
+    else
+    {
+        row_->clean_up();
+    }
 
     int const numcols = backEnd_->prepare_for_describe();
     for (int i = 1; i <= numcols; ++i)
@@ -711,7 +1161,15 @@ void statement_impl::describe()
                 <<" not supported for dynamic selects"<<std::endl;
             throw soci_error(msg.str());
         }
-        row_->add_properties(props);
+
+        if (bulkValues_ != NULL)
+        {
+            bulkValues_->add_column_properties(props);
+        }
+        else
+        {
+            row_->add_properties(props);
+        }
     }
 
     alreadyDescribed_ = true;
@@ -722,7 +1180,7 @@ void statement_impl::describe()
 
 void statement_impl::set_row(row * r)
 {
-    if (row_ != NULL)
+    if (row_ != NULL || bulkValues_ != NULL)
     {
         throw soci_error(
             "Only one Row element allowed in a single statement.");
@@ -732,6 +1190,18 @@ void statement_impl::set_row(row * r)
     row_->uppercase_column_names(session_.get_uppercase_column_names());
 }
 
+void statement_impl::set_bulk_values(values * v)
+{
+    if (row_ != NULL || bulkValues_ != NULL)
+    {
+        throw soci_error(
+            "Only one Row element allowed in a single statement.");
+    }
+
+    bulkValues_ = v;
+    bulkValues_->uppercase_column_names(session_.get_uppercase_column_names());
+}
+
 std::string statement_impl::rewrite_for_procedure_call(std::string const & query)
 {
     return backEnd_->rewrite_for_procedure_call(query);
@@ -783,10 +1253,10 @@ statement_impl::rethrow_current_exception_with_context(char const* operation)
     }
     catch (soci_error& e)
     {
-        if (!query_.empty())
+        if (!query_.str().empty())
         {
             std::ostringstream oss;
-            oss << "while " << operation << " \"" << query_ << "\"";
+            oss << "while " << operation << " \"" << query_.str() << "\"";
 
             if (!uses_.empty())
             {
@@ -0,0 +1,840 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci/error.h"
+#include "soci-compiler.h"
+#include "soci-text-codec.h"
+
+#include <cfloat>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <stdio.h>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // anonymous
+{
+
+unsigned long long const max_unsigned =
+    (std::numeric_limits<unsigned long long>::max)();
+long long const min_signed = (std::numeric_limits<long long>::min)();
+long long const max_signed = (std::numeric_limits<long long>::max)();
+
+inline bool is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Parse the digits at p, which must contain at least one of them, and return
+// the pointer to the first character after them or NULL on overflow.
+char const * parse_digits(char const * p, unsigned long long & value)
+{
+    unsigned long long const max_before_digit = max_unsigned / 10;
+
+    unsigned long long n = 0;
+    for (; is_digit(*p); ++p)
+    {
+        unsigned const digit = static_cast<unsigned>(*p - '0');
+        if (n > max_before_digit ||
+            (n == max_before_digit && digit > max_unsigned % 10))
+        {
+            return NULL;
+        }
+
+        n = n * 10 + digit;
+    }
+
+    value = n;
+    return p;
+}
+
+// Write the digits of the number to the end of the buffer and return the
+// pointer to the first one.
+char * format_digits(unsigned long long n, char * end)
+{
+    char * p = end;
+    do
+    {
+        *--p = static_cast<char>('0' + n % 10);
+        n /= 10;
+    }
+    while (n != 0);
+
+    return p;
+}
+
+// Copy the number formatted at the end of the scratch buffer to the start of
+// the output one and return its length.
+std::size_t copy_formatted(char const * first, char const * end, char * buf)
+{
+    std::size_t const len = static_cast<std::size_t>(end - first);
+    std::memcpy(buf, first, len);
+    buf[len] = '\0';
+
+    return len;
+}
+
+// Powers of 10 exactly representable as double.
+double const exact_powers_of_10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+int const max_exact_power_of_10 = 22;
+
+// Largest integer such that all the integers up to it are exactly
+// representable as double.
+unsigned long long const max_exact_mantissa = 1ULL << 53;
+
+// Format the numbers which can be represented exactly using at most 15
+// significant digits and for which "%.15g" would use fixed notation, which
+// covers most of the values coming from decimal input, without snprintf().
+//
+// The result is the same as the one produced by "%.15g" and is parsed back
+// into the same value, as both the integer and the power of 10 it's divided by
+// are exactly representable. Returns 0 if the value is not such a number.
+std::size_t format_double_fast(double value, char * buf)
+{
+    double const magnitude = value < 0 ? -value : value;
+    if (!(magnitude >= 1e-4 && magnitude < 1e15))
+    {
+        return 0;
+    }
+
+    // We really need exact floating point comparison here.
+    GCC_WARNING_SUPPRESS(float-equal)
+
+    for (int k = 0; k <= max_exact_power_of_10; ++k)
+    {
+        double const scaled = magnitude * exact_powers_of_10[k];
+        if (scaled >= 1e15)
+        {
+            break;
+        }
+
+        unsigned long long const n = static_cast<unsigned long long>(scaled);
+        if (static_cast<double>(n) != scaled ||
+            scaled / exact_powers_of_10[k] != magnitude)
+        {
+            continue;
+        }
+
+        char scratch[number_text_buffer_size];
+        char * const end = scratch + sizeof(scratch);
+        char const * const first = format_digits(n, end);
+        char const * last = end;
+
+        int fractional = k;
+        while (fractional > 0 && last[-1] == '0')
+        {
+            --last;
+            --fractional;
+        }
+
+        int const digits = static_cast<int>(last - first);
+
+        char * p = buf;
+        if (value < 0)
+        {
+            *p++ = '-';
+        }
+
+        if (fractional < digits)
+        {
+            int const integral = digits - fractional;
+            std::memcpy(p, first, integral);
+            p += integral;
+
+            if (fractional != 0)
+            {
+                *p++ = '.';
+                std::memcpy(p, first + integral, fractional);
+                p += fractional;
+            }
+        }
+        else
+        {
+            *p++ = '0';
+            *p++ = '.';
+            for (int i = digits; i < fractional; ++i)
+            {
+                *p++ = '0';
+            }
+
+            std::memcpy(p, first, digits);
+            p += digits;
+        }
+
+        *p = '\0';
+
+        return static_cast<std::size_t>(p - buf);
+    }
+
+    GCC_WARNING_RESTORE(float-equal)
+
+    return 0;
+}
+
+// Output the decimal number with the given significant digits (without
+// trailing zeros) and decimal exponent of the first of them in the same way
+// as "%.*g" with the given precision would do it and return its length.
+std::size_t format_decimal(bool negative, char const * digits, int count,
+    int exponent, int precision, char * buf)
+{
+    char * p = buf;
+    if (negative)
+    {
+        *p++ = '-';
+    }
+
+    if (exponent < -4 || exponent >= precision)
+    {
+        *p++ = digits[0];
+        if (count > 1)
+        {
+            *p++ = '.';
+            std::memcpy(p, digits + 1, count - 1);
+            p += count - 1;
+        }
+
+        *p++ = 'e';
+        *p++ = exponent < 0 ? '-' : '+';
+
+        unsigned const e = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+        if (e >= 100)
+        {
+            *p++ = static_cast<char>('0' + e / 100);
+        }
+        *p++ = static_cast<char>('0' + e / 10 % 10);
+        *p++ = static_cast<char>('0' + e % 10);
+    }
+    else if (exponent < 0)
+    {
+        *p++ = '0';
+        *p++ = '.';
+        for (int i = exponent + 1; i < 0; ++i)
+        {
+            *p++ = '0';
+        }
+
+        std::memcpy(p, digits, count);
+        p += count;
+    }
+    else
+    {
+        for (int i = 0; i <= exponent; ++i)
+        {
+            *p++ = i < count ? digits[i] : '0';
+        }
+
+        if (count > exponent + 1)
+        {
+            *p++ = '.';
+            std::memcpy(p, digits + exponent + 1, count - exponent - 1);
+            p += count - exponent - 1;
+        }
+    }
+
+    *p = '\0';
+
+    return static_cast<std::size_t>(p - buf);
+}
+
+// Check whether the decimal number with the given significant digits and the
+// exponent of the first of them is parsed back into the given value.
+bool is_round_trip(double value, char const * digits, int count, int exponent)
+{
+    // We really need exact floating point comparison here.
+    GCC_WARNING_SUPPRESS(float-equal)
+
+    unsigned long long mantissa = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        mantissa = mantissa * 10 + static_cast<unsigned>(digits[i] - '0');
+    }
+
+    // Use exact arithmetic if possible, as in parse_double().
+    int const power = exponent - count + 1;
+    if (mantissa <= max_exact_mantissa &&
+        power >= -max_exact_power_of_10 && power <= max_exact_power_of_10)
+    {
+        double d = static_cast<double>(mantissa);
+        if (power < 0)
+            d /= exact_powers_of_10[-power];
+        else
+            d *= exact_powers_of_10[power];
+
+        return d == value;
+    }
+
+    char buf[number_text_buffer_size];
+    format_decimal(false, digits, count, exponent, 0, buf);
+
+    double parsed;
+    return soci::details::parse_double(buf, parsed) && parsed == value;
+
+    GCC_WARNING_RESTORE(float-equal)
+}
+
+// Round the 17 significant digits to the given precision, either up or down,
+// and output the result if it's parsed back into the given value, otherwise
+// return 0.
+std::size_t format_rounded(double value, char const * digits, int exponent,
+    int precision, bool up, char * buf)
+{
+    char rounded[17];
+    std::memcpy(rounded, digits, precision);
+
+    if (up)
+    {
+        int i = precision - 1;
+        for (; i >= 0 && rounded[i] == '9'; --i)
+        {
+            rounded[i] = '0';
+        }
+
+        if (i >= 0)
+        {
+            ++rounded[i];
+        }
+        else
+        {
+            rounded[0] = '1';
+            ++exponent;
+        }
+    }
+
+    int count = precision;
+    while (count > 1 && rounded[count - 1] == '0')
+    {
+        --count;
+    }
+
+    if (!is_round_trip(value < 0 ? -value : value, rounded, count, exponent))
+    {
+        return 0;
+    }
+
+    return format_decimal(value < 0, rounded, count, exponent, precision, buf);
+}
+
+// Use the standard strtod() for the numbers not handled by parse_double()
+// itself. The string is known to use point as decimal separator, but the
+// current locale may be using a comma, so retry with it if necessary.
+bool parse_double_slow(char const * s, std::size_t len, double & value)
+{
+    char * end;
+    value = std::strtod(s, &end);
+    if (end == s + len)
+    {
+        return true;
+    }
+
+    if (*end != '.')
+    {
+        return false;
+    }
+
+    // Avoid the allocation for any reasonably sized number.
+    char local[64];
+    char * const buf = len < sizeof(local) ? local : new char[len + 1];
+    std::memcpy(buf, s, len + 1);
+    buf[end - s] = ',';
+
+    value = std::strtod(buf, &end);
+    bool const parsedOK = end == buf + len;
+
+    if (buf != local)
+    {
+        delete [] buf;
+    }
+
+    return parsedOK;
+}
+
+// Helper of parse_std_tm() parsing a single date/time field component.
+int parse_std_tm_field(char const * & p1, char const * & p2)
+{
+    char const * p = p1;
+    while (is_space(*p))
+    {
+        ++p;
+    }
+
+    if (*p == '-')
+        throw soci_error("Negative date/time field component.");
+
+    if (*p == '+')
+        ++p;
+
+    unsigned long long v;
+    if (!is_digit(*p))
+        throw soci_error("Cannot parse date/time field component.");
+
+    p2 = parse_digits(p, v);
+    if (p2 == NULL || v > INT_MAX)
+        throw soci_error("Out of range date/time field component.");
+
+    // Skip the separator following this field, if any.
+    p1 = *p2 != '\0' ? p2 + 1 : p2;
+
+    // Cast is safe due to check above.
+    return static_cast<int>(v);
+}
+
+// Format the number padded with zeroes to the given width.
+char * format_padded(char * p, long long value, int width)
+{
+    char scratch[number_text_buffer_size];
+    char * const end = scratch + sizeof(scratch);
+
+    unsigned long long const u = value < 0
+        ? 0ULL - static_cast<unsigned long long>(value)
+        : static_cast<unsigned long long>(value);
+
+    char * first = format_digits(u, end);
+    if (value < 0)
+    {
+        *p++ = '-';
+    }
+
+    for (int n = static_cast<int>(end - first); n < width; ++n)
+    {
+        *p++ = '0';
+    }
+
+    std::size_t const len = static_cast<std::size_t>(end - first);
+    std::memcpy(p, first, len);
+
+    return p + len;
+}
+
+} // namespace anonymous
+
+bool soci::details::parse_integer(char const * s, unsigned long long & value)
+{
+    char const * p = s;
+    while (is_space(*p))
+    {
+        ++p;
+    }
+
+    if (*p == '+')
+    {
+        ++p;
+    }
+
+    if (!is_digit(*p))
+    {
+        return false;
+    }
+
+    p = parse_digits(p, value);
+
+    return p != NULL && *p == '\0';
+}
+
+bool soci::details::parse_integer(char const * s, long long & value)
+{
+    char const * p = s;
+    while (is_space(*p))
+    {
+        ++p;
+    }
+
+    bool negative = false;
+    if (*p == '+' || *p == '-')
+    {
+        negative = *p == '-';
+        ++p;
+    }
+
+    if (!is_digit(*p))
+    {
+        return false;
+    }
+
+    unsigned long long u;
+    p = parse_digits(p, u);
+    if (p == NULL || *p != '\0')
+    {
+        return false;
+    }
+
+    unsigned long long const max = static_cast<unsigned long long>(max_signed);
+    if (negative)
+    {
+        if (u > max + 1)
+        {
+            return false;
+        }
+
+        // Avoid overflow when negating the smallest value.
+        value = u == max + 1 ? min_signed : -static_cast<long long>(u);
+    }
+    else
+    {
+        if (u > max)
+        {
+            return false;
+        }
+
+        value = static_cast<long long>(u);
+    }
+
+    return true;
+}
+
+bool soci::details::parse_double(char const * s, double & value)
+{
+    char const * p = s;
+    while (is_space(*p))
+    {
+        ++p;
+    }
+
+    char const * const start = p;
+
+    bool negative = false;
+    if (*p == '+' || *p == '-')
+    {
+        negative = *p == '-';
+        ++p;
+    }
+
+    // Accumulate up to 19 significant digits, which always fit into unsigned
+    // long long, and just remember whether any non-zero ones were dropped.
+    unsigned long long mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    bool inexact = false;
+
+    for (; is_digit(*p); ++p)
+    {
+        hasDigits = true;
+        if (significant < 19)
+        {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            if (mantissa != 0)
+                ++significant;
+        }
+        else
+        {
+            ++exponent;
+            if (*p != '0')
+                inexact = true;
+        }
+    }
+
+    if (*p == '.')
+    {
+        for (++p; is_digit(*p); ++p)
+        {
+            hasDigits = true;
+            if (significant < 19)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                if (mantissa != 0)
+                    ++significant;
+                --exponent;
+            }
+            else if (*p != '0')
+            {
+                inexact = true;
+            }
+        }
+    }
+
+    if (!hasDigits)
+    {
+        // This can still be infinity or NaN, which don't depend on the locale.
+        if ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z'))
+        {
+            char * end;
+            value = std::strtod(start, &end);
+            return end != start && *end == '\0';
+        }
+
+        return false;
+    }
+
+    if (*p == 'e' || *p == 'E')
+    {
+        ++p;
+
+        bool negativeExponent = false;
+        if (*p == '+' || *p == '-')
+        {
+            negativeExponent = *p == '-';
+            ++p;
+        }
+
+        if (!is_digit(*p))
+        {
+            return false;
+        }
+
+        // Any exponent this big results in either 0 or infinity anyhow.
+        int e = 0;
+        for (; is_digit(*p); ++p)
+        {
+            if (e < 100000)
+                e = e * 10 + (*p - '0');
+        }
+
+        exponent += negativeExponent ? -e : e;
+    }
+
+    if (*p != '\0')
+    {
+        return false;
+    }
+
+    // When both the mantissa and the power of 10 are exactly representable,
+    // a single multiplication or division gives the correctly rounded result.
+    if (!inexact && mantissa <= max_exact_mantissa &&
+        exponent >= -max_exact_power_of_10 && exponent <= max_exact_power_of_10)
+    {
+        double d = static_cast<double>(mantissa);
+        if (exponent < 0)
+            d /= exact_powers_of_10[-exponent];
+        else
+            d *= exact_powers_of_10[exponent];
+
+        value = negative ? -d : d;
+        return true;
+    }
+
+    return parse_double_slow(start, static_cast<std::size_t>(p - start), value);
+}
+
+std::size_t soci::details::format_integer(unsigned long long value, char * buf)
+{
+    char scratch[number_text_buffer_size];
+    char * const end = scratch + sizeof(scratch);
+
+    return copy_formatted(format_digits(value, end), end, buf);
+}
+
+std::size_t soci::details::format_integer(long long value, char * buf)
+{
+    char scratch[number_text_buffer_size];
+    char * const end = scratch + sizeof(scratch);
+
+    // Avoid overflow when negating the smallest value.
+    unsigned long long const u = value < 0
+        ? 0ULL - static_cast<unsigned long long>(value)
+        : static_cast<unsigned long long>(value);
+
+    char * first = format_digits(u, end);
+    if (value < 0)
+    {
+        *--first = '-';
+    }
+
+    return copy_formatted(first, end, buf);
+}
+
+std::size_t soci::details::format_double(double value, char * buf)
+{
+    std::size_t const fastLen = format_double_fast(value, buf);
+    if (fastLen != 0)
+    {
+        return fastLen;
+    }
+
+    double const magnitude = value < 0 ? -value : value;
+    if (!(magnitude > 0) || magnitude > (std::numeric_limits<double>::max)())
+    {
+        // Zero, infinity and NaN don't depend on the locale.
+        int const len = snprintf(buf, number_text_buffer_size, "%g", value);
+        return static_cast<std::size_t>(len);
+    }
+
+    // Get all the 17 significant digits, which are always enough to represent
+    // any double exactly, and the exponent. The character after the first
+    // digit is the decimal separator of the current locale and is ignored.
+    char text[number_text_buffer_size];
+    snprintf(text, sizeof(text), "%.16e", magnitude);
+
+    char digits[17];
+    digits[0] = text[0];
+    std::memcpy(digits + 1, text + 2, 16);
+
+    int exponent = std::atoi(text + 19);
+
+    // Find the shortest representation, knowing that 15 digits are enough for
+    // most of the values coming from the decimal input.
+    for (int precision = 15; precision < 17; ++precision)
+    {
+        // As the digits are already rounded, rounding them again may give the
+        // wrong neighbour, so try the other one too if this one doesn't work.
+        bool const up = digits[precision] >= '5';
+
+        std::size_t len = format_rounded(value, digits, exponent, precision, up, buf);
+        if (len == 0)
+        {
+            len = format_rounded(value, digits, exponent, precision, !up, buf);
+        }
+
+        if (len != 0)
+        {
+            return len;
+        }
+    }
+
+    int count = 17;
+    while (count > 1 && digits[count - 1] == '0')
+    {
+        --count;
+    }
+
+    return format_decimal(value < 0, digits, count, exponent, 17, buf);
+}
+
+std::size_t soci::details::format_float(float value, char * buf)
+{
+    double const magnitude = value < 0 ? -value : value;
+    if (!(magnitude > 0) || magnitude > (std::numeric_limits<float>::max)())
+    {
+        // Zero, infinity and NaN don't depend on the locale.
+        int const len = snprintf(buf, number_text_buffer_size, "%g", value);
+        return static_cast<std::size_t>(len);
+    }
+
+    // We really need exact floating point comparison here.
+    GCC_WARNING_SUPPRESS(float-equal)
+
+    // Unlike in format_double(), there are few enough digits to let snprintf()
+    // round them correctly for each precision, the last one of which is always
+    // enough to represent any float exactly.
+    std::size_t len = 0;
+    for (int precision = FLT_DIG; precision <= FLT_DIG + 3; ++precision)
+    {
+        // The character after the first digit is the decimal separator of the
+        // current locale and is ignored.
+        char text[number_text_buffer_size];
+        snprintf(text, sizeof(text), "%.*e", precision - 1, magnitude);
+
+        char digits[FLT_DIG + 3];
+        digits[0] = text[0];
+        std::memcpy(digits + 1, text + 2, precision - 1);
+
+        int const exponent = std::atoi(text + precision + 2);
+
+        int count = precision;
+        while (count > 1 && digits[count - 1] == '0')
+        {
+            --count;
+        }
+
+        len = format_decimal(value < 0, digits, count, exponent, precision, buf);
+
+        double parsed;
+        if (parse_double(buf, parsed) && static_cast<float>(parsed) == value)
+        {
+            break;
+        }
+    }
+
+    GCC_WARNING_RESTORE(float-equal)
+
+    return len;
+}
+
+void soci::details::make_std_tm(std::tm & t,
+    int year, int month, int day, int hour, int minute, int second)
+{
+    t.tm_isdst = -1;
+    t.tm_year = year - 1900;
+    t.tm_mon  = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min  = minute;
+    t.tm_sec  = second;
+
+    std::mktime(&t);
+}
+
+void soci::details::parse_std_tm(char const * buf, std::tm & t)
+{
+    char const * p1 = buf;
+    char const * p2;
+    char separator;
+    int a, b, c;
+    int year = 1900, month = 1, day = 1;
+    int hour = 0, minute = 0, second = 0;
+
+    a = parse_std_tm_field(p1, p2);
+    separator = *p2;
+    b = parse_std_tm_field(p1, p2);
+    c = parse_std_tm_field(p1, p2);
+
+    if (*p2 == ' ' || *p2 == 'T')
+    {
+        // there are more elements to parse
+        // - assume that what was already parsed is a date part
+        // and that the remaining elements describe the time of day
+        year = a;
+        month = b;
+        day = c;
+        hour   = parse_std_tm_field(p1, p2);
+        minute = parse_std_tm_field(p1, p2);
+        second = parse_std_tm_field(p1, p2);
+    }
+    else
+    {
+        // only three values have been parsed
+        if (separator == '-')
+        {
+            // assume the date value was read
+            // (leave the time of day as 00:00:00)
+            year = a;
+            month = b;
+            day = c;
+        }
+        else
+        {
+            // assume the time of day was read
+            // (leave the date part as 1900-01-01)
+            hour = a;
+            minute = b;
+            second = c;
+        }
+    }
+
+    make_std_tm(t, year, month, day, hour, minute, second);
+}
+
+std::size_t soci::details::format_std_tm(std::tm const & t, char * buf)
+{
+    char * p = buf;
+    p = format_padded(p, t.tm_year + 1900LL, 4);
+    *p++ = '-';
+    p = format_padded(p, t.tm_mon + 1LL, 2);
+    *p++ = '-';
+    p = format_padded(p, t.tm_mday, 2);
+    *p++ = ' ';
+    p = format_padded(p, t.tm_hour, 2);
+    *p++ = ':';
+    p = format_padded(p, t.tm_min, 2);
+    *p++ = ':';
+    p = format_padded(p, t.tm_sec, 2);
+    *p = '\0';
+
+    return static_cast<std::size_t>(p - buf);
+}
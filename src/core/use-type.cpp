@@ -10,6 +10,8 @@
 #include "soci/use-type.h"
 #include "soci/statement.h"
 #include "soci-exchange-cast.h"
+#include "soci-result-cache.h"
+#include "soci-write-batch.h"
 
 #include <cstdio>
 
@@ -151,6 +153,45 @@ void standard_use_type::clean_up()
     }
 }
 
+std::size_t standard_use_type::get_data_size() const
+{
+    if (ind_ != NULL && *ind_ == i_null)
+    {
+        return 0;
+    }
+
+    return exchange_data_size(type_, data_);
+}
+
+bool standard_use_type::append_cache_key(std::string & key)
+{
+    // the key must use the same value as would be sent to the database
+    convert_to_base();
+
+    // the name determines the placeholder the value is bound to
+    key += name_;
+    key += '\0';
+    key += static_cast<char>(type_);
+    return cache_save_value(key, type_, data_, ind_);
+}
+
+bool standard_use_type::get_batch_value(batched_value & value)
+{
+    if (is_batchable_type(type_) == false)
+    {
+        return false;
+    }
+
+    // the batch must contain the same value as would be sent to the database
+    convert_to_base();
+
+    value.name = name_;
+    value.type = type_;
+    value.data = data_;
+    value.ind = ind_;
+    return true;
+}
+
 vector_use_type::~vector_use_type()
 {
     delete backEnd_;
@@ -210,6 +251,11 @@ std::size_t vector_use_type::size() const
     return backEnd_->size();
 }
 
+std::size_t vector_use_type::get_data_size() const
+{
+    return exchange_vector_data_size(type_, data_, begin_, end_);
+}
+
 void vector_use_type::clean_up()
 {
     if (backEnd_ != NULL)
@@ -23,6 +23,10 @@ indicator values::get_indicator(std::size_t pos) const
     {
         return row_->get_indicator(pos);
     }
+    else if (bulkState_ != bulk_none)
+    {
+        return get_column(pos).indicators_[bulkRow_];
+    }
     else
     {
         return *indicators_[pos];
@@ -35,6 +39,10 @@ indicator values::get_indicator(std::string const& name) const
     {
         return row_->get_indicator(name);
     }
+    else if (bulkState_ != bulk_none)
+    {
+        return get_column(name).indicators_[bulkRow_];
+    }
     else
     {
         std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
@@ -54,6 +62,10 @@ column_properties const& values::get_properties(std::size_t pos) const
     {
         return row_->get_properties(pos);
     }
+    else if (bulkState_ != bulk_none)
+    {
+        return get_column(pos).get_properties();
+    }
 
     throw soci_error("Rowset is empty");
 }
@@ -64,6 +76,10 @@ column_properties const& values::get_properties(std::string const& name) const
     {
         return row_->get_properties(name);
     }
+    else if (bulkState_ != bulk_none)
+    {
+        return get_column(name).get_properties();
+    }
 
     throw soci_error("Rowset is empty");
 }
@@ -0,0 +1,263 @@
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "soci-write-batch.h"
+#include "soci/error.h"
+#include "soci/session.h"
+#include "soci/statement.h"
+#include "soci/use-type.h"
+#include "soci-exchange-cast.h"
+
+#include <cctype>
+#include <sstream>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace soci
+{
+
+namespace details
+{
+
+// All the values of a single use element of the queued statements.
+class batch_column
+{
+public:
+    batch_column(std::string const & name, exchange_type type)
+        : name_(name), type_(type)
+    {}
+
+    virtual ~batch_column() {}
+
+    bool matches(batched_value const & value) const
+    {
+        return value.type == type_ && value.name == name_;
+    }
+
+    virtual void add(void * data, indicator const * ind) = 0;
+
+    // Returns a new vector use element for all the values.
+    virtual use_type_base * make_use() = 0;
+
+protected:
+    std::string const name_;
+    exchange_type const type_;
+    std::vector<indicator> inds_;
+
+    SOCI_NOT_COPYABLE(batch_column)
+};
+
+} // namespace details
+
+} // namespace soci
+
+namespace // anonymous
+{
+
+template <typename T>
+class typed_batch_column : public batch_column
+{
+public:
+    typed_batch_column(std::string const & name, exchange_type type)
+        : batch_column(name, type)
+    {}
+
+    void add(void * data, indicator const * ind) SOCI_OVERRIDE
+    {
+        indicator const i = ind != NULL ? *ind : i_ok;
+
+        // The value of a null element is not used, but must still be there.
+        values_.push_back(i == i_null ? T() : *static_cast<T *>(data));
+        inds_.push_back(i);
+    }
+
+    use_type_base * make_use() SOCI_OVERRIDE
+    {
+        return new vector_use_type(&values_, type_, inds_, name_);
+    }
+
+private:
+    std::vector<T> values_;
+};
+
+template <exchange_type e>
+batch_column * make_typed_batch_column(std::string const & name)
+{
+    return new typed_batch_column<
+        typename exchange_type_traits<e>::value_type>(name, e);
+}
+
+batch_column * make_batch_column(batched_value const & value)
+{
+    switch (value.type)
+    {
+        case x_char:
+            return make_typed_batch_column<x_char>(value.name);
+        case x_stdstring:
+            return make_typed_batch_column<x_stdstring>(value.name);
+        case x_short:
+            return make_typed_batch_column<x_short>(value.name);
+        case x_integer:
+            return make_typed_batch_column<x_integer>(value.name);
+        case x_long_long:
+            return make_typed_batch_column<x_long_long>(value.name);
+        case x_unsigned_long_long:
+            return make_typed_batch_column<x_unsigned_long_long>(value.name);
+        case x_double:
+            return make_typed_batch_column<x_double>(value.name);
+        case x_stdtm:
+            return make_typed_batch_column<x_stdtm>(value.name);
+
+        case x_longstring:
+        case x_xmltype:
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+
+    throw soci_error("Values of this type can't be batched.");
+}
+
+} // namespace anonymous
+
+write_batch::write_batch(std::string const & query,
+    std::vector<batched_value> const & values, std::size_t first)
+    : query_(query), first_(first), size_(0)
+{
+    try
+    {
+        columns_.reserve(values.size());
+        for (std::size_t i = 0; i != values.size(); ++i)
+        {
+            columns_.push_back(make_batch_column(values[i]));
+        }
+
+        add(values);
+    }
+    catch (...)
+    {
+        for (std::size_t i = 0; i != columns_.size(); ++i)
+        {
+            delete columns_[i];
+        }
+
+        throw;
+    }
+}
+
+write_batch::~write_batch()
+{
+    for (std::size_t i = 0; i != columns_.size(); ++i)
+    {
+        delete columns_[i];
+    }
+}
+
+bool write_batch::matches(std::string const & query,
+    std::vector<batched_value> const & values) const
+{
+    if (query != query_ || values.size() != columns_.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i != values.size(); ++i)
+    {
+        if (columns_[i]->matches(values[i]) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void write_batch::add(std::vector<batched_value> const & values)
+{
+    for (std::size_t i = 0; i != values.size(); ++i)
+    {
+        columns_[i]->add(values[i].data, values[i].ind);
+    }
+
+    ++size_;
+}
+
+void write_batch::execute(session & sql)
+{
+    try
+    {
+        statement st(sql);
+        st.alloc();
+        st.prepare(query_, st_repeatable_query);
+
+        for (std::size_t i = 0; i != columns_.size(); ++i)
+        {
+            st.exchange(use_type_ptr(columns_[i]->make_use()));
+        }
+
+        st.define_and_bind();
+        st.execute(true);
+    }
+    catch (soci_error & e)
+    {
+        // The bulk operation doesn't allow to find which one of the queued
+        // statements failed, so at least say which of them were executed.
+        std::ostringstream oss;
+        oss << "when flushing the statements #" << first_
+            << " to #" << first_ + size_ - 1
+            << " queued in the current transaction";
+
+        e.add_context(oss.str());
+        throw;
+    }
+}
+
+bool soci::details::is_batchable_query(std::string const & query)
+{
+    std::string::const_iterator it = query.begin();
+    while (it != query.end() && std::isspace(static_cast<unsigned char>(*it)))
+    {
+        ++it;
+    }
+
+    std::string keyword;
+    while (it != query.end() && std::isalpha(static_cast<unsigned char>(*it)))
+    {
+        keyword += static_cast<char>(
+            std::tolower(static_cast<unsigned char>(*it)));
+        ++it;
+    }
+
+    return keyword == "insert" || keyword == "update" || keyword == "delete";
+}
+
+bool soci::details::is_batchable_type(exchange_type type)
+{
+    switch (type)
+    {
+        case x_char:
+        case x_stdstring:
+        case x_short:
+        case x_integer:
+        case x_long_long:
+        case x_unsigned_long_long:
+        case x_double:
+        case x_stdtm:
+            return true;
+
+        case x_longstring:
+        case x_xmltype:
+        case x_statement:
+        case x_rowid:
+        case x_blob:
+            break;
+    }
+
+    return false;
+}
@@ -22,6 +22,7 @@
 #endif // SOCI_HAVE_BOOST
 
 #include "soci-compiler.h"
+#include "soci-monotonic-clock.h"
 
 #define CATCH_CONFIG_RUNNER
 #include <catch.hpp>
@@ -39,6 +40,7 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 #include <string>
 #include <typeinfo>
 
@@ -123,6 +125,14 @@ private:
     int i_;
 };
 
+// user-defined enum exchanged directly as its base type when using vectors
+enum Weekday
+{
+    weekday_monday = 1,
+    weekday_tuesday,
+    weekday_wednesday
+};
+
 namespace soci
 {
 
@@ -146,6 +156,31 @@ template<> struct type_conversion<MyInt>
     }
 };
 
+template<> struct type_conversion<Weekday>
+{
+    typedef int base_type;
+
+    static void from_base(int i, indicator ind, Weekday &wd)
+    {
+        if (ind == i_null)
+        {
+            throw soci_error("Null value not allowed for this type");
+        }
+        wd = static_cast<Weekday>(i);
+    }
+
+    static void to_base(Weekday wd, int &i, indicator &ind)
+    {
+        i = wd;
+        ind = i_ok;
+    }
+};
+
+template<> struct is_layout_compatible_with_base<Weekday>
+{
+    static bool const value = true;
+};
+
 // basic type conversion on many values (ORM)
 template<> struct type_conversion<PhonebookEntry>
 {
@@ -210,6 +245,22 @@ template<> struct type_conversion<PhonebookEntry3>
 
 } // namespace soci
 
+// Struct with the fields mapped at compile time
+struct MappedRecord
+{
+    int id;
+    MyInt val;
+    double d;
+    std::string str;
+};
+
+SOCI_MAP_STRUCT_BEGIN(MappedRecord)
+    SOCI_MAP_FIELD(id)
+    SOCI_MAP_FIELD(val)
+    SOCI_MAP_FIELD(d)
+    SOCI_MAP_FIELD(str)
+SOCI_MAP_STRUCT_END()
+
 namespace soci
 {
 namespace tests
@@ -2433,6 +2484,290 @@ TEST_CASE_METHOD(common_tests, "Partial match with ORM", "[core][orm]")
     CHECK(out.phone == "phone1");
 }
 
+TEST_CASE_METHOD(common_tests, "Bulk ORM", "[core][orm][bulk]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    sql.uppercase_column_names(true);
+    auto_table_creator tableCreator(tc_.table_creator_3(sql));
+
+    std::vector<PhonebookEntry> in(5);
+    for (std::size_t i = 0; i != in.size(); ++i)
+    {
+        std::ostringstream oss;
+        oss << "name" << i;
+        in[i].name = oss.str();
+
+        // leave one phone empty, which is stored as NULL
+        if (i != 2)
+        {
+            oss << "-phone";
+            in[i].phone = oss.str();
+        }
+    }
+
+    sql << "insert into soci_test values(:NAME, :PHONE)", use(in);
+
+    int count = 0;
+    sql << "select count(*) from soci_test where phone is null", into(count);
+    CHECK(count == 1);
+
+    SECTION("Fetch all rows at once")
+    {
+        std::vector<PhonebookEntry> out(10);
+        sql << "select * from soci_test order by name", into(out);
+
+        REQUIRE(out.size() == 5);
+        CHECK(out[0].name == "name0");
+        CHECK(out[0].phone == "name0-phone");
+        CHECK(out[2].name == "name2");
+
+        // see type_conversion<PhonebookEntry>
+        CHECK(out[2].phone == "<NULL>");
+        CHECK(out[4].name == "name4");
+        CHECK(out[4].phone == "name4-phone");
+    }
+
+    SECTION("Fetch in batches")
+    {
+        std::vector<PhonebookEntry2> out(2);
+        statement st = (sql.prepare <<
+            "select * from soci_test order by name", into(out));
+        st.execute();
+
+        std::vector<PhonebookEntry2> all;
+        while (st.fetch())
+        {
+            all.insert(all.end(), out.begin(), out.end());
+            out.resize(2);
+        }
+
+        REQUIRE(all.size() == 5);
+        CHECK(all[1].name == "name1");
+        CHECK(all[1].phone == "name1-phone");
+
+        // see type_conversion<PhonebookEntry2>
+        CHECK(all[2].phone == "<NULL>");
+        CHECK(all[4].name == "name4");
+    }
+
+    SECTION("Repeated execution")
+    {
+        std::vector<PhonebookEntry> more(3);
+        statement st = (sql.prepare <<
+            "insert into soci_test values(:NAME, :PHONE)", use(more));
+
+        for (int n = 0; n != 2; ++n)
+        {
+            for (std::size_t i = 0; i != more.size(); ++i)
+            {
+                std::ostringstream oss;
+                oss << "more" << n << i;
+                more[i].name = oss.str();
+                more[i].phone = "123";
+            }
+
+            st.execute(true);
+        }
+
+        sql << "select count(*) from soci_test where phone = '123'", into(count);
+        CHECK(count == 6);
+    }
+
+    SECTION("Const vector")
+    {
+        std::vector<PhonebookEntry> more(4);
+        for (std::size_t i = 0; i != more.size(); ++i)
+        {
+            std::ostringstream oss;
+            oss << "const" << i;
+            more[i].name = oss.str();
+            more[i].phone = "456";
+        }
+
+        std::vector<PhonebookEntry> const & cmore = more;
+        sql << "insert into soci_test values(:NAME, :PHONE)", use(cmore);
+
+        sql << "select count(*) from soci_test where phone = '456'", into(count);
+        CHECK(count == 4);
+
+        std::size_t end = 3;
+        sql << "delete from soci_test where phone = '456'";
+        sql << "insert into soci_test values(:NAME, :PHONE)", use(cmore, 1, end);
+
+        std::vector<std::string> names(10);
+        sql << "select name from soci_test where phone = '456' order by name",
+            into(names);
+        REQUIRE(names.size() == 2);
+        CHECK(names[0] == "const1");
+        CHECK(names[1] == "const2");
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Struct mapping", "[core][orm][struct]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    char const * const insertQuery =
+        "insert into soci_test(id, val, d, str) values(:id, :val, :d, :str)";
+    char const * const selectQuery =
+        "select id, val, d, str from soci_test order by id";
+
+    SECTION("Single row")
+    {
+        MappedRecord in;
+        in.id = 1;
+        in.val.set(17);
+        in.d = 2.5;
+        in.str = "one";
+
+        statement st = (sql.prepare << insertQuery, use(in));
+        st.execute(true);
+
+        in.id = 2;
+        in.str = "two";
+        st.execute(true);
+
+        MappedRecord const & cin = in;
+        in.id = 3;
+        sql << insertQuery, use(cin);
+
+        MappedRecord out;
+        sql << selectQuery, into(out);
+        CHECK(out.id == 1);
+        CHECK(out.val.get() == 17);
+        ASSERT_EQUAL_EXACT(out.d, 2.5);
+        CHECK(out.str == "one");
+
+        int count = 0;
+        rowset<MappedRecord> rs = (sql.prepare << selectQuery);
+        for (rowset<MappedRecord>::const_iterator it = rs.begin();
+            it != rs.end(); ++it)
+        {
+            ++count;
+            CHECK(it->id == count);
+        }
+        CHECK(count == 3);
+    }
+
+    SECTION("Bulk")
+    {
+        std::vector<MappedRecord> in(10);
+        for (std::size_t i = 0; i != in.size(); ++i)
+        {
+            in[i].id = static_cast<int>(i);
+            in[i].val.set(static_cast<int>(i * 10));
+            in[i].d = 0.5 * i;
+
+            std::ostringstream oss;
+            oss << "str" << i;
+            in[i].str = oss.str();
+        }
+
+        sql << insertQuery, use(in);
+
+        std::vector<MappedRecord> out(4);
+        statement st = (sql.prepare << selectQuery, into(out));
+        st.execute();
+
+        std::vector<MappedRecord> all;
+        while (st.fetch())
+        {
+            all.insert(all.end(), out.begin(), out.end());
+            out.resize(4);
+        }
+
+        REQUIRE(all.size() == 10);
+        CHECK(all[0].id == 0);
+        CHECK(all[3].val.get() == 30);
+        ASSERT_EQUAL_EXACT(all[7].d, 3.5);
+        CHECK(all[9].str == "str9");
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Layout compatible vector conversions", "[core][type_conversion][vector]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    std::vector<int> ids;
+    std::vector<Weekday> days;
+    ids.push_back(1);
+    days.push_back(weekday_monday);
+    ids.push_back(2);
+    days.push_back(weekday_wednesday);
+    ids.push_back(3);
+    days.push_back(weekday_tuesday);
+
+    sql << "insert into soci_test(id, val) values(:id, :val)", use(ids), use(days);
+
+    SECTION("whole vector")
+    {
+        std::vector<Weekday> out(10);
+        sql << "select val from soci_test order by id", into(out);
+        REQUIRE(out.size() == 3);
+        CHECK(out[0] == weekday_monday);
+        CHECK(out[1] == weekday_wednesday);
+        CHECK(out[2] == weekday_tuesday);
+    }
+
+    SECTION("fetching in batches")
+    {
+        std::vector<Weekday> out(2);
+        statement st = (sql.prepare <<
+            "select val from soci_test order by id", into(out));
+        st.execute();
+
+        REQUIRE(st.fetch());
+        REQUIRE(out.size() == 2);
+        CHECK(out[0] == weekday_monday);
+        CHECK(out[1] == weekday_wednesday);
+
+        REQUIRE(st.fetch());
+        REQUIRE(out.size() == 1);
+        CHECK(out[0] == weekday_tuesday);
+
+        CHECK(!st.fetch());
+    }
+
+    SECTION("use with indicators")
+    {
+        sql << "delete from soci_test";
+
+        std::vector<indicator> inds(3, i_ok);
+        inds[1] = i_null;
+        sql << "insert into soci_test(id, val) values(:id, :val)",
+            use(ids), use(days, inds);
+
+        std::vector<int> out(10);
+        std::vector<indicator> outInds(10);
+        sql << "select val from soci_test order by id", into(out, outInds);
+        REQUIRE(out.size() == 3);
+        CHECK(out[0] == weekday_monday);
+        CHECK(outInds[1] == i_null);
+        CHECK(out[2] == weekday_tuesday);
+    }
+
+    SECTION("NULL values")
+    {
+        sql << "insert into soci_test(id) values(4)";
+
+        std::vector<Weekday> out(4);
+        std::vector<indicator> inds(4);
+        sql << "select val from soci_test order by id", into(out, inds);
+        REQUIRE(out.size() == 4);
+        REQUIRE(inds.size() == 4);
+        CHECK(inds[0] == i_ok);
+        CHECK(out[1] == weekday_wednesday);
+        CHECK(inds[3] == i_null);
+
+        // As for the basic types, NULLs can't be fetched without indicators.
+        CHECK_THROWS_AS((sql << "select val from soci_test order by id",
+            into(out)), soci_error&);
+    }
+}
+
 TEST_CASE_METHOD(common_tests, "Numeric round trip", "[core][float]")
 {
     soci::session sql(backEndFactory_, connectString_);
@@ -2563,6 +2898,19 @@ TEST_CASE_METHOD(common_tests, "Rowset creation and copying", "[core][rowset]")
         CHECK(rs1.end() == rs2.end());
         CHECK(rs1.end() == rs3.end());
     }
+
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    {
+        // Move construction and assignment
+        rowset<row> rs1 = (sql.prepare << "select * from soci_test");
+        rowset<row> rs2(std::move(rs1));
+        CHECK(rs2.begin() == rs2.end());
+
+        rowset<row> rs3 = (sql.prepare << "select * from soci_test");
+        rs3 = std::move(rs2);
+        CHECK(rs3.begin() == rs3.end());
+    }
+#endif // SOCI_HAVE_MOVE_SEMANTICS
 }
 
 // test for simple iterating using rowset iterator (without reading data)
@@ -2803,6 +3151,118 @@ TEST_CASE_METHOD(common_tests, "Reading ints from rowset", "[core][rowset]")
 
 }
 
+// test for reading rowsets fetched in batches
+TEST_CASE_METHOD(common_tests, "Rowset bulk fetching", "[core][rowset][bulk]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+
+    CHECK(sql.get_rowset_batch_size() == 1);
+    CHECK_THROWS_AS(sql.set_rowset_batch_size(0), soci_error&);
+
+    // use a batch size not dividing the number of rows
+    sql.set_rowset_batch_size(3);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+    for (int i = 1; i <= 7; ++i)
+    {
+        if (i == 5)
+        {
+            sql << "insert into soci_test(id) values(:id)", use(i);
+        }
+        else
+        {
+            std::string const str(static_cast<std::size_t>(i), 'x');
+            sql << "insert into soci_test(id, str) values(:id, :str)",
+                use(i), use(str);
+        }
+    }
+
+    SECTION("basic type")
+    {
+        rowset<int> rs = (sql.prepare << "select id from soci_test order by id");
+
+        int expected = 1;
+        for (rowset<int>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            CHECK(*it == expected);
+            ++expected;
+        }
+        CHECK(expected == 8);
+    }
+
+    SECTION("row")
+    {
+        rowset<row> rs = (sql.prepare << "select id, str from soci_test order by id");
+
+        int expected = 1;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            row const& r = *it;
+            REQUIRE(r.size() == 2);
+            CHECK(r.get<int>(0) == expected);
+
+            if (expected == 5)
+            {
+                CHECK(r.get_indicator(1) == i_null);
+            }
+            else
+            {
+                CHECK(r.get_indicator(1) == i_ok);
+                CHECK(r.get<std::string>(1).size() ==
+                    static_cast<std::size_t>(expected));
+            }
+
+            int id = 0;
+            r >> id;
+            CHECK(id == expected);
+
+            ++expected;
+        }
+        CHECK(expected == 8);
+    }
+
+    SECTION("struct mapping")
+    {
+        rowset<MappedRecord> rs = (sql.prepare <<
+            "select id, id, id, str from soci_test where id != 5 order by id");
+
+        int expected = 1;
+        for (rowset<MappedRecord>::const_iterator it = rs.begin();
+             it != rs.end();
+             ++it)
+        {
+            CHECK(it->id == expected);
+            ++expected;
+            if (expected == 5)
+            {
+                ++expected;
+            }
+        }
+        CHECK(expected == 8);
+    }
+
+    SECTION("begin() continues iteration")
+    {
+        rowset<int> rs = (sql.prepare << "select id from soci_test order by id");
+
+        CHECK(*rs.begin() == 1);
+        CHECK(*rs.begin() == 2);
+
+        rowset<int>::const_iterator it = rs.begin();
+        CHECK(*it == 3);
+        CHECK(*++it == 4);
+        CHECK(std::distance(it, rs.end()) == 4);
+    }
+
+    SECTION("batches disabled")
+    {
+        sql.set_rowset_batch_size(1);
+
+        rowset<row> rs = (sql.prepare << "select id from soci_test");
+        CHECK(std::distance(rs.begin(), rs.end()) == 7);
+    }
+}
+
 // test for handling 'use' and reading rowset<std::string> using iterator
 TEST_CASE_METHOD(common_tests, "Reading strings from rowset", "[core][rowset]")
 {
@@ -4460,6 +4920,934 @@ TEST_CASE_METHOD(common_tests, "Logger", "[core][log]")
     sql.set_logger(logger_orig);
 }
 
+// Logger class used for testing the statement events: records all of them.
+// The statement_event object is only valid during the call, so copies of its
+// fields are kept.
+struct recorded_statement_event
+{
+    bool start;
+    statement_operation operation;
+    std::string query;
+    std::string backend_name;
+    bool bulk;
+    long long duration_ns;
+    long long rows;
+    std::size_t bytes;
+    bool failed;
+};
+
+class statement_events_log_impl : public soci::logger_impl
+{
+public:
+    explicit statement_events_log_impl(std::vector<recorded_statement_event>& events)
+        : m_events(events)
+    {
+    }
+
+    virtual void start_query(std::string const &) {}
+
+    virtual int get_statement_events() const
+    {
+        return statement_events_timing | statement_events_bytes;
+    }
+
+    virtual void start_operation(statement_event const & event)
+    {
+        record(true, event);
+    }
+
+    virtual void end_operation(statement_event const & event)
+    {
+        record(false, event);
+    }
+
+private:
+    void record(bool start, statement_event const & event)
+    {
+        recorded_statement_event e;
+        e.start = start;
+        e.operation = event.operation;
+        e.query = event.query;
+        e.backend_name = event.backend_name;
+        e.bulk = event.bulk;
+        e.duration_ns = event.duration_ns;
+        e.rows = event.rows;
+        e.bytes = event.bytes;
+        e.failed = event.failed;
+        m_events.push_back(e);
+    }
+
+    virtual logger_impl* do_clone() const
+    {
+        return new statement_events_log_impl(m_events);
+    }
+
+    std::vector<recorded_statement_event>& m_events;
+};
+
+TEST_CASE_METHOD(common_tests, "Logger statement events", "[core][log]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    soci::logger const logger_orig = sql.get_logger();
+
+    std::vector<recorded_statement_event> events;
+    sql.set_logger(new statement_events_log_impl(events));
+
+    std::vector<int> ids;
+    ids.push_back(1);
+    ids.push_back(2);
+    ids.push_back(3);
+    sql << "insert into soci_test(id) values(:id)", use(ids);
+
+    // One-time statements are prepared and executed.
+    REQUIRE( events.size() == 4 );
+    CHECK( events[0].start );
+    CHECK( events[0].operation == so_prepare );
+    CHECK( events[0].query == "insert into soci_test(id) values(:id)" );
+    CHECK( events[0].backend_name == sql.get_backend_name() );
+    CHECK( !events[1].start );
+    CHECK( events[1].operation == so_prepare );
+    CHECK( !events[1].failed );
+    CHECK( events[1].duration_ns >= 0 );
+    CHECK( events[2].start );
+    CHECK( events[2].operation == so_execute );
+    CHECK( !events[3].start );
+    CHECK( events[3].operation == so_execute );
+    CHECK( events[3].bulk );
+    CHECK( events[3].rows == 3 );
+    CHECK( events[3].bytes == 3*sizeof(int) );
+    CHECK( !events[3].failed );
+
+    events.clear();
+
+    std::vector<int> fetched(2);
+    statement st = (sql.prepare << "select id from soci_test order by id",
+        into(fetched));
+    st.execute();
+
+    int total = 0;
+    while (st.fetch())
+    {
+        total += static_cast<int>(fetched.size());
+    }
+    CHECK( total == 3 );
+
+    // prepare, execute without data exchange, then 2 fetches of 2 and 1 rows
+    // and the final one without any data.
+    REQUIRE( events.size() == 10 );
+    CHECK( events[3].operation == so_execute );
+    CHECK( events[3].rows == 0 );
+    CHECK( events[5].operation == so_fetch );
+    CHECK( events[5].bulk );
+    CHECK( events[5].rows == 2 );
+    CHECK( events[5].bytes == 2*sizeof(int) );
+    CHECK( events[7].rows == 1 );
+    CHECK( events[9].rows == 0 );
+
+    events.clear();
+
+    int count = 0;
+    sql << "select count(*) from soci_test where id = :id", use(ids[0]), into(count);
+    CHECK( count == 1 );
+    REQUIRE( events.size() == 4 );
+    CHECK( !events[3].bulk );
+    CHECK( events[3].rows == 1 );
+    CHECK( events[3].bytes == 2*sizeof(int) );
+
+    events.clear();
+
+    CHECK_THROWS_AS( (sql << "select * from soci_no_such_table"), soci_error& );
+
+    // Depending on the backend, either preparing or executing the statement
+    // fails, but there must be a failed end event in any case.
+    REQUIRE( events.size() >= 2 );
+    CHECK( !events.back().start );
+    CHECK( events.back().failed );
+
+    sql.set_logger(logger_orig);
+}
+
+TEST_CASE_METHOD(common_tests, "Metrics registry", "[core][metrics]")
+{
+    CHECK( metrics_registry::normalize_query(
+            "select *  from t\n where id = 17 and name = 'O''Brien'") ==
+           "select * from t where id = ? and name = ?" );
+    CHECK( metrics_registry::normalize_query(
+            "insert into t2(c1) values(:v1, $2, -1.5e3)") ==
+           "insert into t2(c1) values(:v1, $2, -?)" );
+
+    CHECK( latency_histogram::get_bucket_index(5) == 5 );
+    for (long long ns = 1; ns < 1000000000LL; ns = ns * 3 + 1)
+    {
+        std::size_t const i = latency_histogram::get_bucket_index(ns);
+        CHECK( latency_histogram::get_bucket_upper_bound(i) >= ns );
+        if (i > 0)
+        {
+            CHECK( latency_histogram::get_bucket_upper_bound(i - 1) < ns );
+        }
+    }
+
+    metrics_registry pool_metrics;
+    metrics_registry metrics(&pool_metrics);
+
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql.set_metrics(&metrics);
+    CHECK( sql.get_metrics() == &metrics );
+
+    std::vector<int> ids;
+    ids.push_back(1);
+    ids.push_back(2);
+    ids.push_back(3);
+    sql << "insert into soci_test(id) values(:id)", use(ids);
+
+    for (int i = 1; i <= 3; ++i)
+    {
+        int id = 0;
+        sql << "select id from soci_test where id = " << i, into(id);
+        CHECK( id == i );
+    }
+
+    CHECK_THROWS_AS( (sql << "select * from soci_no_such_table"), soci_error& );
+
+    sql.set_metrics(NULL);
+    sql << "delete from soci_test";
+
+    metrics_snapshot const snapshot = metrics.get_snapshot();
+    CHECK( snapshot.counters.statements_prepared == 5 );
+    CHECK( snapshot.counters.executions >= 4 );
+    CHECK( snapshot.counters.rows_sent == 3 );
+    CHECK( snapshot.counters.rows_fetched == 3 );
+    CHECK( snapshot.counters.errors == 1 );
+    CHECK( snapshot.execute_latency.get_count() ==
+           snapshot.counters.executions );
+    CHECK( snapshot.execute_latency.get_percentile_ns(50) <=
+           snapshot.execute_latency.get_max_ns() );
+
+    // The three selects differ only by the literal value and share an entry.
+    REQUIRE( snapshot.queries.size() == 3 );
+    CHECK( snapshot.queries[0].query == "insert into soci_test(id) values(:id)" );
+    CHECK( snapshot.queries[0].rows_sent == 3 );
+    CHECK( snapshot.queries[1].query == "select id from soci_test where id = ?" );
+    CHECK( snapshot.queries[1].executions == 3 );
+    CHECK( snapshot.queries[1].rows_fetched == 3 );
+    CHECK( snapshot.queries[1].execute_latency.get_count() == 3 );
+    CHECK( snapshot.queries[2].errors == 1 );
+
+    // Everything is also recorded in the parent registry.
+    metrics_snapshot const parent = pool_metrics.get_snapshot();
+    CHECK( parent.counters.executions == snapshot.counters.executions );
+    REQUIRE( parent.queries.size() == 3 );
+    CHECK( parent.queries[1].executions == 3 );
+
+    std::ostringstream oss;
+    snapshot.write_prometheus(oss, "app");
+    std::string const text = oss.str();
+    CHECK( text.find("# TYPE app_executions_total counter\n") != std::string::npos );
+    CHECK( text.find("app_errors_total 1\n") != std::string::npos );
+    CHECK( text.find("app_query_executions_total{query=\"select id from soci_test where id = ?\"} 3\n")
+            != std::string::npos );
+    CHECK( text.find("app_query_duration_seconds_bucket{query=\"select id from soci_test where id = ?\",le=\"+Inf\"} 3\n")
+            != std::string::npos );
+
+    metrics.reset();
+    CHECK( metrics.get_snapshot().counters.executions == 0 );
+    CHECK( metrics.get_snapshot().queries.size() == 3 );
+}
+
+TEST_CASE_METHOD(common_tests, "Pool metrics", "[core][pool][metrics]")
+{
+    metrics_registry metrics;
+    connection_pool pool(2);
+
+    {
+        soci::session sql(pool);
+
+        pool.set_metrics(&metrics);
+        CHECK( pool.get_metrics() == &metrics );
+
+        // The free session is updated immediately, the leased one only when
+        // it's given back.
+        CHECK( pool.at(1).get_metrics() == &metrics );
+        CHECK( pool.at(0).get_metrics() == NULL );
+    }
+
+    CHECK( pool.at(0).get_metrics() == &metrics );
+    CHECK( metrics.get_snapshot().counters.pool_leases == 0 );
+
+    soci::session sql(pool);
+    CHECK( sql.get_metrics() == &metrics );
+    CHECK( metrics.get_snapshot().counters.pool_leases == 1 );
+
+    pool.set_metrics(NULL);
+}
+
+TEST_CASE_METHOD(common_tests, "Asynchronous execution", "[core][async]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    std::vector<int> ids;
+    for (int i = 0; i != 10; ++i)
+    {
+        ids.push_back(i);
+    }
+
+    statement ins = (sql.prepare << "insert into soci_test(id) values(:id)",
+        use(ids));
+
+    execute_future insf = ins.execute_async(true);
+    CHECK( insf.valid() );
+    CHECK( !insf.get() );
+    CHECK( insf.ready() );
+
+    int sum = 0;
+    statement sel = (sql.prepare << "select sum(id) from soci_test", into(sum));
+    execute_future self = sel.execute_async(true);
+
+    // Copies refer to the same execution.
+    execute_future copy(self);
+    CHECK( copy.wait_for(10000) );
+    CHECK( self.get() );
+    CHECK( sel.got_data() );
+    CHECK( sum == 45 );
+
+    // got_data() returns the result of the last execution, whether it was
+    // asynchronous or not.
+    statement none = (sql.prepare << "select id from soci_test where id < 0",
+        into(sum));
+    CHECK( none.execute_async(true).get() == false );
+    CHECK( !none.got_data() );
+    CHECK( none.execute(true) == false );
+    CHECK( !none.got_data() );
+
+    // Errors are reported by get().
+    std::vector<int> empty;
+    statement bad = (sql.prepare << "select id from soci_test", into(empty));
+    execute_future badf = bad.execute_async(true);
+    CHECK_THROWS_AS( badf.get(), soci_error& );
+
+    // The executor can also be shared by several sessions.
+    async_executor executor(2, 1);
+    sql.set_executor(&executor);
+
+    std::vector<int> fetched(4);
+    statement fet = (sql.prepare << "select id from soci_test order by id",
+        into(fetched));
+    CHECK( fet.execute_async(true).get() );
+    CHECK( fetched.size() == 4 );
+    CHECK( fetched[3] == 3 );
+
+    sql.set_executor(NULL);
+
+    CHECK( !execute_future().valid() );
+}
+
+// Collects the rows of all the partitions in the thread executing the query.
+struct partition_rows_collector : soci::partition_row_consumer
+{
+    partition_rows_collector(std::size_t partitions)
+        : counts_(partitions), sum_(0), stopAfter_(0)
+    {}
+
+    void consume(std::size_t partition, row const & r) SOCI_OVERRIDE
+    {
+        if (stopAfter_ != 0 && --stopAfter_ == 0)
+        {
+            throw std::runtime_error("consumer failure");
+        }
+
+        ++counts_.at(partition);
+        sum_ += r.get<int>(0);
+    }
+
+    std::vector<int> counts_;
+    int sum_;
+    int stopAfter_;
+};
+
+// Collects the values fetched for each partition in its worker thread.
+struct partition_batches_collector : soci::partition_batch_consumer
+{
+    partition_batches_collector(std::size_t partitions)
+        : ids_(partitions), maxBatch_(partitions)
+    {}
+
+    void consume(std::size_t partition, row & batch) SOCI_OVERRIDE
+    {
+        std::size_t const size = batch.get_bulk_size();
+        maxBatch_.at(partition) = (std::max)(maxBatch_[partition], size);
+        for (std::size_t i = 0; i != size; ++i)
+        {
+            batch.select_bulk_row(i);
+            ids_[partition].push_back(batch.get<int>(0));
+        }
+    }
+
+    std::vector<std::vector<int> > ids_;
+    std::vector<std::size_t> maxBatch_;
+};
+
+TEST_CASE_METHOD(common_tests, "Partitioned query", "[core][pool][partition]")
+{
+    // A single pooled session is enough to check that the partitions are
+    // executed and merged correctly, they just wait for it in turn.
+    connection_pool pool(1);
+    session & sql = pool.at(0);
+    sql.open(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    std::vector<int> ids;
+    for (int i = 0; i != 20; ++i)
+    {
+        ids.push_back(i);
+    }
+    sql << "insert into soci_test(id) values(:id)", use(ids);
+
+    partitioned_query pq(pool,
+        "select id from soci_test where id >= :begin and id < :end order by id",
+        3);
+    pq.add_partition(0, 5);
+    pq.add_partition(5, 12);
+    pq.add_partition(12, 100);
+    pq.set_batch_size(3);
+    CHECK( pq.get_partitions_count() == 3 );
+
+    SECTION("Merged rows")
+    {
+        partition_rows_collector collector(3);
+        pq.for_each_row(collector);
+
+        CHECK( collector.counts_[0] == 5 );
+        CHECK( collector.counts_[1] == 7 );
+        CHECK( collector.counts_[2] == 8 );
+        CHECK( collector.sum_ == 190 );
+    }
+
+    SECTION("Per-partition batches")
+    {
+        partition_batches_collector collector(3);
+        pq.for_each_batch(collector);
+
+        REQUIRE( collector.ids_[1].size() == 7 );
+        CHECK( collector.ids_[1].front() == 5 );
+        CHECK( collector.ids_[1].back() == 11 );
+        CHECK( collector.ids_[2].size() == 8 );
+        CHECK( collector.maxBatch_[0] == 3 );
+    }
+
+    SECTION("Consumer errors")
+    {
+        partition_rows_collector collector(3);
+        collector.stopAfter_ = 4;
+        CHECK_THROWS_AS( pq.for_each_row(collector), std::runtime_error& );
+    }
+
+    SECTION("Query errors")
+    {
+        partitioned_query bad(pool,
+            "select id from soci_test_nonexistent where id >= :b and id < :e", 2);
+        bad.add_partition(0, 5);
+        bad.add_partition(5, 10);
+
+        partition_rows_collector collector(2);
+        CHECK_THROWS_AS( bad.for_each_row(collector), soci_error& );
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Statement object cache", "[core][cache]")
+{
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    // The freed blocks are reused for the objects of the same size.
+    details::object_cache & cache = sql.get_object_cache();
+    void * const p1 = cache.allocate(100);
+    details::object_cache::deallocate(p1);
+    void * const p2 = cache.allocate(120);
+    CHECK( p2 == p1 );
+    details::object_cache::deallocate(p2);
+
+    // Blocks too big to be cached are still freed correctly.
+    details::object_cache::deallocate(cache.allocate(100000));
+    details::object_cache::deallocate(
+        details::object_cache::allocate_uncached(10));
+
+    // Statements allocated from the cache still work as usual.
+    for (int i = 0; i != 3; ++i)
+    {
+        sql << "insert into soci_test(id) values(" << i << ")";
+    }
+
+    int count = 0;
+    statement st = (sql.prepare << "select count(*) from soci_test",
+        into(count));
+
+#ifdef SOCI_HAVE_MOVE_SEMANTICS
+    statement moved(std::move(st));
+    moved.execute(true);
+
+    st = std::move(moved);
+#endif // SOCI_HAVE_MOVE_SEMANTICS
+
+    st.execute(true);
+    CHECK( count == 3 );
+
+    // The cache stays alive until the last block allocated from it is freed.
+    void * leftover;
+    {
+        soci::session sql2(backEndFactory_, connectString_);
+        leftover = sql2.get_object_cache().allocate(10);
+    }
+    details::object_cache::deallocate(leftover);
+}
+
+TEST_CASE_METHOD(common_tests, "Result cache", "[core][cache][result]")
+{
+    // The cache must outlive the session, which uses it until the end.
+    result_cache cache;
+    metrics_registry metrics;
+
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql << "insert into soci_test(id, str) values(1, 'one')";
+    sql << "insert into soci_test(id, str) values(2, 'two')";
+
+    sql.set_result_cache(&cache);
+    sql.set_metrics(&metrics);
+
+    SECTION("Hits and invalidation")
+    {
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 2 );
+
+        // The queries differing only by whitespace share the results.
+        count = 0;
+        sql << "select  count(*)\n   from soci_test", into(count);
+        CHECK( count == 2 );
+
+        result_cache_stats stats = cache.get_stats();
+        CHECK( stats.hits == 1 );
+        CHECK( stats.misses == 1 );
+        CHECK( stats.entries == 1 );
+        CHECK( stats.get_hit_rate() == 0.5 );
+
+        metrics_snapshot const snapshot = metrics.get_snapshot();
+        CHECK( snapshot.counters.cache_hits == 1 );
+        CHECK( snapshot.counters.cache_misses == 1 );
+
+        // The modifications done without using the cache are not noticed...
+        sql.set_result_cache(NULL);
+        sql << "insert into soci_test(id, str) values(3, 'three')";
+        sql.set_result_cache(&cache);
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 2 );
+
+        // ...but those done using it are.
+        sql << "delete from soci_test where id = 1";
+        CHECK( cache.get_stats().invalidations == 1 );
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 2 );
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 2 );
+        CHECK( cache.get_stats().hits == 3 );
+
+        cache.invalidate_table("SOCI_TEST");
+        CHECK( cache.get_stats().entries == 0 );
+    }
+
+    SECTION("Parameters and indicators")
+    {
+        int id = 1;
+        std::string str;
+        indicator ind = i_null;
+        sql << "select str from soci_test where id = :id",
+            use(id), into(str, ind);
+        CHECK( ind == i_ok );
+        CHECK( str == "one" );
+
+        id = 2;
+        sql << "select str from soci_test where id = :id",
+            use(id), into(str, ind);
+        CHECK( str == "two" );
+
+        id = 1;
+        sql << "select str from soci_test where id = :id",
+            use(id), into(str, ind);
+        CHECK( str == "one" );
+        CHECK( cache.get_stats().hits == 1 );
+
+        // The absence of the results is cached too.
+        id = 5;
+        sql << "select str from soci_test where id = :id",
+            use(id), into(str, ind);
+        CHECK( sql.got_data() == false );
+
+        sql << "select str from soci_test where id = :id",
+            use(id), into(str, ind);
+        CHECK( sql.got_data() == false );
+        CHECK( cache.get_stats().hits == 2 );
+
+        // Null values are preserved.
+        sql << "update soci_test set str = null where id = 2";
+        id = 2;
+        for (int i = 0; i != 2; ++i)
+        {
+            ind = i_ok;
+            sql << "select str from soci_test where id = :id",
+                use(id), into(str, ind);
+            CHECK( sql.got_data() );
+            CHECK( ind == i_null );
+        }
+        CHECK( cache.get_stats().hits == 3 );
+    }
+
+    SECTION("Vectors")
+    {
+        for (int i = 0; i != 2; ++i)
+        {
+            std::vector<int> ids(10);
+            std::vector<std::string> strs(10);
+            sql << "select id, str from soci_test order by id",
+                into(ids), into(strs);
+            REQUIRE( ids.size() == 2 );
+            REQUIRE( strs.size() == 2 );
+            CHECK( ids[1] == 2 );
+            CHECK( strs[1] == "two" );
+        }
+        CHECK( cache.get_stats().hits == 1 );
+
+        // The size of the vectors is part of the key.
+        std::vector<int> ids(5);
+        sql << "select id from soci_test order by id", into(ids);
+        CHECK( ids.size() == 2 );
+        CHECK( cache.get_stats().hits == 1 );
+    }
+
+    SECTION("Transactions")
+    {
+        transaction tr(sql);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 2 );
+
+        tr.commit();
+
+        result_cache_stats const stats = cache.get_stats();
+        CHECK( stats.hits == 0 );
+        CHECK( stats.misses == 0 );
+        CHECK( stats.entries == 0 );
+    }
+
+    SECTION("Limits")
+    {
+        result_cache shortLived(1024 * 1024, 1);
+        sql.set_result_cache(&shortLived);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+
+        long long const start = details::get_monotonic_time_ns();
+        while (details::get_monotonic_time_ns() - start < 2000000)
+            ;
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( shortLived.get_stats().hits == 0 );
+        CHECK( shortLived.get_stats().expirations == 1 );
+
+        result_cache small(400);
+        sql.set_result_cache(&small);
+        for (int i = 0; i != 10; ++i)
+        {
+            sql << "select count(*) from soci_test where id > :i",
+                use(i), into(count);
+        }
+
+        result_cache_stats const stats = small.get_stats();
+        CHECK( stats.evictions != 0 );
+        CHECK( stats.bytes <= 400 );
+
+        sql.set_result_cache(&cache);
+    }
+
+    SECTION("Query analysis")
+    {
+        CHECK( result_cache::normalize_query("select  *\n from t where s = 'a  b' ")
+                == "select * from t where s = 'a  b'" );
+
+        std::vector<std::string> tables;
+        CHECK( result_cache::analyze_query(
+                "select a from Foo f join s.\"Bar\" b on f.id = b.id", tables)
+                == result_cache::query_read );
+        REQUIRE( tables.size() == 2 );
+        CHECK( std::find(tables.begin(), tables.end(), "foo") != tables.end() );
+        CHECK( std::find(tables.begin(), tables.end(), "bar") != tables.end() );
+
+        CHECK( result_cache::analyze_query(
+                "select * from t for update", tables)
+                == result_cache::query_read );
+
+        CHECK( result_cache::analyze_query(
+                "update foo set x = 1 where y in (select y from bar)", tables)
+                == result_cache::query_write );
+        CHECK( tables.size() == 2 );
+
+        CHECK( result_cache::analyze_query("call proc()", tables)
+                == result_cache::query_unknown );
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Write batching", "[core][transaction][batch]")
+{
+    // The number of executions shows how many statements were really sent
+    // to the database.
+    metrics_registry metrics;
+
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql.set_metrics(&metrics);
+
+    sql.set_write_batch_size(3);
+    CHECK( sql.get_write_batch_size() == 3 );
+
+    int id = 0;
+    int count = 0;
+
+    SECTION("Outside of transaction")
+    {
+        sql << "insert into soci_test(id) values(:id)", use(id);
+        CHECK( metrics.get_snapshot().counters.executions == 1 );
+    }
+
+    SECTION("Size threshold and commit")
+    {
+        transaction tr(sql);
+
+        std::string str;
+        indicator ind = i_ok;
+        statement st = (sql.prepare <<
+            "insert into soci_test(id, str) values(:id, :str)",
+            use(id), use(str, ind));
+        for (int i = 0; i != 5; ++i)
+        {
+            id = i;
+            str = "str";
+            ind = i == 2 ? i_null : i_ok;
+            st.execute(true);
+        }
+
+        CHECK( metrics.get_snapshot().counters.executions == 1 );
+
+        // Different statement flushes the previously queued ones.
+        id = 4;
+        sql << "update soci_test set d = 1.5 where id = :id", use(id);
+        CHECK( metrics.get_snapshot().counters.executions == 2 );
+
+        tr.commit();
+        CHECK( metrics.get_snapshot().counters.executions == 3 );
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 5 );
+        sql << "select count(*) from soci_test where str is null", into(count);
+        CHECK( count == 1 );
+        sql << "select count(*) from soci_test where d = 1.5", into(count);
+        CHECK( count == 1 );
+    }
+
+    SECTION("Other statements")
+    {
+        transaction tr(sql);
+
+        id = 1;
+        sql << "insert into soci_test(id) values(:id)", use(id);
+        CHECK( metrics.get_snapshot().counters.executions == 0 );
+
+        // The queued statements are executed before this one.
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 1 );
+
+        tr.commit();
+    }
+
+    SECTION("Asynchronous select")
+    {
+        transaction tr(sql);
+
+        id = 1;
+        sql << "insert into soci_test(id) values(:id)", use(id);
+        CHECK( metrics.get_snapshot().counters.executions == 0 );
+
+        // The queued statements are executed before this one too.
+        statement st = (sql.prepare << "select count(*) from soci_test",
+            into(count));
+        execute_future f = st.execute_async(true);
+        CHECK( f.get() );
+        CHECK( count == 1 );
+
+        tr.commit();
+    }
+
+    SECTION("Asynchronous write")
+    {
+        transaction tr(sql);
+
+        id = 1;
+        sql << "insert into soci_test(id) values(:id)", use(id);
+
+        // A different statement executed asynchronously is queued after the
+        // previously queued ones, which are executed first, so that it
+        // updates the inserted row.
+        statement st = (sql.prepare <<
+            "update soci_test set d = 2.5 where id = :id", use(id));
+        execute_future f = st.execute_async(true);
+        CHECK( f.get() == false );
+        CHECK( metrics.get_snapshot().counters.executions == 1 );
+
+        id = 2;
+        statement ins = (sql.prepare <<
+            "insert into soci_test(id) values(:id)", use(id));
+        execute_future f2 = ins.execute_async(true);
+        CHECK( f2.get() == false );
+        CHECK( metrics.get_snapshot().counters.executions == 2 );
+
+        tr.commit();
+
+        sql << "select count(*) from soci_test where d = 2.5", into(count);
+        CHECK( count == 1 );
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 2 );
+    }
+
+    SECTION("Rollback")
+    {
+        {
+            transaction tr(sql);
+
+            id = 1;
+            sql << "insert into soci_test(id) values(:id)", use(id);
+            tr.rollback();
+        }
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK( count == 0 );
+        CHECK( metrics.get_snapshot().counters.executions == 1 );
+    }
+
+    SECTION("Delay")
+    {
+        sql.set_write_batch_size(100);
+        sql.set_write_batch_delay(1);
+
+        transaction tr(sql);
+
+        id = 1;
+        sql << "insert into soci_test(id) values(:id)", use(id);
+
+        long long const start = details::get_monotonic_time_ns();
+        while (details::get_monotonic_time_ns() - start < 2000000)
+            ;
+
+        id = 2;
+        sql << "insert into soci_test(id) values(:id)", use(id);
+        CHECK( metrics.get_snapshot().counters.executions == 1 );
+
+        tr.commit();
+    }
+
+    SECTION("Errors")
+    {
+        transaction tr(sql);
+
+        sql << "insert into soci_test(id) values(:id)", use(id);
+
+        // The error is only detected when the statements are executed.
+        sql << "insert into soci_test_nonexistent(id) values(:id)", use(id);
+        sql << "insert into soci_test_nonexistent(id) values(:id)", use(id);
+
+        try
+        {
+            tr.commit();
+            FAIL("exception expected");
+        }
+        catch (soci_error const& e)
+        {
+            CHECK_THAT( e.what(), Catch::Contains("#2 to #3") );
+        }
+    }
+}
+
+TEST_CASE_METHOD(common_tests, "Query builder", "[core][query]")
+{
+    details::query_builder qb;
+    qb << "select " << 42 << ", " << -7LL << ", " << 123456789012ULL
+       << ", " << 1.5 << ", " << 'x' << ", " << true;
+    CHECK( qb.str() == "select 42, -7, 123456789012, 1.5, x, 1" );
+
+    // The buffer is reused for the next query.
+    qb.clear();
+    qb << (std::numeric_limits<long long>::min)();
+    CHECK( qb.str() == "-9223372036854775808" );
+
+    // The floating point numbers are output exactly by default.
+    qb.clear();
+    qb << 0.1 << ' ' << 1.0 / 3;
+    CHECK( qb.str() == "0.1 0.3333333333333333" );
+
+    // Floats are output with the precision of float, not double.
+    qb.clear();
+    qb << 0.1f << ' ' << 1.0f / 3;
+    CHECK( qb.str() == "0.1 0.33333334" );
+
+    // The manipulators apply to all the following values of the same query.
+    qb.clear();
+    qb << std::setprecision(3) << 3.14159 << ' ' << std::hex << 255
+       << ' ' << std::setw(4) << std::setfill('0') << 1 << ' ' << 2;
+    CHECK( qb.str() == "3.14 ff 0001 2" );
+
+    qb.clear();
+    qb << 255 << ' ' << 2.5;
+    CHECK( qb.str() == "255 2.5" );
+
+    // The text output to the deprecated stream is part of the query.
+    qb.clear();
+    qb << "select ";
+    qb.get_stream() << 17;
+    qb << " from dual";
+    CHECK( qb.str() == "select 17 from dual" );
+    qb.clear();
+    CHECK( qb.str().empty() );
+
+    // Copies of the shared query refer to the same text.
+    details::shared_query const q1("select 1");
+    details::shared_query q2;
+    CHECK( q2.str().empty() );
+    q2 = q1;
+    CHECK( &q2.str() == &q1.str() );
+
+    // The query built from the session is used by the statements as usual.
+    soci::session sql(backEndFactory_, connectString_);
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql << "insert into soci_test(id, d) values(" << 17 << ", " << 2.25 << ")";
+    CHECK( sql.get_last_query() ==
+        "insert into soci_test(id, d) values(17, 2.25)" );
+
+    double d = 0;
+    sql << "select d from soci_test where id = " << 17, into(d);
+    CHECK( d == 2.25 );
+}
+
 } // namespace test_cases
 
 } // namespace tests
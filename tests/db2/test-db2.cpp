@@ -387,6 +387,63 @@ TEST_CASE("DB2 test 3", "[db2]")
     sql.commit();
 }
 
+// Bulk insert of strings of very different lengths, which are not padded to
+// the longest one, re-executed with modified vector contents.
+TEST_CASE("DB2 bulk strings", "[db2][bulk]")
+{
+    soci::session sql(backEnd, connectString);
+
+    sql << "CREATE TABLE DB2INST1.SOCI_TEST (ID INTEGER,DATA VARCHAR(32000))";
+
+    std::vector<int> ids(1000);
+    std::vector<std::string> data(1000);
+    std::vector<indicator> inds(1000, i_ok);
+    for (int i = 0; i < 1000; i++)
+    {
+        ids[i] = i;
+        data[i] = "short";
+    }
+    data[1] = std::string(32000, 'x');
+    inds[2] = i_null;
+
+    statement st = (sql.prepare <<
+        "insert into db2inst1.SOCI_TEST (id, data) values (:id, :data)",
+        use(ids, "id"), use(data, inds, "data"));
+    st.execute(true);
+
+    // the same statement must use the new values
+    for (int i = 0; i < 1000; i++)
+    {
+        ids[i] = 1000 + i;
+    }
+    data.resize(2);
+    ids.resize(2);
+    inds.resize(2);
+    data[0] = "new";
+    st.execute(true);
+
+    int count = 0;
+    sql << "SELECT COUNT(*) FROM DB2INST1.SOCI_TEST", into(count);
+    CHECK(count == 1002);
+
+    int len = 0;
+    sql << "SELECT LENGTH(DATA) FROM DB2INST1.SOCI_TEST WHERE ID = 1", into(len);
+    CHECK(len == 32000);
+
+    std::string s;
+    sql << "SELECT DATA FROM DB2INST1.SOCI_TEST WHERE ID = 999", into(s);
+    CHECK(s == "short");
+    sql << "SELECT DATA FROM DB2INST1.SOCI_TEST WHERE ID = 1000", into(s);
+    CHECK(s == "new");
+
+    indicator ind;
+    sql << "SELECT DATA FROM DB2INST1.SOCI_TEST WHERE ID = 2", into(s, ind);
+    CHECK(ind == i_null);
+
+    sql<<"DROP TABLE DB2INST1.SOCI_TEST";
+    sql.commit();
+}
+
 
 int main(int argc, char** argv)
 {
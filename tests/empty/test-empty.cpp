@@ -7,6 +7,7 @@
 
 #include "soci/soci.h"
 #include "soci/empty/soci-empty.h"
+#include "soci-text-codec.h"
 
 // Normally the tests would include common-tests.h here, but we can't run any
 // of the tests registered there, so instead include CATCH header directly.
@@ -17,6 +18,7 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <limits>
 
 using namespace soci;
 
@@ -141,6 +143,120 @@ TEST_CASE("Dummy test", "[empty]")
     }
 }
 
+// The text conversions are core code which doesn't depend on the backend.
+TEST_CASE("Text codec", "[core][codec]")
+{
+    long long ll = 0;
+    CHECK( details::parse_integer(" -123", ll) );
+    CHECK( ll == -123 );
+    CHECK( details::parse_integer("-9223372036854775808", ll) );
+    CHECK( ll == (std::numeric_limits<long long>::min)() );
+    CHECK( !details::parse_integer("9223372036854775808", ll) );
+    CHECK( !details::parse_integer("12a", ll) );
+    CHECK( !details::parse_integer("", ll) );
+
+    unsigned long long ull = 0;
+    CHECK( details::parse_integer("18446744073709551615", ull) );
+    CHECK( ull == (std::numeric_limits<unsigned long long>::max)() );
+    CHECK( !details::parse_integer("-1", ull) );
+    CHECK( details::parse_unsigned_integer("-1", ull) );
+    CHECK( ull == (std::numeric_limits<unsigned long long>::max)() );
+
+    unsigned int ui = 0;
+    CHECK( !details::parse_unsigned_integer("-1", ui) );
+
+    short sh = 0;
+    CHECK( details::parse_integer("-32768", sh) );
+    CHECK( sh == -32768 );
+    CHECK( !details::parse_integer("32768", sh) );
+
+    char buf[details::std_tm_text_buffer_size];
+    CHECK( details::format_integer(-42, buf) == 3 );
+    CHECK( std::string(buf) == "-42" );
+    details::format_integer((std::numeric_limits<long long>::min)(), buf);
+    CHECK( std::string(buf) == "-9223372036854775808" );
+
+    double d = 0;
+    CHECK( details::parse_double("1.5", d) );
+    CHECK( d == 1.5 );
+    CHECK( details::parse_double("-2.5e-3", d) );
+    CHECK( d == -2.5e-3 );
+    CHECK( details::parse_double("0.1", d) );
+    CHECK( d == 0.1 );
+    CHECK( details::parse_double("1.7976931348623157e308", d) );
+    CHECK( d == (std::numeric_limits<double>::max)() );
+    CHECK( details::parse_double("inf", d) );
+    CHECK( d == std::numeric_limits<double>::infinity() );
+    CHECK( !details::parse_double("1,5", d) );
+    CHECK( !details::parse_double("1.5x", d) );
+    CHECK( !details::parse_double("", d) );
+
+    details::format_double(0.1, buf);
+    CHECK( std::string(buf) == "0.1" );
+    details::format_double(-1234.5, buf);
+    CHECK( std::string(buf) == "-1234.5" );
+    details::format_double(1e-7, buf);
+    CHECK( std::string(buf) == "1e-07" );
+    details::format_double(1.0 / 3, buf);
+    CHECK( std::string(buf) == "0.3333333333333333" );
+
+    // All values must survive the round trip.
+    double const values[] = { 1.0 / 3, 2.0 / 3 * 1e300, 5e-324, 123456789.125,
+        (std::numeric_limits<double>::max)(), -0.30000000000000004 };
+    for (std::size_t i = 0; i != sizeof(values) / sizeof(values[0]); ++i)
+    {
+        details::format_double(values[i], buf);
+        CHECK( details::parse_double(buf, d) );
+        CHECK( d == values[i] );
+    }
+
+    // Floats use only as many digits as needed for the float value.
+    details::format_float(0.1f, buf);
+    CHECK( std::string(buf) == "0.1" );
+    details::format_float(1.0f / 3, buf);
+    CHECK( std::string(buf) == "0.33333334" );
+    details::format_float(-16777216.0f, buf);
+    CHECK( std::string(buf) == "-16777216" );
+    details::format_float(0.0f, buf);
+    CHECK( std::string(buf) == "0" );
+
+    float const float_values[] = { 1.0f / 3, 2.0f / 3 * 1e30f, 1e-45f, 0.3f,
+        (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::min)() };
+    for (std::size_t i = 0; i != sizeof(float_values) / sizeof(float_values[0]); ++i)
+    {
+        details::format_float(float_values[i], buf);
+        CHECK( details::parse_double(buf, d) );
+        CHECK( static_cast<float>(d) == float_values[i] );
+    }
+
+    // Out of range values are normalized, as with mktime().
+    std::tm t;
+    details::make_std_tm(t, 2019, 12, 31, 23, 59, 60);
+    CHECK( t.tm_year == 120 );
+    CHECK( t.tm_mon == 0 );
+    CHECK( t.tm_mday == 1 );
+    CHECK( t.tm_hour == 0 );
+    CHECK( t.tm_min == 0 );
+    CHECK( t.tm_sec == 0 );
+    CHECK( t.tm_wday == 3 );
+    CHECK( t.tm_yday == 0 );
+
+    details::parse_std_tm("2024-02-29T13:14:15.678+01:00", t);
+    CHECK( t.tm_year == 124 );
+    CHECK( t.tm_mon == 1 );
+    CHECK( t.tm_mday == 29 );
+    CHECK( t.tm_hour == 13 );
+    CHECK( t.tm_min == 14 );
+    CHECK( t.tm_sec == 15 );
+    CHECK( t.tm_wday == 4 );
+    CHECK( t.tm_yday == 59 );
+
+    CHECK( details::format_std_tm(t, buf) == 19 );
+    CHECK( std::string(buf) == "2024-02-29 13:14:15" );
+
+    CHECK_THROWS_AS(details::parse_std_tm("not a date", t), soci_error&);
+}
+
 
 int main(int argc, char** argv)
 {
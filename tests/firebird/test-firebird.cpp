@@ -500,6 +500,182 @@ TEST_CASE("Firebird bulk operations", "[firebird][bulk]")
     sql << "drop table test6";
 }
 
+// bulk operations executed in blocks of rows
+TEST_CASE("Firebird bulk blocks", "[firebird][bulk]")
+{
+    soci::session sql(backEnd, connectString);
+
+    try
+    {
+        sql << "drop table test6";
+    }
+    catch (soci_error const &)
+    {} // ignore if error
+
+    sql << "create table test6 (id integer, name varchar(20), amount numeric(10,2))";
+    sql.commit();
+
+    sql.begin();
+
+    // use more rows than fit into a single block, with a partial last one
+    int const rowsToTest = 257;
+
+    std::vector<int> ids(rowsToTest);
+    std::vector<std::string> names(rowsToTest);
+    std::vector<double> amounts(rowsToTest);
+    std::vector<indicator> inds(rowsToTest, i_ok);
+    for (int i = 0; i != rowsToTest; ++i)
+    {
+        std::ostringstream ss;
+        ss << "name '" << i;
+
+        ids[i] = i;
+        names[i] = ss.str();
+        amounts[i] = i + 0.25;
+
+        if (i % 10 == 0)
+        {
+            inds[i] = i_null;
+        }
+    }
+
+    {
+        statement st = (sql.prepare <<
+            "insert into test6(id, name, amount) values(?, ?, ?)",
+            use(ids), use(names), use(amounts, inds));
+        st.execute(true);
+        CHECK(st.get_affected_rows() == rowsToTest);
+
+        // executing the same statement again must reuse the blocks
+        st.execute(true);
+        CHECK(st.get_affected_rows() == rowsToTest);
+    }
+
+    int count;
+    sql << "select count(*) from test6", into(count);
+    CHECK(count == 2 * rowsToTest);
+
+    sql << "select count(*) from test6 where amount is null", into(count);
+    CHECK(count == 2 * ((rowsToTest + 9) / 10));
+
+    std::string name;
+    sql << "select first 1 name from test6 where id = 123", into(name);
+    CHECK(name == "name '123");
+
+    {
+        std::vector<int> del(3);
+        del[0] = 1;
+        del[1] = 2;
+        del[2] = rowsToTest + 1; // doesn't exist
+
+        statement st = (sql.prepare <<
+            "delete from test6 where id = :id", use(del, "id"));
+        st.execute(true);
+        CHECK(st.get_affected_rows() == 4);
+    }
+
+    sql << "drop table test6";
+}
+
+// Compare the speed of fetching rows one by one with fetching them in bulk,
+// this test is hidden and must be run explicitly, e.g. using "[.][firebird]".
+TEST_CASE("Firebird bulk fetch benchmark", "[firebird][bulk][.]")
+{
+    soci::session sql(backEnd, connectString);
+
+    try
+    {
+        sql << "drop table test6";
+    }
+    catch (soci_error const &)
+    {} // ignore if error
+
+    sql << "create table test6 (id integer, name varchar(20),"
+           " amount numeric(10,2), ts timestamp)";
+    sql.commit();
+
+    sql.begin();
+
+    int const rowsToTest = 100000;
+    int const batchSize = 1000;
+
+    {
+        std::vector<int> ids(batchSize);
+        std::vector<std::string> names(batchSize, "some name");
+        std::vector<double> amounts(batchSize, 12.5);
+        std::tm t = std::tm();
+        t.tm_year = 120;
+        t.tm_mday = 1;
+        std::vector<std::tm> ts(batchSize, t);
+
+        statement st = (sql.prepare <<
+            "insert into test6(id, name, amount, ts) values(?, ?, ?, ?)",
+            use(ids), use(names), use(amounts), use(ts));
+
+        for (int n = 0; n < rowsToTest; n += batchSize)
+        {
+            for (int i = 0; i < batchSize; ++i)
+            {
+                ids[i] = n + i;
+            }
+
+            st.execute(true);
+        }
+    }
+
+    std::clock_t start = std::clock();
+    int fetched = 0;
+    {
+        int id;
+        std::string name;
+        double amount;
+        std::tm ts;
+
+        statement st = (sql.prepare <<
+            "select id, name, amount, ts from test6",
+            into(id), into(name), into(amount), into(ts));
+        st.execute();
+        while (st.fetch())
+        {
+            ++fetched;
+        }
+    }
+    CHECK(fetched == rowsToTest);
+
+    double const singleTime = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+    start = std::clock();
+    fetched = 0;
+    {
+        std::vector<int> ids(batchSize);
+        std::vector<std::string> names(batchSize);
+        std::vector<double> amounts(batchSize);
+        std::vector<std::tm> ts(batchSize);
+
+        statement st = (sql.prepare <<
+            "select id, name, amount, ts from test6",
+            into(ids), into(names), into(amounts), into(ts));
+        st.execute();
+        while (st.fetch())
+        {
+            fetched += static_cast<int>(ids.size());
+            ids.resize(batchSize);
+            names.resize(batchSize);
+            amounts.resize(batchSize);
+            ts.resize(batchSize);
+        }
+    }
+    CHECK(fetched == rowsToTest);
+
+    double const bulkTime = double(std::clock() - start) / CLOCKS_PER_SEC;
+
+    std::cout << "Fetching " << rowsToTest << " rows took "
+              << singleTime << "s row by row and "
+              << bulkTime << "s in batches of " << batchSize << " rows\n";
+
+    sql << "drop table test6";
+}
+
 // blob test
 TEST_CASE("Firebird blobs", "[firebird][blob]")
 {
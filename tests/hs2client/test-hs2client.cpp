@@ -7,6 +7,7 @@
 
 #include "soci/soci.h"
 #include "soci/hs2client/soci-hs2client.h"
+#include "hs2client/common.h"
 
 // Normally the tests would include common-tests.h here, but we can't run any
 // of the tests registered there, so instead include CATCH header directly.
@@ -295,6 +296,126 @@ TEST_CASE("OperationTests-BulkInsert-ParametersByPosition", "Adding multiple rec
 	REQUIRE_FALSE(st.fetch());
 }
 
+TEST_CASE("OperationTests-BulkInsert-MultipleChunks", "Adding more records in bulk than fits into a single multi-row insert statement.")
+{
+	std::unique_ptr<soci::session> sql;
+	CHECK_NOTHROW(sql = soci::testing::hs2client::Utilities::OpenSession(connectString + ", bulkinsertsize=7, maxstatementlength=512"));
+
+	soci::testing::hs2client::Utilities::CreateDatabase(*sql);
+	soci::testing::hs2client::Utilities::CreateTable(*sql);
+
+	std::vector<int> expected_int_values;
+	std::vector<std::string> expected_string_values;
+
+	for (int i = 0; i < 100; i++)
+	{
+		expected_int_values.push_back(i);
+		expected_string_values.push_back("some'thing(" + std::to_string(i) + ")");
+	}
+
+	*sql << "insert into hs2client_test_table (int_col, string_col) values (:int_value, :string_value)", use(expected_int_values, "int_value"), use(expected_string_values, "string_value");
+
+	std::vector<int> fetched_int_values(100);
+	std::vector<std::string> fetched_string_values(100);
+
+	statement st = (sql->prepare << "select int_col, string_col from hs2client_test_table order by int_col", into(fetched_int_values), into(fetched_string_values));
+	st.execute();
+	st.fetch();
+
+	REQUIRE(fetched_int_values == expected_int_values);
+	REQUIRE(fetched_string_values == expected_string_values);
+	REQUIRE_FALSE(st.fetch());
+}
+
+TEST_CASE("OperationTests-WaitingOnMultipleOperations", "Waiting on multiple operations from a single thread.")
+{
+	std::unique_ptr<soci::session> sql;
+	CHECK_NOTHROW(sql = soci::testing::hs2client::Utilities::OpenSession(connectString + ", pollinterval=100, maxpollinterval=10000"));
+
+	soci::testing::hs2client::Utilities::CreateDatabase(*sql);
+	soci::testing::hs2client::Utilities::CreateTable(*sql);
+
+	hs2client_session_backend* backend = static_cast<hs2client_session_backend*>(sql->get_backend());
+	hs2client_operation_poller poller(backend->get_poll_policy(), &backend->get_operation_mutex());
+
+	std::vector<std::unique_ptr<hs2client::Operation>> operations(5);
+	int completed_count = 0;
+
+	for (size_t i = 0; i < operations.size(); i++)
+	{
+		std::stringstream str_statement;
+		str_statement << "insert into hs2client_test_table VALUES (" << i << ", 'something" << i << "')";
+
+		REQUIRE(backend->execute_statement(str_statement.str(), &operations[i]).ok());
+		poller.add(*operations[i], [&completed_count](hs2client::Operation::State state, uint64_t poll_count)
+		{
+			REQUIRE(state == hs2client::Operation::State::FINISHED);
+			REQUIRE(poll_count > 0);
+
+			completed_count++;
+		});
+	}
+
+	REQUIRE(poller.pending() == operations.size());
+	poller.wait_all();
+
+	REQUIRE(poller.pending() == 0);
+	REQUIRE(completed_count == static_cast<int>(operations.size()));
+
+	long long count = 0;
+	statement st = (sql->prepare << "select count(*) from hs2client_test_table", into(count));
+	st.execute(true);
+
+	REQUIRE(count == static_cast<long long>(operations.size()));
+	REQUIRE(static_cast<hs2client_statement_backend*>(st.get_backend())->get_state_poll_count() > 0);
+}
+
+TEST_CASE("OperationTests-FetchWithPrefetching", "Fetching records spanning multiple batches, while the following batches are fetched in the background.")
+{
+	std::unique_ptr<soci::session> sql;
+	CHECK_NOTHROW(sql = soci::testing::hs2client::Utilities::OpenSession(connectString + ", rowsfetchedperblock=7, prefetchdepth=2"));
+
+	soci::testing::hs2client::Utilities::CreateDatabase(*sql);
+	soci::testing::hs2client::Utilities::CreateTable(*sql);
+
+	std::vector<int> expected_int_values;
+	std::vector<std::string> expected_string_values;
+
+	for (int i = 0; i < 100; i++)
+	{
+		expected_int_values.push_back(i);
+		expected_string_values.push_back("something" + std::to_string(i));
+	}
+
+	soci::testing::hs2client::Utilities::InsertSampleData(*sql, expected_int_values, expected_string_values);
+
+	std::vector<int> fetched_int_values;
+	std::vector<std::string> fetched_string_values;
+
+	std::vector<int> int_values(5);
+	std::vector<std::string> string_values(5);
+
+	statement st = (sql->prepare << "select int_col, string_col from hs2client_test_table order by int_col", into(int_values), into(string_values));
+	st.execute();
+
+	while (st.fetch())
+	{
+		fetched_int_values.insert(fetched_int_values.end(), int_values.begin(), int_values.end());
+		fetched_string_values.insert(fetched_string_values.end(), string_values.begin(), string_values.end());
+
+		/* Using the session while the following batches are being fetched */
+		long long count = 0;
+		*sql << "select count(*) from (select 1) t", into(count);
+		REQUIRE(count == 1);
+
+		int_values.resize(5);
+		string_values.resize(5);
+	}
+
+	REQUIRE(fetched_int_values == expected_int_values);
+	REQUIRE(fetched_string_values == expected_string_values);
+}
+
 TEST_CASE("OperationTests-FetchSingularEntry", "Fetching a single record")
 {
 	std::unique_ptr<soci::session> sql;
@@ -513,6 +634,25 @@ TEST_CASE("OperationTests-EscapingSingleQuote", "Checking where the soci-hs2clie
 	REQUIRE(fetched_value7 == value7);
 }
 
+TEST_CASE("OperationTests-EmptyStrings", "Checking whether empty strings are rendered properly")
+{
+	std::unique_ptr<soci::session> sql;
+	CHECK_NOTHROW(sql = soci::testing::hs2client::Utilities::OpenSession(connectString));
+
+	soci::testing::hs2client::Utilities::CreateDatabase(*sql);
+	soci::testing::hs2client::Utilities::CreateTable(*sql);
+
+	std::string value = "";
+	*sql << "insert into hs2client_test_table VALUES (1, :string_value)", use(value);
+
+	std::string fetched_value = "something";
+	indicator ind = i_null;
+	*sql << "select string_col from hs2client_test_table where int_col=1", into(fetched_value, ind);
+
+	REQUIRE(ind == i_ok);
+	REQUIRE(fetched_value == value);
+}
+
 TEST_CASE("OperationTests-EscapingSingleQuoteInBulkInserting", "Checking where the soci-hs2client implementation handles single quotes")
 {
 	std::unique_ptr<soci::session> sql;
@@ -687,6 +827,85 @@ TEST_CASE("OperationTests-MultipleExchangesOnTheSameStatement", "Using the same
 }
 
 
+/* A synthetic column laid out the same way as the columns of a 'hs2client::ColumnarRowSet' (which can only be
+   created by the hs2client library itself), i.e. a vector of values and a bitmap of NULLs. */
+template <typename T>
+struct SyntheticColumn
+{
+	std::vector<T> data;
+	std::string nulls;
+
+	bool IsNull(size_t i) const { return (nulls[i / 8] & (1 << (i % 8))) != 0; }
+};
+
+template <typename T, typename Generator>
+SyntheticColumn<T> CreateSyntheticColumn(size_t row_count, Generator generator)
+{
+	SyntheticColumn<T> column;
+	column.data.reserve(row_count);
+	column.nulls.assign((row_count + 7) / 8, '\0');
+
+	for (size_t i = 0; i < row_count; i++)
+	{
+		column.data.push_back(generator(i));
+		if (i % 100 == 0) column.nulls[i / 8] |= static_cast<char>(1 << (i % 8));
+	}
+
+	return column;
+}
+
+TEST_CASE("ColumnDecodingTests-Benchmark", "[hs2client][bulk][.]")
+{
+	const size_t row_count = 1000000;
+	const size_t segment_size = 10000;
+
+	SyntheticColumn<int32_t> int_column = CreateSyntheticColumn<int32_t>(row_count, [](size_t i) { return static_cast<int32_t>(i); });
+	SyntheticColumn<std::string> string_column = CreateSyntheticColumn<std::string>(row_count, [](size_t i) { return "something" + std::to_string(i); });
+	SyntheticColumn<int64_t> time_column = CreateSyntheticColumn<int64_t>(row_count, [](size_t i) { return static_cast<int64_t>(1500000000 + i * 37); });
+
+	std::vector<int> int_values;
+	std::vector<std::string> string_values;
+	std::vector<std::tm> time_values;
+	std::vector<indicator> indicators(segment_size);
+
+	std::clock_t start = std::clock();
+	for (size_t offset = 0; offset < row_count; offset += segment_size)
+	{
+		soci::details::hs2client_columns::decode_fixed_width_column(int_column.data.data(), int_column.data.size(), [&int_column](size_t i) { return int_column.IsNull(i); },
+			offset, offset + segment_size, int_values, indicators.data());
+	}
+	double int_seconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+	start = std::clock();
+	for (size_t offset = 0; offset < row_count; offset += segment_size)
+	{
+		soci::details::hs2client_columns::decode_string_column(string_column.data.data(), string_column.data.size(), [&string_column](size_t i) { return string_column.IsNull(i); },
+			offset, offset + segment_size, string_values, indicators.data());
+	}
+	double string_seconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+	start = std::clock();
+	for (size_t offset = 0; offset < row_count; offset += segment_size)
+	{
+		soci::details::hs2client_columns::decode_time_column(time_column.data.data(), time_column.data.size(), [&time_column](size_t i) { return time_column.IsNull(i); },
+			offset, offset + segment_size, time_values, indicators.data());
+	}
+	double time_seconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+
+	REQUIRE(int_values.size() == segment_size);
+	REQUIRE(int_values[1] == static_cast<int>(row_count - segment_size + 1));
+	REQUIRE(string_values[1] == "something" + std::to_string(row_count - segment_size + 1));
+	REQUIRE(indicators[0] == i_null);
+	REQUIRE(indicators[1] == i_ok);
+
+	time_t expected_time = static_cast<time_t>(time_column.data[row_count - 1]);
+	std::tm expected_tm;
+	localtime_r(&expected_time, &expected_tm);
+	REQUIRE(std::mktime(&time_values[segment_size - 1]) == std::mktime(&expected_tm));
+
+	WARN("Decoded " << row_count << " rows (int: " << int_seconds << "s, string: " << string_seconds << "s, timestamp: " << time_seconds << "s)");
+}
+
 int main(int argc, char** argv)
 {
 
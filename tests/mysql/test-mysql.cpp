@@ -518,6 +518,155 @@ TEST_CASE("MySQL get affected rows", "[mysql][affected-rows]")
     CHECK(st2.get_affected_rows() == 5);
 }
 
+TEST_CASE("MySQL bulk batching", "[mysql][bulk]")
+{
+    // Check both the default batching mode and the row by row execution.
+    std::string const suffixes[] = { "", " bulk_batching=0" };
+    for (std::size_t n = 0; n != 2; ++n)
+    {
+        soci::session sql(backEnd, connectString + suffixes[n]);
+
+        integer_value_table_creator tableCreator(sql);
+
+        std::vector<int> v;
+        for (int i = 0; i != 1000; ++i)
+        {
+            v.push_back(i);
+        }
+
+        // This is executed as a few multi-row INSERT statements.
+        statement st1 = (sql.prepare <<
+            "insert into soci_test(val) values(:val)", use(v));
+        st1.execute(true);
+
+        CHECK(st1.get_affected_rows() == 1000);
+
+        int count = 0;
+        long long sum = 0;
+        sql << "select count(*), sum(val) from soci_test", into(count), into(sum);
+        CHECK(count == 1000);
+        CHECK(sum == 999 * 1000 / 2);
+
+        // And this one as several statements in the same query.
+        std::vector<int> odd;
+        for (int i = 1; i < 1000; i += 2)
+        {
+            odd.push_back(i);
+        }
+
+        statement st2 = (sql.prepare <<
+            "delete from soci_test where val = :val", use(odd));
+        st2.execute(true);
+
+        CHECK(st2.get_affected_rows() == 500);
+
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 500);
+    }
+}
+
+
+TEST_CASE("MySQL streamed results", "[mysql][stream]")
+{
+    soci::session sql(backEnd, connectString + " stream_results=1");
+
+    integer_value_table_creator tableCreator(sql);
+
+    std::vector<int> v;
+    std::vector<indicator> inds;
+    for (int i = 0; i != 100; ++i)
+    {
+        v.push_back(i);
+        inds.push_back(i % 10 == 3 ? i_null : i_ok);
+    }
+
+    sql << "insert into soci_test(val) values(:val)", use(v, inds);
+
+    SECTION("Single row")
+    {
+        int val = 0;
+        indicator ind = i_ok;
+        statement st = (sql.prepare <<
+            "select val from soci_test order by val", into(val, ind));
+        st.execute();
+
+        int count = 0;
+        int nulls = 0;
+        long long sum = 0;
+        while (st.fetch())
+        {
+            ++count;
+            if (ind == i_null)
+            {
+                ++nulls;
+            }
+            else
+            {
+                sum += val;
+            }
+        }
+
+        CHECK(count == 100);
+        CHECK(nulls == 10);
+        CHECK(sum == 99 * 100 / 2 - (3 + 93) * 10 / 2);
+    }
+
+    SECTION("Bulk fetch")
+    {
+        // use a batch size not dividing the number of rows
+        std::vector<int> out(7);
+        std::vector<indicator> outInds(7);
+        statement st = (sql.prepare <<
+            "select val from soci_test where val is not null order by val",
+            into(out, outInds));
+        st.execute();
+
+        std::vector<int> all;
+        while (st.fetch())
+        {
+            all.insert(all.end(), out.begin(), out.end());
+            out.resize(7);
+        }
+
+        REQUIRE(all.size() == 90);
+        CHECK(all[0] == 0);
+        CHECK(all[3] == 4);
+        CHECK(all[89] == 99);
+    }
+
+    SECTION("Rowset")
+    {
+        rowset<row> rs = (sql.prepare <<
+            "select val from soci_test where val < 5 order by val");
+
+        std::vector<int> values;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            values.push_back(it->get<int>(0));
+        }
+
+        // 3 is NULL and so is not selected
+        REQUIRE(values.size() == 4);
+        CHECK(values[0] == 0);
+        CHECK(values[2] == 2);
+        CHECK(values[3] == 4);
+    }
+
+    SECTION("Statement not fully fetched")
+    {
+        int val = 0;
+        statement st = (sql.prepare <<
+            "select val from soci_test where val is not null", into(val));
+        st.execute(true);
+
+        // the remaining rows are discarded when the statement is destroyed
+        st.clean_up();
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        CHECK(count == 100);
+    }
+}
 
 // The prepared statements should survive session::reconnect().
 // However currently it doesn't and attempting to use it results in crashes due
@@ -7,6 +7,7 @@
 
 #include <soci/soci.h>
 #include <soci/sqlite3/soci-sqlite3.h>
+#include <soci/soci-simple.h>
 #include "common-tests.h"
 #include <iostream>
 #include <sstream>
@@ -310,6 +311,139 @@ TEST_CASE("SQLite last insert id", "[sqlite][last-insert-id]")
     CHECK(id == 42);
 }
 
+TEST_CASE("SQLite asynchronous execution error", "[sqlite][async]")
+{
+    soci::session sql(backEnd, connectString);
+    table_creator_for_get_last_insert_id tableCreator(sql);
+
+    int id = 1;
+    statement st = (sql.prepare << "insert into soci_test(id) values(:id)",
+        use(id));
+    CHECK( !st.execute_async(true).get() );
+
+    // The backend-specific error is rethrown with its type preserved.
+    execute_future f = st.execute_async(true);
+    try
+    {
+        f.get();
+        FAIL("exception expected");
+    }
+    catch (sqlite3_soci_error const & e)
+    {
+        CHECK( e.result() == SQLITE_CONSTRAINT );
+    }
+}
+
+struct ignore_partition_rows : soci::partition_row_consumer
+{
+    void consume(std::size_t, row const &) SOCI_OVERRIDE {}
+};
+
+TEST_CASE("SQLite partitioned query error", "[sqlite][partition]")
+{
+    connection_pool pool(1);
+    pool.at(0).open(backEnd, connectString);
+
+    partitioned_query pq(pool,
+        "select id from soci_no_such_table where id >= :begin and id < :end",
+        1);
+    pq.add_partition(0, 10);
+
+    ignore_partition_rows consumer;
+    try
+    {
+        pq.for_each_row(consumer);
+        FAIL("exception expected");
+    }
+    catch (sqlite3_soci_error const & e)
+    {
+        CHECK( e.result() == SQLITE_ERROR );
+    }
+}
+
+TEST_CASE("SQLite simple interface column access", "[sqlite][simple]")
+{
+    // Make the statically linked backend available to the simple interface,
+    // which creates the session from a connection string.
+    register_factory_sqlite3();
+
+    session_handle sh =
+        soci_create_session(("sqlite3://db=" + connectString).c_str());
+    REQUIRE( soci_session_state(sh) == 1 );
+
+    statement_handle st = soci_create_statement(sh);
+    soci_prepare(st, "create table soci_test(id integer, name varchar(20))");
+    soci_execute(st, 1);
+    REQUIRE( soci_statement_state(st) == 1 );
+    soci_destroy_statement(st);
+
+    char const * const inserts[] =
+    {
+        "insert into soci_test(id, name) values(1, 'one')",
+        "insert into soci_test(id, name) values(2, null)",
+        "insert into soci_test(id, name) values(3, 'three')",
+        "insert into soci_test(id, name) values(null, 'four')",
+        "insert into soci_test(id, name) values(5, '')"
+    };
+    for (std::size_t i = 0; i != sizeof(inserts) / sizeof(inserts[0]); ++i)
+    {
+        st = soci_create_statement(sh);
+        soci_prepare(st, inserts[i]);
+        soci_execute(st, 1);
+        REQUIRE( soci_statement_state(st) == 1 );
+        soci_destroy_statement(st);
+    }
+
+    st = soci_create_statement(sh);
+    int const idPos = soci_into_int_v(st);
+    int const namePos = soci_into_string_v(st);
+    soci_into_resize_v(st, 4);
+    soci_prepare(st, "select id, name from soci_test order by rowid");
+    CHECK( soci_execute(st, 1) == 1 );
+
+    soci_column ids;
+    REQUIRE( soci_get_into_column_v(st, idPos, &ids) == 4 );
+    CHECK( ids.validity[0] == 0x07 );
+    int const * const idValues = static_cast<int const *>(ids.values);
+    CHECK( idValues[0] == 1 );
+    CHECK( idValues[2] == 3 );
+    CHECK( ids.offsets == NULL );
+
+    soci_column names;
+    REQUIRE( soci_get_into_column_v(st, namePos, &names) == 4 );
+    CHECK( names.validity[0] == 0x0d );
+    CHECK( names.values == NULL );
+    CHECK( std::string(names.data + names.offsets[0],
+                       names.data + names.offsets[1]) == "one" );
+    CHECK( names.offsets[2] == names.offsets[1] );
+    CHECK( std::string(names.data + names.offsets[3],
+                       names.data + names.offsets[4]) == "four" );
+
+    // The column is only copied once per fetch.
+    soci_column again;
+    REQUIRE( soci_get_into_column_v(st, namePos, &again) == 4 );
+    CHECK( again.data == names.data );
+    CHECK( again.offsets == names.offsets );
+
+    CHECK( soci_fetch(st) == 1 );
+    REQUIRE( soci_get_into_column_v(st, idPos, &ids) == 1 );
+    CHECK( static_cast<int const *>(ids.values)[0] == 5 );
+    REQUIRE( soci_get_into_column_v(st, namePos, &names) == 1 );
+    CHECK( names.validity[0] == 0x01 );
+    CHECK( names.offsets[0] == 0 );
+    CHECK( names.offsets[1] == 0 );
+
+    CHECK( soci_fetch(st) == 0 );
+    soci_destroy_statement(st);
+
+    st = soci_create_statement(sh);
+    soci_prepare(st, "drop table soci_test");
+    soci_execute(st, 1);
+    soci_destroy_statement(st);
+
+    soci_destroy_session(sh);
+}
+
 struct table_creator_for_std_tm_bind : table_creator_base
 {
     table_creator_for_std_tm_bind(soci::session & sql)